@@ -82,6 +82,8 @@ Application::Application()
   //passed_argv_(0),
   use_profiler(true),
   profiler_path(""),
+  use_profiler_trace_(false),
+  profiler_trace_path_(""),
   yaml_balance_output_(false)
 
 {
@@ -338,6 +340,8 @@ void Application::parse_cmd_line(const int argc, char ** argv) {
         ("no_signal_handler", "Turn off signal handling. Useful for debugging with valgrind.")
         ("no_profiler,no-profiler", "Turn off profiler output.")
         ("profiler_path,profiler-path", po::value< string >(), "Path to the profiler file")
+        ("profiler_hw_counters,profiler-hw-counters", "Measure hardware performance counters (cycles, instructions, cache misses, FLOPs) in profiler timers.")
+        ("profiler_trace,profiler-trace", po::value< string >()->implicit_value(""), "Record timeline of profiler events, write it in Chrome trace format (chrome://tracing, Perfetto) to given file (default: profiler_trace.json).")
         ("input_format", po::value< string >(), "Writes full structure of the main input file into given file.")
 		("petsc_redirect", po::value<string>(), "Redirect all PETSc stdout and stderr to given file.")
 		("yaml_balance", "Redirect balance output to YAML format too (simultaneously with the selected balance output format).");
@@ -385,6 +389,16 @@ void Application::parse_cmd_line(const int argc, char ** argv) {
         profiler_path = vm["profiler_path"].as<string>();
     }
 
+    if (vm.count("profiler_hw_counters")) {
+        Profiler::instance()->set_hw_counters(true);
+    }
+
+    if (vm.count("profiler_trace")) {
+        use_profiler_trace_ = true;
+        profiler_trace_path_ = vm["profiler_trace"].as<string>();
+        Profiler::instance()->set_trace(true);
+    }
+
     // if there is "help" option
     if (vm.count("help")) {
         display_version();
@@ -617,6 +631,8 @@ Application::~Application() {
         if (petsc_initialized) {
             // log profiler data to this stream
             profiler_json = Profiler::instance()->output(PETSC_COMM_WORLD, profiler_path);
+            if (use_profiler_trace_)
+                Profiler::instance()->output_trace(PETSC_COMM_WORLD, profiler_trace_path_);
         } else {
         	profiler_json = Profiler::instance()->output(profiler_path);
         }
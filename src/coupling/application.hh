@@ -232,6 +232,12 @@ protected:
     /// location of the profiler report file
     string profiler_path;
 
+    /// If true, timeline of profiler events is recorded and written in Chrome trace format.
+    bool use_profiler_trace_;
+
+    /// location of the profiler timeline file
+    string profiler_trace_path_;
+
     /// If true, preserves output of balance in YAML format.
     bool yaml_balance_output_;
 
@@ -24,10 +24,10 @@
 #include "system/sys_profiler.hh"
 #include "system/index_types.hh"
 
-#include <petscmat.h>
 #include "mesh/mesh.h"
 #include "mesh/accessors.hh"
 #include "io/output_time_set.hh"
+#include "io/checkpoint.hh"
 #include "coupling/balance.hh"
 #include "tools/unit_si.hh"
 #include "tools/time_governor.hh"
@@ -59,6 +59,10 @@ const Record & Balance::get_input_type() {
 		.declare_key("format", Balance::get_format_selection_input_type(), Default("\"txt\""), "Format of output file.")
 		.declare_key("cumulative", Bool(), Default("false"), "Compute cumulative balance over time. "
 				"If true, then balance is calculated at each computational time step, which can slow down the program.")
+		.declare_key("lazy_cumulative", Bool(), Default("false"), "Evaluate the cumulative balance only at balance output times. "
+				"The solution is integrated over time in every computational time step and the integrated flux and source "
+				"are computed from this integral at output times and when the balanced equation changes its data. "
+				"Results differ from the default evaluation only by round-off errors.")
 		.declare_key("file", FileName::output(), Default::read_time("File name generated from the balanced quantity: <quantity_name>_balance.*"), "File name for output of balance.")
 		.close();
 }
@@ -91,6 +95,8 @@ Balance::Balance(const std::string &file_prefix, const Mesh *mesh)
 	      mesh_(mesh),
 	  	  last_time_(),
 	  	  initial_(true),
+	  	  cumulative_(false),
+	  	  lazy_cumulative_(false),
 	  	  allocation_done_(false),
           balance_on_(true),
 	  	  output_line_counter_(0),
@@ -109,23 +115,6 @@ Balance::~Balance()
 		output_.close();
 		if (do_yaml_output_) output_yaml_.close();
 	}
-	if (! allocation_done_) return;
-
-	for (unsigned int c=0; c<quantities_.size(); ++c)
-	{
-		chkerr(MatDestroy(&(region_mass_matrix_[c])));
-		chkerr(MatDestroy(&(be_flux_matrix_[c])));
-		chkerr(MatDestroy(&(region_source_matrix_[c])));
-		chkerr(MatDestroy(&(region_source_rhs_[c])));
-		chkerr(VecDestroy(&(be_flux_vec_[c])));
-        chkerr(VecDestroy(&(region_mass_vec_[c])));
-	}
-	delete[] region_mass_matrix_;
-	delete[] be_flux_matrix_;
-	delete[] be_flux_vec_;
-	delete[] region_source_matrix_;
-	delete[] region_source_rhs_;
-    delete[] region_mass_vec_;
 }
 
 
@@ -143,6 +132,7 @@ void Balance::init_from_input(
     balance_output_type_ = tg.equation_fixed_mark_type() | marks.type_balance_output();
 
     cumulative_ = in_rec.val<bool>("cumulative");
+    lazy_cumulative_ = cumulative_ && in_rec.val<bool>("lazy_cumulative");
     output_format_ = in_rec.val<OutputFormat>("format");
 
     OutputTimeSet time_set;
@@ -187,7 +177,6 @@ void Balance::allocate(unsigned int n_loc_dofs,
 {
     ASSERT(! allocation_done_);
     n_loc_dofs_seq_ = n_loc_dofs;
-	n_loc_dofs_par_ = n_loc_dofs;
     max_dofs_per_boundary_ = max_dofs_per_boundary;
 }
 
@@ -195,10 +184,8 @@ void Balance::allocate(const std::shared_ptr<DOFHandlerMultiDim>& dh,
 		unsigned int max_dofs_per_boundary)
 {
     ASSERT(! allocation_done_);
-	// for sequential matrices, we need to include ghost values
+	// local dofs including ghost values
     n_loc_dofs_seq_ = dh->get_local_to_global_map().size();
-	// for parallel matrices, we use the local size from dof distribution
-	n_loc_dofs_par_ = dh->distr()->lsize();
     max_dofs_per_boundary_ = max_dofs_per_boundary;
 }
 
@@ -218,12 +205,10 @@ void Balance::lazy_initialize()
     {
         balance_on_ = false;
         cumulative_ = false;
+        lazy_cumulative_ = false;
         return;
     }
 
-	// Max. number of regions to which a single dof can contribute.
-	// TODO: estimate or compute this number directly (from mesh or dof handler).
-	const int n_bulk_regs_per_dof = min(10, (int)mesh_->region_db().bulk_size());
 	const unsigned int n_quant = quantities_.size();
 	const unsigned int n_bdr_reg = mesh_->region_db().boundary_size();
 	const unsigned int n_blk_reg = mesh_->region_db().bulk_size();
@@ -279,66 +264,18 @@ void Balance::lazy_initialize()
 
 
 
-	region_mass_matrix_ = new Mat[n_quant];
-	be_flux_matrix_ = new Mat[n_quant];
-	region_source_matrix_ = new Mat[n_quant];
-	region_source_rhs_ = new Mat[n_quant];
-    region_mass_vec_ = new Vec[n_quant];
-	be_flux_vec_ = new Vec[n_quant];
-
-
-	for (unsigned int c=0; c<n_quant; ++c)
+	quantity_data_.resize(n_quant);
+	for (QuantityData &q_data : quantity_data_)
 	{
-		chkerr(MatCreateAIJ(PETSC_COMM_WORLD,
-				n_loc_dofs_par_,
-				(rank_==0)?mesh_->region_db().bulk_size():0,
-				PETSC_DECIDE,
-				PETSC_DECIDE,
-				(rank_==0)?n_bulk_regs_per_dof:0,
-				0,
-				(rank_==0)?0:n_bulk_regs_per_dof,
-				0,
-				&(region_mass_matrix_[c])));
-
-        chkerr(MatCreateSeqAIJ(PETSC_COMM_SELF,
-               n_loc_dofs_seq_,
-               mesh_->region_db().bulk_size(),
-               n_bulk_regs_per_dof,
-               NULL,
-               &(region_source_matrix_[c])));
-
-        chkerr(MatCreateSeqAIJ(PETSC_COMM_SELF,
-               n_loc_dofs_seq_,
-               mesh_->region_db().bulk_size(),
-               n_bulk_regs_per_dof,
-               NULL,
-               &(region_source_rhs_[c])));
-    
-       chkerr(MatCreateAIJ(PETSC_COMM_WORLD,
-               be_regions_.size(),  // n local rows, number of local boundary edges
-               n_loc_dofs_par_,     // n local cols (local rows of multiplying vector)
-               PETSC_DECIDE,        // n global rows
-               PETSC_DECIDE,        // n global cols
-               max_dofs_per_boundary_,  // allocation, local poriton
-               0,
-               0,
-               0,
-               &(be_flux_matrix_[c])));
-        
-        chkerr(VecCreateMPI(PETSC_COMM_WORLD,
-                (rank_==0)?mesh_->region_db().bulk_size():0,
-                PETSC_DECIDE,
-                &(region_mass_vec_[c])));
-
-		chkerr(VecCreateMPI(PETSC_COMM_WORLD,
-				be_regions_.size(),
-				PETSC_DECIDE,
-				&(be_flux_vec_[c])));
+		q_data.mass_vec_.assign(n_blk_reg, 0);
+		q_data.flux_vec_.assign(be_regions_.size(), 0);
+		q_data.flux_edges_.reserve(be_regions_.size()*max_dofs_per_boundary_);
+		q_data.flux_dofs_.reserve(be_regions_.size()*max_dofs_per_boundary_);
+		q_data.flux_values_.reserve(be_regions_.size()*max_dofs_per_boundary_);
+		if (lazy_cumulative_) q_data.integrated_solution_.assign(n_loc_dofs_seq_, 0);
+		q_data.integrated_dt_ = 0;
 	}
 
-	// set be_offset_, used in add_flux_matrix_values()
-	chkerr(VecGetOwnershipRange(be_flux_vec_[0], &be_offset_, NULL));
-    
     if (rank_ == 0) {
         // set default value by output_format_
         std::string default_file_name;
@@ -388,8 +325,11 @@ void Balance::start_mass_assembly(unsigned int quantity_idx)
 {
     lazy_initialize();
     if (! balance_on_) return;
-	chkerr(MatZeroEntries(region_mass_matrix_[quantity_idx]));
-    chkerr(VecZeroEntries(region_mass_vec_[quantity_idx]));
+    QuantityData &q_data = quantity_data_[quantity_idx];
+    q_data.mass_dofs_.clear();
+    q_data.mass_regions_.clear();
+    q_data.mass_values_.clear();
+    std::fill(q_data.mass_vec_.begin(), q_data.mass_vec_.end(), 0);
 }
 
 
@@ -397,8 +337,12 @@ void Balance::start_flux_assembly(unsigned int quantity_idx)
 {
     lazy_initialize();
     if (! balance_on_) return;
-	chkerr(MatZeroEntries(be_flux_matrix_[quantity_idx]));
-	chkerr(VecZeroEntries(be_flux_vec_[quantity_idx]));
+    flush_integrated_solution(quantity_idx);
+    QuantityData &q_data = quantity_data_[quantity_idx];
+    q_data.flux_edges_.clear();
+    q_data.flux_dofs_.clear();
+    q_data.flux_values_.clear();
+    std::fill(q_data.flux_vec_.begin(), q_data.flux_vec_.end(), 0);
 }
 
 
@@ -406,42 +350,26 @@ void Balance::start_source_assembly(unsigned int quantity_idx)
 {
     lazy_initialize();
     if (! balance_on_) return;
-	chkerr(MatZeroEntries(region_source_matrix_[quantity_idx]));
-	chkerr(MatZeroEntries(region_source_rhs_[quantity_idx]));
+    flush_integrated_solution(quantity_idx);
+    QuantityData &q_data = quantity_data_[quantity_idx];
+    std::fill(q_data.source_mult_values_.begin(), q_data.source_mult_values_.end(), 0);
+    std::fill(q_data.source_add_values_.begin(), q_data.source_add_values_.end(), 0);
 }
 
 
-void Balance::finish_mass_assembly(unsigned int quantity_idx)
+void Balance::finish_mass_assembly(FMT_UNUSED unsigned int quantity_idx)
 {
 	ASSERT(allocation_done_);
-    if (! balance_on_) return;
-
-	chkerr(MatAssemblyBegin(region_mass_matrix_[quantity_idx], MAT_FINAL_ASSEMBLY));
-	chkerr(MatAssemblyEnd(region_mass_matrix_[quantity_idx], MAT_FINAL_ASSEMBLY));
-    chkerr(VecAssemblyBegin(region_mass_vec_[quantity_idx]));
-    chkerr(VecAssemblyEnd(region_mass_vec_[quantity_idx]));
 }
 
-void Balance::finish_flux_assembly(unsigned int quantity_idx)
+void Balance::finish_flux_assembly(FMT_UNUSED unsigned int quantity_idx)
 {
     ASSERT(allocation_done_);
-    if (! balance_on_) return;
-
-    chkerr(MatAssemblyBegin(be_flux_matrix_[quantity_idx], MAT_FINAL_ASSEMBLY));
-	chkerr(MatAssemblyEnd(be_flux_matrix_[quantity_idx], MAT_FINAL_ASSEMBLY));
-	chkerr(VecAssemblyBegin(be_flux_vec_[quantity_idx]));
-	chkerr(VecAssemblyEnd(be_flux_vec_[quantity_idx]));
 }
 
-void Balance::finish_source_assembly(unsigned int quantity_idx)
+void Balance::finish_source_assembly(FMT_UNUSED unsigned int quantity_idx)
 {
     ASSERT(allocation_done_);
-    if (! balance_on_) return;
-
-    chkerr(MatAssemblyBegin(region_source_matrix_[quantity_idx], MAT_FINAL_ASSEMBLY));
-	chkerr(MatAssemblyEnd(region_source_matrix_[quantity_idx], MAT_FINAL_ASSEMBLY));
-	chkerr(MatAssemblyBegin(region_source_rhs_[quantity_idx], MAT_FINAL_ASSEMBLY));
-	chkerr(MatAssemblyEnd(region_source_rhs_[quantity_idx], MAT_FINAL_ASSEMBLY));
 }
 
 
@@ -454,26 +382,15 @@ void Balance::add_mass_values(unsigned int quantity_idx,
 	ASSERT(allocation_done_);
     if (! balance_on_) return;
 
-	// map local dof indices to global
-	uint m = mat_values.size();
-	int row_dofs[m];
-	for (uint i=0; i<m; i++)
-		row_dofs[i]= dh_cell.dh()->get_local_to_global_map()[loc_dof_indices[i]];
-
-	PetscInt reg_array[1] = { (int)dh_cell.elm().region_idx().bulk_idx() };
-
-	chkerr_assert(MatSetValues(region_mass_matrix_[quantity_idx],
-			m,
-			row_dofs,
-			1,
-			reg_array,
-			&(mat_values[0]),
-			ADD_VALUES));
-
-	chkerr_assert(VecSetValue(region_mass_vec_[quantity_idx],
-            dh_cell.elm().region_idx().bulk_idx(),
-            vec_value,
-            ADD_VALUES));
+    QuantityData &q_data = quantity_data_[quantity_idx];
+	unsigned int reg_idx = dh_cell.elm().region_idx().bulk_idx();
+	for (unsigned int i=0; i<mat_values.size(); i++)
+	{
+		q_data.mass_dofs_.push_back(loc_dof_indices[i]);
+		q_data.mass_regions_.push_back(reg_idx);
+		q_data.mass_values_.push_back(mat_values[i]);
+	}
+	q_data.mass_vec_[reg_idx] += vec_value;
 }
 
 void Balance::add_flux_values(unsigned int quantity_idx,
@@ -486,28 +403,16 @@ void Balance::add_flux_values(unsigned int quantity_idx,
     if (! balance_on_) return;
 
 	// filling row elements corresponding to a boundary edge
-
-	// map local dof indices to global
-	uint m = mat_values.size();
-	int col_dofs[m];
-	for (uint i=0; i<m; i++)
-		col_dofs[i]= side.cell().dh()->get_local_to_global_map()[loc_dof_indices[i]];
-
+    QuantityData &q_data = quantity_data_[quantity_idx];
 	SideIter s = SideIter(side.side());
-	PetscInt glob_be_idx[1] = { int(be_offset_ + be_id_map_[get_boundary_edge_uid(s)]) };
-
-	chkerr_assert(MatSetValues(be_flux_matrix_[quantity_idx],
-			1,
-			glob_be_idx,
-			m,
-			col_dofs,
-			&(mat_values[0]),
-			ADD_VALUES));
-
-	chkerr_assert(VecSetValue(be_flux_vec_[quantity_idx],
-			glob_be_idx[0],
-			vec_value,
-			ADD_VALUES));
+	unsigned int be_idx = be_id_map_[get_boundary_edge_uid(s)];
+	for (unsigned int i=0; i<mat_values.size(); i++)
+	{
+		q_data.flux_edges_.push_back(be_idx);
+		q_data.flux_dofs_.push_back(loc_dof_indices[i]);
+		q_data.flux_values_.push_back(mat_values[i]);
+	}
+	q_data.flux_vec_[be_idx] += vec_value;
 }
 
 void Balance::add_source_values(unsigned int quantity_idx,
@@ -519,23 +424,23 @@ void Balance::add_source_values(unsigned int quantity_idx,
     ASSERT(allocation_done_);
     if (! balance_on_) return;
 
-	PetscInt reg_array[1] = { (int)region_idx };
-
-	chkerr_assert(MatSetValues(region_source_matrix_[quantity_idx],
-			loc_dof_indices.size(),
-			loc_dof_indices.memptr(),
-			1,
-			reg_array,
-			&(mult_mat_values[0]),
-			ADD_VALUES));
-    
-    chkerr_assert(MatSetValues(region_source_rhs_[quantity_idx],
-			loc_dof_indices.size(),
-			loc_dof_indices.memptr(),
-			1,
-			reg_array,
-			&(add_mat_values[0]),
-			ADD_VALUES));
+    // values of the same dof and region are summed up, signed sources are computed from the sums
+    QuantityData &q_data = quantity_data_[quantity_idx];
+    for (unsigned int i=0; i<loc_dof_indices.size(); i++)
+    {
+        unsigned long long key = (unsigned long long)loc_dof_indices[i] * mesh_->region_db().bulk_size() + region_idx;
+        auto it = q_data.source_entries_.find(key);
+        if (it == q_data.source_entries_.end())
+        {
+            it = q_data.source_entries_.emplace(key, q_data.source_dofs_.size()).first;
+            q_data.source_dofs_.push_back(loc_dof_indices[i]);
+            q_data.source_regions_.push_back(region_idx);
+            q_data.source_mult_values_.push_back(0);
+            q_data.source_add_values_.push_back(0);
+        }
+        q_data.source_mult_values_[it->second] += mult_mat_values[i];
+        q_data.source_add_values_[it->second] += add_mat_values[i];
+    }
 }
 
 
@@ -549,6 +454,43 @@ void Balance::add_cumulative_source(unsigned int quantity_idx, double source)
 }
 
 
+void Balance::sum_local_flux_source(unsigned int quantity_idx, const double *solution, double vec_coef,
+        double &flux, double &source) const
+{
+    const QuantityData &q_data = quantity_data_[quantity_idx];
+
+    // sum over region columns of transpose(S) * solution + SV * ones(n_blk_reg)
+    source = 0;
+    for (unsigned int k=0; k<q_data.source_dofs_.size(); ++k)
+        source += q_data.source_mult_values_[k]*solution[q_data.source_dofs_[k]] + vec_coef*q_data.source_add_values_[k];
+
+    // sum over boundary edges of F * solution + fv
+    flux = 0;
+    for (unsigned int k=0; k<q_data.flux_dofs_.size(); ++k)
+        flux += q_data.flux_values_[k]*solution[q_data.flux_dofs_[k]];
+    for (double fv : q_data.flux_vec_)
+        flux += vec_coef*fv;
+}
+
+
+void Balance::flush_integrated_solution(unsigned int quantity_idx)
+{
+    if (! lazy_cumulative_) return;
+    QuantityData &q_data = quantity_data_[quantity_idx];
+    if (q_data.integrated_dt_ == 0) return;
+
+    double flux, source;
+    sum_local_flux_source(quantity_idx, q_data.integrated_solution_.data(), q_data.integrated_dt_, flux, source);
+    increment_sources_[quantity_idx] += source;
+    // Since internally we keep outgoing fluxes, we change sign
+    // to write to output _incoming_ fluxes.
+    increment_fluxes_[quantity_idx] += -1.0 * flux;
+
+    std::fill(q_data.integrated_solution_.begin(), q_data.integrated_solution_.end(), 0);
+    q_data.integrated_dt_ = 0;
+}
+
+
 void Balance::calculate_cumulative(unsigned int quantity_idx,
 		const Vec &solution)
 {
@@ -556,55 +498,44 @@ void Balance::calculate_cumulative(unsigned int quantity_idx,
 	if (!cumulative_) return;
     if (time_->tlevel() <= 0) return;
 
-    // sources
-    double temp_source = 0;
-    int lsize, n_cols_mat, n_cols_rhs;
-    //const int *cols;
-	const double *vals_mat, *vals_rhs, *sol_array;
-    // chkerr(VecGetLocalSize(solution, &lsize));
-	// chkerr(ISLocalToGlobalMappingGetSize(solution->mapping, &lsize);  // cannot do for const
-	lsize = n_loc_dofs_seq_;
+    const double *sol_array;
     chkerr(VecGetArrayRead(solution, &sol_array));
-    
-    // computes transpose multiplication and sums region_source_rhs_ over dofs
-    // resulting in a vector of sources for each region
-    // transpose(region_source_matrix_) * solution + region_source_rhs_*ones(n_blk_reg)
-    // the region vector is then summed up to temp_source
-    for (int i=0; i<lsize; ++i){
-        chkerr(MatGetRow(region_source_matrix_[quantity_idx], i, &n_cols_mat, NULL, &vals_mat));
-        chkerr(MatGetRow(region_source_rhs_[quantity_idx], i, &n_cols_rhs, NULL, &vals_rhs));
-        
-        ASSERT(n_cols_mat == n_cols_rhs);
-        
-        for (int j=0; j<n_cols_mat; ++j)
-            temp_source += vals_mat[j]*sol_array[i] + vals_rhs[j];
-        
-        chkerr(MatRestoreRow(region_source_matrix_[quantity_idx], i, &n_cols_mat, NULL, &vals_mat));
-        chkerr(MatRestoreRow(region_source_rhs_[quantity_idx], i, &n_cols_rhs, NULL, &vals_rhs));
+
+    if (lazy_cumulative_)
+    {
+        // only integrate the solution, fluxes and sources are computed in flush_integrated_solution()
+        QuantityData &q_data = quantity_data_[quantity_idx];
+        double dt = time_->dt();
+        for (unsigned int i=0; i<n_loc_dofs_seq_; ++i)
+            q_data.integrated_solution_[i] += dt*sol_array[i];
+        q_data.integrated_dt_ += dt;
+    }
+    else
+    {
+        // local contributions, summed over processes in output()
+        double sum_fluxes, sum_sources;
+        sum_local_flux_source(quantity_idx, sol_array, 1.0, sum_fluxes, sum_sources);
+        increment_sources_[quantity_idx] += sum_sources*time_->dt();
+        // sum fluxes in one step
+        // Since internally we keep outgoing fluxes, we change sign
+        // to write to output _incoming_ fluxes.
+        increment_fluxes_[quantity_idx] += -1.0 * sum_fluxes*time_->dt();
     }
+
     chkerr(VecRestoreArrayRead(solution, &sol_array));
+}
 
-    increment_sources_[quantity_idx] += temp_source*time_->dt();
 
-    
-    // fluxes     
-	Vec temp;
-    chkerr(VecCreateMPI(PETSC_COMM_WORLD,
-			be_regions_.size(),
-			PETSC_DECIDE,
-			&temp));
-    
-	chkerr(MatMultAdd(be_flux_matrix_[quantity_idx], solution, be_flux_vec_[quantity_idx], temp));
-	
-    double sum_fluxes;
-	chkerr(VecSum(temp, &sum_fluxes));
-	chkerr(VecDestroy(&temp));
+void Balance::calculate_local_mass(unsigned int quantity_idx,
+		const double *solution,
+		vector<double> &output_array) const
+{
+    const QuantityData &q_data = quantity_data_[quantity_idx];
 
-	if (rank_ == 0)
-		// sum fluxes in one step
-        // Since internally we keep outgoing fluxes, we change sign
-        // to write to output _incoming_ fluxes.
-		increment_fluxes_[quantity_idx] += -1.0 * sum_fluxes*time_->dt();
+	// compute mass on regions: M'.u + mv
+    output_array.assign(q_data.mass_vec_.begin(), q_data.mass_vec_.end());
+    for (unsigned int k=0; k<q_data.mass_dofs_.size(); ++k)
+        output_array[ q_data.mass_regions_[k] ] += q_data.mass_values_[k]*solution[q_data.mass_dofs_[k]];
 }
 
 
@@ -615,132 +546,144 @@ void Balance::calculate_mass(unsigned int quantity_idx,
     ASSERT(allocation_done_);
     if (! balance_on_) return;
 
-    Vec bulk_vec;
-
-	chkerr(VecCreateMPIWithArray(PETSC_COMM_WORLD,
-			1,
-			(rank_==0)?mesh_->region_db().bulk_size():0,
-			PETSC_DECIDE,
-			&(output_array[0]),
-			&bulk_vec));
-
-	// compute mass on regions: M'.u
-	chkerr(VecZeroEntries(bulk_vec));
-	chkerr(MatMultTransposeAdd(region_mass_matrix_[quantity_idx], 
-                               solution, 
-                               region_mass_vec_[quantity_idx], 
-                               bulk_vec));
-	chkerr(VecDestroy(&bulk_vec));
+    const double *sol_array;
+    chkerr(VecGetArrayRead(solution, &sol_array));
+    calculate_local_mass(quantity_idx, sol_array, output_array);
+    chkerr(VecRestoreArrayRead(solution, &sol_array));
+
+    MPI_Reduce((rank_==0) ? MPI_IN_PLACE : output_array.data(), output_array.data(), output_array.size(),
+            MPI_DOUBLE, MPI_SUM, 0, PETSC_COMM_WORLD);
 }
 
 void Balance::calculate_instant(unsigned int quantity_idx, const Vec& solution)
 {
     if ( !is_current() ) return;
-    
-    calculate_mass(quantity_idx, solution, masses_[quantity_idx]);
-    
+
+    const QuantityData &q_data = quantity_data_[quantity_idx];
+    const double *sol_array;
+    chkerr(VecGetArrayRead(solution, &sol_array));
+
+    calculate_local_mass(quantity_idx, sol_array, masses_[quantity_idx]);
+
 	// compute positive/negative sources
-    for (unsigned int r=0; r<mesh_->region_db().bulk_size(); ++r)
+    sources_in_[quantity_idx].assign(mesh_->region_db().bulk_size(), 0);
+    sources_out_[quantity_idx].assign(mesh_->region_db().bulk_size(), 0);
+    for (unsigned int k=0; k<q_data.source_dofs_.size(); ++k)
     {
-        sources_in_[quantity_idx][r] = 0;
-		sources_out_[quantity_idx][r] = 0;
-    }
-    
-    int lsize, n_cols_mat, n_cols_rhs;
-    const int *cols;    // the columns must be same - matrices created and filled in the same way
-	const double *vals_mat, *vals_rhs, *sol_array;
-    // chkerr(VecGetLocalSize(solution, &lsize));
-	// chkerr(ISLocalToGlobalMappingGetSize(solution->mapping, &lsize);	// cannot do for const
-	lsize = n_loc_dofs_seq_;
-    chkerr(VecGetArrayRead(solution, &sol_array));
-    
-    // computes transpose multiplication and sums region_source_rhs_ over dofs
-    // resulting in a vector of sources for each region, one positive, one negative
-    // transpose(region_source_matrix_) * solution + region_source_rhs_*ones(n_blk_reg)
-    for (int i=0; i<lsize; ++i)
-    {
-        int row = i;
-        chkerr(MatGetRow(region_source_matrix_[quantity_idx], row, &n_cols_mat, &cols, &vals_mat));
-        chkerr(MatGetRow(region_source_rhs_[quantity_idx], row, &n_cols_rhs, NULL, &vals_rhs));
-        
-        ASSERT(n_cols_mat == n_cols_rhs);
-        
-        for (int j=0; j<n_cols_mat; ++j)
-        {
-            int col = cols[j];
-            
-            double f = vals_mat[j]*sol_array[i] + vals_rhs[j];
-            if (f > 0) sources_in_[quantity_idx][col] += f;
-            else sources_out_[quantity_idx][col] += f;
-        }
+        double f = q_data.source_mult_values_[k]*sol_array[q_data.source_dofs_[k]] + q_data.source_add_values_[k];
+        if (f > 0) sources_in_[quantity_idx][q_data.source_regions_[k]] += f;
+        else sources_out_[quantity_idx][q_data.source_regions_[k]] += f;
     }
+
+    // calculate flux F * solution + fv on local boundary edges
+    std::vector<double> be_flux(q_data.flux_vec_);
+    for (unsigned int k=0; k<q_data.flux_dofs_.size(); ++k)
+        be_flux[ q_data.flux_edges_[k] ] += q_data.flux_values_[k]*sol_array[q_data.flux_dofs_[k]];
     chkerr(VecRestoreArrayRead(solution, &sol_array));
-    
-    // calculate flux
-	Vec temp;
-    chkerr(VecCreateMPI(PETSC_COMM_WORLD,
-			be_regions_.size(),
-			PETSC_DECIDE,
-			&temp));
-    
-	chkerr(MatMultAdd(be_flux_matrix_[quantity_idx], solution, be_flux_vec_[quantity_idx], temp));
-	// Since internally we keep outgoing fluxes, we change sign
-	// to write to output _incoming_ fluxes.
-	chkerr(VecScale(temp, -1));
 
 	// compute positive/negative fluxes
+	// Since internally we keep outgoing fluxes, we change sign
+	// to write to output _incoming_ fluxes.
 	fluxes_in_[quantity_idx].assign(mesh_->region_db().boundary_size(), 0);
 	fluxes_out_[quantity_idx].assign(mesh_->region_db().boundary_size(), 0);
-	const double *flux_array;
-// 	int lsize;
-	chkerr(VecGetArrayRead(temp, &flux_array));
-	chkerr(VecGetLocalSize(temp, &lsize));
-	for (int e=0; e<lsize; ++e)
+	for (unsigned int e=0; e<be_flux.size(); ++e)
 	{
-		if (flux_array[e] < 0)
-			fluxes_out_[quantity_idx][be_regions_[e]] += flux_array[e];
+		double flux = -be_flux[e];
+		if (flux < 0)
+			fluxes_out_[quantity_idx][be_regions_[e]] += flux;
 		else
-			fluxes_in_[quantity_idx][be_regions_[e]] += flux_array[e];
+			fluxes_in_[quantity_idx][be_regions_[e]] += flux;
 	}
-	chkerr(VecRestoreArrayRead(temp, &flux_array));
-	chkerr(VecDestroy(&temp));
 }
 
 
 
 
 
+void Balance::save_state(CheckpointData &data, const std::string &prefix) const
+{
+	if (! balance_on_) return;
+	// increments include the time integral of the solution not evaluated yet (lazy mode)
+	std::vector<double> increment_sources(increment_sources_), increment_fluxes(increment_fluxes_);
+	if (lazy_cumulative_)
+		for (unsigned int qi=0; qi<quantity_data_.size(); qi++)
+		{
+			if (quantity_data_[qi].integrated_dt_ == 0) continue;
+			double flux, source;
+			sum_local_flux_source(qi, quantity_data_[qi].integrated_solution_.data(), quantity_data_[qi].integrated_dt_,
+			        flux, source);
+			increment_sources[qi] += source;
+			increment_fluxes[qi] += -1.0 * flux;
+		}
+	data.save(prefix + "/initial_mass", initial_mass_);
+	data.save(prefix + "/integrated_sources", integrated_sources_);
+	data.save(prefix + "/integrated_fluxes", integrated_fluxes_);
+	data.save(prefix + "/increment_sources", increment_sources);
+	data.save(prefix + "/increment_fluxes", increment_fluxes);
+	data.save(prefix + "/last_time", last_time_);
+	data.save(prefix + "/initial", initial_);
+}
+
+
+
+void Balance::load_state(const CheckpointData &data, const std::string &prefix)
+{
+	lazy_initialize();
+	if (! balance_on_) return;
+	data.load(prefix + "/initial_mass", initial_mass_);
+	data.load(prefix + "/integrated_sources", integrated_sources_);
+	data.load(prefix + "/integrated_fluxes", integrated_fluxes_);
+	data.load(prefix + "/increment_sources", increment_sources_);
+	data.load(prefix + "/increment_fluxes", increment_fluxes_);
+	data.load(prefix + "/last_time", last_time_);
+	data.load(prefix + "/initial", initial_);
+}
+
+
+
 void Balance::output()
 {
     ASSERT(allocation_done_);
     if (! balance_on_) return;
     if (! is_current() ) return;
     
-	// gather results from processes and sum them up
+	// evaluate postponed cumulative fluxes and sources
+	if (lazy_cumulative_)
+		for (unsigned int qi=0; qi<quantities_.size(); qi++)
+			flush_integrated_solution(qi);
+
+	// gather results from processes and sum them up, all quantities are packed into a single buffer:
+	// masses, sources_in, sources_out (bulk regions), fluxes_in, fluxes_out (boundary regions) of every quantity
+	// and increments of source and flux of every quantity for cumulative balance
     const unsigned int n_quant = quantities_.size();
 	const unsigned int n_blk_reg = mesh_->region_db().bulk_size();
 	const unsigned int n_bdr_reg = mesh_->region_db().boundary_size();
-	const int buf_size = n_quant*2*n_blk_reg + n_quant*2*n_bdr_reg + n_quant;
-	double sendbuffer[buf_size], recvbuffer[buf_size];
+	const unsigned int q_size = 3*n_blk_reg + 2*n_bdr_reg;
+	const unsigned int inc_offset = n_quant*q_size;
+	const int buf_size = inc_offset + (cumulative_ ? 2*n_quant : 0);
+	std::vector<double> sendbuffer(buf_size), recvbuffer(buf_size);
 	for (unsigned int qi=0; qi<n_quant; qi++)
 	{
+		double *q_buffer = sendbuffer.data() + qi*q_size;
 		for (unsigned int ri=0; ri<n_blk_reg; ri++)
 		{
-			sendbuffer[qi*2*n_blk_reg +           + ri] = sources_in_[qi][ri];
-			sendbuffer[qi*2*n_blk_reg + n_blk_reg + ri] = sources_out_[qi][ri];
+			q_buffer[              ri] = masses_[qi][ri];
+			q_buffer[  n_blk_reg + ri] = sources_in_[qi][ri];
+			q_buffer[2*n_blk_reg + ri] = sources_out_[qi][ri];
 		}
 		for (unsigned int ri=0; ri<n_bdr_reg; ri++)
 		{
-			sendbuffer[n_quant*2*n_blk_reg + qi*2*n_bdr_reg +           + ri] = fluxes_in_[qi][ri];
-			sendbuffer[n_quant*2*n_blk_reg + qi*2*n_bdr_reg + n_bdr_reg + ri] = fluxes_out_[qi][ri];
+			q_buffer[3*n_blk_reg +             ri] = fluxes_in_[qi][ri];
+			q_buffer[3*n_blk_reg + n_bdr_reg + ri] = fluxes_out_[qi][ri];
 		}
 		if (cumulative_)
         {
-            sendbuffer[n_quant*2*n_blk_reg + n_quant*2*n_bdr_reg + qi] = increment_sources_[qi];
+            sendbuffer[inc_offset +           qi] = increment_sources_[qi];
+            sendbuffer[inc_offset + n_quant + qi] = increment_fluxes_[qi];
         }
 	}
     
-	MPI_Reduce(&sendbuffer,recvbuffer,buf_size,MPI_DOUBLE,MPI_SUM,0,PETSC_COMM_WORLD);
+	MPI_Reduce(sendbuffer.data(),recvbuffer.data(),buf_size,MPI_DOUBLE,MPI_SUM,0,PETSC_COMM_WORLD);
 	// for other than 0th process update last_time and finish,
 	// on process #0 sum balances over all regions and calculate
 	// cumulative balance over time.
@@ -749,19 +692,22 @@ void Balance::output()
 		// update balance vectors
 		for (unsigned int qi=0; qi<n_quant; qi++)
 		{
+			const double *q_buffer = recvbuffer.data() + qi*q_size;
 			for (unsigned int ri=0; ri<n_blk_reg; ri++)
 			{
-				sources_in_[qi][ri]  = recvbuffer[qi*2*n_blk_reg +           + ri];
-				sources_out_[qi][ri] = recvbuffer[qi*2*n_blk_reg + n_blk_reg + ri];
+				masses_[qi][ri]      = q_buffer[              ri];
+				sources_in_[qi][ri]  = q_buffer[  n_blk_reg + ri];
+				sources_out_[qi][ri] = q_buffer[2*n_blk_reg + ri];
 			}
 			for (unsigned int ri=0; ri<n_bdr_reg; ri++)
 			{
-				fluxes_in_[qi][ri]  = recvbuffer[n_quant*2*n_blk_reg + qi*2*n_bdr_reg +           + ri];
-				fluxes_out_[qi][ri] = recvbuffer[n_quant*2*n_blk_reg + qi*2*n_bdr_reg + n_bdr_reg + ri];
+				fluxes_in_[qi][ri]  = q_buffer[3*n_blk_reg +             ri];
+				fluxes_out_[qi][ri] = q_buffer[3*n_blk_reg + n_bdr_reg + ri];
 			}
 			if (cumulative_)
             {
-                increment_sources_[qi] = recvbuffer[n_quant*2*n_blk_reg + n_quant*2*n_bdr_reg + qi];
+                increment_sources_[qi] = recvbuffer[inc_offset +           qi];
+                increment_fluxes_[qi]  = recvbuffer[inc_offset + n_quant + qi];
             }
 		}
 	}
@@ -847,8 +793,8 @@ void Balance::output()
 	{
 		sum_fluxes_.assign(n_quant, 0);
 		sum_sources_.assign(n_quant, 0);
-		increment_fluxes_.assign(n_quant, 0);
 	}
+	increment_fluxes_.assign(n_quant, 0);
 	increment_sources_.assign(n_quant, 0);
 }
 
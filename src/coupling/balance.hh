@@ -26,7 +26,6 @@
 #include "mesh/accessors.hh"    // for SideIter
 #include "tools/unit_si.hh"    // for UnitSI
 #include "input/accessors.hh"   // for Record
-#include "petscmat.h"           // for Mat, _p_Mat
 #include "petscvec.h"           // for Vec, _p_Vec
 #include "system/file_path.hh"  // for FilePath
 #include "tools/time_marks.hh"  // for TimeMark, TimeMark::Type
@@ -34,6 +33,7 @@
 
 class Mesh;
 class TimeGovernor;
+class CheckpointData;
 class DOFHandlerMultiDim;
 class DHCellSide;
 class DHCellAccessor;
@@ -70,14 +70,20 @@ namespace Input {
  *
  * and
  *
- * 	M(q)...region_mass_matrix_		n_dofs x n_bulk_regions
- * 	F(q)...be_flux_matrix_			n_boundary_edges x n_dofs
- * 	S(q)...region_source_matrix_	n_dofs x n_bulk_regions
- * 	SV(q)..region_source_rhs_		n_dofs x n_bulk_regions
- *  mv(q)..region_mass_vec_         n_bulk_regions
- * 	fv(q)..be_flux_vec_				n_boundary_edges
- * 	sv(q)..region_source_vec_    	n_bulk_regions
- * 	R......region_be_matrix_		n_boundary_edges x n_boundary_regions
+ * 	M(q)...mass_values_				n_dofs x n_bulk_regions
+ * 	F(q)...flux_values_				n_boundary_edges x n_dofs
+ * 	S(q)...source_mult_values_		n_dofs x n_bulk_regions
+ * 	SV(q)..source_add_values_		n_dofs x n_bulk_regions
+ *  mv(q)..mass_vec_                n_bulk_regions
+ * 	fv(q)..flux_vec_				n_boundary_edges
+ * 	sv(q)..column sum of SV(q)    	n_bulk_regions
+ * 	R......be_regions_				n_boundary_edges x n_boundary_regions
+ *
+ * The matrices are not stored as PETSc objects. Every process keeps lists of entries
+ * (local dof, region or boundary edge, value) assembled on the process and dense vectors
+ * of regions and local boundary edges. Products with the solution are evaluated locally
+ * from the local (ghosted) solution array and the region sums of all processes are reduced
+ * by a single MPI_Reduce in @p output.
  * 
  * Remark: Matrix F and the vector fv are such that F*solution+fv produces _outcoming_ fluxes per boundary edge.
  * However we write to output _incoming_ flux due to users' convention and consistently with input interface.
@@ -115,6 +121,11 @@ namespace Input {
  *
  * error = current_mass - (initial_mass + integrated_source - integrated_flux)
  *
+ * In the lazy cumulative mode (key 'lazy_cumulative') the method @p calculate_cumulative only adds
+ * dt*solution to the time integral of the solution. Integrated flux and source are evaluated
+ * from this integral at the output and before the balance data are assembled again, which is exact
+ * as the flux and source are linear in the solution.
+ *
  */
 class Balance {
 public:
@@ -189,6 +200,9 @@ public:
 	/// Getter for cumulative_.
 	inline bool cumulative() const { return cumulative_; }
 
+	/// Getter for lazy_cumulative_.
+	inline bool lazy_cumulative() const { return lazy_cumulative_; }
+
 
 	/**
 	 * Define a single conservative quantity.
@@ -350,7 +364,8 @@ public:
 	/**
 	 * Updates cumulative quantities for balance.
 	 * This method can be called in substeps even if no output is generated.
-	 * It calculates the sum of source and sum of (incoming) flux over time interval.
+	 * It calculates the sum of source and sum of (incoming) flux over time interval,
+	 * in the lazy mode it only integrates the solution over time.
 	 * @param quantity_idx  Index of quantity.
 	 * @param solution      Solution vector.
 	 */
@@ -359,6 +374,7 @@ public:
 
 	/**
 	 * Calculates actual mass and save it to given vector.
+	 * Collective, the masses summed over all processes are set only on the process 0.
 	 * @param quantity_idx  Index of quantity.
 	 * @param solution      Solution vector.
 	 * @param output_array	Vector of output masses per region.
@@ -369,6 +385,7 @@ public:
 
 	/**
 	 * Calculates actual mass, incoming flux and source.
+	 * Only local contributions are computed, they are summed over processes in @p output.
 	 * @param quantity_idx  Index of quantity.
 	 * @param solution      Solution vector.
 	 */
@@ -386,9 +403,68 @@ public:
 	/// Perform output to file for given time instant.
 	void output();
 
+	/**
+	 * Store cumulative quantities (initial mass, integrated fluxes and sources) into the checkpoint.
+	 * Other data are recomputed in every output.
+	 */
+	void save_state(CheckpointData &data, const std::string &prefix) const;
+
+	/// Restore cumulative quantities stored by @p save_state.
+	void load_state(const CheckpointData &data, const std::string &prefix);
+
 private:
 	/// Size of column in output (used if delimiter is space)
 	static const unsigned int output_column_width = 20;
+
+	/**
+	 * Balance data of a single quantity assembled on the process, see class description.
+	 * Entries are indexed by local dofs (including ghost dofs), bulk region indices
+	 * and local boundary edges.
+	 */
+	struct QuantityData {
+	    /// Entries of the mass matrix M: local dof, bulk region index and value.
+	    std::vector<unsigned int> mass_dofs_, mass_regions_;
+	    std::vector<double> mass_values_;
+
+	    /// Mass vector mv (n_bulk_regions).
+	    std::vector<double> mass_vec_;
+
+	    /// Entries of the flux matrix F: local boundary edge, local dof and value.
+	    std::vector<unsigned int> flux_edges_, flux_dofs_;
+	    std::vector<double> flux_values_;
+
+	    /// Flux vector fv (n_local_boundary_edges).
+	    std::vector<double> flux_vec_;
+
+	    /// Entries of source matrices S and SV with the same position: local dof, bulk region index and values.
+	    std::vector<unsigned int> source_dofs_, source_regions_;
+	    std::vector<double> source_mult_values_, source_add_values_;
+
+	    /**
+	     * Maps (local dof, bulk region index) to the source entry, the entries are kept over assemblies
+	     * (only their values are set to zero), so repeated assemblies do not allocate.
+	     */
+	    std::unordered_map<unsigned long long, unsigned int> source_entries_;
+
+	    /// Time integral of the solution (local dofs) not included in cumulative flux and source yet (lazy mode).
+	    std::vector<double> integrated_solution_;
+
+	    /// Length of the time interval of @p integrated_solution_.
+	    double integrated_dt_;
+	};
+
+	/**
+	 * Compute sum of source and sum of outgoing flux of the quantity on the process
+	 * for given solution array (local dofs), the vectors sv and fv are multiplied by @p vec_coef.
+	 */
+	void sum_local_flux_source(unsigned int quantity_idx, const double *solution, double vec_coef,
+	        double &flux, double &source) const;
+
+	/// Compute masses of regions from contributions of the process.
+	void calculate_local_mass(unsigned int quantity_idx, const double *solution, vector<double> &output_array) const;
+
+	/// Add cumulative flux and source of the time integral of the solution to increments (lazy mode).
+	void flush_integrated_solution(unsigned int quantity_idx);
 	/**
 	 * Postponed allocation and initialization to allow calling setters in arbitrary order.
 	 * In particular we need to perform adding of output times after the output time marks are set.
@@ -431,7 +507,6 @@ private:
 	static bool do_yaml_output_;
 
 	/// Allocation parameters. Set by the allocate method used in the lazy_initialize.
-	unsigned int n_loc_dofs_par_;
 	unsigned int n_loc_dofs_seq_;
     unsigned int max_dofs_per_boundary_;
 
@@ -460,23 +535,8 @@ private:
     UnitSI units_;
 
 
-    /// Matrices for calculation of mass (n_dofs x n_bulk_regions).
-    Mat *region_mass_matrix_;
-
-    /// Matrices for calculation of flux (n_boundary_edges x n_dofs).
-    Mat *be_flux_matrix_;
-
-    /// Matrices for calculation of source (n_dofs x n_bulk_regions).
-    Mat *region_source_matrix_;
-
-    /// Matrices for calculation of signed source (n_dofs x n_bulk_regions).
-    Mat *region_source_rhs_;
-
-    /// Vectors for calculation of flux (n_boundary_edges).
-    Vec *be_flux_vec_;
-    
-    /// Vectors for calculation of mass (n_bulk_regions).
-    Vec *region_mass_vec_;
+    /// Assembled balance data of quantities.
+    std::vector<QuantityData> quantity_data_;
 
     /** Maps unique identifier of (local bulk element idx, side idx) returned by @p get_boundary_edge_uid(side)
      * to local boundary edge.
@@ -488,9 +548,6 @@ private:
     /// Maps local boundary edge to its region boundary index.
     std::vector<unsigned int> be_regions_;
 
-    /// Offset for local part of vector of boundary edges.
-    int be_offset_;
-
 
     // Vectors storing mass and balances of fluxes and volumes.
     // substance, phase, region
@@ -532,7 +589,10 @@ private:
 	/// if true then cumulative balance is computed
 	bool cumulative_;
 
-	/// true before allocating necessary internal structures (Petsc matrices etc.)
+	/// if true then cumulative flux and source are evaluated from the time integral of the solution
+	bool lazy_cumulative_;
+
+	/// true before allocating necessary internal structures
 	bool allocation_done_;
 
 	/// If the balance is on. Balance is off in the case of no balance output time marks.
@@ -28,6 +28,8 @@
 #include "fields/bc_field.hh"
 #include "tools/unit_converter.hh"
 #include "tools/unit_si.hh"
+#include "coupling/balance.hh"
+#include "io/checkpoint.hh"
 
 
 
@@ -57,7 +59,8 @@ EquationBase::EquationBase()
   mesh_(NULL),
   time_(NULL),
   input_record_(),
-  eq_fieldset_(nullptr)
+  eq_fieldset_(nullptr),
+  zero_step_output_(true)
 {}
 
 
@@ -67,7 +70,8 @@ EquationBase::EquationBase(Mesh &mesh, const  Input::Record in_rec)
   mesh_(&mesh),
   time_(NULL),
   input_record_(in_rec),
-  eq_fieldset_(nullptr)
+  eq_fieldset_(nullptr),
+  zero_step_output_(true)
 {}
 
 
@@ -81,6 +85,18 @@ double EquationBase::solved_time()
     return time_->t();
 }
 
+void EquationBase::save_state(CheckpointData &data, const std::string &prefix)
+{
+    if (time_ != nullptr) time_->save_state(data, prefix + "/time");
+    if (balance_ != nullptr) balance_->save_state(data, prefix + "/balance");
+}
+
+void EquationBase::load_state(const CheckpointData &data, const std::string &prefix)
+{
+    if (time_ != nullptr) time_->load_state(data, prefix + "/time");
+    if (balance_ != nullptr) balance_->load_state(data, prefix + "/balance");
+}
+
 void EquationBase::init_user_fields(Input::Array user_fields, FieldSet &output_fields) {
 	for (Input::Iterator<Input::Record> it = user_fields.begin<Input::Record>();
                     it != user_fields.end();
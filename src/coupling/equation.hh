@@ -24,15 +24,19 @@
 #include <memory>                                      // for shared_ptr
 #include <string>                                      // for basic_string
 #include <typeinfo>                                    // for type_info
+#include <vector>                                      // for vector
 #include "input/accessors.hh"                          // for Record
 #include "system/exceptions.hh"                        // for ExcAssertMsg::...
 #include "system/asserts.hh"                           // for ASSERT_PERMANENT, ...
 #include "system/logger.hh"                            // for Logger, DebugOut
+#include "system/fmt/posix.h"                          // for FMT_UNUSED
 #include "tools/time_governor.hh"                      // for TimeGovernor
 #include "tools/time_marks.hh"                         // for TimeMark, Time...
 class Balance;
+class CheckpointData;
 class FieldSet;
 class Mesh;
+class OutputTime;
 
 
 /**
@@ -235,6 +239,36 @@ public:
      */
     void init_user_fields(Input::Array user_fields, FieldSet &output_fields);
 
+    /**
+     * Store state of the equation necessary for restart of the simulation into the checkpoint.
+     * Names of the blocks are prefixed by @p prefix.
+     *
+     * Default implementation stores the time governor and the balance, equations with
+     * a solution have to override it and store the solution vectors as well.
+     */
+    virtual void save_state(CheckpointData &data, const std::string &prefix);
+
+    /**
+     * Restore state of the equation stored by @p save_state. Called after @p zero_time_step,
+     * so all structures are allocated.
+     */
+    virtual void load_state(const CheckpointData &data, const std::string &prefix);
+
+    /**
+     * Switch output of the initial state in @p zero_time_step. The output is suppressed on restart
+     * from a checkpoint, where the zero time step only allocates the structures and its state is overwritten.
+     * Coupled equations pass the setting to their sub-equations.
+     */
+    virtual void set_zero_step_output(bool output)
+    { zero_step_output_ = output; }
+
+    /**
+     * Add output streams of the equation to @p streams, so their observe output can be flushed
+     * and stored at checkpoints. Coupled equations add streams of their sub-equations.
+     */
+    virtual void get_output_streams(FMT_UNUSED std::vector<std::shared_ptr<OutputTime>> &streams)
+    {}
+
 protected:
     bool equation_empty_;       ///< flag is true if only default constructor was called
     Mesh * mesh_;
@@ -250,6 +284,9 @@ protected:
     
     /// object for calculation and writing the mass balance to file.
     std::shared_ptr<Balance> balance_;
+
+    /// Output of the initial state in zero_time_step, false on restart from a checkpoint.
+    bool zero_step_output_;
     
 };
 
@@ -18,6 +18,7 @@
 #ifndef GENERIC_ASSEMBLY_HH_
 #define GENERIC_ASSEMBLY_HH_
 
+#include <deque>
 #include "quadrature/quadrature_lib.hh"
 #include "fields/eval_subset.hh"
 #include "fields/eval_points.hh"
@@ -160,6 +161,13 @@ protected:
  *  - associates assemblation objects specified by dimension
  *  - provides general assemble method
  *  - provides methods that allow construction of element patches
+ *
+ * Patches are constructed only at the first call of assemble. Their layout (sorted eval points, region and element
+ * chunks) and integral data are stored as patch plans and replayed by following calls of assemble, so repeated
+ * assemblies (time steps, nonlinear iterations) do not pass through the sides of mesh nor sort eval points.
+ * Plans are rebuilt if the DOF handler (or its distribution of DOFs) changes, or explicitly after
+ * invalidate_patch_plans. Every plan also holds values of fields that did not change since the previous
+ * assembly (see FieldSet::cache_update), these are copied to the field caches instead of evaluation.
  */
 template < template<IntDim...> class DimAssembly>
 class GenericAssembly : public GenericAssemblyBase
@@ -198,6 +206,13 @@ public:
 
     void set_min_edge_sides(unsigned int val) {
         min_edge_sides_ = val;
+        this->invalidate_patch_plans();
+    }
+
+    /// Discard stored patch plans, patches are created again at the next call of assemble.
+    void invalidate_patch_plans() {
+        patch_plans_.clear();
+        plan_key_ = PatchPlanKey();
     }
 
 	/**
@@ -211,6 +226,67 @@ public:
         this->reallocate_cache();
         multidim_assembly_[1_d]->begin();
 
+        PatchPlanKey key(dh);
+        if (key == plan_key_) {
+            for (auto &plan : patch_plans_) this->replay_patch_plan(plan);
+        } else {
+            patch_plans_.clear();
+            this->create_patches(dh);
+            plan_key_ = key;
+        }
+
+        multidim_assembly_[1_d]->end();
+        END_TIMER( DimAssembly<1>::name() );
+    }
+
+    /// Return ElementCacheMap
+    inline const ElementCacheMap &cache_map() const {
+        return element_cache_map_;
+    }
+
+private:
+    /**
+     * Recorded patch: layout of ElementCacheMap and data of integrals.
+     */
+    struct PatchPlan {
+        /// Constructor, copies integral data of the actual patch
+        PatchPlan(const RevertableList<BulkIntegralData> &bulk, const RevertableList<EdgeIntegralData> &edge,
+                const RevertableList<CouplingIntegralData> &coupling, const RevertableList<BoundaryIntegralData> &boundary)
+        : bulk_integral_data_(bulk), edge_integral_data_(edge), coupling_integral_data_(coupling), boundary_integral_data_(boundary) {}
+
+        ElementCacheMap::PatchLayout layout_;
+        RevertableList<BulkIntegralData>       bulk_integral_data_;
+        RevertableList<EdgeIntegralData>       edge_integral_data_;
+        RevertableList<CouplingIntegralData>   coupling_integral_data_;
+        RevertableList<BoundaryIntegralData>   boundary_integral_data_;
+    };
+
+    /**
+     * Identification of the DOF handler the patch plans were created for.
+     *
+     * Plans are valid if the same DOF handler with the same mesh and distribution of DOFs and cells is assembled.
+     */
+    struct PatchPlanKey {
+        PatchPlanKey()
+        : dh_(nullptr), mesh_(nullptr), n_global_dofs_(0), lsize_(0), n_own_cells_(0) {}
+
+        PatchPlanKey(std::shared_ptr<DOFHandlerMultiDim> dh)
+        : dh_(dh.get()), mesh_(dh->mesh()), n_global_dofs_(dh->n_global_dofs()), lsize_(dh->lsize()), n_own_cells_(dh->n_own_cells()) {}
+
+        bool operator==(const PatchPlanKey &other) const {
+            return (dh_ != nullptr) && (dh_ == other.dh_) && (mesh_ == other.mesh_) && (n_global_dofs_ == other.n_global_dofs_)
+                    && (lsize_ == other.lsize_) && (n_own_cells_ == other.n_own_cells_);
+        }
+
+        const DOFHandlerMultiDim *dh_;
+        const MeshBase *mesh_;
+        unsigned int n_global_dofs_;
+        unsigned int lsize_;
+        unsigned int n_own_cells_;
+    };
+
+    /// Pass through the local cells, create patches, assemble and store them as patch plans.
+    void create_patches(std::shared_ptr<DOFHandlerMultiDim> dh) {
         bool add_into_patch = false; // control variable
         for(auto cell_it = dh->local_range().begin(); cell_it != dh->local_range().end(); )
         {
@@ -248,22 +324,45 @@ public:
         if (add_into_patch) {
             this->assemble_integrals();
         }
-
-        multidim_assembly_[1_d]->end();
-        END_TIMER( DimAssembly<1>::name() );
-    }
-
-    /// Return ElementCacheMap
-    inline const ElementCacheMap &cache_map() const {
-        return element_cache_map_;
     }
 
-private:
-    /// Call assemblations when patch is filled
+    /// Call assemblations when patch is filled, store the patch as the patch plan.
     void assemble_integrals() {
         START_TIMER("create_patch");
         element_cache_map_.create_patch();
         END_TIMER("create_patch");
+        patch_plans_.emplace_back(bulk_integral_data_, edge_integral_data_, coupling_integral_data_, boundary_integral_data_);
+        element_cache_map_.set_patch_field_values( &patch_plans_.back().layout_.field_values_ );
+        this->assemble_patch(bulk_integral_data_, edge_integral_data_, coupling_integral_data_, boundary_integral_data_);
+
+        element_cache_map_.save_patch_layout(patch_plans_.back().layout_);
+        element_cache_map_.set_patch_field_values(nullptr);
+
+        // clean integral data
+        bulk_integral_data_.reset();
+        edge_integral_data_.reset();
+        coupling_integral_data_.reset();
+        boundary_integral_data_.reset();
+        element_cache_map_.clear_element_eval_points_map();
+    }
+
+    /// Set patch stored in the @p plan and call assemblations.
+    void replay_patch_plan(PatchPlan &plan) {
+        element_cache_map_.start_elements_update();
+        START_TIMER("create_patch");
+        element_cache_map_.restore_patch_layout(plan.layout_);
+        END_TIMER("create_patch");
+        this->assemble_patch(plan.bulk_integral_data_, plan.edge_integral_data_, plan.coupling_integral_data_,
+                plan.boundary_integral_data_);
+        element_cache_map_.release_patch_layout(plan.layout_);
+        element_cache_map_.clear_element_eval_points_map();
+    }
+
+    /// Update field cache of the actual patch and assemble given integrals.
+    void assemble_patch(const RevertableList<BulkIntegralData> &bulk_integral_data,
+            const RevertableList<EdgeIntegralData> &edge_integral_data,
+            const RevertableList<CouplingIntegralData> &coupling_integral_data,
+            const RevertableList<BoundaryIntegralData> &boundary_integral_data) {
         START_TIMER("cache_update");
         multidim_assembly_[1_d]->eq_fields_->cache_update(element_cache_map_); // TODO replace with sub FieldSet
         END_TIMER("cache_update");
@@ -271,40 +370,34 @@ private:
 
         {
             START_TIMER("assemble_volume_integrals");
-            multidim_assembly_[1_d]->assemble_cell_integrals(bulk_integral_data_);
-            multidim_assembly_[2_d]->assemble_cell_integrals(bulk_integral_data_);
-            multidim_assembly_[3_d]->assemble_cell_integrals(bulk_integral_data_);
+            multidim_assembly_[1_d]->assemble_cell_integrals(bulk_integral_data);
+            multidim_assembly_[2_d]->assemble_cell_integrals(bulk_integral_data);
+            multidim_assembly_[3_d]->assemble_cell_integrals(bulk_integral_data);
             END_TIMER("assemble_volume_integrals");
         }
 
         {
             START_TIMER("assemble_fluxes_boundary");
-            multidim_assembly_[1_d]->assemble_boundary_side_integrals(boundary_integral_data_);
-            multidim_assembly_[2_d]->assemble_boundary_side_integrals(boundary_integral_data_);
-            multidim_assembly_[3_d]->assemble_boundary_side_integrals(boundary_integral_data_);
+            multidim_assembly_[1_d]->assemble_boundary_side_integrals(boundary_integral_data);
+            multidim_assembly_[2_d]->assemble_boundary_side_integrals(boundary_integral_data);
+            multidim_assembly_[3_d]->assemble_boundary_side_integrals(boundary_integral_data);
             END_TIMER("assemble_fluxes_boundary");
         }
 
         {
             START_TIMER("assemble_fluxes_elem_elem");
-            multidim_assembly_[1_d]->assemble_edge_integrals(edge_integral_data_);
-            multidim_assembly_[2_d]->assemble_edge_integrals(edge_integral_data_);
-            multidim_assembly_[3_d]->assemble_edge_integrals(edge_integral_data_);
+            multidim_assembly_[1_d]->assemble_edge_integrals(edge_integral_data);
+            multidim_assembly_[2_d]->assemble_edge_integrals(edge_integral_data);
+            multidim_assembly_[3_d]->assemble_edge_integrals(edge_integral_data);
             END_TIMER("assemble_fluxes_elem_elem");
         }
 
         {
             START_TIMER("assemble_fluxes_elem_side");
-            multidim_assembly_[2_d]->assemble_neighbour_integrals(coupling_integral_data_);
-            multidim_assembly_[3_d]->assemble_neighbour_integrals(coupling_integral_data_);
+            multidim_assembly_[2_d]->assemble_neighbour_integrals(coupling_integral_data);
+            multidim_assembly_[3_d]->assemble_neighbour_integrals(coupling_integral_data);
             END_TIMER("assemble_fluxes_elem_side");
         }
-        // clean integral data
-        bulk_integral_data_.reset();
-        edge_integral_data_.reset();
-        coupling_integral_data_.reset();
-        boundary_integral_data_.reset();
-        element_cache_map_.clear_element_eval_points_map();
     }
 
     /**
@@ -428,6 +521,12 @@ private:
     RevertableList<EdgeIntegralData>       edge_integral_data_;      ///< Holds data for computing edge integrals.
     RevertableList<CouplingIntegralData>   coupling_integral_data_;  ///< Holds data for computing couplings integrals.
     RevertableList<BoundaryIntegralData>   boundary_integral_data_;  ///< Holds data for computing boundary integrals.
+
+    /// Patch plans recorded by the first assemble, replayed by following calls.
+    std::deque<PatchPlan> patch_plans_;
+
+    /// Identification of DOF handler of @p patch_plans_.
+    PatchPlanKey plan_key_;
 };
 
 
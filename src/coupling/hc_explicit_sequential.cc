@@ -31,6 +31,8 @@
 #include "fields/field_set.hh"
 #include "mesh/mesh.h"
 #include "io/msh_gmshreader.h"
+#include "io/checkpoint.hh"
+#include "io/output_time.hh"
 #include "system/sys_profiler.hh"
 #include "input/input_type.hh"
 #include "input/accessors.hh"
@@ -71,6 +73,8 @@ const it::Record & HC_ExplicitSequential::get_input_type() {
 				"Transport of soluted substances, depends on the velocity field from a Flow equation.")
 		.declare_key("heat_equation", AdvectionProcessBase::get_input_type(),
 		        "Heat transfer, depends on the velocity field from a Flow equation.")
+		.declare_key("checkpoint", Checkpoint::get_input_type(), it::Default::optional(),
+		        "Binary checkpoints of the simulation state and restart from them.")
 		.close();
 }
 
@@ -158,6 +162,10 @@ HC_ExplicitSequential::HC_ExplicitSequential(Input::Record in_record)
 
     processes_.push_back(AdvectionData(make_advection_process("solute_equation")));
     processes_.push_back(AdvectionData(make_advection_process("heat_equation")));
+
+    Input::Record checkpoint_rec;
+    if (in_record.opt_val("checkpoint", checkpoint_rec))
+        checkpoint_ = std::make_shared<Checkpoint>(checkpoint_rec, water->time());
 }
 
 void HC_ExplicitSequential::advection_process_step(AdvectionData &pdata)
@@ -202,6 +210,81 @@ void HC_ExplicitSequential::flow_step(double requested_time)
     }
 }
 
+void HC_ExplicitSequential::write_checkpoint()
+{
+    if (! checkpoint_) return;
+
+    // the state is consistent when all running equations passed the checkpoint time
+    double solved_time = TimeGovernor::inf_time;
+    if (! water->time().is_end()) solved_time = water->solved_time();
+    for(auto &pdata : processes_)
+        if (! pdata.process->time().is_end())
+            solved_time = min(solved_time, pdata.process->solved_time());
+    if (! checkpoint_->is_checkpoint_time(solved_time)) return;
+
+    CheckpointData data;
+    // observe values buffered up to the checkpoint are written, restart appends the observe files
+    auto streams = output_streams();
+    for(unsigned int i=0; i<streams.size(); ++i) {
+        streams[i]->flush_observe();
+        streams[i]->save_state(data, "output_" + std::to_string(i));
+    }
+    water->save_state(data, "flow");
+    for(unsigned int i=0; i<processes_.size(); ++i) {
+        std::string prefix = "process_" + std::to_string(i);
+        processes_[i].process->save_state(data, prefix);
+        data.save(prefix + "/velocity_time", processes_[i].velocity_time);
+    }
+    data.save("coupling/min_velocity_time", min_velocity_time);
+    checkpoint_->write(data, solved_time);
+}
+
+
+void HC_ExplicitSequential::restart_from_checkpoint()
+{
+    START_TIMER("HC restart");
+    CheckpointData data;
+    checkpoint_->read_restart(data);
+
+    // zero time steps allocate all structures, the state is overwritten by the checkpoint,
+    // the initial state is not written to the output, observe and balance files
+    water->set_zero_step_output(false);
+    water->zero_time_step();
+    for(auto &pdata : processes_) {
+        if (pdata.process->time().is_end()) continue;
+        pdata.process->set_zero_step_output(false);
+        auto& flux = pdata.process->eq_fieldset()["flow_flux"];
+        flux.copy_from(water->eq_fieldset()["flux"]);
+        flux.set_time_result_changed();
+        pdata.process->zero_time_step();
+    }
+
+    water->load_state(data, "flow");
+    for(unsigned int i=0; i<processes_.size(); ++i) {
+        std::string prefix = "process_" + std::to_string(i);
+        processes_[i].process->load_state(data, prefix);
+        data.load(prefix + "/velocity_time", processes_[i].velocity_time);
+        // velocity of the restored flow solution has to be passed to the process
+        processes_[i].velocity_changed = true;
+    }
+    data.load("coupling/min_velocity_time", min_velocity_time);
+
+    auto streams = output_streams();
+    for(unsigned int i=0; i<streams.size(); ++i)
+        streams[i]->load_state(data, "output_" + std::to_string(i));
+}
+
+
+std::vector<std::shared_ptr<OutputTime>> HC_ExplicitSequential::output_streams()
+{
+    std::vector<std::shared_ptr<OutputTime>> streams;
+    water->get_output_streams(streams);
+    for(auto &pdata : processes_)
+        pdata.process->get_output_streams(streams);
+    return streams;
+}
+
+
 /**
  * TODO:
  * - have support for steady problems in TimeGovernor, make Noting problems steady
@@ -222,7 +305,9 @@ void HC_ExplicitSequential::run_simulation()
     // theta = 1.0   velocity from end of transport interval (partialy explicit scheme)
     const double theta=0.5;
 
-    {
+    if (checkpoint_ && checkpoint_->is_restart()) {
+        restart_from_checkpoint();
+    } else {
         START_TIMER("HC water zero time step");
         water->zero_time_step();
         for(auto &process : processes_)
@@ -285,6 +370,8 @@ void HC_ExplicitSequential::run_simulation()
         }
         advection_process_step(processes_[0]); // solute
         advection_process_step(processes_[1]); // heat
+
+        write_checkpoint();
     }
     //MessageOut().fmt("End of simulation at time: {}\n", max(solute->solved_time(), heat->solved_time()));
 }
@@ -30,6 +30,7 @@ class DarcyFlowInterface;
 class Mesh;
 class AdvectionProcessBase;
 class FieldCommon;
+class Checkpoint;
 
 
 /**
@@ -83,6 +84,19 @@ private:
      */
     void flow_step(double requested_time);
 
+    /**
+     * Write the checkpoint if all equations passed the next checkpoint time.
+     */
+    void write_checkpoint();
+
+    /**
+     * Perform zero time steps of all equations and restore their state from the restart checkpoint.
+     */
+    void restart_from_checkpoint();
+
+    /// Return output streams of all equations, the order is the same in every run of the same problem.
+    std::vector<std::shared_ptr<OutputTime>> output_streams();
+
     static const int registrar;
 
     ///
@@ -102,6 +116,9 @@ private:
 
     bool is_end_all_;
 
+    /// Checkpoints of the simulation state, nullptr if checkpoints are not set on input.
+    std::shared_ptr<Checkpoint> checkpoint_;
+
     FieldCommon *water_content_saturated_;
     FieldCommon *water_content_p0_;
 };
@@ -23,6 +23,7 @@
 #include "fields/field_fe.hh"         // for create_field_fe()
 #include "fields/field_model.hh"      // for Model
 #include "assembly_hm.hh"
+#include "io/checkpoint.hh"
 
 
 FLOW123D_FORCE_LINK_IN_CHILD(coupling_iterative)
@@ -306,6 +307,46 @@ void HM_Iterative::zero_time_step()
 }
 
 
+void HM_Iterative::set_zero_step_output(bool output)
+{
+    EquationBase::set_zero_step_output(output);
+    eq_data_->flow_->set_zero_step_output(output);
+    eq_data_->mechanics_->set_zero_step_output(output);
+}
+
+
+void HM_Iterative::save_state(CheckpointData &data, const std::string &prefix)
+{
+    EquationBase::save_state(data, prefix);
+    eq_data_->flow_->save_state(data, prefix + "/flow");
+    eq_data_->mechanics_->save_state(data, prefix + "/mechanics");
+    data.save(prefix + "/old_iter_pressure", eq_fields_->old_iter_pressure_ptr_->vec());
+    data.save(prefix + "/old_div_u", eq_fields_->old_div_u_ptr_->vec());
+}
+
+
+void HM_Iterative::load_state(const CheckpointData &data, const std::string &prefix)
+{
+    EquationBase::load_state(data, prefix);
+    eq_data_->flow_->load_state(data, prefix + "/flow");
+    eq_data_->mechanics_->load_state(data, prefix + "/mechanics");
+    data.load(prefix + "/old_iter_pressure", eq_fields_->old_iter_pressure_ptr_->vec());
+    data.load(prefix + "/old_div_u", eq_fields_->old_div_u_ptr_->vec());
+    eq_fields_->old_iter_pressure.set_time_result_changed();
+    eq_fields_->old_div_u.set_time_result_changed();
+
+    // pressure potential of the restored pressure is passed to the mechanics
+    update_potential();
+}
+
+
+void HM_Iterative::get_output_streams(std::vector<std::shared_ptr<OutputTime>> &streams)
+{
+    eq_data_->flow_->get_output_streams(streams);
+    eq_data_->mechanics_->get_output_streams(streams);
+}
+
+
 void HM_Iterative::update_solution()
 {
     time_->next_time();
@@ -182,6 +182,18 @@ public:
     void update_solution() override;
     ~HM_Iterative();
 
+    /// Pass the setting to the flow and the mechanics.
+    void set_zero_step_output(bool output) override;
+
+    /// Store state of the flow, the mechanics and the coupling terms of the last time step to the checkpoint.
+    void save_state(CheckpointData &data, const std::string &prefix) override;
+
+    /// Restore state stored by @p save_state and update the coupling fields.
+    void load_state(const CheckpointData &data, const std::string &prefix) override;
+
+    /// Add output streams of the flow and the mechanics.
+    void get_output_streams(std::vector<std::shared_ptr<OutputTime>> &streams) override;
+
 private:
     
     void update_potential();
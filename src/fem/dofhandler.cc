@@ -28,6 +28,12 @@
 #include "mesh/range_wrapper.hh"
 #include "mesh/neighbours.h"
 #include "la/distribution.hh"
+#include "mesh/bounding_box.hh"
+#include "system/sys_profiler.hh"
+#include "input/input_type.hh"
+#include <algorithm>
+#include <numeric>
+#include <limits>
 
 
 const int DOFHandlerMultiDim::INVALID_NFACE  = 1;
@@ -36,6 +42,27 @@ const int DOFHandlerMultiDim::ASSIGNED_NFACE = 3;
 const int DOFHandlerMultiDim::INVALID_DOF   = -1;
 
 
+namespace {
+
+/// Key of the point along Z-order (Morton) curve, coordinates are normalized by the bounding box.
+uint64_t zorder_key(const BoundingBox &box, const arma::vec3 &point)
+{
+    const unsigned int n_bits = 21;
+    double size = std::max(box.longest_size(), std::numeric_limits<double>::min());
+    uint64_t key = 0;
+    for (unsigned int d=0; d<3; d++)
+    {
+        double x = std::min( std::max( (point(d) - box.min()(d)) / size, 0.0), 1.0);
+        uint64_t coord = static_cast<uint64_t>( x * ((1 << n_bits) - 1) );
+        for (unsigned int b=0; b<n_bits; b++)
+            key |= ((coord >> b) & 1ull) << (3*b + d);
+    }
+    return key;
+}
+
+} // namespace
+
+
 
 
 DOFHandlerBase::~DOFHandlerBase()
@@ -46,13 +73,26 @@ DOFHandlerBase::~DOFHandlerBase()
 
 
 
+const Input::Type::Selection & DOFHandlerMultiDim::get_renumbering_selection() {
+	return Input::Type::Selection("DOF_Renumbering", "Renumbering of degrees of freedom owned by the processor.")
+		.add_value((int)Renumbering::none, "none", "Dofs numbered in traversal order of local cells.")
+		.add_value((int)Renumbering::rcm, "rcm", "Reverse Cuthill-McKee ordering of the graph of dofs sharing a cell.")
+		.add_value((int)Renumbering::sfc, "sfc", "Order of nodes, sides and cells owning the dofs along the Z-order space filling curve.")
+		.add_value((int)Renumbering::cell_block, "cell_block",
+		        "Dofs of a cell numbered contiguously, cells in order of the space filling curve (suitable for DG).")
+		.close();
+}
+
+
 DOFHandlerMultiDim::DOFHandlerMultiDim(MeshBase& _mesh, bool make_elem_part)
 	: DOFHandlerBase(_mesh),
 	  ds_(nullptr),
 	  is_parallel_(true),
 	  dh_seq_(nullptr),
 	  scatter_to_seq_(nullptr),
-	  el_ds_(nullptr)
+	  el_ds_(nullptr),
+	  ghost_comm_(MPI_COMM_NULL),
+	  renumbering_(Renumbering::none)
 {
     // Set up flag that ensures that edges are allocated, so that dofs can be distributed on edges.
     // Currently this works only for Mesh objects, not for BCMesh.
@@ -175,67 +215,93 @@ void DOFHandlerMultiDim::init_status(
 }
 
 
-void DOFHandlerMultiDim::receive_ghost_dofs(unsigned int proc, vector<LongIdx> &dofs)
+void DOFHandlerMultiDim::create_ghost_comm()
 {
-    // send number of elements required from the other processor
-    unsigned int n_elems = ghost_proc_el[proc].size();
-    MPI_Send(&n_elems, 1, MPI_UNSIGNED, proc, 0, MPI_COMM_WORLD);
-    
-    // send indices of elements required
-    MPI_Send(&(ghost_proc_el[proc][0]), n_elems, MPI_LONG_IDX, proc, 1, MPI_COMM_WORLD);
-    
-    // receive numbers of dofs on required elements
-    vector<unsigned int> n_dofs(n_elems);
-    MPI_Recv(&(n_dofs[0]), n_elems, MPI_UNSIGNED, proc, 2, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-    
-    // receive dofs on required elements
-    unsigned int n_dofs_sum = 0;
-    for (auto nd : n_dofs) n_dofs_sum += nd;
-    dofs.resize(n_dofs_sum);
-    MPI_Recv(&(dofs[0]), n_dofs_sum, MPI_LONG_IDX, proc, 3, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    if (ghost_comm_ != MPI_COMM_NULL) return;
+
+    // neighbourhood is symmetric, sources and destinations are the same processors
+    vector<int> neighbours(ghost_proc.begin(), ghost_proc.end());
+    MPI_Dist_graph_create_adjacent(MPI_COMM_WORLD,
+            neighbours.size(), neighbours.data(), MPI_UNWEIGHTED,
+            neighbours.size(), neighbours.data(), MPI_UNWEIGHTED,
+            MPI_INFO_NULL, 0, &ghost_comm_);
 }
 
 
-void DOFHandlerMultiDim::send_ghost_dofs(unsigned int proc)
+void DOFHandlerMultiDim::exchange_ghost_data(const map<unsigned int, vector<LongIdx> > &send_data,
+                                             map<unsigned int, vector<LongIdx> > &recv_data)
 {
-    // receive number of elements required by the other processor
-    unsigned int n_elems;
-    MPI_Recv(&n_elems, 1, MPI_UNSIGNED, proc, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-    
-    // receive indices of elements required
-    vector<LongIdx> elems(n_elems);
-    MPI_Recv(&(elems[0]), n_elems, MPI_LONG_IDX, proc, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-    
-    // send numbers of dofs on required elements
-    vector<unsigned int> n_dofs;
-    for (LongIdx el : elems)
+    ASSERT(ghost_comm_ != MPI_COMM_NULL).error("Communicator of neighbouring processors is not created.");
+
+    // neighbours are ordered in the same way as in create_ghost_comm()
+    unsigned int n_neighbours = ghost_proc.size();
+    vector<int> send_counts(n_neighbours, 0), recv_counts(n_neighbours, 0);
+    vector<int> send_displs(n_neighbours, 0), recv_displs(n_neighbours, 0);
+    vector<LongIdx> send_buffer;
+    unsigned int i_nb = 0;
+    for (unsigned int proc : ghost_proc)
     {
-        auto cell = this->cell_accessor_from_element(el);
-        n_dofs.push_back(cell_starts[cell.local_idx()+1] - cell_starts[cell.local_idx()]);
+        auto it = send_data.find(proc);
+        send_displs[i_nb] = send_buffer.size();
+        if (it != send_data.end())
+            send_buffer.insert(send_buffer.end(), it->second.begin(), it->second.end());
+        send_counts[i_nb] = send_buffer.size() - send_displs[i_nb];
+        i_nb++;
     }
-    MPI_Send(&(n_dofs[0]), n_elems, MPI_UNSIGNED, proc, 2, MPI_COMM_WORLD);
-    
-    // send dofs on the required elements
-    vector<LongIdx> dofs;
+
+    // sizes of messages
+    MPI_Request request;
+    MPI_Ineighbor_alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, ghost_comm_, &request);
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+    unsigned int recv_size = 0;
+    for (i_nb=0; i_nb<n_neighbours; i_nb++)
+    {
+        recv_displs[i_nb] = recv_size;
+        recv_size += recv_counts[i_nb];
+    }
+
+    // data
+    vector<LongIdx> recv_buffer(recv_size);
+    MPI_Ineighbor_alltoallv(send_buffer.data(), send_counts.data(), send_displs.data(), MPI_LONG_IDX,
+                            recv_buffer.data(), recv_counts.data(), recv_displs.data(), MPI_LONG_IDX,
+                            ghost_comm_, &request);
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+    recv_data.clear();
+    i_nb = 0;
+    for (unsigned int proc : ghost_proc)
+    {
+        recv_data[proc].assign(recv_buffer.begin() + recv_displs[i_nb],
+                               recv_buffer.begin() + recv_displs[i_nb] + recv_counts[i_nb]);
+        i_nb++;
+    }
+}
+
+
+void DOFHandlerMultiDim::get_cell_global_dofs(const vector<LongIdx> &elems, vector<LongIdx> &dofs) const
+{
+    dofs.clear();
     for (LongIdx el : elems)
     {
         auto cell = this->cell_accessor_from_element(el);
         for (LongIdx i=cell_starts[cell.local_idx()]; i<cell_starts[cell.local_idx()+1]; i++)
-            dofs.push_back(local_to_global_dof_idx_[dof_indices[i]]);
+            if (dof_indices[i] == INVALID_DOF)
+                dofs.push_back(INVALID_DOF);
+            else
+                dofs.push_back(local_to_global_dof_idx_[dof_indices[i]]);
     }
-    MPI_Send(&(dofs[0]), dofs.size(), MPI_LONG_IDX, proc, 3, MPI_COMM_WORLD);
 }
 
 
-void DOFHandlerMultiDim::update_local_dofs(unsigned int proc,
-                                           const std::vector<bool> &update_cells,
-                                           const std::vector<LongIdx> &dofs, 
+void DOFHandlerMultiDim::update_ghost_dofs(unsigned int proc,
+                                           const std::vector<LongIdx> &dofs,
                                            const std::vector<LongIdx> &node_dof_starts,
                                            std::vector<LongIdx> &node_dofs,
                                            const std::vector<LongIdx> &edge_dof_starts,
-                                           std::vector<LongIdx> &edge_dofs)
+                                           std::vector<LongIdx> &edge_dofs,
+                                           bool update_ghost_cells)
 {
-    // update dof_indices on ghost cells
     unsigned int dof_offset=0;
     for (unsigned int gid=0; gid<ghost_proc_el[proc].size(); gid++)
     {
@@ -251,12 +317,13 @@ void DOFHandlerMultiDim::update_local_dofs(unsigned int proc,
                 unsigned int nid = mesh_->duplicate_nodes()->objects(dh_cell.dim())[mesh_->duplicate_nodes()->obj_4_el()[dh_cell.elm_idx()]].nodes[dof_nface_idx];
                 unsigned int node_dof_idx = node_dof_starts[nid]+loc_node_dof_count[dof_nface_idx];
                     
-                if (node_dofs[node_dof_idx] == INVALID_DOF)
+                if (node_dofs[node_dof_idx] == INVALID_DOF && dofs[dof_offset+idof] != INVALID_DOF)
                 {
                     node_dofs[node_dof_idx] = local_to_global_dof_idx_.size();
                     local_to_global_dof_idx_.push_back(dofs[dof_offset+idof]);
                 }
-                dof_indices[cell_starts[dh_cell.local_idx()]+idof] = node_dofs[node_dof_idx];
+                if (update_ghost_cells)
+                    dof_indices[cell_starts[dh_cell.local_idx()]+idof] = node_dofs[node_dof_idx];
                 
                 loc_node_dof_count[dof_nface_idx]++;
             }
@@ -268,15 +335,16 @@ void DOFHandlerMultiDim::update_local_dofs(unsigned int proc,
                 unsigned int eid = dh_cell.elm().side(dof_nface_idx)->edge_idx();
                 unsigned int edge_dof_idx = edge_dof_starts[eid]+loc_edge_dof_count[dof_nface_idx];
                     
-                if (edge_dofs[edge_dof_idx] == INVALID_DOF)
+                if (edge_dofs[edge_dof_idx] == INVALID_DOF && dofs[dof_offset+idof] != INVALID_DOF)
                 {
                     edge_dofs[edge_dof_idx] = local_to_global_dof_idx_.size();
                     local_to_global_dof_idx_.push_back(dofs[dof_offset+idof]);
                 }
-                dof_indices[cell_starts[dh_cell.local_idx()]+idof] = edge_dofs[edge_dof_idx];
+                if (update_ghost_cells)
+                    dof_indices[cell_starts[dh_cell.local_idx()]+idof] = edge_dofs[edge_dof_idx];
                 
                 loc_edge_dof_count[dof_nface_idx]++;
-            } else if (dh_cell.cell_dof(idof).dim == dh_cell.dim())
+            } else if (dh_cell.cell_dof(idof).dim == dh_cell.dim() && update_ghost_cells)
             {
                 dof_indices[cell_starts[dh_cell.local_idx()]+idof] = local_to_global_dof_idx_.size();
                 local_to_global_dof_idx_.push_back(dofs[dof_offset+idof]);
@@ -285,7 +353,15 @@ void DOFHandlerMultiDim::update_local_dofs(unsigned int proc,
         
         dof_offset += dh_cell.n_dofs();
     }
-    
+}
+
+
+void DOFHandlerMultiDim::update_local_dofs(const std::vector<bool> &update_cells,
+                                           const std::vector<LongIdx> &node_dof_starts,
+                                           const std::vector<LongIdx> &node_dofs,
+                                           const std::vector<LongIdx> &edge_dof_starts,
+                                           const std::vector<LongIdx> &edge_dofs)
+{
     // update dof_indices on local elements
     for (auto cell : this->own_range())
     {
@@ -414,6 +490,8 @@ void DOFHandlerMultiDim::distribute_dofs(std::shared_ptr<DiscreteSpace> ds)
     edge_status.clear();
     
     lsize_ = next_free_dof;
+    if (renumbering_ != Renumbering::none)
+        renumber_owned_dofs(lsize_, node_dofs, edge_dofs);
 
     // communicate n_dofs across all processes
     dof_ds_ = std::make_shared<Distribution>(lsize_, PETSC_COMM_WORLD);
@@ -428,30 +506,34 @@ void DOFHandlerMultiDim::distribute_dofs(std::shared_ptr<DiscreteSpace> ds)
     }
     
     // communicate dofs from ghost cells
-    // first propagate from lower procs to higher procs and then vice versa
-    for (unsigned int from_higher = 0; from_higher < 2; from_higher++)
+    // Nodes and edges are owned by the lowest processor having them on local element, so the owner is always
+    // a neighbour. In the first exchange every processor sends the dofs it owns, which resolves all dofs
+    // on local elements. In the second exchange the dofs on ghost elements are complete.
+    create_ghost_comm();
+    map<unsigned int, vector<LongIdx> > required_elems, send_dofs, recv_dofs;
+    exchange_ghost_data(ghost_proc_el, required_elems);
+    for (unsigned int i_exchange = 0; i_exchange < 2; i_exchange++)
     {
         for (unsigned int proc : ghost_proc)
-        {
-            if ((proc > el_ds_->myp()) == from_higher)
-            { // receive dofs from master processor
-                vector<LongIdx> dofs;
-                receive_ghost_dofs(proc, dofs);
-                
-                // update dof_indices and node_dofs on ghost elements
-                update_local_dofs(proc,
-                                  update_cells,
-                                  dofs,
-                                  node_dof_starts,
-                                  node_dofs,
-                                  edge_dof_starts,
-                                  edge_dofs
-                                 );
-                
-            }
-            else
-                send_ghost_dofs(proc);
-        }
+            get_cell_global_dofs(required_elems[proc], send_dofs[proc]);
+        exchange_ghost_data(send_dofs, recv_dofs);
+
+        for (unsigned int proc : ghost_proc)
+            update_ghost_dofs(proc,
+                              recv_dofs[proc],
+                              node_dof_starts,
+                              node_dofs,
+                              edge_dof_starts,
+                              edge_dofs,
+                              i_exchange == 1
+                             );
+        if (i_exchange == 0)
+            update_local_dofs(update_cells,
+                              node_dof_starts,
+                              node_dofs,
+                              edge_dof_starts,
+                              edge_dofs
+                             );
     }
     update_cells.clear();
     node_dofs.clear();
@@ -461,6 +543,140 @@ void DOFHandlerMultiDim::distribute_dofs(std::shared_ptr<DiscreteSpace> ds)
 }
 
 
+void DOFHandlerMultiDim::renumber_owned_dofs(unsigned int n_owned,
+                                             std::vector<LongIdx> &node_dofs,
+                                             std::vector<LongIdx> &edge_dofs)
+{
+    if (n_owned == 0) return;
+    START_TIMER("renumber_owned_dofs");
+    // new_idx[old local index] = new local index
+    vector<LongIdx> new_idx(n_owned, INVALID_DOF);
+    LongIdx next_idx = 0;
+
+    switch (renumbering_)
+    {
+    case Renumbering::rcm:
+    {
+        // graph of owned dofs, two dofs are connected if they share a local cell
+        vector<vector<LongIdx> > adjacency(n_owned);
+        for (auto cell : this->own_range())
+        {
+            LocDofVec loc_dofs = cell.get_loc_dof_indices();
+            for (unsigned int i=0; i<loc_dofs.n_elem; i++)
+            {
+                if (loc_dofs[i] == INVALID_DOF || loc_dofs[i] >= (LongIdx)n_owned) continue;
+                for (unsigned int j=0; j<loc_dofs.n_elem; j++)
+                    if (i != j && loc_dofs[j] != INVALID_DOF && loc_dofs[j] < (LongIdx)n_owned)
+                        adjacency[loc_dofs[i]].push_back(loc_dofs[j]);
+            }
+        }
+        for (auto &adj : adjacency)
+        {
+            std::sort(adj.begin(), adj.end());
+            adj.erase(std::unique(adj.begin(), adj.end()), adj.end());
+        }
+
+        // Cuthill-McKee ordering, every connected component starts from a vertex of minimal degree
+        vector<LongIdx> by_degree(n_owned), order;
+        order.reserve(n_owned);
+        std::iota(by_degree.begin(), by_degree.end(), 0);
+        std::stable_sort(by_degree.begin(), by_degree.end(),
+                [&adjacency](LongIdx a, LongIdx b) { return adjacency[a].size() < adjacency[b].size(); });
+        vector<bool> visited(n_owned, false);
+        for (LongIdx start : by_degree)
+        {
+            if (visited[start]) continue;
+            visited[start] = true;
+            order.push_back(start);
+            for (unsigned int i_queue = order.size()-1; i_queue < order.size(); i_queue++)
+            {
+                vector<LongIdx> next;
+                for (LongIdx nb : adjacency[order[i_queue]])
+                    if (!visited[nb])
+                    {
+                        visited[nb] = true;
+                        next.push_back(nb);
+                    }
+                std::stable_sort(next.begin(), next.end(),
+                        [&adjacency](LongIdx a, LongIdx b) { return adjacency[a].size() < adjacency[b].size(); });
+                order.insert(order.end(), next.begin(), next.end());
+            }
+        }
+        // reverse
+        for (auto it = order.rbegin(); it != order.rend(); ++it)
+            new_idx[*it] = next_idx++;
+        break;
+    }
+    case Renumbering::sfc:
+    case Renumbering::cell_block:
+    {
+        // bounding box of local cells
+        BoundingBox box( *mesh_->element_accessor( mesh_->get_el_4_loc()[0] ).node(0) );
+        for (auto cell : this->own_range())
+            for (unsigned int n=0; n<cell.elm()->n_nodes(); n++)
+                box.expand( *cell.elm().node(n) );
+
+        if (renumbering_ == Renumbering::cell_block)
+        {
+            vector<std::pair<uint64_t, unsigned int> > cell_keys;
+            for (auto cell : this->own_range())
+                cell_keys.push_back( std::make_pair(zorder_key(box, cell.elm().centre()), cell.local_idx()) );
+            std::sort(cell_keys.begin(), cell_keys.end());
+            for (auto &cell_key : cell_keys)
+            {
+                LocDofVec loc_dofs = this->get_loc_dof_indices(cell_key.second);
+                for (unsigned int i=0; i<loc_dofs.n_elem; i++)
+                    if (loc_dofs[i] != INVALID_DOF && loc_dofs[i] < (LongIdx)n_owned && new_idx[loc_dofs[i]] == INVALID_DOF)
+                        new_idx[loc_dofs[i]] = next_idx++;
+            }
+        }
+        else
+        {
+            // key of every dof given by position of its entity (node, side or cell)
+            vector<std::pair<uint64_t, LongIdx> > dof_keys;
+            vector<bool> has_key(n_owned, false);
+            for (auto cell : this->own_range())
+            {
+                LocDofVec loc_dofs = cell.get_loc_dof_indices();
+                for (unsigned int idof=0; idof<loc_dofs.n_elem; idof++)
+                {
+                    if (loc_dofs[idof] == INVALID_DOF || loc_dofs[idof] >= (LongIdx)n_owned || has_key[loc_dofs[idof]]) continue;
+                    unsigned int dof_dim = cell.cell_dof(idof).dim;
+                    unsigned int dof_nface_idx = cell.cell_dof(idof).n_face_idx;
+                    arma::vec3 point;
+                    if (dof_dim == 0)
+                        point = *cell.elm().node(dof_nface_idx);
+                    else if (dof_dim == cell.dim()-1)
+                        point = cell.elm().side(dof_nface_idx)->centre();
+                    else
+                        point = cell.elm().centre();
+                    dof_keys.push_back( std::make_pair(zorder_key(box, point), loc_dofs[idof]) );
+                    has_key[loc_dofs[idof]] = true;
+                }
+            }
+            std::sort(dof_keys.begin(), dof_keys.end());
+            for (auto &dof_key : dof_keys)
+                new_idx[dof_key.second] = next_idx++;
+        }
+        break;
+    }
+    default:
+        return;
+    }
+    ASSERT_EQ(next_idx, (LongIdx)n_owned).error("Renumbering does not cover all owned dofs.");
+
+    // apply permutation, local_to_global_dof_idx_ of owned dofs is identity
+    for (auto cell : this->own_range())
+        for (LongIdx i=cell_starts[cell.local_idx()]; i<cell_starts[cell.local_idx()+1]; i++)
+            if (dof_indices[i] != INVALID_DOF && dof_indices[i] < (LongIdx)n_owned)
+                dof_indices[i] = new_idx[dof_indices[i]];
+    for (auto &dof : node_dofs)
+        if (dof != INVALID_DOF) dof = new_idx[dof];
+    for (auto &dof : edge_dofs)
+        if (dof != INVALID_DOF) dof = new_idx[dof];
+}
+
+
 void DOFHandlerMultiDim::create_sequential()
 {
   if (dh_seq_ != nullptr) return;
@@ -577,7 +793,11 @@ unsigned int DOFHandlerMultiDim::get_dof_indices(const DHCellAccessor &cell, std
 
 
 DOFHandlerMultiDim::~DOFHandlerMultiDim()
-{}
+{
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (ghost_comm_ != MPI_COMM_NULL && !finalized) MPI_Comm_free(&ghost_comm_);
+}
 
 
 
@@ -861,67 +1081,52 @@ SubDOFHandlerMultiDim::SubDOFHandlerMultiDim(std::shared_ptr<DOFHandlerMultiDim>
             local_to_global_dof_idx_[i] += loffset_;
     
     // communicate ghost values
-    // first propagate from lower procs to higher procs and then vice versa
-    for (unsigned int from_higher = 0; from_higher < 2; from_higher++)
+    // Ghost dofs owned by a neighbouring processor are obtained directly from the owner. Remaining ghost dofs
+    // lie only on ghost elements, they are obtained from the processor of the element in the second exchange,
+    // when it knows all dofs on its local elements.
+    const unsigned int undef_proc = el_ds_->np();
+    vector<unsigned int> owner_proc(ghost_dof_proc.size(), undef_proc);
+    for (unsigned int i=lsize_; i<local_to_global_dof_idx_.size(); i++)
     {
-        for (unsigned int proc : ghost_proc)
+        unsigned int owner = parent_->dof_ds_->get_proc( parent_->local_to_global_dof_idx_[parent_dof_idx_[i]] );
+        if (ghost_proc.find(owner) != ghost_proc.end())
         {
-            if ((proc > el_ds_->myp()) == from_higher)
-            { // receive dofs from master processor
-                receive_sub_ghost_dofs(proc, ghost_dof_proc, global_to_local_dof_idx);
-            }
-            else
-                send_sub_ghost_dofs(proc, global_to_local_dof_idx);
+            owner_proc[i-lsize_] = owner;
+            ghost_dof_proc[i-lsize_] = undef_proc;
         }
     }
+    create_ghost_comm();
+    update_sub_ghost_dofs(owner_proc, global_to_local_dof_idx);
+    update_sub_ghost_dofs(ghost_dof_proc, global_to_local_dof_idx);
 }
 
 
-void SubDOFHandlerMultiDim::receive_sub_ghost_dofs(unsigned int proc, vector<unsigned int> &ghost_dof_proc, map<LongIdx,LongIdx> &global_to_local_dof_idx)
+void SubDOFHandlerMultiDim::update_sub_ghost_dofs(const vector<unsigned int> &ghost_dof_proc, map<LongIdx,LongIdx> &global_to_local_dof_idx)
 {
-    // send number of ghost dofs required from the other processor
-    vector<LongIdx> dof_indices;
-    vector<LongIdx> dofs;
+    // global dof indices of parent handler required from neighbouring processors
+    map<unsigned int, vector<LongIdx> > required_dofs, requested_dofs;
     for (unsigned int i=lsize_; i<local_to_global_dof_idx_.size(); i++)
-        if (ghost_dof_proc[i-lsize_] == proc)
-            dof_indices.push_back(parent_->local_to_global_dof_idx_[parent_dof_idx_[i]]);
-    unsigned int n_ghosts = dof_indices.size();
-    MPI_Send(&n_ghosts, 1, MPI_UNSIGNED, proc, 0, MPI_COMM_WORLD);
+        if (ghost_dof_proc[i-lsize_] != el_ds_->np())
+            required_dofs[ghost_dof_proc[i-lsize_]].push_back(parent_->local_to_global_dof_idx_[parent_dof_idx_[i]]);
+    exchange_ghost_data(required_dofs, requested_dofs);
     
-    // send indices of dofs required
-    MPI_Send(dof_indices.data(), n_ghosts, MPI_LONG_IDX, proc, 1, MPI_COMM_WORLD);
-    
-    // receive dofs
-    dofs.resize(n_ghosts);
-    MPI_Recv(dofs.data(), n_ghosts, MPI_LONG_IDX, proc, 2, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    // send global dof indices relative to the sub-handler
+    map<unsigned int, vector<LongIdx> > send_dofs, recv_dofs;
+    for (auto &proc_dofs : requested_dofs)
+        for (auto global_dof : proc_dofs.second)
+            send_dofs[proc_dofs.first].push_back(global_to_local_dof_idx.at(global_dof) + dof_ds_->begin());
+    exchange_ghost_data(send_dofs, recv_dofs);
     
     // update ghost dofs
-    unsigned int idof = 0;
+    map<unsigned int, unsigned int> idof;
     for (unsigned int i=lsize_; i<local_to_global_dof_idx_.size(); i++)
-        if (ghost_dof_proc[i-lsize_] == proc)
-        {
-            local_to_global_dof_idx_[i] = dofs[idof];
-            global_to_local_dof_idx[parent_->local_to_global_dof_idx_[parent_dof_idx_[i]]] = dofs[idof] - loffset_;
-            idof++;
-        }
-}
-
-
-void SubDOFHandlerMultiDim::send_sub_ghost_dofs(unsigned int proc, const map<LongIdx,LongIdx> &global_to_local_dof_idx)
-{
-    // receive number of dofs required by the other processor
-    unsigned int n_ghosts;
-    MPI_Recv(&n_ghosts, 1, MPI_UNSIGNED, proc, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-    
-    // receive global indices of dofs required
-    vector<LongIdx> dof_indices(n_ghosts);
-    MPI_Recv(dof_indices.data(), n_ghosts, MPI_LONG_IDX, proc, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-    
-    // send global dof indices relative to the sub-handler
-    vector<LongIdx> dofs;
-    for (auto global_dof : dof_indices)
-        dofs.push_back(global_to_local_dof_idx.at(global_dof) + dof_ds_->begin());
-    MPI_Send(dofs.data(), dofs.size(), MPI_LONG_IDX, proc, 2, MPI_COMM_WORLD);
+    {
+        unsigned int proc = ghost_dof_proc[i-lsize_];
+        if (proc == el_ds_->np()) continue;
+        LongIdx dof = recv_dofs[proc][idof[proc]++];
+        local_to_global_dof_idx_[i] = dof;
+        global_to_local_dof_idx[parent_->local_to_global_dof_idx_[parent_dof_idx_[i]]] = dof - loffset_;
+    }
 }
 
 
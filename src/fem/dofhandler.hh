@@ -36,6 +36,11 @@ class DHCellAccessor;
 class Mesh;
 class Distribution;
 class Dof;
+namespace Input {
+	namespace Type {
+		class Selection;
+	}
+}
 
 
 /**
@@ -151,6 +156,22 @@ protected:
 class DOFHandlerMultiDim : public DOFHandlerBase {
 public:
 
+    /**
+     * Strategies of renumbering of dofs owned by the processor, applied in distribute_dofs().
+     *
+     * Renumbering changes only the order of owned dofs inside the processor, the distribution
+     * of dofs among processors is not affected.
+     */
+    enum class Renumbering {
+        none,        ///< dofs numbered in traversal order of local cells
+        rcm,         ///< reverse Cuthill-McKee ordering of the graph of dofs sharing a cell
+        sfc,         ///< order of owning entities (node, side, cell) along Z-order space filling curve
+        cell_block   ///< dofs of a cell numbered contiguously, cells in order of space filling curve (suitable for DG)
+    };
+
+    /// Input selection of Renumbering, used by equations in key 'dof_renumbering'.
+    static const Input::Type::Selection & get_renumbering_selection();
+
     /**
      * @brief Constructor.
      * @param _mesh The mesh.
@@ -173,6 +194,19 @@ public:
      */
     void distribute_dofs(std::shared_ptr<DiscreteSpace> ds);
 
+    /**
+     * @brief Set strategy of renumbering of owned dofs, has to be called before distribute_dofs().
+     */
+    inline void set_renumbering(Renumbering renumbering)
+    {
+        ASSERT(ds_ == nullptr).error("Renumbering has to be set before dofs are distributed.");
+        renumbering_ = renumbering;
+    }
+
+    /// Return strategy of renumbering of owned dofs.
+    inline Renumbering renumbering() const
+    { return renumbering_; }
+
     /** @brief Returns sequential version of the current dof handler.
      * 
      * Collective on all processors.
@@ -312,39 +346,85 @@ protected:
                      std::vector<short int> &edge_status);
     
     /**
-     * @brief Obtain dof numbers on ghost elements from other processor.
-     * @param proc  Neighbouring processor.
-     * @param dofs  Array where dofs are stored (output).
+     * @brief Create distributed graph communicator of neighbouring processors @p ghost_proc.
+     *
+     * Collective on all processors. Neighbourhood is symmetric, every processor is source
+     * and destination of its neighbours.
      */
-    void receive_ghost_dofs(unsigned int proc,
-                            std::vector<LongIdx> &dofs);
+    void create_ghost_comm();
 
     /**
-     * @brief Send dof numbers to other processor.
-     * @param proc  Neighbouring processor.
-     */    
-    void send_ghost_dofs(unsigned int proc);
-    
+     * @brief Exchange data with all neighbouring processors at once.
+     *
+     * Uses nonblocking neighbourhood collectives on the communicator created by create_ghost_comm().
+     * Collective on all processors.
+     *
+     * @param send_data Data sent to neighbouring processors, missing processor means empty message.
+     * @param recv_data Data received from all neighbouring processors (output).
+     */
+    void exchange_ghost_data(const map<unsigned int, vector<LongIdx> > &send_data,
+                             map<unsigned int, vector<LongIdx> > &recv_data);
+
+    /**
+     * @brief Get global dof numbers on given local elements.
+     *
+     * @param elems  Global indices of local elements.
+     * @param dofs   Global dof numbers, dofs not resolved yet are INVALID_DOF (output).
+     */
+    void get_cell_global_dofs(const vector<LongIdx> &elems,
+                              vector<LongIdx> &dofs) const;
+
     /** 
-     * @brief Update dofs on local elements from ghost element dofs.
+     * @brief Update nodal and edge dofs from ghost element dofs.
      * 
-     * @param proc            Neighbouring processor.
-     * @param update_cells    Vector of global indices of elements which need to be updated
+     * @param proc               Neighbouring processor.
+     * @param dofs               Vector of dof indices on ghost elements from processor @p proc,
+     *                           INVALID_DOF values are skipped.
+     * @param node_dof_starts    Vector of starting indices of nodal dofs.
+     * @param node_dofs          Vector of nodal dof indices (output).
+     * @param edge_dof_starts    Vector of starting indices of edge dofs.
+     * @param edge_dofs          Vector of edge dof indices (output).
+     * @param update_ghost_cells If true, dof_indices of ghost elements are set as well.
+     */
+    void update_ghost_dofs(unsigned int proc,
+                           const std::vector<LongIdx> &dofs,
+                           const std::vector<LongIdx> &node_dof_starts,
+                           std::vector<LongIdx> &node_dofs,
+                           const std::vector<LongIdx> &edge_dof_starts,
+                           std::vector<LongIdx> &edge_dofs,
+                           bool update_ghost_cells);
+
+    /** 
+     * @brief Update dofs on local elements from resolved nodal and edge dofs.
+     * 
+     * @param update_cells    Vector of flags of local elements which need to be updated
      *                        from ghost elements.
-     * @param dofs            Vector of dof indices on ghost elements from processor @p proc.
      * @param node_dof_starts Vector of starting indices of nodal dofs.
-     * @param node_dofs       Vector of nodal dof indices (output).
+     * @param node_dofs       Vector of nodal dof indices.
      * @param edge_dof_starts Vector of starting indices of edge dofs.
-     * @param edge_dofs       Vector of edge dof indices (output).
+     * @param edge_dofs       Vector of edge dof indices.
      */
-    void update_local_dofs(unsigned int proc,
-                           const std::vector<bool> &update_cells,
-                           const std::vector<LongIdx> &dofs,
+    void update_local_dofs(const std::vector<bool> &update_cells,
                            const std::vector<LongIdx> &node_dof_starts,
-                           std::vector<LongIdx> &node_dofs,
+                           const std::vector<LongIdx> &node_dofs,
                            const std::vector<LongIdx> &edge_dof_starts,
-                           std::vector<LongIdx> &edge_dofs);
+                           const std::vector<LongIdx> &edge_dofs);
     
+    /**
+     * @brief Renumber dofs owned by the processor according to @p renumbering_.
+     *
+     * Called after dofs on local cells are distributed and before the ghost dofs are communicated,
+     * when owned dofs have local indices 0..@p n_owned-1 equal to their position in the local part
+     * of parallel vectors.
+     *
+     * @param n_owned   Number of owned dofs.
+     * @param node_dofs Vector of nodal dof indices (updated).
+     * @param edge_dofs Vector of edge dof indices (updated).
+     */
+    void renumber_owned_dofs(unsigned int n_owned,
+                             std::vector<LongIdx> &node_dofs,
+                             std::vector<LongIdx> &edge_dofs);
+
     /**
      * @brief Communicate local dof indices to all processors and create new sequential dof handler.
      *
@@ -435,7 +515,7 @@ protected:
      * @brief Maps local and ghost dof indices to global ones.
      * 
      * First lsize_ entries correspond to dofs owned by local processor,
-     * the remaining entries are ghost dofs sorted by neighbouring processor id.
+     * the remaining entries are ghost dofs.
      */
     std::vector<LongIdx> local_to_global_dof_idx_;
     
@@ -462,6 +542,12 @@ protected:
     /// Arrays of ghost cells for each neighbouring processor.
     map<unsigned int, vector<LongIdx> > ghost_proc_el;
 
+    /// Distributed graph communicator of neighbouring processors (see create_ghost_comm()).
+    MPI_Comm ghost_comm_;
+
+    /// Strategy of renumbering of owned dofs.
+    Renumbering renumbering_;
+
     /// Temporary flag which prevents using dof handler on meshes where edges are not allocated (currently BCMesh).
     bool distribute_edge_dofs;
 
@@ -501,11 +587,13 @@ public:
     
 private:
 
-    /// Get global dof indices of ghost dofs for sub-handler.
-    void receive_sub_ghost_dofs(unsigned int proc, vector<unsigned int> &ghost_dof_proc, map<LongIdx,LongIdx> &global_to_local_dof_idx);
-    
-    /// Send global indices of dofs that are ghost on other processors.
-    void send_sub_ghost_dofs(unsigned int proc, const map<LongIdx,LongIdx> &global_to_local_dof_idx);
+    /**
+     * Get global dof indices of ghost dofs for sub-handler by single exchange with neighbouring processors.
+     *
+     * @param ghost_dof_proc          Processor asked for each ghost dof, ghost dofs with value @p undef_proc are skipped.
+     * @param global_to_local_dof_idx Maps global dof indices of parent handler to local (or shifted ghost) indices.
+     */
+    void update_sub_ghost_dofs(const vector<unsigned int> &ghost_dof_proc, map<LongIdx,LongIdx> &global_to_local_dof_idx);
 
     /// Parent dof handler.
     std::shared_ptr<DOFHandlerMultiDim> parent_;
@@ -296,6 +296,10 @@ public:
     inline const Dof &dof(unsigned int i) const
     { return dofs_[i]; }
     
+    /// Returns type of the finite element (mapping of shape functions to the real element).
+    inline FEType type() const
+    { return type_; }
+
     /// Number of components of FE in a mapped space with dimension @p spacedim.
     unsigned int n_space_components(unsigned int spacedim);
     
@@ -69,6 +69,17 @@ public:
     void assemble(std::shared_ptr<DOFHandlerMultiDim> dh) override {
         START_TIMER( DimAssembly<1>::name() );
 
+        // fields given by FE data are filled by precomputed interpolation stencils, other fields are evaluated on patch
+        FieldSet patch_fields;
+        for (FieldListAccessor f_acc : multidim_assembly_[1_d]->used_fields_.fields_range()) {
+            if (!f_acc->fill_observe_stencil_value(observe_->get_output_cache(f_acc->name()), *observe_))
+                patch_fields += *f_acc.field();
+        }
+        if (patch_fields.size() == 0) {
+            END_TIMER( DimAssembly<1>::name() );
+            return;
+        }
+
         unsigned int i_ep, subset_begin, subset_idx;
         auto &patch_point_data = observe_->patch_point_data();
         for(auto & p_data : patch_point_data) {
@@ -82,13 +93,13 @@ public:
         bulk_integral_data_.make_permanent();
         element_cache_map_.eval_point_data_.make_permanent();
 
-        this->reallocate_cache();
+        this->reallocate_cache(patch_fields);
         element_cache_map_.create_patch();
         multidim_assembly_[1_d]->eq_fields_->cache_update(element_cache_map_);
 
-        multidim_assembly_[1_d]->assemble_cell_integrals(bulk_integral_data_);
-        multidim_assembly_[2_d]->assemble_cell_integrals(bulk_integral_data_);
-        multidim_assembly_[3_d]->assemble_cell_integrals(bulk_integral_data_);
+        multidim_assembly_[1_d]->assemble_cell_integrals(bulk_integral_data_, patch_fields);
+        multidim_assembly_[2_d]->assemble_cell_integrals(bulk_integral_data_, patch_fields);
+        multidim_assembly_[3_d]->assemble_cell_integrals(bulk_integral_data_, patch_fields);
         bulk_integral_data_.reset();
         element_cache_map_.clear_element_eval_points_map();
         END_TIMER( DimAssembly<1>::name() );
@@ -96,9 +107,9 @@ public:
 
 
 private:
-    /// Calls cache_reallocate method on set of used fields
-    inline void reallocate_cache() {
-        multidim_assembly_[1_d]->eq_fields_->cache_reallocate(this->element_cache_map_, multidim_assembly_[1_d]->used_fields_);
+    /// Calls cache_reallocate method on set of fields evaluated on patch
+    inline void reallocate_cache(FieldSet &patch_fields) {
+        multidim_assembly_[1_d]->eq_fields_->cache_reallocate(this->element_cache_map_, patch_fields);
         // DebugOut() << "Order of evaluated fields (" << DimAssembly<1>::name() << "):" << multidim_assembly_[1_d]->eq_fields_->print_dependency();
     }
 
@@ -136,8 +147,8 @@ public:
         this->element_cache_map_ = element_cache_map;
     }
 
-    /// Assembles the cell integrals for the given dimension.
-    inline void assemble_cell_integrals(const RevertableList<GenericAssemblyBase::BulkIntegralData> &bulk_integral_data) {
+    /// Assembles the cell integrals for the given dimension, fills values of @p patch_fields.
+    inline void assemble_cell_integrals(const RevertableList<GenericAssemblyBase::BulkIntegralData> &bulk_integral_data, FieldSet &patch_fields) {
         unsigned int element_patch_idx, field_value_cache_position, val_idx;
         this->reset_offsets();
         for (unsigned int i=0; i<bulk_integral_data.permanent_size(); ++i) {
@@ -148,7 +159,7 @@ public:
             val_idx = ObservePointAccessor(observe_, i).loc_point_time_index();
             this->offsets_[field_value_cache_position] = val_idx;
         }
-        for (FieldListAccessor f_acc : this->used_fields_.fields_range()) {
+        for (FieldListAccessor f_acc : patch_fields.fields_range()) {
             f_acc->fill_observe_value(observe_->get_output_cache(f_acc->name()), this->offsets_);
         }
     }
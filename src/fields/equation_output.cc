@@ -163,6 +163,20 @@ void EquationOutput::initialize(std::shared_ptr<OutputTime> stream, Mesh *mesh,
     output_node_data_assembly_ = new GenericAssembly< AssemblyOutputNodeData >(this, this);
     output_corner_data_assembly_ = new GenericAssembly< AssemblyOutputNodeData >(this, this);
     observe_output_assembly_ = new GenericAssemblyObserve< AssemblyObserveOutput >(this, this->observe_fields_, stream_->observe( mesh_ ));
+
+    // register observed fields, so they are in the header of the binary observe file also if their output starts later
+    auto observe_ptr = stream_->observe( mesh_ );
+    for (auto observe_field : this->observe_fields_) {
+        auto *field_ptr = this->field(observe_field);
+        if ( field_ptr->flags().match( FieldFlag::allow_output) ) {
+            if (field_ptr->is_multifield()) {
+                for (uint i_comp=0; i_comp<field_ptr->n_comp(); ++i_comp)
+                    observe_ptr->register_field(field_ptr->full_comp_name(i_comp), field_ptr->n_shape());
+            } else {
+                observe_ptr->register_field(field_ptr->name(), field_ptr->n_shape());
+            }
+        }
+    }
 }
 
 
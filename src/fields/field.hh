@@ -22,6 +22,7 @@
 #include <string.h>                                    // for memcpy
 #include <algorithm>                                   // for find, min
 #include <boost/circular_buffer.hpp>
+#include <map>                                         // for map
 #include <memory>                                      // for dynamic_pointe...
 #include <new>                                         // for operator new[]
 #include <ostream>                                     // for basic_ostream:...
@@ -47,6 +48,7 @@
 #include "mesh/region.hh"                              // for RegionDB::ExcU...
 #include "system/asserts.hh"                           // for Assert, ASSERT
 #include "system/exceptions.hh"                        // for ExcAssertMsg::...
+#include "system/index_types.hh"                       // for IntIdx
 #include "tools/time_governor.hh"                      // for TimeStep
 
 class Mesh;
@@ -56,6 +58,7 @@ class BulkPoint;
 class SidePoint;
 class FieldSet;
 class ElementDataCacheBase;
+class DOFHandlerMultiDim;
 template <int spacedim> class ElementAccessor;
 template <int spacedim, class Value> class FieldFE;
 namespace detail
@@ -238,6 +241,10 @@ public:
      * Check that whole field list is set, possibly use default values for unset regions
      * and call set_time for every field in the field list.
      *
+     * Field pointers are updated on all regions only after a change of the history, otherwise only on regions
+     * with a history point at the actual time or at the time of the previous call (see @p SharedData::region_groups_).
+     * The set_time method of every distinct field of the field list is called once.
+     *
      * Returns true if the field has been changed.
      */
     bool set_time(const TimeStep &time, LimitSide limit_side) override;
@@ -325,6 +332,15 @@ public:
     /// Implements FieldCommon::cache_update
     void cache_update(ElementCacheMap &cache_map, unsigned int region_patch_idx) const override;
 
+    /// Implements FieldCommon::is_cache_reusable
+    bool is_cache_reusable(unsigned int region_idx) const override;
+
+    /// Implements FieldCommon::eval_signature
+    std::string eval_signature(unsigned int region_idx) const override;
+
+    /// Implements FieldCommon::is_batch_evaluated
+    bool is_batch_evaluated(unsigned int region_idx) const override;
+
     /// Implements FieldCommon::value_cache
     FieldValueCache<double> * value_cache() override;
 
@@ -336,12 +352,20 @@ public:
      */
     std::vector<const FieldCommon *> set_dependency(unsigned int i_reg) const override;
 
+    /// Implements FieldCommon::region_algorithm
+    const void *region_algorithm(unsigned int i_reg) const override {
+        return (i_reg < region_fields_.size()) ? region_fields_[i_reg].get() : nullptr;
+    }
+
     /// Implements FieldCommon::fill_data_value
     void fill_data_value(const std::vector<int> &offsets) override;
 
     /// Implements FieldCommon::fill_observe_value
     void fill_observe_value(std::shared_ptr<ElementDataCacheBase> output_cache_base, const std::vector<int> &offsets) override;
 
+    /// Implements FieldCommon::fill_observe_stencil_value
+    bool fill_observe_stencil_value(std::shared_ptr<ElementDataCacheBase> output_cache_base, Observe &observe) override;
+
 protected:
 
     /// Return item of @p value_cache_ given by i_cache_point.
@@ -358,6 +382,12 @@ protected:
      */
     void check_initialized_region_fields_();
 
+    /**
+     * Set field pointer of the region @p reg_idx given by its history, @p time and @p limit_side.
+     * Returns true if @p time is the time of the newest history point of the region (jump time).
+     */
+    bool update_region_field(unsigned int reg_idx, const TimeStep &time, LimitSide limit_side);
+
     /**************** Shared data **************/
 
     /// Pair: time, pointer to FieldBase instance
@@ -366,11 +396,32 @@ protected:
     typedef boost::circular_buffer<HistoryPoint> RegionHistory;
 
     struct SharedData {
+        /// Constructor.
+        SharedData()
+        : history_version_(1), index_version_(0), checked_version_(0) {}
 
         /**
          *  History for every region. Shared among copies.
          */
          std::vector< RegionHistory >  region_history_;
+
+         /// Indices of regions of the region set "ALL", resolved in set_mesh.
+         std::vector<unsigned int> all_regions_;
+
+         /// Counter of changes of @p region_history_.
+         unsigned int history_version_;
+
+         /**
+          * Time-event index: regions with nonempty history grouped by time of their newest history point.
+          * Field pointers of other regions can not change until the history is changed.
+          */
+         std::map<double, std::vector<unsigned int>> region_groups_;
+
+         /// Value of @p history_version_ for which @p region_groups_ was created.
+         unsigned int index_version_;
+
+         /// Value of @p history_version_ for which the history was checked by @p check_initialized_region_fields_.
+         unsigned int checked_version_;
     };
 
     /**************** Data per copy **************/
@@ -392,6 +443,30 @@ protected:
      */
     std::vector< FieldBasePtr > region_fields_;
 
+    /// Value of SharedData::history_version_ in the last call of set_time, all regions are updated if it differs.
+    unsigned int set_time_version_;
+
+    /// Regions set in a jump time by the last call of set_time, their fields depend on the limit side.
+    std::vector<unsigned int> jump_regions_;
+
+    /// Distinct fields of @p region_fields_ in order of regions, cleared on change of @p region_fields_.
+    std::vector< FieldBasePtr > active_fields_;
+
+    /**
+     * Interpolation stencils of local observe points (see FieldFE::observe_stencil), created
+     * for the FieldFE objects and DOF handlers stored in @p point_fields_ and @p point_dhs_.
+     */
+    struct ObserveStencils {
+        std::vector< FieldBasePtr > point_fields_;                    ///< Field algorithm in every local point.
+        std::vector< std::shared_ptr<DOFHandlerMultiDim> > point_dhs_; ///< DOF handler of the algorithm in every point.
+        std::vector<unsigned int> point_begin_;                      ///< Starts of points in @p dofs_ (size n_points+1).
+        std::vector<IntIdx> dofs_;                                   ///< Local indices of DOFs.
+        std::vector<double> shapes_;                                 ///< Shape values, Value::NRows_*Value::NCols_ per DOF.
+    };
+
+    /// Observe stencils, not shared among copies.
+    ObserveStencils observe_stencils_;
+
     std::vector<std::shared_ptr<FactoryBase> >  factories_;
 
     /**
@@ -18,6 +18,8 @@
 #ifndef FIELD_IMPL_HH_
 #define FIELD_IMPL_HH_
 
+#include <unordered_set>
+
 #include "field.hh"
 #include "field_algo_base.impl.hh"
 #include "field_fe.hh"
@@ -40,6 +42,7 @@
 template<int spacedim, class Value>
 Field<spacedim,Value>::Field()
 : data_(std::make_shared<SharedData>()),
+  set_time_version_(0),
   value_cache_( FieldValueCache<typename Value::element_type>(Value::NRows_, Value::NCols_) )
 {
 	// n_comp is nonzero only for variable size vectors Vector, VectorEnum, ..
@@ -59,6 +62,7 @@ Field<spacedim,Value>::Field()
 template<int spacedim, class Value>
 Field<spacedim,Value>::Field(const string &name)
 : data_(std::make_shared<SharedData>()),
+  set_time_version_(0),
   value_cache_( FieldValueCache<typename Value::element_type>(Value::NRows_, Value::NCols_) )
 {
 		// n_comp is nonzero only for variable size vectors Vector, VectorEnum, ..
@@ -79,6 +83,7 @@ Field<spacedim,Value>::Field(const string &name)
 template<int spacedim, class Value>
 Field<spacedim,Value>::Field(unsigned int component_index, string input_name, string name)
 : data_(std::make_shared<SharedData>()),
+  set_time_version_(0),
   value_cache_( FieldValueCache<typename Value::element_type>(Value::NRows_, Value::NCols_) )
 {
 	// n_comp is nonzero only for variable size vectors Vector, VectorEnum, ..
@@ -102,6 +107,7 @@ Field<spacedim,Value>::Field(const Field &other)
 : FieldCommon(other),
   data_(other.data_),
   region_fields_(other.region_fields_),
+  set_time_version_(0),
   factories_(other.factories_),
   value_cache_(other.value_cache_)
 {
@@ -132,11 +138,16 @@ Field<spacedim,Value> &Field<spacedim,Value>::operator=(const Field<spacedim,Val
 	is_jump_time_ = other.is_jump_time_;
 	component_index_ = other.component_index_;
 	this->multifield_ = false;
+	n_changes_++; // values of the field are given by other field now
 
 	// class members of Field class
 	data_ = other.data_;
 	factories_ = other.factories_;
 	region_fields_ = other.region_fields_;
+	set_time_version_ = 0; // update all regions in next set_time
+	jump_regions_.clear();
+	active_fields_.clear();
+	observe_stencils_ = ObserveStencils();
 	value_cache_ = other.value_cache_;
 	this->shape_ = other.shape_;
 
@@ -213,6 +224,10 @@ void Field<spacedim,Value>::set_mesh(const Mesh &in_mesh) {
 	region_fields_.resize( mesh()->region_db().size() );
 	RegionHistory init_history(history_length_limit_);	// capacity
     data_->region_history_.resize( mesh()->region_db().size(), init_history );
+    data_->all_regions_.clear();
+    for(const Region &reg: mesh()->region_db().get_region_set("ALL") )
+        data_->all_regions_.push_back(reg.idx());
+    data_->history_version_++;
 
     if (no_check_control_field_) no_check_control_field_->set_mesh(in_mesh);
 }
@@ -263,6 +278,7 @@ void Field<spacedim, Value>::set(
     	    region_history.push_front(hp);
         }
 	}
+    data_->history_version_++;
     set_history_changed();
 }
 
@@ -312,54 +328,94 @@ bool Field<spacedim, Value>::set_time(const TimeStep &time_step, LimitSide limit
     update_history(time_step);
     check_initialized_region_fields_();
 
-    //
-    is_jump_time_=false;
-    // set time_step on all regions
-    // for regions that match type of the field domain
-    for(const Region &reg: mesh()->region_db().get_region_set("ALL") ) {
-    	auto rh = data_->region_history_[reg.idx()];
-
-    	// Check regions with empty history, possibly set default.
-    	if ( rh.empty()) continue;
-
-        double last_time_in_history = rh.front().first;
-        unsigned int history_size=rh.size();
-        unsigned int i_history;
-        ASSERT( time_step.ge(last_time_in_history) ).error("Setting field time back in history not fully supported yet!");
-
-        // set history index
-        if ( time_step.gt(last_time_in_history) ) {
-            // in smooth time_step
-            i_history=0;
-        } else {
-            // time_step .eq. input_time; i.e. jump time
-            is_jump_time_=true;
-            if (limit_side == LimitSide::right) {
-                i_history=0;
-            } else {
-                i_history=1;
-            }
+    // time-event index of the actual history
+    SharedData &data = *data_;
+    if (data.index_version_ != data.history_version_) {
+        data.region_groups_.clear();
+        for(unsigned int reg_idx : data.all_regions_) {
+            const RegionHistory &rh = data.region_history_[reg_idx];
+            if ( ! rh.empty() ) data.region_groups_[ rh.front().first ].push_back(reg_idx);
         }
-        i_history=min(i_history, history_size - 1);
-        // This is a VERY old menaingless assert. Let see if we can live without it.
-        // ASSERT(i_history >= 0).error("Empty field history.");
+        data.index_version_ = data.history_version_;
+    }
 
-        // possibly update field pointer
+    is_jump_time_=false;
+    std::vector<unsigned int> last_jump_regions;
+    last_jump_regions.swap(jump_regions_);
+    if (set_time_version_ != data.history_version_) {
+        // history changed, set time_step on all regions
+        for(unsigned int reg_idx : data.all_regions_)
+            if ( update_region_field(reg_idx, time_step, limit_side) ) jump_regions_.push_back(reg_idx);
+        set_time_version_ = data.history_version_;
+    } else if ( ! data.region_groups_.empty() ) {
+        ASSERT( time_step.ge(data.region_groups_.rbegin()->first) ).error("Setting field time back in history not fully supported yet!");
+        // regions with history point at the actual time
+        for(auto it = data.region_groups_.rbegin(); it != data.region_groups_.rend() && ! time_step.gt(it->first); ++it)
+            for(unsigned int reg_idx : it->second)
+                if ( update_region_field(reg_idx, time_step, limit_side) ) jump_regions_.push_back(reg_idx);
+        // regions set in the jump time by the previous call, other regions are not changed
+        for(unsigned int reg_idx : last_jump_regions)
+            if ( time_step.gt(data.region_history_[reg_idx].front().first) )
+                update_region_field(reg_idx, time_step, limit_side);
+    }
 
-        auto new_ptr = rh.at(i_history).second;
-        if (new_ptr != region_fields_[reg.idx()]) {
-            region_fields_[reg.idx()]=new_ptr;
-            set_time_result_ = TimeStatus::changed;
+    // let FieldBase implementations set the time, every field once
+    if ( active_fields_.empty() ) {
+        std::unordered_set<const FieldBaseType *> set_fields;
+        for(unsigned int reg_idx : data.all_regions_) {
+            const FieldBasePtr &field = region_fields_[reg_idx];
+            if ( field && set_fields.insert(field.get()).second ) active_fields_.push_back(field);
         }
-        // let FieldBase implementation set the time
-        if ( new_ptr->set_time(time_step) )  set_time_result_ = TimeStatus::changed;
-
     }
+    for(const FieldBasePtr &field : active_fields_)
+        if ( field->set_time(time_step) )  set_time_result_ = TimeStatus::changed;
 
+    if (changed()) n_changes_++;
     return changed();
 }
 
 
+template<int spacedim, class Value>
+bool Field<spacedim, Value>::update_region_field(unsigned int reg_idx, const TimeStep &time_step, LimitSide limit_side)
+{
+    const RegionHistory &rh = data_->region_history_[reg_idx];
+
+    // Check regions with empty history, possibly set default.
+    if ( rh.empty()) return false;
+
+    double last_time_in_history = rh.front().first;
+    unsigned int history_size=rh.size();
+    unsigned int i_history;
+    bool is_jump = false;
+    ASSERT( time_step.ge(last_time_in_history) ).error("Setting field time back in history not fully supported yet!");
+
+    // set history index
+    if ( time_step.gt(last_time_in_history) ) {
+        // in smooth time_step
+        i_history=0;
+    } else {
+        // time_step .eq. input_time; i.e. jump time
+        is_jump_time_=true;
+        is_jump = true;
+        if (limit_side == LimitSide::right) {
+            i_history=0;
+        } else {
+            i_history=1;
+        }
+    }
+    i_history=min(i_history, history_size - 1);
+
+    // possibly update field pointer
+    auto new_ptr = rh.at(i_history).second;
+    if (new_ptr != region_fields_[reg_idx]) {
+        region_fields_[reg_idx]=new_ptr;
+        set_time_result_ = TimeStatus::changed;
+        active_fields_.clear();
+    }
+    return is_jump;
+}
+
+
 template<int spacedim, class Value>
 void Field<spacedim, Value>::copy_from(const FieldCommon & other) {
 	ASSERT( flags().match(FieldFlag::equation_input))(other.name())(this->name())
@@ -478,12 +534,14 @@ void Field<spacedim,Value>::update_history(const TimeStep &time) {
                         {
                             data_->region_history_[reg.idx()].push_front(
                                     HistoryPoint(input_time, field_instance));
+                            data_->history_version_++;
                             //DebugOut() << "Update history" << print_var(this->name()) << print_var(reg.label()) << print_var(input_time);
                         }
                         else
                         {
                             data_->region_history_[reg.idx()].back() = 
                                     HistoryPoint(input_time, field_instance);
+                            data_->history_version_++;
                         }
 					}
 					break;
@@ -499,6 +557,8 @@ template<int spacedim, class Value>
 void Field<spacedim,Value>::check_initialized_region_fields_() {
 	ASSERT_PTR(mesh()).error("Null mesh pointer.");
     //if (shared_->is_fully_initialized_) return;
+    // the result depends only on the history
+    if (data_->checked_version_ == data_->history_version_) return;
 
     // check there are no empty field pointers, collect regions to be initialized from default value
     RegionSet regions_to_init; // empty vector
@@ -543,9 +603,11 @@ void Field<spacedim,Value>::check_initialized_region_fields_() {
     		                .push_front(HistoryPoint( 0.0, field_ptr) );
     		region_list+=" "+reg.label();
         }
+        data_->history_version_++;
         FieldCommon::messages_data_.push_back( MessageData(input_default(), name(), region_list) );
 
     }
+    data_->checked_version_ = data_->history_version_;
     //shared_->is_fully_initialized_ = true;
 }
 
@@ -675,6 +737,62 @@ void Field<spacedim,Value>::fill_observe_value(std::shared_ptr<ElementDataCacheB
 }
 
 
+template<int spacedim, class Value>
+bool Field<spacedim,Value>::fill_observe_stencil_value(std::shared_ptr<ElementDataCacheBase> output_cache_base, Observe &observe)
+{
+    typedef typename Value::element_type ElemType;
+    typedef FieldFE<spacedim, Value> FieldFEType;
+    // values of integer fields are computed in their own arithmetic on patch
+    if (!std::is_same<ElemType, double>::value) return false;
+
+    auto &patch_point_data = observe.patch_point_data();
+    unsigned int n_points = patch_point_data.size();
+    ObserveStencils &st = observe_stencils_;
+
+    // stencils are valid until FieldFE object or its DOF handler of some point is changed
+    bool is_valid = (st.point_fields_.size() == n_points);
+    for (unsigned int i=0; i<n_points && is_valid; ++i) {
+        unsigned int reg_idx = this->mesh()->element_accessor(patch_point_data[i].elem_idx).region_idx().idx();
+        is_valid = (st.point_fields_[i] == region_fields_[reg_idx])
+                && (st.point_dhs_[i] == std::static_pointer_cast<FieldFEType>(st.point_fields_[i])->get_dofhandler());
+    }
+    if (!is_valid) {
+        st = ObserveStencils();
+        for (unsigned int i=0; i<n_points; ++i) {
+            unsigned int reg_idx = this->mesh()->element_accessor(patch_point_data[i].elem_idx).region_idx().idx();
+            if (!std::dynamic_pointer_cast<FieldFEType>(region_fields_[reg_idx])) return false;
+            st.point_fields_.push_back(region_fields_[reg_idx]);
+        }
+        st.point_begin_.push_back(0);
+        for (unsigned int i=0; i<n_points; ++i) {
+            auto field_fe = std::static_pointer_cast<FieldFEType>(st.point_fields_[i]);
+            if (!field_fe->observe_stencil(patch_point_data[i].elem_idx, patch_point_data[i].local_coords, st.dofs_, st.shapes_)) {
+                st = ObserveStencils();
+                return false;
+            }
+            st.point_dhs_.push_back(field_fe->get_dofhandler());
+            st.point_begin_.push_back(st.dofs_.size());
+        }
+    }
+
+    std::shared_ptr<ElementDataCache<ElemType>> observe_data_cache =
+            std::dynamic_pointer_cast<ElementDataCache<ElemType>>(output_cache_base);
+    const unsigned int n_comp = Value::NRows_ * Value::NCols_;
+    std::vector<ElemType> value(n_comp);
+    for (unsigned int i=0; i<n_points; ++i) {
+        const VectorMPI &data_vec = static_cast<const FieldFEType &>(*st.point_fields_[i]).vec();
+        std::fill(value.begin(), value.end(), 0);
+        for (unsigned int k=st.point_begin_[i]; k<st.point_begin_[i+1]; ++k) {
+            double dof_value = data_vec.get(st.dofs_[k]);
+            const double *shape = &st.shapes_[k*n_comp];
+            for (unsigned int c=0; c<n_comp; ++c) value[c] += dof_value * shape[c];
+        }
+        observe_data_cache->store_value(ObservePointAccessor(&observe, i).loc_point_time_index(), value.data());
+    }
+    return true;
+}
+
+
 template<int spacedim, class Value>
 std::shared_ptr< FieldFE<spacedim, Value> > Field<spacedim,Value>::get_field_fe() {
 	ASSERT_EQ(this->mesh()->region_db().size(), region_fields_.size()).error();
@@ -713,6 +831,26 @@ void Field<spacedim, Value>::cache_update(ElementCacheMap &cache_map, unsigned i
 }
 
 
+template<int spacedim, class Value>
+bool Field<spacedim, Value>::is_cache_reusable(unsigned int region_idx) const {
+    return (region_fields_[region_idx] != nullptr) && (this->value_cache() != nullptr)
+            && region_fields_[region_idx]->is_cache_reusable();
+}
+
+
+template<int spacedim, class Value>
+std::string Field<spacedim, Value>::eval_signature(unsigned int region_idx) const {
+    if (!this->is_cache_reusable(region_idx)) return std::string();
+    return region_fields_[region_idx]->eval_signature();
+}
+
+
+template<int spacedim, class Value>
+bool Field<spacedim, Value>::is_batch_evaluated(unsigned int region_idx) const {
+    return (region_fields_[region_idx] != nullptr) && region_fields_[region_idx]->is_batch_evaluated();
+}
+
+
 template<int spacedim, class Value>
 std::vector<const FieldCommon *> Field<spacedim, Value>::set_dependency(unsigned int i_reg) const {
    	if (region_fields_[i_reg] != nullptr) return region_fields_[i_reg]->set_dependency(*this->shared_->default_fieldset_);
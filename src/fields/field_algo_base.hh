@@ -26,6 +26,7 @@
 #define field_algo_base_HH_
 
 #include <string.h>                        // for memcpy
+#include <cstdint>                         // for uintptr_t
 #include <type_traits>   // for is_same
 #include <limits>                          // for numeric_limits
 #include <memory>                          // for shared_ptr
@@ -205,6 +206,34 @@ public:
        virtual void cache_update(FieldValueCache<typename Value::element_type> &data_cache,
 				   ElementCacheMap &cache_map, unsigned int region_patch_idx);
 
+       /**
+        * Return true if values computed by cache_update change only with the time (i.e. if set_time returns true)
+        * or with the fields returned by set_dependency. See FieldCommon::is_cache_reusable.
+        *
+        * Returns false by default, implementations that allow reuse of their values must override the method.
+        */
+       virtual bool is_cache_reusable() const
+       { return false; }
+
+       /**
+        * Return true if cache_update may postpone the evaluation to a batch of more fields and region chunks
+        * (see PythonFieldBatch). Returns false by default.
+        */
+       virtual bool is_batch_evaluated() const
+       { return false; }
+
+       /**
+        * Return key identifying values computed by cache_update, two algorithms with equal non-empty keys
+        * compute equal values (used by FieldSet to evaluate such values only once on the patch).
+        *
+        * Default key is given by the address of the algorithm (instance shared by more fields), it is empty
+        * if values of the algorithm are not reusable. Descendants may compare also their content.
+        */
+       virtual std::string eval_signature() const {
+           if (!this->is_cache_reusable()) return std::string();
+           return "algorithm:" + std::to_string( reinterpret_cast<std::uintptr_t>(this) );
+       }
+
        /**
         * Postponed setter of Dof handler for FieldFE. For other types of fields has no effect.
         */
@@ -31,6 +31,7 @@
 FieldCommon::FieldCommon()
 : shared_( std::make_shared<SharedData>() ),
   set_time_result_(TimeStatus::unknown),
+  n_changes_(0),
   is_jump_time_(true),
   component_index_(std::numeric_limits<unsigned int>::max())
 {
@@ -46,6 +47,7 @@ FieldCommon::FieldCommon(const FieldCommon & other)
 : name_(other.name_),
   shared_(other.shared_),
   set_time_result_(other.set_time_result_),
+  n_changes_(other.n_changes_),
   last_time_(other.last_time_),
   last_limit_side_(other.last_limit_side_),
   is_jump_time_(other.is_jump_time_),
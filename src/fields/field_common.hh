@@ -365,6 +365,17 @@ public:
                  (set_time_result_ == TimeStatus::changed_forced) );
     }
 
+    /**
+     * Returns number of changes of the field, i.e. calls of set_time that changed the field
+     * and calls of @p set_time_result_changed.
+     *
+     * Unlike @p changed, the counter allows to detect changes over several calls of set_time.
+     */
+    unsigned int n_changes() const
+    {
+        return n_changes_;
+    }
+
     /**
      * Common part of the field descriptor. To get finished record
      * one has to add keys for individual fields. This is done automatically
@@ -443,6 +454,15 @@ public:
      */
     virtual std::vector<const FieldCommon *> set_dependency(unsigned int i_reg) const =0;
 
+    /**
+     * Identifies algorithm of the field on the region @p i_reg (nullptr for fields without
+     * region algorithms). The dependency of the field given by set_dependency can change only
+     * together with the algorithm, FieldSet uses it to check validity of cached evaluation plans.
+     */
+    virtual const void *region_algorithm(FMT_UNUSED unsigned int i_reg) const {
+        return nullptr;
+    }
+
     /**
      * Sets @p component_index_
      */
@@ -470,6 +490,38 @@ public:
      */
     virtual void cache_update(ElementCacheMap &cache_map, unsigned int region_patch_idx) const = 0;
 
+    /**
+     * Returns true if values computed by cache_update on given region depend only on the evaluation points,
+     * on the time of the field and on the dependent fields (see @p set_dependency). Such values can be stored
+     * and reused by FieldSet::cache_update until @p n_changes of the field or of some dependent field is increased.
+     *
+     * Returns false by default.
+     */
+    virtual bool is_cache_reusable(FMT_UNUSED unsigned int region_idx) const {
+        return false;
+    }
+
+    /**
+     * Returns true if cache_update on given region may be postponed to a batch evaluated at once for all
+     * regions of the patch (see FieldAlgorithmBase::is_batch_evaluated).
+     *
+     * Returns false by default.
+     */
+    virtual bool is_batch_evaluated(FMT_UNUSED unsigned int region_idx) const {
+        return false;
+    }
+
+    /**
+     * Returns key of values computed by cache_update on given region (see FieldAlgorithmBase::eval_signature).
+     * Fields of the same shape with equal non-empty keys have equal values, FieldSet::cache_update evaluates
+     * them only once.
+     *
+     * Returns empty key by default.
+     */
+    virtual std::string eval_signature(FMT_UNUSED unsigned int region_idx) const {
+        return std::string();
+    }
+
 
     /**
      *  Returns pointer to this (Field) or the sub-field component (MultiField).
@@ -509,6 +561,16 @@ public:
         ASSERT_PERMANENT(false);
     }
 
+    /**
+     * Fill values in all local observe points to ElementDataCache directly from FE data of the field,
+     * without evaluation on patch. Returns false if it is not possible (field is not given by FieldFE
+     * in some point), values have to be filled by fill_observe_value in such case.
+     */
+    virtual bool fill_observe_stencil_value(FMT_UNUSED std::shared_ptr<ElementDataCacheBase> output_cache_base, FMT_UNUSED Observe &observe)
+    {
+        return false;
+    }
+
 
     /**
      * Print stored messages to table.
@@ -691,6 +753,9 @@ protected:
      */
     TimeStatus set_time_result_;
 
+    /// Number of changes of the field, see @p n_changes.
+    unsigned int n_changes_;
+
     /**
      * Last set time. Can be different for different field copies.
      * Store also time limit, since the field may be discontinuous.
@@ -750,7 +815,10 @@ public:
     
     /// Manually mark flag that the field has been changed.
     void set_time_result_changed()
-    { set_time_result_ = TimeStatus::changed_forced; }
+    {
+        set_time_result_ = TimeStatus::changed_forced;
+        n_changes_++;
+    }
 };
 
 
@@ -78,6 +78,10 @@ public:
     void cache_update(FieldValueCache<typename Value::element_type> &data_cache,
 			ElementCacheMap &cache_map, unsigned int region_patch_idx) override;
 
+    /// Implements FieldAlgorithmBase::is_cache_reusable, value is changed only by set_time.
+    bool is_cache_reusable() const override
+    { return true; }
+
 
     virtual ~FieldConstant();
 
@@ -146,6 +146,11 @@ public:
         }
     }
 
+    /// Implements FieldCommon::is_cache_reusable
+    bool is_cache_reusable(FMT_UNUSED unsigned int region_idx) const override {
+        return true;
+    }
+
     /// Implements FieldCommon::value_cache
     FieldValueCache<double> * value_cache() override {
     	return &value_cache_;
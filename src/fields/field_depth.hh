@@ -113,6 +113,11 @@ public:
         }
     }
 
+    /// Implements FieldCommon::is_cache_reusable
+    bool is_cache_reusable(FMT_UNUSED unsigned int region_idx) const override {
+        return true;
+    }
+
     /// Implements FieldCommon::value_cache
     FieldValueCache<double> * value_cache() override {
     	return &value_cache_;
@@ -132,6 +137,7 @@ public:
 
     /// Setter of surface_depth data member
     inline void set_surface_depth(std::shared_ptr<SurfaceDepth> surface_depth) {
+        if (surface_depth_ != surface_depth) n_changes_++; // invalidates stored values, see is_cache_reusable
         surface_depth_ = surface_depth;
     }
 
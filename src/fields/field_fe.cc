@@ -134,9 +134,10 @@ template <int spacedim, class Value>
 FieldFE<spacedim, Value>::FieldFE( unsigned int n_comp)
 : FieldAlgorithmBase<spacedim, Value>(n_comp),
   dh_(nullptr), field_name_(""), discretization_(OutputTime::DiscreteSpace::UNDEFINED),
-  boundary_domain_(false), fe_values_(4)
+  boundary_domain_(false), fe_values_(4), read_data_time_(-numeric_limits<double>::infinity())
 {
 	this->is_constant_in_space_ = false;
+	fe_kernel_.fill(FEKernel::generic);
 }
 
 
@@ -200,6 +201,8 @@ VectorMPI FieldFE<spacedim, Value>::set_fe_data(std::shared_ptr<DOFHandlerMultiD
                 std::dynamic_pointer_cast<FESystem<3>>( dh_->ds()->fe()[Dim<3>{}] )->fe()[block_index]
                 );
     }
+    // kernels of the new FE are initialized in cache_reinit
+    fe_kernel_.fill(FEKernel::generic);
 
 	// set interpolation
 	interpolation_ = DataInterpolation::equivalent_msh;
@@ -221,14 +224,17 @@ void FieldFE<spacedim, Value>::cache_update(FieldValueCache<typename Value::elem
         return;
     }
 
-    Armor::ArmaMat<typename Value::element_type, Value::NRows_, Value::NCols_> mat_value;
+    ShapeMat mat_value;
+    arma::mat33 piola_mat;
+    arma::vec3 ref_vec_value;
 
     unsigned int reg_chunk_begin = cache_map.region_chunk_begin(region_patch_idx);
     unsigned int reg_chunk_end = cache_map.region_chunk_end(region_patch_idx);
     unsigned int last_element_idx = -1;
     DHCellAccessor cell = *( dh_->local_range().begin() ); //needs set variable for correct compiling
     LocDofVec loc_dofs;
-    unsigned int range_bgn=0, range_end=0;
+    unsigned int range_bgn=0, range_end=0, n_dofs=0, dim=0;
+    FEKernel kernel = FEKernel::generic;
 
     // Throws exception if any element value of processed region is NaN
     unsigned int r_idx = cache_map.eval_point_data(reg_chunk_begin).i_reg_;
@@ -239,19 +245,57 @@ void FieldFE<spacedim, Value>::cache_update(FieldValueCache<typename Value::elem
         unsigned int elm_idx = cache_map.eval_point_data(i_data).i_element_;
         if (elm_idx != last_element_idx) {
             ElementAccessor<spacedim> elm(dh_->mesh(), elm_idx);
-            fe_values_[elm.dim()].reinit( elm );
+            dim = elm.dim();
+            kernel = fe_kernel_[dim];
+            if (kernel == FEKernel::generic) {
+                fe_values_[dim].reinit( elm );
+            } else if (kernel == FEKernel::piola) {
+                switch (dim) {
+                case 1: piola_mat = this->piola_map<1>(elm); break;
+                case 2: piola_mat = this->piola_map<2>(elm); break;
+                case 3: piola_mat = this->piola_map<3>(elm); break;
+                }
+            }
             cell = dh_->cell_accessor_from_element( elm_idx );
             loc_dofs = cell.get_loc_dof_indices();
             last_element_idx = elm_idx;
-            range_bgn = this->fe_item_[elm.dim()].range_begin_;
-            range_end = this->fe_item_[elm.dim()].range_end_;
+            range_bgn = this->fe_item_[dim].range_begin_;
+            range_end = this->fe_item_[dim].range_end_;
+            n_dofs = range_end - range_bgn;
+
+            if (kernel == FEKernel::constant) {
+                // direct gather of DOF values, shape functions are equal in all points
+                mat_value.fill(0.0);
+                for (unsigned int i_dof=range_bgn, i_cdof=0; i_dof<range_end; i_dof++, i_cdof++)
+                    mat_value += data_vec_.get(loc_dofs[i_dof]) * ref_shape_values_[dim][i_cdof];
+            }
         }
 
         unsigned int i_ep=cache_map.eval_point_data(i_data).i_eval_point_;
-        //DHCellAccessor cache_cell = cache_map(cell);
-        mat_value.fill(0.0);
-        for (unsigned int i_dof=range_bgn, i_cdof=0; i_dof<range_end; i_dof++, i_cdof++) {
-            mat_value += data_vec_.get(loc_dofs[i_dof]) * this->handle_fe_shape(cell.dim(), i_cdof, i_ep);
+        switch (kernel) {
+        case FEKernel::constant:
+            break;
+        case FEKernel::reference: {
+            const ShapeMat *shape = &ref_shape_values_[dim][i_ep*n_dofs];
+            mat_value.fill(0.0);
+            for (unsigned int i_dof=range_bgn, i_cdof=0; i_dof<range_end; i_dof++, i_cdof++)
+                mat_value += data_vec_.get(loc_dofs[i_dof]) * shape[i_cdof];
+            break;
+        }
+        case FEKernel::piola: {
+            const arma::vec3 *shape = &ref_vec_shape_values_[dim][i_ep*n_dofs];
+            ref_vec_value.zeros();
+            for (unsigned int i_dof=range_bgn, i_cdof=0; i_dof<range_end; i_dof++, i_cdof++)
+                ref_vec_value += data_vec_.get(loc_dofs[i_dof]) * shape[i_cdof];
+            ref_vec_value = piola_mat * ref_vec_value;
+            for (unsigned int c=0; c<spacedim; ++c) mat_value(c) = ref_vec_value(c);
+            break;
+        }
+        default:
+            mat_value.fill(0.0);
+            for (unsigned int i_dof=range_bgn, i_cdof=0; i_dof<range_end; i_dof++, i_cdof++) {
+                mat_value += data_vec_.get(loc_dofs[i_dof]) * this->handle_fe_shape(dim, i_cdof, i_ep);
+            }
         }
         data_cache.set(i_data) = mat_value;
     }
@@ -267,6 +311,10 @@ void FieldFE<spacedim, Value>::cache_reinit(const ElementCacheMap &cache_map)
     fe_values_[1].initialize(quads[1], *this->fe_[1_d], update_values);
     fe_values_[2].initialize(quads[2], *this->fe_[2_d], update_values);
     fe_values_[3].initialize(quads[3], *this->fe_[3_d], update_values);
+    this->init_fe_kernel<0>(quads[0]);
+    this->init_fe_kernel<1>(quads[1]);
+    this->init_fe_kernel<2>(quads[2]);
+    this->init_fe_kernel<3>(quads[3]);
 }
 
 
@@ -281,6 +329,46 @@ Quadrature FieldFE<spacedim, Value>::init_quad(std::shared_ptr<EvalPoints> eval_
 }
 
 
+template <int spacedim, class Value>
+bool FieldFE<spacedim, Value>::observe_stencil(unsigned int elm_idx, const arma::vec &local_coords,
+        std::vector<IntIdx> &dofs, std::vector<double> &shapes) const
+{
+    ElementAccessor<spacedim> elm(dh_->mesh(), elm_idx);
+    if (region_value_err_[elm.region_idx().idx()].is_invalid_) return false;
+
+    switch (elm.dim()) {
+    case 1: this->fill_observe_stencil<1>(elm, local_coords, dofs, shapes); break;
+    case 2: this->fill_observe_stencil<2>(elm, local_coords, dofs, shapes); break;
+    case 3: this->fill_observe_stencil<3>(elm, local_coords, dofs, shapes); break;
+    default: ASSERT_PERMANENT(false)(elm.dim()).error("Observe point on element of unsupported dimension.");
+    }
+    return true;
+}
+
+
+template <int spacedim, class Value>
+template <unsigned int dim>
+void FieldFE<spacedim, Value>::fill_observe_stencil(const ElementAccessor<spacedim> &elm, const arma::vec &local_coords,
+        std::vector<IntIdx> &dofs, std::vector<double> &shapes) const
+{
+    // one point quadrature, shape values are mapped in the same way as in the generic kernel of cache_update
+    Quadrature quad(dim, 1);
+    arma::vec::fixed<dim> fix_p = local_coords.subvec(0, dim-1);
+    quad.weight(0) = 1.0;
+    quad.set(0) = fix_p;
+    FEValues<spacedim> fe_values;
+    fe_values.initialize(quad, *this->fe_[Dim<dim>{}], update_values);
+    fe_values.reinit(elm);
+
+    LocDofVec loc_dofs = dh_->cell_accessor_from_element( elm.idx() ).get_loc_dof_indices();
+    for (unsigned int i_dof=fe_item_[dim].range_begin_, i_cdof=0; i_dof<fe_item_[dim].range_end_; i_dof++, i_cdof++) {
+        ShapeMat shape = this->handle_fe_shape(fe_values, i_cdof, 0);
+        dofs.push_back(loc_dofs[i_dof]);
+        shapes.insert(shapes.end(), shape.memptr(), shape.memptr() + Value::NRows_*Value::NCols_);
+    }
+}
+
+
 template <int spacedim, class Value>
 void FieldFE<spacedim, Value>::init_from_input(const Input::Record &rec, const struct FieldAlgoBaseInitData& init_data) {
 	this->init_unit_conversion_coefficient(rec, init_data);
@@ -375,6 +463,8 @@ void FieldFE<spacedim, Value>::make_dof_handler(const MeshBase *mesh) {
     this->fill_fe_item<2>();
     this->fill_fe_item<3>();
     this->fe_ = dh_->ds()->fe();
+    // kernels of the new FE are initialized in cache_reinit
+    fe_kernel_.fill(FEKernel::generic);
 
     data_vec_ = VectorMPI::sequential( dh_->lsize() ); // allocate data_vec_
 }
@@ -411,6 +501,9 @@ bool FieldFE<spacedim, Value>::set_time(const TimeStep &time) {
         BaseMeshReader::HeaderQuery header_query(field_name_, read_time, this->discretization_, dh_->hash());
         auto reader = ReaderCache::get_reader(reader_file_);
         auto header = reader->find_header(header_query);
+        // data of the same time frame are already read, values are not changed
+        if (header.time == read_data_time_) return false;
+        read_data_time_ = header.time;
         this->input_data_cache_ = reader->template get_element_data<double>(
             header, n_entities, n_components, bdr_shift);
 
@@ -39,6 +39,7 @@
 #include "input/factory.hh"
 
 #include <memory>
+#include <limits>
 
 
 
@@ -137,6 +138,16 @@ public:
     void cache_update(FieldValueCache<typename Value::element_type> &data_cache,
 			ElementCacheMap &cache_map, unsigned int region_patch_idx) override;
 
+    /**
+     * Overload @p FieldAlgorithmBase::is_cache_reusable
+     *
+     * Only values read from input file are changed exclusively by set_time, fields set by set_fe_data
+     * share data vector with the equation.
+     */
+    bool is_cache_reusable() const override {
+        return flags_.match(FieldFlag::equation_input) && flags_.match(FieldFlag::declare_input) && !(reader_file_ == FilePath());
+    }
+
     /**
      * Overload @p FieldAlgorithmBase::cache_reinit
      *
@@ -152,6 +163,8 @@ public:
 
     /**
      * Update time and possibly update data from GMSH file.
+     *
+     * Returns true if data of new time frame are read.
      */
     bool set_time(const TimeStep &time) override;
 
@@ -185,6 +198,17 @@ public:
     	return data_vec_;
     }
 
+    /**
+     * Append interpolation stencil of the field in the observe point given by element @p elm_idx and local
+     * coordinates @p local_coords on it: local indices of DOFs to @p dofs and values of their shape functions
+     * in the point to @p shapes (Value::NRows_*Value::NCols_ components in column-major order per DOF).
+     * Value of the field in the point is the sum of DOF values of vec() multiplied by the shape values.
+     *
+     * Returns false and appends nothing if the field has invalid values on the region of the element.
+     */
+    bool observe_stencil(unsigned int elm_idx, const arma::vec &local_coords,
+            std::vector<IntIdx> &dofs, std::vector<double> &shapes) const;
+
     /// Call begin scatter functions (local to ghost) on data vector
     void local_to_ghost_data_scatter_begin();
 
@@ -195,6 +219,20 @@ public:
 	virtual ~FieldFE();
 
 private:
+    /// Shape function value in the shape of field value.
+    typedef Armor::ArmaMat<typename Value::element_type, Value::NRows_, Value::NCols_> ShapeMat;
+
+    /**
+     * Kernels used in cache_update, selected for every dimension according to the finite element
+     * in cache_reinit together with their tables of shape values (see init_fe_kernel).
+     */
+    enum class FEKernel {
+        generic,    ///< Evaluation through FEValues, used for higher order and mixed system FE.
+        constant,   ///< Shape functions constant on element (P0), value is gathered once per element.
+        reference,  ///< Shape functions not mapped to element (FEScalar, FEVector, FETensor), uses precomputed shape values.
+        piola       ///< Vector FE with Piola transformation (RT0), precomputed shape values are mapped by element Jacobian.
+    };
+
 	/**
 	 * Helper class holds specific data of field evaluation.
 	 */
@@ -256,12 +294,24 @@ private:
 	template <unsigned int dim>
 	Quadrature init_quad(std::shared_ptr<EvalPoints> eval_points);
 
+	/// Implements observe_stencil on element of given dimension.
+	template <unsigned int dim>
+	void fill_observe_stencil(const ElementAccessor<spacedim> &elm, const arma::vec &local_coords,
+	        std::vector<IntIdx> &dofs, std::vector<double> &shapes) const;
+
     inline Armor::ArmaMat<typename Value::element_type, Value::NRows_, Value::NCols_> handle_fe_shape(unsigned int dim,
             unsigned int i_dof, unsigned int i_qp)
+    {
+        return handle_fe_shape(fe_values_[dim], i_dof, i_qp);
+    }
+
+    /// Shape function value of @p i_dof in quadrature point @p i_qp of given FEValues object.
+    static inline Armor::ArmaMat<typename Value::element_type, Value::NRows_, Value::NCols_> handle_fe_shape(
+            const FEValues<spacedim> &fe_values, unsigned int i_dof, unsigned int i_qp)
     {
         Armor::ArmaMat<typename Value::element_type, Value::NCols_, Value::NRows_> v;
         for (unsigned int c=0; c<Value::NRows_*Value::NCols_; ++c)
-            v(c/spacedim,c%spacedim) = fe_values_[dim].shape_value_component(i_dof, i_qp, c);
+            v(c/spacedim,c%spacedim) = fe_values.shape_value_component(i_dof, i_qp, c);
         if (Value::NRows_ == Value::NCols_)
             return v;
         else
@@ -285,6 +335,82 @@ private:
         this->fe_item_[dim].range_end_ = dh_->ds()->fe()[Dim<dim>{}]->n_dofs();
     }
 
+    /**
+     * Return evaluation kernel of given dimension according to type of finite element @p fe_.
+     *
+     * Kernels other than generic are used only if shape functions can be evaluated on the reference element,
+     * P0 elements are detected by equal values of all shape functions in vertices of the reference element.
+     */
+    template<unsigned int dim>
+    FEKernel select_fe_kernel() const {
+        auto fe = this->fe_[Dim<dim>{}];
+        switch (fe->type()) {
+        case FEScalar:
+        case FEVector:
+        case FETensor:
+            if (fe->n_components() != Value::NRows_*Value::NCols_) return FEKernel::generic;
+            break;
+        case FEVectorPiola:
+            if (dim > 0 && fe->n_components() == dim && Value::NRows_ == spacedim && Value::NCols_ == 1)
+                return FEKernel::piola;
+            return FEKernel::generic;
+        default:
+            return FEKernel::generic;
+        }
+
+        for (unsigned int i_node=1; i_node<RefElement<dim>::n_nodes; ++i_node)
+            for (unsigned int i_dof=0; i_dof<fe->n_dofs(); ++i_dof)
+                for (unsigned int c=0; c<fe->n_components(); ++c)
+                    if ( fabs(fe->shape_value(i_dof, RefElement<dim>::node_coords(i_node), c)
+                            - fe->shape_value(i_dof, RefElement<dim>::node_coords(0), c)) > 4*std::numeric_limits<double>::epsilon() )
+                        return FEKernel::reference;
+        return FEKernel::constant;
+    }
+
+    /**
+     * Select evaluation kernel of given dimension (see select_fe_kernel) and precompute its values of shape functions
+     * in points of @p quad. Kernel and its tables are always set together, so they can not get out of sync.
+     */
+    template<unsigned int dim>
+    void init_fe_kernel(const Quadrature &quad) {
+        auto fe = this->fe_[Dim<dim>{}];
+        this->fe_kernel_[dim] = this->select_fe_kernel<dim>();
+        ref_shape_values_[dim].clear();
+        ref_vec_shape_values_[dim].clear();
+        if (this->fe_kernel_[dim] == FEKernel::constant || this->fe_kernel_[dim] == FEKernel::reference) {
+            ref_shape_values_[dim].resize(quad.size() * fe->n_dofs());
+            for (unsigned int i_qp=0; i_qp<quad.size(); ++i_qp)
+                for (unsigned int i_dof=0; i_dof<fe->n_dofs(); ++i_dof) {
+                    // same ordering of components as in handle_fe_shape
+                    Armor::ArmaMat<typename Value::element_type, Value::NCols_, Value::NRows_> v;
+                    for (unsigned int c=0; c<Value::NRows_*Value::NCols_; ++c)
+                        v(c/spacedim,c%spacedim) = fe->shape_value(i_dof, quad.point<dim>(i_qp), c);
+                    if (Value::NRows_ == Value::NCols_)
+                        ref_shape_values_[dim][i_qp*fe->n_dofs()+i_dof] = v;
+                    else
+                        ref_shape_values_[dim][i_qp*fe->n_dofs()+i_dof] = v.t();
+                }
+        } else if (this->fe_kernel_[dim] == FEKernel::piola) {
+            ref_vec_shape_values_[dim].resize(quad.size() * fe->n_dofs());
+            for (unsigned int i_qp=0; i_qp<quad.size(); ++i_qp)
+                for (unsigned int i_dof=0; i_dof<fe->n_dofs(); ++i_dof) {
+                    arma::vec3 &v = ref_vec_shape_values_[dim][i_qp*fe->n_dofs()+i_dof];
+                    v.zeros();
+                    for (unsigned int c=0; c<dim; ++c)
+                        v(c) = fe->shape_value(i_dof, quad.point<dim>(i_qp), c);
+                }
+        }
+    }
+
+    /// Return Piola transformation J/|det J| of the element, columns of missing dimensions are zero.
+    template<unsigned int dim>
+    arma::mat33 piola_map(const ElementAccessor<spacedim> &elm) {
+        arma::mat::fixed<spacedim,dim> jac = MappingP1<dim,spacedim>::jacobian( MappingP1<dim,spacedim>::element_map(elm) );
+        arma::mat33 map(arma::fill::zeros);
+        map.cols(0, dim-1) = jac / fabs(::determinant(jac));
+        return map;
+    }
+
     /**
      * Method computes value of given input cache element.
      *
@@ -352,6 +478,9 @@ private:
     /// List of FEValues objects of dimensions 0,1,2,3 used for value calculation
     std::vector<FEValues<spacedim>> fe_values_;
 
+    /// Time of the data frame read by the last call of set_time, the same frame is not read repeatedly.
+    double read_data_time_;
+
     /// Maps element indices from computational mesh to the  source (data).
     std::shared_ptr<EquivalentMeshMap> source_target_mesh_elm_map_;
 
@@ -359,6 +488,15 @@ private:
     std::array<FEItem, 4> fe_item_;
     MixedPtr<FiniteElement> fe_;
 
+    /// Evaluation kernels of dimensions 0,1,2,3.
+    std::array<FEKernel, 4> fe_kernel_;
+
+    /// Values of shape functions in evaluation points for constant and reference kernels, indexed by [dim][i_qp*n_dofs+i_dof].
+    std::array<std::vector<ShapeMat>, 4> ref_shape_values_;
+
+    /// Reference values of shape functions in evaluation points for piola kernel, indexed by [dim][i_qp*n_dofs+i_dof].
+    std::array<std::vector<arma::vec3>, 4> ref_vec_shape_values_;
+
     /// Set holds data of valid / invalid element values on all regions
     std::vector<RegionValueErr> region_value_err_;
 
@@ -24,6 +24,8 @@
 //#include "include/arena_alloc.hh"       // bparser
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/regex.hpp>
+#include <iomanip>
+#include <sstream>
 
 
 
@@ -74,6 +76,8 @@ template <int spacedim, class Value>
 FieldFormula<spacedim, Value>::FieldFormula( unsigned int n_comp)
 : FieldAlgorithmBase<spacedim, Value>(n_comp),
   b_parser_( CacheMapElementNumber::get() ),
+  has_time_(false),
+  is_time_independent_(false),
   arena_alloc_(nullptr)
 {
 	this->is_constant_in_space_ = false;
@@ -88,6 +92,33 @@ void FieldFormula<spacedim, Value>::init_from_input(const Input::Record &rec, co
 	// read formulas form input
     this->formula_ = rec.val<std::string>("value");
     in_rec_ = rec;
+
+    // time independence must be known in the first set_time
+    this->parse_formula();
+}
+
+
+template <int spacedim, class Value>
+std::vector<std::string> FieldFormula<spacedim, Value>::parse_formula() {
+    try {
+        b_parser_.parse( formula_ );
+    } catch (std::exception const& e) {
+        if (typeid(e) == typeid(bparser::Exception))
+            THROW( ExcParserError() << EI_BParserMsg(e.what()) << EI_Formula(formula_) << Input::EI_Address( in_rec_.address_string() ) );
+        else throw;
+    }
+    std::vector<std::string> variables = b_parser_.free_symbols();
+    std::sort( variables.begin(), variables.end() );
+    variables.erase( std::unique( variables.begin(), variables.end() ), variables.end() );
+
+    // formula is time independent if it depends only on coordinates and depth, other fields can change in time
+    has_time_ = false;
+    is_time_independent_ = true;
+    for (auto var : variables) {
+        if (var == "t") has_time_ = true;
+        if (var != "X" && var != "x" && var != "y" && var != "z" && var != "d") is_time_independent_ = false;
+    }
+    return variables;
 }
 
 
@@ -96,7 +127,7 @@ bool FieldFormula<spacedim, Value>::set_time(const TimeStep &time) {
 
     this->time_=time;
 	this->is_constant_in_space_ = false;
-    return true;
+    return !is_time_independent_;
 
 }
 
@@ -117,23 +148,17 @@ void FieldFormula<spacedim, Value>::cache_update(FieldValueCache<typename Value:
 {
     unsigned int reg_chunk_begin = cache_map.region_chunk_begin(region_patch_idx);
     unsigned int reg_chunk_end = cache_map.region_chunk_end(region_patch_idx);
+    uint vec_size = CacheMapElementNumber::get();
 
-    for (unsigned int i=reg_chunk_begin; i<reg_chunk_end; ++i) {
-        res_[i] = 0.0;
-    }
-    for (auto it : eval_field_data_) {
-        // Copy data from dependent fields to arena. Temporary solution.
-        // TODO hold field data caches in arena, remove this step
-        auto value_cache = it.first->value_cache();
-        for (unsigned int i=reg_chunk_begin; i<reg_chunk_end; ++i) {
-            if (it.first->name() == "X") {
-                x_[i] = value_cache->template vec<3>(i)(0);
-                y_[i] = value_cache->template vec<3>(i)(1);
-                z_[i] = value_cache->template vec<3>(i)(2);
-            } else
-        	   it.second[i] = value_cache->data_[i];
-        }
-    }
+    // Caches of scalar and vector fields are read by BParser directly, tensors are transposed to row major order.
+    for (const TensorCopy &tc : tensor_copies_)
+        for (uint row=0; row<tc.n_rows; ++row)
+            for (uint col=0; col<tc.n_cols; ++col) {
+                const double *cache_comp = tc.cache_data + (col*tc.n_rows+row) * vec_size;
+                double *arena_comp = tc.arena_data + (row*tc.n_cols+col) * vec_size;
+                for (unsigned int i=reg_chunk_begin; i<reg_chunk_end; ++i)
+                    arena_comp[i] = cache_comp[i];
+            }
 
     // Get vector of subsets as subarray
     uint subsets_begin = reg_chunk_begin / cache_map.simd_size_double;
@@ -143,15 +168,15 @@ void FieldFormula<spacedim, Value>::cache_update(FieldValueCache<typename Value:
 
     b_parser_.set_subset(subset_vec);
     b_parser_.run();
-    uint vec_size = CacheMapElementNumber::get();
-    for(unsigned int row=0; row < this->value_.n_rows(); row++)
-        for(unsigned int col=0; col < this->value_.n_cols(); col++) {
-            uint comp_shift = (row*this->value_.n_cols()+col) * vec_size;
-            for (unsigned int i=reg_chunk_begin; i<reg_chunk_end; ++i) {
-                auto cache_val = data_cache.template mat<Value::NRows_, Value::NCols_>(i);
-                cache_val(row, col) = this->unit_conversion_coefficient_ * res_[i + comp_shift];
-                data_cache.set(i) = cache_val;
-            }
+
+    // Result of BParser is row major, FieldValueCache stores components in column major order.
+    const double coef = this->unit_conversion_coefficient_;
+    for(unsigned int row=0; row < Value::NRows_; row++)
+        for(unsigned int col=0; col < Value::NCols_; col++) {
+            const double *res_comp = res_ + (row*Value::NCols_+col) * vec_size;
+            typename Value::element_type *cache_comp = data_cache.data_ + (col*Value::NRows_+row) * vec_size;
+            for (unsigned int i=reg_chunk_begin; i<reg_chunk_end; ++i)
+                cache_comp[i] = coef * res_comp[i];
         }
 }
 
@@ -181,25 +206,16 @@ std::vector<const FieldCommon * > FieldFormula<spacedim, Value>::set_dependency(
     required_fields_.clear(); // returned value
 
     // set expression and data to BParser
-    try {
-        b_parser_.parse( formula_ );
-    } catch (std::exception const& e) {
-        if (typeid(e) == typeid(bparser::Exception))
-            THROW( ExcParserError() << EI_BParserMsg(e.what()) << EI_Formula(formula_) << Input::EI_Address( in_rec_.address_string() ) );
-        else throw;
-    }
-    std::vector<std::string> variables = b_parser_.free_symbols();
-    std::sort( variables.begin(), variables.end() );
-    variables.erase( std::unique( variables.begin(), variables.end() ), variables.end() );
+    std::vector<std::string> variables = this->parse_formula();
 
-    has_time_=false;
     sum_shape_sizes_=0; // scecifies size of arena
     for (auto var : variables) {
         if (var == "X" || var == "x" || var == "y" || var == "z") {
             required_fields_.push_back( field_set.field("X") );
-            sum_shape_sizes_ += spacedim;
         }
-        else if (var == "t") has_time_ = true;
+        else if (var == "t") {
+            // time is set as a constant of BParser in cache_reinit
+        }
         else {
             auto field_ptr = field_set.field(var);
             if (field_ptr != nullptr) required_fields_.push_back( field_ptr );
@@ -208,7 +224,7 @@ std::vector<const FieldCommon * > FieldFormula<spacedim, Value>::set_dependency(
             if (field_ptr->value_cache() == nullptr) THROW( ExcNotDoubleField() << EI_Field(var) << Input::EI_Address( in_rec_.address_string() ) );
             // TODO: Test the exception, report input line of the formula.
 
-            sum_shape_sizes_ += field_ptr->n_shape();
+            if (field_ptr->shape_.size() > 1) sum_shape_sizes_ += field_ptr->n_shape(); // tensors are copied to arena
             if (var == "d") {
                 field_set.set_surface_depth(this->surface_depth_);
             }
@@ -219,6 +235,19 @@ std::vector<const FieldCommon * > FieldFormula<spacedim, Value>::set_dependency(
 }
 
 
+template <int spacedim, class Value>
+std::string FieldFormula<spacedim, Value>::eval_signature() const
+{
+    std::stringstream ss;
+    ss << "FieldFormula<" << Value::NRows_ << "," << Value::NCols_ << ">:" << std::setprecision(17)
+       << this->unit_conversion_coefficient_ << ":";
+    if (has_time_) ss << this->time_.end();
+    ss << ":" << formula_ << ":";
+    for (auto field : required_fields_) ss << field << ",";
+    return ss.str();
+}
+
+
 template <int spacedim, class Value>
 void FieldFormula<spacedim, Value>::cache_reinit(FMT_UNUSED const ElementCacheMap &cache_map)
 {
@@ -227,7 +256,7 @@ void FieldFormula<spacedim, Value>::cache_reinit(FMT_UNUSED const ElementCacheMa
     if (arena_alloc_!=nullptr) {
         delete arena_alloc_;
     }
-    eval_field_data_.clear();
+    tensor_copies_.clear();
     uint vec_size = CacheMapElementNumber::get();
 
     // number of subset alignment to block size
@@ -236,33 +265,35 @@ void FieldFormula<spacedim, Value>::cache_reinit(FMT_UNUSED const ElementCacheMa
     uint n_vectors = sum_shape_sizes_ + res_comp; // needs add space of result vector
     arena_alloc_ = new bparser::ArenaAlloc(cache_map.simd_size_double, n_vectors * vec_size * sizeof(double) + n_subsets * sizeof(uint));
     res_ = arena_alloc_->create_array<double>(vec_size * res_comp);
-    for (auto field : required_fields_) {
-        std::string field_name = field->name();
-        eval_field_data_[field] = arena_alloc_->create_array<double>(field->n_shape() * vec_size);
-        if (field_name == "X") {
-            X_ = eval_field_data_[field] + 0;
-            x_ = eval_field_data_[field] + 0;
-            y_ = eval_field_data_[field] + vec_size;
-            z_ = eval_field_data_[field] + 2*vec_size;
-        }
-    }
     subsets_ = arena_alloc_->create_array<uint>(n_subsets);
 
-    // set expression and data to BParser
+    // set expression and data to BParser, value caches of dependent fields are shared with BParser
     if (has_time_) {
         b_parser_.set_constant("t",  {}, {this->time_.end()});
     }
     for (auto field : required_fields_) {
         std::string field_name = field->name();
+        const FieldValueCache<double> *value_cache = field->value_cache();
+        ASSERT_EQ(value_cache->size(), vec_size)(field_name);
+        // BParser only reads variables
+        double *cache_data = const_cast<double *>(value_cache->data_);
         if (field_name == "X") {
+            X_ = cache_data;
+            x_ = cache_data;
+            y_ = cache_data + vec_size;
+            z_ = cache_data + 2*vec_size;
             b_parser_.set_variable("X",  {3}, X_);
             b_parser_.set_variable("x",  {}, x_);
             b_parser_.set_variable("y",  {}, y_);
             b_parser_.set_variable("z",  {}, z_);
+        } else if (field->shape_.size() > 1) {
+            double *arena_data = arena_alloc_->create_array<double>(field->n_shape() * vec_size);
+            tensor_copies_.push_back( {cache_data, arena_data, field->shape_[0], field->shape_[1]} );
+            b_parser_.set_variable(field_name, field->shape_, arena_data);
         } else {
             std::vector<uint> f_shape = {};
             if (field->n_shape() > 1) f_shape = field->shape_;
-            b_parser_.set_variable(field_name, f_shape, eval_field_data_[field]);
+            b_parser_.set_variable(field_name, f_shape, cache_data);
         }
     }
     std::vector<uint> shape = {};
@@ -90,6 +90,10 @@ public:
 
     /**
      * For time dependent formulas returns always true. For time independent formulas returns true only for the first time.
+     *
+     * Formula is time independent if it contains neither time variable 't' nor other fields than coordinates and depth.
+     * Variables of the formula are known after the first call of set_dependency, formula is considered as time dependent
+     * before.
      */
     bool set_time(const TimeStep &time) override;
 
@@ -108,6 +112,17 @@ public:
      */
     std::vector<const FieldCommon *> set_dependency(FieldSet &field_set) override;
 
+    /// Implements FieldAlgorithmBase::is_cache_reusable, values depend on time (set in set_time) and dependent fields.
+    bool is_cache_reusable() const override {
+        return true;
+    }
+
+    /**
+     * Implements FieldAlgorithmBase::eval_signature, formulas with equal expression, shape, unit conversion
+     * and dependent fields compute equal values.
+     */
+    std::string eval_signature() const override;
+
     /**
      * Overload @p FieldAlgorithmBase::cache_reinit
      *
@@ -125,6 +140,13 @@ private:
      */
     inline arma::vec eval_depth_var(const Point &p);
 
+    /**
+     * Parse @p formula_ by BParser, set @p has_time_ and @p is_time_independent_.
+     *
+     * Return sorted vector of free variables of the formula.
+     */
+    std::vector<std::string> parse_formula();
+
     // formula expression, string is set to BParser
     std::string formula_;
 
@@ -143,7 +165,10 @@ private:
     /// Flag indicates if time variable 't' is used in formula - parameter of BParser
     bool has_time_;
 
-    /// Helper variable for construct of arena, holds sum of sizes (over shape) of all dependent fields.
+    /// Flag indicates that formula depends only on coordinates and depth, set in init_from_input
+    bool is_time_independent_;
+
+    /// Helper variable for construct of arena, holds sum of sizes (over shape) of all dependent tensor fields.
     uint sum_shape_sizes_;
 
     /// Arena object providing data arrays
@@ -160,11 +185,22 @@ private:
 	std::vector<const FieldCommon * > required_fields_;
 
 	/**
-	 * Data of fields evaluated in expressions.
+	 * Transposition of dependent tensor field from its FieldValueCache (column major components)
+	 * to the arena array of BParser (row major components).
+	 */
+	struct TensorCopy {
+	    const double *cache_data; ///< Data of the FieldValueCache
+	    double *arena_data;       ///< Array allocated in arena
+	    uint n_rows;              ///< Shape of the tensor
+	    uint n_cols;
+	};
+
+	/**
+	 * Dependent tensor fields, resolved in cache_reinit.
 	 *
-	 * Temporary data member, we need to copy data from FieldValueCaches to arrays allocated in arena.
+	 * Caches of scalar and vector fields are passed to BParser directly, only tensors need to be copied.
 	 */
-	std::unordered_map<const FieldCommon *, double *> eval_field_data_;
+	std::vector<TensorCopy> tensor_copies_;
 
     /// Registrar of class to factory
     static const int registrar;
@@ -25,6 +25,7 @@
 #include <vector>
 #include <utility>
 #include <type_traits>
+#include <typeinfo>
 
 #include "fields/field.hh"
 #include "fields/field_common.hh"
@@ -281,6 +282,33 @@ public:
     	}
     }
 
+    /**
+     * Implements FieldAlgoBase::is_cache_reusable.
+     *
+     * Only values of functor without data members depend only on input fields, functors with state
+     * (e.g. time governor of fn_fluid_source in HM_Iterative) are evaluated in every cache update.
+     */
+    bool is_cache_reusable() const override {
+        return std::is_empty<Fn>::value;
+    }
+
+    /**
+     * Implements FieldAlgoBase::eval_signature.
+     *
+     * Models of functor without data members compute equal values for equal input fields.
+     */
+    std::string eval_signature() const override {
+        if (!std::is_empty<Fn>::value) return FieldAlgorithmBase<spacedim, Value>::eval_signature();
+        std::string signature = std::string("FieldModel<") + typeid(Value).name() + "," + typeid(Fn).name() + ">:";
+        auto dep_fields = detail::get_dependency<
+                                decltype(input_fields),
+                                std::tuple_size<FieldsTuple>::value
+                            >::eval(input_fields);
+        for (auto field : dep_fields)
+            signature += std::to_string( reinterpret_cast<std::uintptr_t>(field) ) + ",";
+        return signature;
+    }
+
 };
 
 
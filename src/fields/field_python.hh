@@ -24,6 +24,7 @@
 #include "system/system.hh"
 #include "system/python_loader.hh"
 #include "fields/field_algo_base.hh"
+#include "fields/python_field_batch.hh"
 #include "mesh/point.hh"
 #include "input/factory.hh"
 
@@ -81,9 +82,29 @@ public:
      */
     void cache_reinit(const ElementCacheMap &cache_map) override;
 
+    /**
+     * Evaluate the field on the region chunk by method '_cache_update' of the user class, or add the chunk
+     * to the batch of the user class if the batch is set to the cache map (see PythonFieldBatch).
+     */
     void cache_update(FieldValueCache<typename Value::element_type> &data_cache,
 			ElementCacheMap &cache_map, unsigned int region_patch_idx) override;
 
+    /**
+     * Set time, returns true if the field is not declared as time independent by the user class
+     * (set 'time_independent_fields' of the class).
+     */
+    bool set_time(const TimeStep &time) override;
+
+    /// Implements FieldAlgorithmBase::is_cache_reusable, values of time independent fields are stored by FieldSet.
+    bool is_cache_reusable() const override {
+        return is_time_independent_;
+    }
+
+    /// Implements FieldAlgorithmBase::is_batch_evaluated, see PythonFieldBatch.
+    bool is_batch_evaluated() const override {
+        return true;
+    }
+
     /**
      * Returns list of fields on which this field depends.
      */
@@ -110,6 +131,9 @@ private:
     /// Pointer to FieldCommon that holds this fields (stores in set_dependency and uses in cache_reinit)
 	const FieldCommon * self_field_ptr_;
 
+    /// Flag indicates that values depend only on points and used fields, given by the user class.
+    bool is_time_independent_;
+
 };
 
 
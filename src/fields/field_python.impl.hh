@@ -65,7 +65,8 @@ const int FieldPython<spacedim, Value>::registrar =
 
 template <int spacedim, class Value>
 FieldPython<spacedim, Value>::FieldPython(unsigned int n_comp)
-: FieldAlgorithmBase<spacedim, Value>( n_comp)
+: FieldAlgorithmBase<spacedim, Value>( n_comp),
+  is_time_independent_(false)
 {
 	this->is_constant_in_space_ = false;
 }
@@ -84,11 +85,26 @@ void FieldPython<spacedim, Value>::init_from_input(const Input::Record &rec, con
         set_python_field_from_class( source_file, source_class );
     } INPUT_CATCH(FilePath::ExcFileOpen, FilePath::EI_Address_String, rec)
 
+    try {
+        py::gil_scoped_acquire gil;
+        is_time_independent_ = user_class_instance_.attr("_is_time_independent")(this->field_name_).template cast<bool>();
+    } catch (const py::error_already_set &ex) {
+        PythonLoader::throw_error(ex);
+    }
+
     in_rec_ = rec;
 }
 
 
 
+template <int spacedim, class Value>
+bool FieldPython<spacedim, Value>::set_time(const TimeStep &time) {
+    this->time_ = time;
+    return !is_time_independent_;
+}
+
+
+
 template <int spacedim, class Value>
 void FieldPython<spacedim, Value>::set_python_field_from_class(const string &file_name, const string &class_name)
 {
@@ -137,6 +153,7 @@ void FieldPython<spacedim, Value>::cache_reinit(FMT_UNUSED const ElementCacheMap
     double * cache_data = self_field_ptr_->value_cache()->data_;
     FieldCacheProxy result_data(this->field_name_, self_field_ptr_->shape_, cache_data, (CacheMapElementNumber::get()*self_field_ptr_->n_shape()));
 
+    py::gil_scoped_acquire gil;
     try {
         py::object p_func = user_class_instance_.attr("_cache_reinit");
         p_func(this->time_.end(), field_data, result_data);
@@ -153,6 +170,12 @@ void FieldPython<spacedim, Value>::cache_update(FMT_UNUSED FieldValueCache<typen
 {
     unsigned int reg_chunk_begin = cache_map.region_chunk_begin(region_patch_idx);
     unsigned int reg_chunk_end = cache_map.region_chunk_end(region_patch_idx);
+    if (cache_map.python_batch() != nullptr) {
+        cache_map.python_batch()->add(user_class_instance_, this->field_name_, reg_chunk_begin, reg_chunk_end, this->time_.end());
+        return;
+    }
+
+    py::gil_scoped_acquire gil;
     try {
         py::object p_func = user_class_instance_.attr("_cache_update");
         p_func(this->field_name_, reg_chunk_begin, reg_chunk_end);
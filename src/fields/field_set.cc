@@ -16,6 +16,7 @@
  */
 
 #include "fields/field_set.hh"
+#include "fields/python_field_batch.hh"
 #include "system/sys_profiler.hh"
 #include "input/flow_attribute_lib.hh"
 #include "fem/mapping_p1.hh"
@@ -23,6 +24,7 @@
 #include "tools/bidirectional_map.hh"
 #include "tools/unit_converter.hh"
 #include <boost/algorithm/string/replace.hpp>
+#include <algorithm>
 #include <queue>
 
 
@@ -219,15 +221,148 @@ bool FieldSet::is_jump_time() const {
 
 void FieldSet::cache_update(ElementCacheMap &cache_map) {
     ASSERT_GT(region_field_update_order_.size(), 0).error("Variable 'region_dependency_list' is empty. Did you call 'set_dependency' method?\n");
+    bool store_values = (cache_map.patch_field_values() != nullptr);
+    if (store_values) step_versions_.resize(cache_map.n_regions());
+    pending_stores_.clear();
+
+    // fields independent on batch evaluated fields, batch evaluated fields are postponed to own batch
+    // of this update, the batch of an outer update (if any) is restored after the loop
+    PythonFieldBatch python_batch;
+    PythonFieldBatch *outer_batch = cache_map.python_batch();
+    cache_map.set_python_batch(&python_batch);
     for (unsigned int i_reg_patch=0; i_reg_patch<cache_map.n_regions(); ++i_reg_patch) {
-        for (const FieldCommon *field : region_field_update_order_[cache_map.region_idx_from_chunk_position(i_reg_patch)])
-            field->cache_update(cache_map, i_reg_patch);
+        unsigned int region_idx = cache_map.region_idx_from_chunk_position(i_reg_patch);
+        std::vector<EvalStep> &plan = region_eval_plans_[region_idx];
+        for (EvalStep &step : plan)
+            if (step.source_step != undef_idx) this->check_eval_source(step, plan, region_idx);
+        if (store_values) step_versions_[i_reg_patch].assign(plan.size(), undef_idx);
+        for (unsigned int i_step=0; i_step<plan.size(); ++i_step)
+            if (!plan[i_step].after_batch) this->eval_step(plan, i_step, cache_map, i_reg_patch, region_idx);
+    }
+    cache_map.set_python_batch(outer_batch);
+    python_batch.close();
+    for (const PendingStore &pending : pending_stores_)
+        this->store_values(pending.field, cache_map, pending.i_reg_patch, pending.version);
+
+    // fields depending on batch evaluated fields
+    for (unsigned int i_reg_patch=0; i_reg_patch<cache_map.n_regions(); ++i_reg_patch) {
+        unsigned int region_idx = cache_map.region_idx_from_chunk_position(i_reg_patch);
+        const std::vector<EvalStep> &plan = region_eval_plans_[region_idx];
+        for (unsigned int i_step=0; i_step<plan.size(); ++i_step)
+            if (plan[i_step].after_batch) this->eval_step(plan, i_step, cache_map, i_reg_patch, region_idx);
+    }
+}
+
+
+void FieldSet::eval_step(const std::vector<EvalStep> &plan, unsigned int i_step, ElementCacheMap &cache_map,
+        unsigned int i_reg_patch, unsigned int region_idx) {
+    const EvalStep &step = plan[i_step];
+    if (cache_map.patch_field_values() != nullptr)
+        this->cache_update_stored(plan, i_step, cache_map, i_reg_patch, region_idx, step_versions_[i_reg_patch]);
+    else if (step.copy_source)
+        this->copy_cache_chunk(plan[step.source_step].field, step.field, cache_map, i_reg_patch);
+    else
+        step.field->cache_update(cache_map, i_reg_patch);
+}
+
+
+void FieldSet::cache_update_stored(const std::vector<EvalStep> &plan, unsigned int i_step, ElementCacheMap &cache_map,
+        unsigned int i_reg_patch, unsigned int region_idx, std::vector<unsigned int> &step_versions) {
+    const EvalStep &step = plan[i_step];
+    const FieldCommon *field = step.field;
+    if (step.copy_source) {
+        this->copy_cache_chunk(plan[step.source_step].field, field, cache_map, i_reg_patch);
+        if (step_versions[step.source_step] != undef_idx)
+            step_versions[i_step] = step_versions[step.source_step] + field->n_changes();
+        return;
+    }
+
+    // Version of field sums its changes and versions of dependencies, so it grows with every change of any of them.
+    bool is_reusable = field->is_cache_reusable(region_idx);
+    unsigned int version = field->n_changes();
+    if (is_reusable) {
+        for (unsigned int dep_step : step.dep_steps) {
+            if ( (dep_step == undef_idx) || (step_versions[dep_step] == undef_idx) ) {
+                is_reusable = false;
+                break;
+            }
+            version += step_versions[dep_step];
+        }
+    }
+    if (!is_reusable) {
+        field->cache_update(cache_map, i_reg_patch);
+        return;
+    }
+    step_versions[i_step] = version;
+
+    // Values of components are stored in blocks of size of cache, stored values hold only region chunk of every block.
+    const FieldValueCache<double> *value_cache = field->value_cache();
+    unsigned int n_comp = value_cache->n_rows() * value_cache->n_cols();
+    unsigned int block_size = value_cache->size();
+    unsigned int chunk_begin = cache_map.region_chunk_begin(i_reg_patch);
+    unsigned int chunk_size = cache_map.region_chunk_end(i_reg_patch) - chunk_begin;
+    ElementCacheMap::StoredFieldValues &stored = (*cache_map.patch_field_values())[ std::make_pair(field, i_reg_patch) ];
+    if ( (stored.values_.size() == n_comp * chunk_size) && (stored.version_ == version) ) {
+        for (unsigned int i_comp=0; i_comp<n_comp; ++i_comp)
+            std::copy(stored.values_.begin() + i_comp*chunk_size, stored.values_.begin() + (i_comp+1)*chunk_size,
+                    value_cache->data_ + i_comp*block_size + chunk_begin);
+    } else {
+        field->cache_update(cache_map, i_reg_patch);
+        // values of postponed field are known after the batch
+        if (step.in_batch) pending_stores_.push_back( {field, i_reg_patch, version} );
+        else this->store_values(field, cache_map, i_reg_patch, version);
+    }
+}
+
+
+void FieldSet::store_values(const FieldCommon *field, ElementCacheMap &cache_map, unsigned int i_reg_patch, unsigned int version) {
+    const FieldValueCache<double> *value_cache = field->value_cache();
+    unsigned int n_comp = value_cache->n_rows() * value_cache->n_cols();
+    unsigned int block_size = value_cache->size();
+    unsigned int chunk_begin = cache_map.region_chunk_begin(i_reg_patch);
+    unsigned int chunk_size = cache_map.region_chunk_end(i_reg_patch) - chunk_begin;
+    ElementCacheMap::StoredFieldValues &stored = (*cache_map.patch_field_values())[ std::make_pair(field, i_reg_patch) ];
+    stored.version_ = version;
+    stored.values_.resize(n_comp * chunk_size);
+    for (unsigned int i_comp=0; i_comp<n_comp; ++i_comp) {
+        const double *block_begin = value_cache->data_ + i_comp*block_size + chunk_begin;
+        std::copy(block_begin, block_begin + chunk_size, stored.values_.begin() + i_comp*chunk_size);
+    }
+}
+
+
+void FieldSet::copy_cache_chunk(const FieldCommon *source, const FieldCommon *target, ElementCacheMap &cache_map, unsigned int i_reg_patch) {
+    const FieldValueCache<double> *source_cache = source->value_cache();
+    const FieldValueCache<double> *target_cache = target->value_cache();
+    unsigned int n_comp = source_cache->n_rows() * source_cache->n_cols();
+    unsigned int chunk_begin = cache_map.region_chunk_begin(i_reg_patch);
+    unsigned int chunk_end = cache_map.region_chunk_end(i_reg_patch);
+    for (unsigned int i_comp=0; i_comp<n_comp; ++i_comp) {
+        const double *source_block = source_cache->data_ + i_comp*source_cache->size();
+        std::copy(source_block + chunk_begin, source_block + chunk_end, target_cache->data_ + i_comp*target_cache->size() + chunk_begin);
     }
 }
 
 
 void FieldSet::set_dependency(FieldSet &used_fieldset) {
+    std::vector<const FieldCommon *> used_field_list;
+    for (FieldListAccessor f_acc : used_fieldset.fields_range()) used_field_list.push_back(f_acc.field());
+    if (this->plans_valid(used_field_list)) return;
+
+    // actual plans of other used field set are cached, plans of used_fieldset are taken from the cache
+    if (!plans_used_fields_.empty() && plans_used_fields_ != used_field_list) {
+        unsigned int i_cache = 0;
+        while (i_cache < cached_plans_.size() && cached_plans_[i_cache].used_fields != used_field_list) ++i_cache;
+        if (i_cache == cached_plans_.size()) cached_plans_.emplace_back();
+        this->swap_plans(cached_plans_[i_cache]);
+        if (this->plans_valid(used_field_list)) return;
+    }
+
+    START_TIMER("FieldSet::set_dependency");
     region_field_update_order_.clear();
+    region_field_dependencies_.clear();
+    region_eval_plans_.clear();
+    plans_algorithms_.clear();
     std::unordered_set<const FieldCommon *> used_fields;
 
     for (unsigned int i_reg=0; i_reg<mesh_->region_db().size(); ++i_reg) {
@@ -235,7 +370,88 @@ void FieldSet::set_dependency(FieldSet &used_fieldset) {
             topological_sort( f_acc.field(), i_reg, used_fields );
         }
         used_fields.clear();
+        this->create_eval_plan(i_reg);
     }
+
+    for (auto &reg_it : region_field_update_order_)
+        for (const FieldCommon *field : reg_it.second)
+            plans_algorithms_.push_back( {reg_it.first, field, field->region_algorithm(reg_it.first)} );
+    plans_used_fields_ = used_field_list;
+}
+
+
+bool FieldSet::plans_valid(const std::vector<const FieldCommon *> &used_fields) const {
+    if (region_field_update_order_.empty() || plans_used_fields_ != used_fields) return false;
+    for (const PlannedAlgorithm &planned : plans_algorithms_)
+        if (planned.field->region_algorithm(planned.region_idx) != planned.algorithm) return false;
+    return true;
+}
+
+
+void FieldSet::swap_plans(CachedPlans &cached) {
+    std::swap(plans_used_fields_, cached.used_fields);
+    std::swap(plans_algorithms_, cached.algorithms);
+    std::swap(region_field_update_order_, cached.update_order);
+    std::swap(region_field_dependencies_, cached.dependencies);
+    std::swap(region_eval_plans_, cached.eval_plans);
+}
+
+
+void FieldSet::create_eval_plan(unsigned int i_reg) {
+    auto order_it = region_field_update_order_.find(i_reg);
+    if (order_it == region_field_update_order_.end()) return;
+    const std::vector<const FieldCommon *> &update_order = order_it->second;
+    std::vector<EvalStep> &plan = region_eval_plans_[i_reg];
+    plan.resize(update_order.size());
+
+    std::unordered_map<const FieldCommon *, unsigned int> field_steps;
+    std::unordered_map<std::string, unsigned int> signature_steps;
+    for (unsigned int i_step=0; i_step<update_order.size(); ++i_step) {
+        EvalStep &step = plan[i_step];
+        step.field = update_order[i_step];
+        field_steps[step.field] = i_step;
+        for (const FieldCommon *dep_field : region_field_dependencies_[i_reg][step.field]) {
+            auto dep_it = field_steps.find(dep_field);
+            step.dep_steps.push_back( (dep_it == field_steps.end()) ? undef_idx : dep_it->second );
+        }
+
+        // The first field with given signature is evaluated, next fields are copied from it.
+        step.source_step = undef_idx;
+        step.copy_source = false;
+        std::string signature = step.field->eval_signature(i_reg);
+        if (!signature.empty()) {
+            auto it = signature_steps.find(signature);
+            if (it == signature_steps.end()) {
+                signature_steps[signature] = i_step;
+            } else {
+                const FieldValueCache<double> *source_cache = plan[it->second].field->value_cache();
+                const FieldValueCache<double> *value_cache = step.field->value_cache();
+                if ( (source_cache->n_rows() == value_cache->n_rows()) && (source_cache->n_cols() == value_cache->n_cols()) ) {
+                    step.source_step = it->second;
+                    step.checked_changes = step.field->n_changes() + plan[it->second].field->n_changes();
+                    step.copy_source = true;
+                }
+            }
+        }
+
+        // Steps using results of the batch are evaluated after it.
+        step.after_batch = false;
+        for (unsigned int dep_step : step.dep_steps)
+            if ( (dep_step != undef_idx) && (plan[dep_step].in_batch || plan[dep_step].after_batch) ) step.after_batch = true;
+        if ( (step.source_step != undef_idx) && (plan[step.source_step].in_batch || plan[step.source_step].after_batch) )
+            step.after_batch = true;
+        step.in_batch = !step.after_batch && step.field->is_batch_evaluated(i_reg);
+    }
+}
+
+
+void FieldSet::check_eval_source(EvalStep &step, const std::vector<EvalStep> &plan, unsigned int region_idx) {
+    const FieldCommon *source = plan[step.source_step].field;
+    unsigned int changes = step.field->n_changes() + source->n_changes();
+    if (changes == step.checked_changes) return;
+    std::string signature = step.field->eval_signature(region_idx);
+    step.copy_source = !signature.empty() && (signature == source->eval_signature(region_idx));
+    step.checked_changes = changes;
 }
 
 
@@ -247,6 +463,7 @@ void FieldSet::topological_sort(const FieldCommon *f, unsigned int i_reg, std::u
         topological_sort(f_dep, i_reg, used_fields);
     }
     region_field_update_order_[i_reg].push_back(f);
+    region_field_dependencies_[i_reg][f] = dep_vec;
 }
 
 
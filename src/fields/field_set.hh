@@ -20,6 +20,7 @@
 
 
 #include <iosfwd>                  // for ostream
+#include <limits>                  // for numeric_limits
 #include <string>                  // for string
 #include <vector>                  // for vector
 #include "fields/field_common.hh"  // for FieldCommon, FieldCommon::EI_Field
@@ -365,11 +366,29 @@ public:
 
     /**
      * Collective interface to @p FieldCommon::cache_update().
+     *
+     * Fields are evaluated by the evaluation plan of the region (see @p set_dependency). Fields with equal
+     * values (see FieldCommon::eval_signature) are evaluated only once, the other fields copy the values.
+     *
+     * Evaluation of fields given in batches (see FieldCommon::is_batch_evaluated, FieldPython) is postponed
+     * and performed at once for all regions of the patch, fields that depend on them are evaluated after
+     * the batch.
+     *
+     * If the cache map provides storage of field values of the patch (patch repeated by GenericAssembly), values
+     * of fields that did not change since the previous update of the patch are copied from the storage and are not
+     * evaluated. Field values are reused if the field and all its dependencies are reusable on the region
+     * (see FieldCommon::is_cache_reusable) and neither of them changed (see FieldCommon::n_changes).
      */
     void cache_update(ElementCacheMap &cache_map);
 
     /**
      * Set reference of FieldSet to all instances of FieldFormula.
+     *
+     * Sort fields by dependency and create evaluation plans of all regions.
+     *
+     * Method is called by every assembly (see cache_reallocate), so plans are cached for each
+     * @p used_fieldset and rebuilt only if some planned field changed its region algorithm
+     * (see FieldCommon::region_algorithm).
      */
     void set_dependency(FieldSet &used_fieldset);
 
@@ -411,10 +430,86 @@ public:
 
 
 protected:
+    /// Marks step without source step and not reusable values of the step.
+    static constexpr unsigned int undef_idx = std::numeric_limits<unsigned int>::max();
+
+    /**
+     * Step of the evaluation plan of the region: evaluation of one field.
+     *
+     * Plan holds fields in the order of dependencies with positions of dependent fields resolved.
+     * Step may have a source, a preceding step with equal eval_signature, values of the step are
+     * then copied from the source. The equality is checked again if the field or its source change.
+     *
+     * Steps of batch evaluated fields are postponed, steps depending on them (or copying them) are
+     * evaluated after the batch.
+     */
+    struct EvalStep {
+        const FieldCommon *field;               ///< Evaluated field
+        std::vector<unsigned int> dep_steps;    ///< Steps of fields the field depends on
+        unsigned int source_step;               ///< Step with equal values, undef_idx if not exists
+        unsigned int checked_changes;           ///< n_changes of field and source at last check of signatures
+        bool copy_source;                       ///< Values are copied from the source step
+        bool in_batch;                          ///< Evaluation of the field is postponed to the batch
+        bool after_batch;                       ///< Step depends on result of the batch
+    };
+
+    /// Values of the batch evaluated field that are stored after evaluation of the batch.
+    struct PendingStore {
+        const FieldCommon *field;
+        unsigned int i_reg_patch;
+        unsigned int version;
+    };
+
+    /// Region algorithm (see FieldCommon::region_algorithm) of the field used in evaluation plans.
+    struct PlannedAlgorithm {
+        unsigned int region_idx;
+        const FieldCommon *field;
+        const void *algorithm;
+    };
+
+    /// Evaluation plans and dependency data of one used field set, see set_dependency.
+    struct CachedPlans {
+        std::vector<const FieldCommon *> used_fields;
+        std::vector<PlannedAlgorithm> algorithms;
+        std::map<unsigned int, std::vector<const FieldCommon *>> update_order;
+        std::map<unsigned int, std::unordered_map<const FieldCommon *, std::vector<const FieldCommon *>>> dependencies;
+        std::map<unsigned int, std::vector<EvalStep>> eval_plans;
+    };
+
+    /// Create evaluation plan of the region from sorted fields, find steps with equal values.
+    void create_eval_plan(unsigned int i_reg);
+
+    /// Return true if actual evaluation plans were created for given used fields and algorithms of fields did not change.
+    bool plans_valid(const std::vector<const FieldCommon *> &used_fields) const;
+
+    /// Exchange actual evaluation plans (and dependency data) with the cached plans @p cached.
+    void swap_plans(CachedPlans &cached);
+
+    /// Check that the step has still equal values with its source (signatures are compared only after changes).
+    void check_eval_source(EvalStep &step, const std::vector<EvalStep> &plan, unsigned int region_idx);
+
+    /// Evaluate step @p i_step of the @p plan of region chunk @p i_reg_patch.
+    void eval_step(const std::vector<EvalStep> &plan, unsigned int i_step, ElementCacheMap &cache_map,
+            unsigned int i_reg_patch, unsigned int region_idx);
+
+    /// Copy values of region chunk @p i_reg_patch of @p field to the storage of patch values with given @p version.
+    void store_values(const FieldCommon *field, ElementCacheMap &cache_map, unsigned int i_reg_patch, unsigned int version);
+
+    /// Copy values of region chunk @p i_reg_patch from cache of @p source to cache of @p target.
+    void copy_cache_chunk(const FieldCommon *source, const FieldCommon *target, ElementCacheMap &cache_map, unsigned int i_reg_patch);
 
     /// Helper method sort used fields by dependency
     void topological_sort(const FieldCommon *f, unsigned int i_reg, std::unordered_set<const FieldCommon *> &used_fields);
 
+    /**
+     * Update cache of field of step @p i_step on region chunk @p i_reg_patch or copy stored values if the field is reusable.
+     *
+     * Versions (see ElementCacheMap::StoredFieldValues) of reusable fields are set to @p step_versions,
+     * version undef_idx marks fields not reusable on the region.
+     */
+    void cache_update_stored(const std::vector<EvalStep> &plan, unsigned int i_step, ElementCacheMap &cache_map,
+            unsigned int i_reg_patch, unsigned int region_idx, std::vector<unsigned int> &step_versions);
+
     /// List of all fields.
     std::vector<FieldCommon *> field_list;
 
@@ -429,6 +524,27 @@ protected:
      */
     std::map<unsigned int, std::vector<const FieldCommon *>> region_field_update_order_;
 
+    /// Holds fields that every used field depends on (result of FieldCommon::set_dependency) for every region.
+    std::map<unsigned int, std::unordered_map<const FieldCommon *, std::vector<const FieldCommon *>>> region_field_dependencies_;
+
+    /// Evaluation plans of regions, see EvalStep.
+    std::map<unsigned int, std::vector<EvalStep>> region_eval_plans_;
+
+    /// Fields of used field set of actual evaluation plans.
+    std::vector<const FieldCommon *> plans_used_fields_;
+
+    /// Region algorithms of all planned fields at the time of creation of actual evaluation plans.
+    std::vector<PlannedAlgorithm> plans_algorithms_;
+
+    /// Evaluation plans of other used field sets, exchanged with the actual plans in set_dependency.
+    std::vector<CachedPlans> cached_plans_;
+
+    /// Versions of steps of all region chunks of the patch, helper data member of cache_update.
+    std::vector< std::vector<unsigned int> > step_versions_;
+
+    /// Values of batch evaluated fields to store after the batch, helper data member of cache_update.
+    std::vector<PendingStore> pending_stores_;
+
     // Default fields.
     // TODO derive from Field<>, make public, rename
 
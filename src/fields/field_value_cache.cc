@@ -38,7 +38,8 @@ ElementCacheMap::ElementCacheMap()
 : simd_size_double(bparser::get_simd_size()), elm_idx_(CacheMapElementNumber::get(), ElementCacheMap::undef_elem_idx),
   ready_to_reading_(false), element_eval_points_map_(nullptr), eval_point_data_(0),
   regions_starts_(2*ElementCacheMap::regions_in_chunk,ElementCacheMap::regions_in_chunk),
-  element_starts_(2*ElementCacheMap::elements_in_chunk,ElementCacheMap::elements_in_chunk) {}
+  element_starts_(2*ElementCacheMap::elements_in_chunk,ElementCacheMap::elements_in_chunk),
+  patch_field_values_(nullptr), python_batch_(nullptr) {}
 
 
 ElementCacheMap::~ElementCacheMap() {
@@ -116,6 +117,46 @@ void ElementCacheMap::create_patch() {
 }
 
 
+void ElementCacheMap::save_patch_layout(PatchLayout &layout) {
+    layout.eval_point_data_.assign(eval_point_data_.begin(), eval_point_data_.end());
+    layout.regions_starts_.assign(regions_starts_.begin(), regions_starts_.end());
+    layout.element_starts_.assign(element_starts_.begin(), element_starts_.end());
+    layout.element_to_map_.swap(element_to_map_);
+    layout.element_to_map_bdr_.swap(element_to_map_bdr_);
+}
+
+
+void ElementCacheMap::restore_patch_layout(PatchLayout &layout) {
+    eval_point_data_.assign(layout.eval_point_data_.begin(), layout.eval_point_data_.end());
+    regions_starts_.assign(layout.regions_starts_.begin(), layout.regions_starts_.end());
+    element_starts_.assign(layout.element_starts_.begin(), layout.element_starts_.end());
+    element_to_map_.swap(layout.element_to_map_);
+    element_to_map_bdr_.swap(layout.element_to_map_bdr_);
+    patch_field_values_ = &layout.field_values_;
+
+    // Fill element indices and map of eval points
+    std::fill(elm_idx_.begin(), elm_idx_.end(), ElementCacheMap::undef_elem_idx);
+    for (unsigned int i_elm=0; i_elm<n_elements(); ++i_elm) {
+        unsigned int i_begin = element_starts_[i_elm], i_end = element_starts_[i_elm+1];
+        elm_idx_[i_elm] = eval_point_data_[i_begin].i_element_;
+        for (unsigned int i_pos=i_begin; i_pos<i_end; ++i_pos) {
+            // SIMD padding duplicates the last point of region, map holds the first position (same as create_patch)
+            const EvalPointData &point = eval_point_data_[i_pos];
+            if (element_eval_point(i_elm, point.i_eval_point_) == ElementCacheMap::unused_point)
+                set_element_eval_point(i_elm, point.i_eval_point_, i_pos);
+        }
+    }
+    set_of_regions_.clear();
+}
+
+
+void ElementCacheMap::release_patch_layout(PatchLayout &layout) {
+    layout.element_to_map_.swap(element_to_map_);
+    layout.element_to_map_bdr_.swap(element_to_map_bdr_);
+    patch_field_values_ = nullptr;
+}
+
+
 void ElementCacheMap::start_elements_update() {
 	ready_to_reading_ = false;
 }
@@ -19,6 +19,7 @@
 #ifndef FIELD_VALUE_CACHE_HH_
 #define FIELD_VALUE_CACHE_HH_
 
+#include <map>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -32,6 +33,8 @@
 
 class EvalPoints;
 class ElementCacheMap;
+class FieldCommon;
+class PythonFieldBatch;
 class DHCellAccessor;
 class DHCellSide;
 template < template<IntDim...> class DimAssembly> class GenericAssembly;
@@ -151,6 +154,30 @@ private:
  */
 class ElementCacheMap {
 public:
+    /// Values of a field on one region chunk of the patch stored for reuse in following assemblies (see FieldSet::cache_update).
+    struct StoredFieldValues {
+        unsigned int version_;        ///< Sum of numbers of changes of the field and of its dependencies (see FieldCommon::n_changes)
+        std::vector<double> values_;  ///< Values of the region chunk, stored component by component
+    };
+
+    /// Stored values of fields on the patch, indexed by field and by index of region chunk in patch.
+    typedef std::map<std::pair<const FieldCommon *, unsigned int>, StoredFieldValues> PatchFieldValues;
+
+    /**
+     * Layout of one patch created by create_patch: sorted and SIMD padded eval points, region and element chunks.
+     *
+     * Stored by save_patch_layout and used by restore_patch_layout to repeat the same patch without sorting
+     * of eval points and without filling of the element maps (see GenericAssembly patch plans).
+     */
+    struct PatchLayout {
+        std::vector<EvalPointData> eval_point_data_;                        ///< Eval points in cache order
+        std::vector<unsigned int> regions_starts_;                          ///< Start positions of regions
+        std::vector<unsigned int> element_starts_;                          ///< Start positions of elements
+        std::unordered_map<unsigned int, unsigned int> element_to_map_;     ///< Maps bulk element_idx to element index in patch
+        std::unordered_map<unsigned int, unsigned int> element_to_map_bdr_; ///< Maps boundary element_idx to element index in patch
+        PatchFieldValues field_values_;                                     ///< Values of fields reused in following assemblies
+    };
+
     /// Index of invalid element in cache.
     static const unsigned int undef_elem_idx;
 
@@ -166,6 +193,46 @@ public:
     /// Create patch of cached elements before reading data to cache.
     void create_patch();
 
+    /**
+     * Store layout of the actual patch into @p layout. Must be called after create_patch and before
+     * clear_element_eval_points_map. Maps of elements are moved to @p layout.
+     */
+    void save_patch_layout(PatchLayout &layout);
+
+    /**
+     * Set actual patch from the @p layout stored by save_patch_layout, replaces call of create_patch.
+     *
+     * Maps of elements are moved from the @p layout, they have to be returned by release_patch_layout
+     * after the patch is processed.
+     */
+    void restore_patch_layout(PatchLayout &layout);
+
+    /// Return maps of elements to the @p layout, called after processing of patch set by restore_patch_layout.
+    void release_patch_layout(PatchLayout &layout);
+
+    /**
+     * Set storage of field values of the actual patch. Storage is set automatically by restore_patch_layout
+     * and unset by release_patch_layout. Storage has to be unset (set to nullptr) if the patch is not repeated.
+     */
+    inline void set_patch_field_values(PatchFieldValues *field_values) {
+        patch_field_values_ = field_values;
+    }
+
+    /// Return storage of field values of the actual patch or nullptr if the patch is not stored.
+    inline PatchFieldValues *patch_field_values() const {
+        return patch_field_values_;
+    }
+
+    /// Set batch of postponed FieldPython evaluations of the actual update (see FieldSet::cache_update), or nullptr.
+    inline void set_python_batch(PythonFieldBatch *python_batch) {
+        python_batch_ = python_batch;
+    }
+
+    /// Return batch of postponed FieldPython evaluations or nullptr if fields are evaluated immediately.
+    inline PythonFieldBatch *python_batch() const {
+        return python_batch_;
+    }
+
     /// Reset all items of elements_eval_points_map
     inline void clear_element_eval_points_map() {
         ASSERT_PTR(element_eval_points_map_);
@@ -366,6 +433,12 @@ protected:
     /// Keeps set of unique region indices of added eval. points.
     std::unordered_set<unsigned int> set_of_regions_;
 
+    /// Storage of field values of the actual patch, see set_patch_field_values.
+    PatchFieldValues *patch_field_values_;
+
+    /// Batch of postponed FieldPython evaluations, see set_python_batch.
+    PythonFieldBatch *python_batch_;
+
     // TODO: remove friend class
     template < template<IntDim...> class DimAssembly>
     friend class GenericAssembly;
@@ -0,0 +1,77 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    python_field_batch.cc
+ * @brief   Batched evaluation of FieldPython fields.
+ */
+
+#include "fields/python_field_batch.hh"
+#include "system/python_loader.hh"
+#include "system/sys_profiler.hh"
+#include <pybind11/stl.h>
+
+
+PythonFieldBatch::~PythonFieldBatch()
+{
+    if (batches_.size() == 0) return;
+    py::gil_scoped_acquire gil;
+    batches_.clear();
+}
+
+
+void PythonFieldBatch::close()
+{
+    if (batches_.size() == 0) return;
+
+    START_TIMER("PythonFieldBatch::close");
+    py::gil_scoped_acquire gil;
+    try {
+        for (Batch &batch : batches_) {
+            py::object p_func = batch.user_class_instance_.attr("_cache_update_batch");
+            p_func(batch.time_, batch.requests_);
+        }
+    } catch (const py::error_already_set &ex) {
+        batches_.clear();
+        PythonLoader::throw_error(ex);
+    }
+    batches_.clear();
+}
+
+
+void PythonFieldBatch::add(const py::object &user_class_instance, const std::string &field_name,
+        unsigned int begin, unsigned int end, double time)
+{
+    // few user classes, linear search
+    Batch *batch = nullptr;
+    for (Batch &b : batches_)
+        if (b.user_class_instance_.is(user_class_instance)) {
+            batch = &b;
+            break;
+        }
+    if (batch == nullptr) {
+        py::gil_scoped_acquire gil;
+        batches_.push_back( {user_class_instance, time, {}} );
+        batch = &batches_.back();
+    }
+
+    // merge with the last request of the field if chunks are adjacent
+    for (auto it = batch->requests_.rbegin(); it != batch->requests_.rend(); ++it)
+        if (std::get<0>(*it) == field_name) {
+            if (std::get<2>(*it) == begin) {
+                std::get<2>(*it) = end;
+                return;
+            }
+            break;
+        }
+    batch->requests_.emplace_back(field_name, begin, end);
+}
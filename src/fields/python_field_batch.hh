@@ -0,0 +1,78 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    python_field_batch.hh
+ * @brief   Batched evaluation of FieldPython fields.
+ */
+
+#ifndef PYTHON_FIELD_BATCH_HH_
+#define PYTHON_FIELD_BATCH_HH_
+
+#include <string>
+#include <tuple>
+#include <vector>
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+// Pybind11 needs set visibility to hidden (see https://pybind11.readthedocs.io/en/stable/faq.html).
+#pragma GCC visibility push(hidden)
+
+/**
+ * @brief Batches of postponed evaluations of FieldPython.
+ *
+ * FieldSet::cache_update creates the batches of the evaluated patch and passes them to FieldPython
+ * through ElementCacheMap::python_batch. FieldPython::cache_update then only adds its region chunk
+ * to the batch of its user class. Closing of batches evaluates all requests of the user class by a single
+ * call of its method '_cache_update_batch', so the interpreter is entered once per user class and patch
+ * instead of once per field and region chunk. Adjacent chunks of the same field are merged.
+ *
+ * The state belongs to one FieldSet::cache_update, so nested updates of other field sets have their own batches.
+ * Python calls acquire GIL, so the evaluation can be called also from threads without the GIL.
+ */
+class PythonFieldBatch {
+public:
+    /// Constructor.
+    PythonFieldBatch() {}
+
+    /// Destructor, releases postponed requests if the batch was not closed (e.g. after exception).
+    ~PythonFieldBatch();
+
+    PythonFieldBatch(const PythonFieldBatch &) = delete;
+    PythonFieldBatch & operator=(const PythonFieldBatch &) = delete;
+
+    /// Evaluate postponed requests of all user classes.
+    void close();
+
+    /**
+     * Add request of evaluation of field @p field_name on region chunk <@p begin, @p end) at @p time
+     * to the batch of @p user_class_instance.
+     */
+    void add(const py::object &user_class_instance, const std::string &field_name,
+            unsigned int begin, unsigned int end, double time);
+
+private:
+    /// Postponed requests of one user class.
+    struct Batch {
+        py::object user_class_instance_;  ///< Instance of the user class
+        double time_;                     ///< Evaluated time
+        std::vector< std::tuple<std::string, unsigned int, unsigned int> > requests_; ///< (field name, chunk begin, chunk end)
+    };
+
+    /// Batches of user classes, cleared by close so no Python object outlives the interpreter.
+    std::vector<Batch> batches_;
+};
+
+#pragma GCC visibility pop
+
+#endif /* PYTHON_FIELD_BATCH_HH_ */
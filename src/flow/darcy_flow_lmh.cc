@@ -64,6 +64,7 @@
 #include "fields/field_constant.hh"
 
 #include "coupling/balance.hh"
+#include "io/checkpoint.hh"
 
 #include "intersection/mixed_mesh_intersections.hh"
 #include "intersection/intersection_local.hh"
@@ -693,7 +694,7 @@ void DarcyLMH::zero_time_step()
         END_TIMER("DarcyFlowMH::reconstruct_solution_from_schur");
     }
     //solution_output(T,right_limit); // data for time T in any case
-    output_data();
+    if (zero_step_output_) output_data();
 }
 
 //=============================================================================
@@ -776,6 +777,8 @@ bool DarcyLMH::zero_time_term(bool time_global) {
 
 void DarcyLMH::solve_nonlinear()
 {
+    // nonlinear iterations are not used for extrapolation of the initial guess
+    lin_sys_schur().start_time_step();
 
     assembly_linear_system();
     double residual_norm = lin_sys_schur().compute_residual();
@@ -876,6 +879,37 @@ void DarcyLMH::accept_time_step()
 }
 
 
+void DarcyLMH::save_state(CheckpointData &data, const std::string &prefix)
+{
+    EquationBase::save_state(data, prefix);
+    data.save(prefix + "/full_solution", eq_data_->full_solution);
+    data.save(prefix + "/p_edge_solution", eq_data_->p_edge_solution);
+    data.save(prefix + "/p_edge_solution_previous", eq_data_->p_edge_solution_previous);
+    data.save(prefix + "/p_edge_solution_previous_time", eq_data_->p_edge_solution_previous_time);
+    data.save(prefix + "/time_step", eq_data_->time_step_);
+}
+
+
+void DarcyLMH::load_state(const CheckpointData &data, const std::string &prefix)
+{
+    EquationBase::load_state(data, prefix);
+    data.load(prefix + "/full_solution", eq_data_->full_solution);
+    data.load(prefix + "/p_edge_solution", eq_data_->p_edge_solution);
+    data.load(prefix + "/p_edge_solution_previous", eq_data_->p_edge_solution_previous);
+    data.load(prefix + "/p_edge_solution_previous_time", eq_data_->p_edge_solution_previous_time);
+    data.load(prefix + "/time_step", eq_data_->time_step_);
+
+    // data of the restored time step have to be set in the next solved step
+    data_changed_ = true;
+}
+
+
+void DarcyLMH::get_output_streams(std::vector<std::shared_ptr<OutputTime>> &streams)
+{
+    streams.push_back( output_object->get_output_stream() );
+}
+
+
 void DarcyLMH::output_data() {
     START_TIMER("Darcy output data");
     
@@ -1273,6 +1307,8 @@ void DarcyLMH::assembly_linear_system() {
         lin_sys_schur().mat_zero_entries();
         lin_sys_schur().rhs_zero_entries();
         
+        // change of the time step changes scale of the time term, reused preconditioner would be poor
+        if (eq_data_->time_step_ != time_->dt()) lin_sys_schur().force_pc_rebuild();
         eq_data_->time_step_ = time_->dt();
 
         START_TIMER("DarcyLMH::assembly_steady_mh_matrix");
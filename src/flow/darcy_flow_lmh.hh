@@ -309,6 +309,15 @@ public:
 
     virtual double solved_time() override;
 
+    /// Store time governor, balance and solution vectors to the checkpoint.
+    void save_state(CheckpointData &data, const std::string &prefix) override;
+
+    /// Restore state stored by @p save_state.
+    void load_state(const CheckpointData &data, const std::string &prefix) override;
+
+    /// Add the output stream of the flow.
+    void get_output_streams(std::vector<std::shared_ptr<OutputTime>> &streams) override;
+
     inline EqFields &eq_fields() { return *eq_fields_; }
     inline EqData &eq_data() { return *eq_data_; }
 
@@ -133,6 +133,10 @@ public:
     /** \brief Calculate values for output.  **/
     void output();
 
+    /// Getter of the output stream.
+    inline std::shared_ptr<OutputTime> get_output_stream() const
+    { return output_stream; }
+
     //const OutputFields &get_output_fields() { return output_fields; }
 
 
@@ -27,6 +27,7 @@
 
 #include "la/schur.hh"
 #include "la/vector_mpi.hh"
+#include "io/checkpoint.hh"
 
 
 #include "tools/include_fadbad.hh" // for "fadbad.h", "badiff.h", "fadiff.h"
@@ -223,6 +224,7 @@ void RichardsLMH::assembly_linear_system()
         
         lin_sys_schur().start_add_assembly();
             
+        if (eq_data_->time_step_ != time_->dt()) lin_sys_schur().force_pc_rebuild();
         eq_data_->time_step_ = time_->dt();
         
         lin_sys_schur().mat_zero_entries();
@@ -252,6 +254,25 @@ void RichardsLMH::read_init_cond_asm() {
 }
 
 
+void RichardsLMH::save_state(CheckpointData &data, const std::string &prefix)
+{
+    DarcyLMH::save_state(data, prefix);
+    data.save(prefix + "/water_content", eq_fields_->water_content_ptr->vec());
+    data.save(prefix + "/water_content_previous_time", eq_data_->water_content_previous_time);
+    data.save(prefix + "/capacity", eq_data_->capacity);
+}
+
+
+void RichardsLMH::load_state(const CheckpointData &data, const std::string &prefix)
+{
+    DarcyLMH::load_state(data, prefix);
+    VectorMPI water_content_vec = eq_fields_->water_content_ptr->vec();
+    data.load(prefix + "/water_content", water_content_vec);
+    data.load(prefix + "/water_content_previous_time", eq_data_->water_content_previous_time);
+    data.load(prefix + "/capacity", eq_data_->capacity);
+}
+
+
 RichardsLMH::~RichardsLMH() {
     if (init_cond_postprocess_assembly_!=nullptr) {
         delete init_cond_postprocess_assembly_;
@@ -103,6 +103,12 @@ public:
     static const Input::Type::Record & get_input_type();
     
     void accept_time_step() override;
+
+    /// Store state of DarcyLMH, water content and capacity of the previous time step to the checkpoint.
+    void save_state(CheckpointData &data, const std::string &prefix) override;
+
+    /// Restore state stored by @p save_state.
+    void load_state(const CheckpointData &data, const std::string &prefix) override;
     
     virtual ~RichardsLMH() override;
 
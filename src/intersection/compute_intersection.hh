@@ -74,6 +74,10 @@ public:
      */
     ComputeIntersection(ElementAccessor<3> abscissa, ElementAccessor<3> triangle);
 	~ComputeIntersection();
+
+	/// Objects own their Plucker coordinates and products, copies are not allowed.
+	ComputeIntersection(const ComputeIntersection &) = delete;
+	ComputeIntersection &operator=(const ComputeIntersection &) = delete;
     
     /** @brief Computes intersection points of line and triangle.
      * 
@@ -250,6 +254,10 @@ public:
      */
     ComputeIntersection(ElementAccessor<3> triaA, ElementAccessor<3> triaB);
     ~ComputeIntersection();
+
+    /// Objects own their Plucker coordinates and products, copies are not allowed.
+    ComputeIntersection(const ComputeIntersection &) = delete;
+    ComputeIntersection &operator=(const ComputeIntersection &) = delete;
     
     /** @brief Initializes lower dimensional objects.
      * Sets correctly the pointers to Plucker coordinates and products.
@@ -353,6 +361,10 @@ public:
      */
     ComputeIntersection(ElementAccessor<3> abscissa, ElementAccessor<3> tetrahedron);
 	~ComputeIntersection();
+
+	/// Objects own their Plucker coordinates and products, copies are not allowed.
+	ComputeIntersection(const ComputeIntersection &) = delete;
+	ComputeIntersection &operator=(const ComputeIntersection &) = delete;
 	
     /** @brief Initializes lower dimensional objects.
      * Sets correctly the pointers to Plucker coordinates and products.
@@ -482,6 +494,10 @@ public:
     ComputeIntersection(ElementAccessor<3> triangle, ElementAccessor<3> tetrahedron);
     ~ComputeIntersection();
 
+    /// Objects own their Plucker coordinates and products, copies are not allowed.
+    ComputeIntersection(const ComputeIntersection &) = delete;
+    ComputeIntersection &operator=(const ComputeIntersection &) = delete;
+
     /** @brief Initializes lower dimensional objects.
      * Sets correctly the pointers to Plucker coordinates and products.
      */
@@ -6,6 +6,10 @@
  */
 
 #include <unordered_set>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
 #include <boost/functional/hash.hpp>
 
 #include "inspect_elements_algorithm.hh"
@@ -43,7 +47,9 @@ IntersectionAlgorithmBase<dimA,dimB>::IntersectionAlgorithmBase(Mesh* mesh)
 
 template<unsigned int dim>    
 InspectElementsAlgorithm<dim>::InspectElementsAlgorithm(Mesh* input_mesh)
-: IntersectionAlgorithmBase<dim,3>(input_mesh)
+: IntersectionAlgorithmBase<dim,3>(input_mesh),
+  n_threads_(1),
+  relevant_elements_(nullptr)
 {
 }
 
@@ -52,18 +58,42 @@ InspectElementsAlgorithm<dim>::~InspectElementsAlgorithm()
 {}
 
 
+template<unsigned int dim>
+void InspectElementsAlgorithm<dim>::set_n_threads(unsigned int n_threads)
+{
+    ASSERT_GT(n_threads, 0);
+    n_threads_ = n_threads;
+}
+
+
+template<unsigned int dim>
+void InspectElementsAlgorithm<dim>::set_relevant_elements(const std::vector<char> *relevant_elements)
+{
+    if (relevant_elements == nullptr || relevant_elements->empty()) relevant_elements_ = nullptr;
+    else {
+        ASSERT_EQ(relevant_elements->size(), mesh->n_elements());
+        relevant_elements_ = relevant_elements;
+    }
+}
+
     
 template<unsigned int dim>
 void InspectElementsAlgorithm<dim>::init()
 {
     START_TIMER("Intersection initialization");
-    last_slave_for_3D_elements.assign(mesh->n_elements(), undefined_elm_idx_);
     closed_elements.assign(mesh->n_elements(), false);
     intersection_list_.assign(mesh->n_elements(),std::vector<IntersectionAux<dim,3>>());
     n_intersections_ = 0;
     END_TIMER("Intersection initialization");
 }
 
+template<unsigned int dim>
+void InspectElementsAlgorithm<dim>::init_worker(WorkerData &wd)
+{
+    wd.last_slave_for_3D_elements.assign(mesh->n_elements(), undefined_elm_idx_);
+    wd.n_intersections_ = 0;
+}
+
 template<unsigned int dim>
 void InspectElementsAlgorithm<dim>::compute_bounding_boxes()
 {
@@ -89,9 +119,93 @@ void InspectElementsAlgorithm<dim>::compute_bounding_boxes()
     END_TIMER("Compute bounding boxes");
 }
 
+template<unsigned int dim>
+std::vector<std::vector<unsigned int>> InspectElementsAlgorithm<dim>::create_components() const
+{
+    START_TIMER("Create components");
+    std::vector<std::vector<unsigned int>> components;
+    std::vector<char> visited(mesh->n_elements(), false);
+    
+    // prolongation queue in the component mesh.
+    std::queue<unsigned int> queue;
+    
+    for (auto ele : mesh->elements_range()) {
+        if (ele->dim() != dim || visited[ele.idx()]) continue;
+        
+        // start component
+        std::vector<unsigned int> component;
+        bool relevant = false;
+        visited[ele.idx()] = true;
+        queue.push(ele.idx());
+        
+        while(!queue.empty()){
+            unsigned int ele_idx = queue.front();
+            queue.pop();
+            component.push_back(ele_idx);
+            relevant = relevant || is_relevant(ele_idx);
+            
+            const ElementAccessor<3> elm = mesh->element_accessor( ele_idx );
+            for(unsigned int sid=0; sid < elm->n_sides(); sid++) {
+                Edge edg = elm.side(sid)->edge();
+                for(uint j=0; j < edg.n_sides();j++) {
+                    uint neigh_idx = edg.side(j)->element().idx();
+                    if (! visited[neigh_idx]) {
+                        visited[neigh_idx] = true;
+                        queue.push(neigh_idx);
+                    }
+                }
+            }
+        }
+        
+        if (relevant) {
+            // elements are processed in the same order as by the serial algorithm
+            std::sort(component.begin(), component.end());
+            components.push_back(std::move(component));
+        }
+    }
+    
+    // large components first, gives better balance of threads
+    std::stable_sort(components.begin(), components.end(),
+            [](const std::vector<unsigned int> &a, const std::vector<unsigned int> &b) { return a.size() > b.size(); });
+    END_TIMER("Create components");
+    return components;
+}
+
+template<unsigned int dim>
+void InspectElementsAlgorithm<dim>::run_parallel(unsigned int n_units, std::function<void(unsigned int, WorkerData &)> fn)
+{
+    unsigned int n_workers = std::max(1u, std::min(n_threads_, n_units));
+    std::vector<WorkerData> workers(n_workers);
+    std::vector<std::exception_ptr> exceptions(n_workers);
+    std::atomic<unsigned int> next_unit(0);
+    
+    auto worker_fn = [&](unsigned int i_worker) {
+        try {
+            init_worker(workers[i_worker]);
+            for (unsigned int unit = next_unit++; unit < n_units; unit = next_unit++)
+                fn(unit, workers[i_worker]);
+        } catch (...) {
+            exceptions[i_worker] = std::current_exception();
+            next_unit = n_units; // stop other threads
+        }
+    };
+    
+    // the calling thread is the first worker
+    std::vector<std::thread> threads;
+    for (unsigned int i_worker=1; i_worker < n_workers; i_worker++)
+        threads.emplace_back(worker_fn, i_worker);
+    worker_fn(0);
+    for (std::thread &thread : threads) thread.join();
+    
+    for (std::exception_ptr &exc : exceptions)
+        if (exc) std::rethrow_exception(exc);
+    for (WorkerData &wd : workers) n_intersections_ += wd.n_intersections_;
+}
+
 template<unsigned int dim> 
 bool InspectElementsAlgorithm<dim>::compute_initial_CI(const ElementAccessor<3> &comp_ele,
-                                                       const ElementAccessor<3> &bulk_ele)
+                                                       const ElementAccessor<3> &bulk_ele,
+                                                       WorkerData &wd)
 {
     unsigned int component_ele_idx = comp_ele.idx(),
                  bulk_ele_idx = bulk_ele.idx();
@@ -103,11 +217,11 @@ bool InspectElementsAlgorithm<dim>::compute_initial_CI(const ElementAccessor<3>
     CI.compute(is);
     END_TIMER("Compute intersection");
     
-    last_slave_for_3D_elements[bulk_ele_idx] = component_ele_idx;
+    wd.last_slave_for_3D_elements[bulk_ele_idx] = component_ele_idx;
     
     if(is.points().size() > 0) {
         intersection_list_[component_ele_idx].push_back(is);
-        n_intersections_++;
+        wd.n_intersections_++;
         return true;
     }
     else return false;
@@ -147,119 +261,134 @@ void InspectElementsAlgorithm<dim>::compute_intersections(const BIHTree& bih)
     
     START_TIMER("Element iteration");
     
-    for (auto elm : mesh->elements_range()) {
-        unsigned int component_ele_idx = elm.idx();
-        
-        if (elm->dim() == dim &&                                // is component element
-            !closed_elements[component_ele_idx] &&                    // is not closed yet
-            bih.ele_bounding_box(component_ele_idx).intersect(bih.tree_box()))    // its bounding box intersects 3D mesh bounding box
-        {    
-            std::vector<unsigned int> searchedElements;
-            
-            START_TIMER("BIHtree find");
-            bih.find_bounding_box(bih.ele_bounding_box(component_ele_idx), searchedElements);
-            END_TIMER("BIHtree find");
+    // prolongation never leaves connected component of elements, so components are computed independently
+    std::vector<std::vector<unsigned int>> components = create_components();
+    run_parallel(components.size(), [this, &components, &bih](unsigned int i_comp, WorkerData &wd) {
+        for (unsigned int component_ele_idx : components[i_comp])
+            this->compute_element_intersections(mesh->element_accessor(component_ele_idx), bih, wd);
+    });
 
-            START_TIMER("Bounding box element iteration");
-            
-            // Go through all element which bounding box intersects the component element bounding box
-            for (std::vector<unsigned int>::iterator it = searchedElements.begin(); it!=searchedElements.end(); it++)
-            {
-                unsigned int bulk_ele_idx = *it;
-                ElementAccessor<3> ele_3D = mesh->element_accessor( bulk_ele_idx );
+    END_TIMER("Element iteration");
+    
+    MessageOut().fmt("{}D-3D: number of intersections = {}\n", dim, n_intersections_);
+    // DBG write which elements are closed
+//     for (auto ele : mesh->elements_range()) {
+//         DebugOut().fmt("Element[{}] closed: {}\n",ele.index(),(closed_elements[ele.index()] ? 1 : 0));
+//     }
+}
 
-                // if:
-                // check 3D only
-                // check with the last component element computed for the current 3D element
-                // intersection has not been computed already
-                if (ele_3D->dim() == 3 &&
-                    (last_slave_for_3D_elements[bulk_ele_idx] != component_ele_idx &&
-                     !intersection_exists(component_ele_idx,bulk_ele_idx) )
-                ) {
-                    
-                        // - find first intersection
-                        // - if found, prolongate and possibly fill both prolongation queues
-                        // do-while loop:
-                        // - empty prolongation queues:
-                        //      - empty bulk queue:
-                        //          - get a candidate from queue and compute CI
-                        //          - prolongate and possibly push new candidates into queues
-                        //          - repeat until bulk queue is empty
-                        //          - the component element is still the same whole time in here
-                        //
-                        //      - the component element might get fully covered by bulk elements
-                        //        and only then it can be closed
-                        //
-                        //      - pop next candidate from component queue:
-                        //          - the component element is now changed
-                        //          - compute CI
-                        //          - prolongate and possibly push new candidates into queues
-                        //
-                        // - repeat until both queues are empty
-                    
-                    bool found = compute_initial_CI(elm, ele_3D);
+template<unsigned int dim>
+void InspectElementsAlgorithm<dim>::compute_element_intersections(const ElementAccessor<3> &elm,
+                                                                  const BIHTree& bih,
+                                                                  WorkerData &wd)
+{
+    unsigned int component_ele_idx = elm.idx();
+    
+    if (!closed_elements[component_ele_idx] &&                    // is not closed yet
+        bih.ele_bounding_box(component_ele_idx).intersect(bih.tree_box()))    // its bounding box intersects 3D mesh bounding box
+    {    
+        std::vector<unsigned int> searchedElements;
+        
+        START_TIMER("BIHtree find");
+        bih.find_bounding_box(bih.ele_bounding_box(component_ele_idx), searchedElements);
+        END_TIMER("BIHtree find");
 
-                    // keep the index of the current component element that is being investigated
-                    unsigned int current_component_element_idx = component_ele_idx;
+        START_TIMER("Bounding box element iteration");
+        
+        // Go through all element which bounding box intersects the component element bounding box
+        for (std::vector<unsigned int>::iterator it = searchedElements.begin(); it!=searchedElements.end(); it++)
+        {
+            unsigned int bulk_ele_idx = *it;
+            ElementAccessor<3> ele_3D = mesh->element_accessor( bulk_ele_idx );
+
+            // if:
+            // check 3D only
+            // check with the last component element computed for the current 3D element
+            // intersection has not been computed already
+            if (ele_3D->dim() == 3 &&
+                (wd.last_slave_for_3D_elements[bulk_ele_idx] != component_ele_idx &&
+                 !intersection_exists(component_ele_idx,bulk_ele_idx) )
+            ) {
+                bool found = compute_initial_CI(elm, ele_3D, wd);
+                
+                if(found){
+                    prolongate_component(elm, ele_3D, wd);
                     
-                    if(found){
-                        
-                        prolongation_decide(elm, ele_3D, intersection_list_[component_ele_idx].back());
-                        
-                        START_TIMER("Prolongation algorithm");
-                        do{
-                            // flag is set false if the component element is not fully covered with tetrahedrons
-                            bool element_covered = true;
-                            
-                            while(!bulk_queue_.empty()){
-                                Prolongation pr = bulk_queue_.front();
-                                //DebugOut().fmt("Bulk queue: ele_idx {}.\n",pr.elm_3D_idx);
-                                
-                                if( pr.elm_3D_idx == undefined_elm_idx_)
-                                {
-                                    //DebugOut().fmt("Open intersection component element: {}\n",current_component_element_idx);
-                                    element_covered = false;
-                                }
-                                else prolongate(pr);
-                                
-                                bulk_queue_.pop();
-                            }
-                            
-                            if(! closed_elements[current_component_element_idx])
-                                closed_elements[current_component_element_idx] = element_covered;
-                            
-                            
-                            if(!component_queue_.empty()){
-                                Prolongation pr = component_queue_.front();
-
-                                // note the component element index
-                                current_component_element_idx = pr.component_elm_idx;
-                                //DebugOut().fmt("Component queue: ele_idx {}.\n",current_component_element_idx);
-                                
-                                prolongate(pr);
-                                component_queue_.pop();
-                            }
-                        }
-                        while( !(component_queue_.empty() && bulk_queue_.empty()) );
-                        END_TIMER("Prolongation algorithm");
-                        
-                        // if component element is closed, do not check other bounding boxes
-                        if(closed_elements[component_ele_idx])
-                            break;
-                    }
+                    // if component element is closed, do not check other bounding boxes
+                    if(closed_elements[component_ele_idx])
+                        break;
                 }
             }
-            END_TIMER("Bounding box element iteration");
         }
+        END_TIMER("Bounding box element iteration");
     }
+}
 
-    END_TIMER("Element iteration");
+template<unsigned int dim>
+void InspectElementsAlgorithm<dim>::prolongate_component(const ElementAccessor<3> &comp_ele,
+                                                         const ElementAccessor<3> &bulk_ele,
+                                                         WorkerData &wd)
+{
+    // - first intersection is found, prolongate and possibly fill both prolongation queues
+    // do-while loop:
+    // - empty prolongation queues:
+    //      - empty bulk queue:
+    //          - get a candidate from queue and compute CI
+    //          - prolongate and possibly push new candidates into queues
+    //          - repeat until bulk queue is empty
+    //          - the component element is still the same whole time in here
+    //
+    //      - the component element might get fully covered by bulk elements
+    //        and only then it can be closed
+    //
+    //      - pop next candidate from component queue:
+    //          - the component element is now changed
+    //          - compute CI
+    //          - prolongate and possibly push new candidates into queues
+    //
+    // - repeat until both queues are empty
     
-    MessageOut().fmt("{}D-3D: number of intersections = {}\n", dim, n_intersections_);
-    // DBG write which elements are closed
-//     for (auto ele : mesh->elements_range()) {
-//         DebugOut().fmt("Element[{}] closed: {}\n",ele.index(),(closed_elements[ele.index()] ? 1 : 0));
-//     }
+    // keep the index of the current component element that is being investigated
+    unsigned int current_component_element_idx = comp_ele.idx();
+    
+    prolongation_decide(comp_ele, bulk_ele, intersection_list_[comp_ele.idx()].back(), wd);
+    
+    START_TIMER("Prolongation algorithm");
+    do{
+        // flag is set false if the component element is not fully covered with tetrahedrons
+        bool element_covered = true;
+        
+        while(!wd.bulk_queue_.empty()){
+            Prolongation pr = wd.bulk_queue_.front();
+            //DebugOut().fmt("Bulk queue: ele_idx {}.\n",pr.elm_3D_idx);
+            
+            if( pr.elm_3D_idx == undefined_elm_idx_)
+            {
+                //DebugOut().fmt("Open intersection component element: {}\n",current_component_element_idx);
+                element_covered = false;
+            }
+            else prolongate(pr, wd);
+            
+            wd.bulk_queue_.pop();
+        }
+        
+        if(! closed_elements[current_component_element_idx])
+            closed_elements[current_component_element_idx] = element_covered;
+        
+        
+        if(!wd.component_queue_.empty()){
+            Prolongation pr = wd.component_queue_.front();
+
+            // note the component element index
+            current_component_element_idx = pr.component_elm_idx;
+            //DebugOut().fmt("Component queue: ele_idx {}.\n",current_component_element_idx);
+            
+            prolongate(pr, wd);
+            wd.component_queue_.pop();
+        }
+    }
+    while( !(wd.component_queue_.empty() && wd.bulk_queue_.empty()) );
+    END_TIMER("Prolongation algorithm");
 }
   
 template<unsigned int dim>
@@ -271,12 +400,21 @@ void InspectElementsAlgorithm<dim>::compute_intersections_BIHtree(const BIHTree&
     
     START_TIMER("Element iteration");
     
+    // candidate pairs are independent, consecutive component elements are split into blocks
+    std::vector<unsigned int> component_elements;
     for (auto elm : mesh->elements_range()) {
-        unsigned int component_ele_idx = elm.idx();
-        
         if (elm.dim() == dim &&                                    // is component element
-            bih.ele_bounding_box(component_ele_idx).intersect(bih.tree_box()))   // its bounding box intersects 3D mesh bounding box
-        {   
+            is_relevant(elm.idx()) &&
+            bih.ele_bounding_box(elm.idx()).intersect(bih.tree_box()))   // its bounding box intersects 3D mesh bounding box
+            component_elements.push_back(elm.idx());
+    }
+    unsigned int n_blocks = (component_elements.size() + block_size_ - 1) / block_size_;
+    
+    run_parallel(n_blocks, [this, &component_elements, &bih](unsigned int i_block, WorkerData &wd) {
+        unsigned int i_end = std::min( (unsigned int)component_elements.size(), (i_block+1)*block_size_ );
+        for (unsigned int i = i_block*block_size_; i < i_end; i++) {
+            unsigned int component_ele_idx = component_elements[i];
+            ElementAccessor<3> elm = mesh->element_accessor( component_ele_idx );
             std::vector<unsigned int> searchedElements;
             
             START_TIMER("BIHtree find");
@@ -291,7 +429,7 @@ void InspectElementsAlgorithm<dim>::compute_intersections_BIHtree(const BIHTree&
                 unsigned int bulk_ele_idx = *it;
                 ElementAccessor<3> ele_3D = mesh->element_accessor( bulk_ele_idx );
                 
-                if (ele_3D.dim() == 3
+                if (ele_3D.dim() == 3 && this->is_relevant(bulk_ele_idx)
                 ) {
                     
                     IntersectionAux<dim,3> is(component_ele_idx, bulk_ele_idx);
@@ -304,7 +442,7 @@ void InspectElementsAlgorithm<dim>::compute_intersections_BIHtree(const BIHTree&
                     if(is.points().size() > 0) {
                         
                         intersection_list_[component_ele_idx].push_back(is);
-                        n_intersections_++;
+                        wd.n_intersections_++;
                         // if component element is closed, do not check other bounding boxes
                         closed_elements[component_ele_idx] = true;
                     }
@@ -312,7 +450,7 @@ void InspectElementsAlgorithm<dim>::compute_intersections_BIHtree(const BIHTree&
             }
             END_TIMER("Bounding box element iteration");
         }
-    }
+    });
 
     END_TIMER("Element iteration");
 }
@@ -324,6 +462,10 @@ void InspectElementsAlgorithm<dim>::compute_intersections_BB()
     init();
     compute_bounding_boxes();
     
+    // serial algorithm, used for testing
+    WorkerData wd;
+    init_worker(wd);
+    
     START_TIMER("Element iteration");
     
     
@@ -347,78 +489,16 @@ void InspectElementsAlgorithm<dim>::compute_intersections_BB()
                 // check that the bounding boxes intersect
                 // intersection has not been computed already
                 if (ele_3D.dim() == 3 &&
-                    (last_slave_for_3D_elements[bulk_ele_idx] != component_ele_idx &&
+                    (wd.last_slave_for_3D_elements[bulk_ele_idx] != component_ele_idx &&
                      elements_bb[component_ele_idx].intersect(elements_bb[bulk_ele_idx]) &&
                      !intersection_exists(component_ele_idx,bulk_ele_idx) )
                 ){
                     // check that tetrahedron element is numbered correctly and is not degenerated
-                    
-                        // - find first intersection
-                        // - if found, prolongate and possibly fill both prolongation queues
-                        // do-while loop:
-                        // - empty prolongation queues:
-                        //      - empty bulk queue:
-                        //          - get a candidate from queue and compute CI
-                        //          - prolongate and possibly push new candidates into queues
-                        //          - repeat until bulk queue is empty
-                        //          - the component element is still the same whole time in here
-                        //
-                        //      - the component element might get fully covered by bulk elements
-                        //        and only then it can be closed
-                        //
-                        //      - pop next candidate from component queue:
-                        //          - the component element is now changed
-                        //          - compute CI
-                        //          - prolongate and possibly push new candidates into queues
-                        //
-                        // - repeat until both queues are empty
-                    
-                    bool found = compute_initial_CI(elm, ele_3D);
-
-                    // keep the index of the current component element that is being investigated
-                    unsigned int current_component_element_idx = component_ele_idx;
+                    bool found = compute_initial_CI(elm, ele_3D, wd);
                     
                     if(found){
                         //DebugOut().fmt("start component with elements {} {}\n",component_ele_idx, bulk_ele_idx);
-                        
-                        prolongation_decide(elm, ele_3D, intersection_list_[component_ele_idx].back());
-                        
-                        START_TIMER("Prolongation algorithm");
-                        do{
-                            // flag is set false if the component element is not fully covered with tetrahedrons
-                            bool element_covered = true;
-                            
-                            while(!bulk_queue_.empty()){
-                                Prolongation pr = bulk_queue_.front();
-                                //DebugOut().fmt("Bulk queue: ele_idx {}.\n",pr.elm_3D_idx);
-                                
-                                if( pr.elm_3D_idx == undefined_elm_idx_)
-                                {
-                                    //DebugOut().fmt("Open intersection component element: {}\n",current_component_element_idx);
-                                    element_covered = false;
-                                }
-                                else prolongate(pr);
-                                
-                                bulk_queue_.pop();
-                            }
-                            
-                            if(! closed_elements[current_component_element_idx])
-                                closed_elements[current_component_element_idx] = element_covered;
-                            
-                            
-                            if(!component_queue_.empty()){
-                                Prolongation pr = component_queue_.front();
-
-                                // note the component element index
-                                current_component_element_idx = pr.component_elm_idx;
-                                //DebugOut().fmt("Component queue: ele_idx {}.\n",current_component_element_idx);
-                                
-                                prolongate(pr);
-                                component_queue_.pop();
-                            }
-                        }
-                        while( !(component_queue_.empty() && bulk_queue_.empty()) );
-                        END_TIMER("Prolongation algorithm");
+                        prolongate_component(elm, ele_3D, wd);
                         
                         // if component element is closed, do not check other bounding boxes
                         if(closed_elements[component_ele_idx])
@@ -432,6 +512,7 @@ void InspectElementsAlgorithm<dim>::compute_intersections_BB()
     }
 
     END_TIMER("Element iteration");
+    n_intersections_ = wd.n_intersections_;
     
     // DBG write which elements are closed
 //     for (auto ele : mesh->elements_range()) {
@@ -504,12 +585,13 @@ std::vector< unsigned int > InspectElementsAlgorithm<dim>::get_element_neighbors
 template<unsigned int dim>
 unsigned int InspectElementsAlgorithm<dim>::create_prolongation(unsigned int bulk_ele_idx,
                                                                 unsigned int component_ele_idx,
-                                                                std::queue< Prolongation >& queue)
+                                                                std::queue< Prolongation >& queue,
+                                                                WorkerData &wd)
 {
 //     if(last_slave_for_3D_elements[bulk_ele_idx] == undefined_elm_idx_ ||
 //         (last_slave_for_3D_elements[bulk_ele_idx] != component_ele_idx && !intersection_exists(component_ele_idx,bulk_ele_idx)))
 //     {
-    last_slave_for_3D_elements[bulk_ele_idx] = component_ele_idx;
+    wd.last_slave_for_3D_elements[bulk_ele_idx] = component_ele_idx;
 
     //DebugOut().fmt("prolongation: c {} in b {}\n",component_ele_idx,bulk_ele_idx);
     
@@ -530,7 +612,8 @@ unsigned int InspectElementsAlgorithm<dim>::create_prolongation(unsigned int bul
 template<unsigned int dim>
 void InspectElementsAlgorithm<dim>::prolongation_decide(const ElementAccessor<3>& comp_ele,
                                                         const ElementAccessor<3>& bulk_ele,
-                                                        IntersectionAux<dim,3> is)
+                                                        IntersectionAux<dim,3> is,
+                                                        WorkerData &wd)
 // Can not pass is by reference as that reference points into reallocating vector.
 // 'create_prolongation' push_back into 'intersection_list_[component_ele_idx]'
 {
@@ -591,7 +674,7 @@ void InspectElementsAlgorithm<dim>::prolongation_decide(const ElementAccessor<3>
             // add all component neighbors with current bulk element into component queue
             for(unsigned int& comp_neighbor_idx : comp_neighbors) {
                 if(!intersection_exists(comp_neighbor_idx,bulk_current))
-                    create_prolongation(bulk_current, comp_neighbor_idx, component_queue_);
+                    create_prolongation(bulk_current, comp_neighbor_idx, wd.component_queue_, wd);
             }
         }   
         
@@ -612,12 +695,12 @@ void InspectElementsAlgorithm<dim>::prolongation_decide(const ElementAccessor<3>
             // prolong over current comp element to other bulk elements (into bulk queue) (covering comp ele)
             for(unsigned int& bulk_neighbor_idx : bulk_neighbors)
             {
-                if(last_slave_for_3D_elements[bulk_neighbor_idx] == undefined_elm_idx_ ||
-                    (last_slave_for_3D_elements[bulk_neighbor_idx] != comp_current && 
+                if(wd.last_slave_for_3D_elements[bulk_neighbor_idx] == undefined_elm_idx_ ||
+                    (wd.last_slave_for_3D_elements[bulk_neighbor_idx] != comp_current && 
                         !intersection_exists(comp_current,bulk_neighbor_idx)))
                     n_prolongations += create_prolongation(bulk_neighbor_idx,
                                                            comp_current,
-                                                           bulk_queue_);
+                                                           wd.bulk_queue_, wd);
             }
             
             // if there are no sides of any edge that we can continue to prolongate over,
@@ -625,7 +708,7 @@ void InspectElementsAlgorithm<dim>::prolongation_decide(const ElementAccessor<3>
             if(n_prolongations == 0)
             {
                 Prolongation pr = {comp_ele.idx(), undefined_elm_idx_, undefined_elm_idx_};
-                bulk_queue_.push(pr);
+                wd.bulk_queue_.push(pr);
             }
         }
     }
@@ -651,7 +734,7 @@ void InspectElementsAlgorithm<2>::assert_same_intersection(unsigned int comp_ele
 
 
 template<unsigned int dim>
-void InspectElementsAlgorithm<dim>::prolongate(const InspectElementsAlgorithm< dim >::Prolongation& pr)
+void InspectElementsAlgorithm<dim>::prolongate(const InspectElementsAlgorithm< dim >::Prolongation& pr, WorkerData &wd)
 {
 	ElementAccessor<3> elm = mesh->element_accessor( pr.component_elm_idx );
 	ElementAccessor<3> ele_3D = mesh->element_accessor( pr.elm_3D_idx );
@@ -671,7 +754,7 @@ void InspectElementsAlgorithm<dim>::prolongate(const InspectElementsAlgorithm< d
     CI.compute(is);
     END_TIMER("Compute intersection");
     
-    last_slave_for_3D_elements[pr.elm_3D_idx] = pr.component_elm_idx;
+    wd.last_slave_for_3D_elements[pr.elm_3D_idx] = pr.component_elm_idx;
     
     if(is.size() > 0){
 //         for(unsigned int j=0; j < is.size(); j++) 
@@ -682,8 +765,8 @@ void InspectElementsAlgorithm<dim>::prolongate(const InspectElementsAlgorithm< d
 //                        is.size()
 //                       );
         
-        prolongation_decide(elm, ele_3D,is);
-        n_intersections_++;
+        prolongation_decide(elm, ele_3D, is, wd);
+        wd.n_intersections_++;
 //         DBGVAR(n_intersections_);
     }
     else{
@@ -25,6 +25,8 @@
 // #include "simplex.hh"
 
 #include <queue>
+#include <vector>
+#include <functional>
 
 class Mesh; // forward declare
 class BIHTree;
@@ -89,6 +91,12 @@ protected:
  *      - BIH search: creates BIH, uses BIH to find only first candidates of components; then uses prolongation
  *      - BB search: does not create BIH, uses bounding boxes to search through all elements to find candidates
  * 
+ * BIH search and BIH only algorithms can run in several threads (see @p set_n_threads). Work units are connected
+ * components of component elements (BIH search, the prolongation never leaves a component) or blocks of consecutive
+ * component elements (BIH only). Units are processed independently by the threads, every thread has its own
+ * prolongation queues and writes only into @p intersection_list_ of the elements of its units, so the result
+ * does not depend on the number of threads.
+ * 
  * Due to optimal tracing algorithm for 2d-3d, we consider tetrahedron only with positive Jacobian.
  * This is checked in assert.
  * 
@@ -113,6 +121,16 @@ public:
     void compute_intersections_BB();
     //@}
     
+    /// Set number of threads used by BIH search and BIH only algorithms.
+    void set_n_threads(unsigned int n_threads);
+    
+    /**
+     * Restrict computation to elements with nonzero flag in @p relevant_elements (indexed by element index),
+     * intersection of elements is computed only if both of them are relevant. Empty vector means all elements.
+     * The vector has to exist during the computation.
+     */
+    void set_relevant_elements(const std::vector<char> *relevant_elements);
+    
 private:
     using IntersectionAlgorithmBase<dim,3>::mesh;
     using IntersectionAlgorithmBase<dim,3>::undefined_elm_idx_;
@@ -130,17 +148,32 @@ private:
         unsigned int dictionary_idx;
     };
     
+    /// Data of a single thread of the algorithm.
+    struct WorkerData{
+        /// Prolongation queue in the component mesh.
+        std::queue<Prolongation> component_queue_;
+        /// Prolongation queue in the bulk mesh.
+        std::queue<Prolongation> bulk_queue_;
+        /// Last component element computed with the bulk element.
+        std::vector<unsigned int> last_slave_for_3D_elements;
+        /// Counter for intersection found by the thread.
+        unsigned int n_intersections_;
+    };
+    
     /// Counter for intersection among elements.
     unsigned int n_intersections_;
     
-    /// Prolongation queue in the component mesh.
-    std::queue<Prolongation> component_queue_;
-    /// Prolongation queue in the bulk mesh.
-    std::queue<Prolongation> bulk_queue_;
+    /// Number of threads.
+    unsigned int n_threads_;
+    
+    /// Number of component elements in a work unit of BIH only algorithm.
+    static const unsigned int block_size_ = 64;
+    
+    /// Flags of relevant elements, NULL means all elements (see @p set_relevant_elements).
+    const std::vector<char> *relevant_elements_;
     
-    // Array of flags, which elements are computed
-    std::vector<bool> closed_elements;
-    std::vector<unsigned int> last_slave_for_3D_elements;
+    /// Array of flags, which elements are computed (char, so that threads can write flags of different elements).
+    std::vector<char> closed_elements;
     
     /// Elements bounding boxes.
     std::vector<BoundingBox> elements_bb;
@@ -157,21 +190,44 @@ private:
     /// Computes bounding boxes of all elements. Fills @p elements_bb and @p mesh_3D_bb.
     void compute_bounding_boxes();
     
+    /// Return true if the element is relevant for the computation.
+    inline bool is_relevant(unsigned int ele_idx) const
+    { return relevant_elements_ == nullptr || (*relevant_elements_)[ele_idx]; }
+    
+    /// Return connected components of @p dim dimensional relevant elements, elements of a component are sorted.
+    std::vector<std::vector<unsigned int>> create_components() const;
+    
+    /// Initialize data of a thread.
+    void init_worker(WorkerData &wd);
+    
+    /**
+     * Call @p fn(unit, worker) for all units 0 .. @p n_units - 1 in @p n_threads_ threads (units are given
+     * to threads dynamically). Exception thrown in a thread is rethrown in the calling thread.
+     * Intersections found by threads are added to @p n_intersections_.
+     */
+    void run_parallel(unsigned int n_units, std::function<void(unsigned int, WorkerData &)> fn);
+    
+    /// Computes intersections of component element @p elm with candidates found by BIH and prolongates them.
+    void compute_element_intersections(const ElementAccessor<3> &elm, const BIHTree& bih, WorkerData &wd);
+    
+    /// Prolongates intersection of @p comp_ele and @p bulk_ele, until both queues of @p wd are empty.
+    void prolongate_component(const ElementAccessor<3> &comp_ele, const ElementAccessor<3> &bulk_ele, WorkerData &wd);
+    
     void assert_same_intersection(unsigned int comp_ele_idx, unsigned int bulk_ele_idx);
     
     /// A hard way to find whether the intersection of two elements has already been computed, or not.
     bool intersection_exists(unsigned int component_ele_idx, unsigned int bulk_ele_idx);
     
     /// Computes the first intersection, from which we then prolongate.
-    bool compute_initial_CI(const ElementAccessor<3> &comp_ele, const ElementAccessor<3> &bulk_ele);
+    bool compute_initial_CI(const ElementAccessor<3> &comp_ele, const ElementAccessor<3> &bulk_ele, WorkerData &wd);
     
     /// Finds neighbouring elements that are new candidates for intersection and pushes
     /// them into component queue or bulk queue.
     void prolongation_decide(const ElementAccessor<3> &comp_ele, const ElementAccessor<3> &bulk_ele,
-                             IntersectionAux<dim,3> is);
+                             IntersectionAux<dim,3> is, WorkerData &wd);
     
     /// Computes the intersection for a candidate in a queue and calls @p prolongation_decide again.
-    void prolongate(const Prolongation &pr);
+    void prolongate(const Prolongation &pr, WorkerData &wd);
 
     template<unsigned int ele_dim>
     std::vector< unsigned int > get_element_neighbors(const ElementAccessor<3>& ele,
@@ -183,7 +239,8 @@ private:
     
     unsigned int create_prolongation(unsigned int bulk_ele_idx,
                                      unsigned int component_ele_idx,
-                                     std::queue<Prolongation>& queue);
+                                     std::queue<Prolongation>& queue,
+                                     WorkerData &wd);
     
     friend class MixedMeshIntersections;
 };
@@ -5,6 +5,9 @@
  *      Author: viktor, pe, jb
  */
 
+#include <fstream>
+#include <boost/functional/hash.hpp>
+
 #include "inspect_elements_algorithm.hh"
 #include "intersection_point_aux.hh"
 #include "intersection_aux.hh"
@@ -12,6 +15,7 @@
 
 #include "system/global_defs.h"
 #include "system/sys_profiler.hh"
+#include "system/file_path.hh"
 
 #include "mesh/mesh.h"
 #include "mesh/ref_element.hh"
@@ -20,6 +24,7 @@
 #include "mesh/accessors.hh"
 #include "mesh/node_accessor.hh"
 #include "mesh/range_wrapper.hh"
+#include "la/distribution.hh"
 
 
 MixedMeshIntersections::MixedMeshIntersections(Mesh* mesh)
@@ -182,6 +187,9 @@ void MixedMeshIntersections::compute_intersections(InspectElementsAlgorithm< dim
                     
                     // skip zero intersections (are made in iea.prolongate())
                     if(iea.intersection_list_[idx][j].size() == 0) continue;
+                    // skip intersections not touching local elements (computed for whole components)
+                    if(! relevant_elements_.empty() &&
+                       ! (relevant_elements_[idx] && relevant_elements_[iea.intersection_list_[idx][j].bulk_ele_idx()]) ) continue;
                     store_intersection(storage, iea.intersection_list_[idx][j]);                }
         }
     }
@@ -320,10 +328,51 @@ void MixedMeshIntersections::compute_intersections_12_1(vector< IntersectionLoca
     END_TIMER("Intersection into storage");
 }
 
+void MixedMeshIntersections::mark_relevant_elements()
+{
+    relevant_elements_.clear();
+    Distribution *el_ds = mesh->get_el_ds();
+    if (el_ds == nullptr || el_ds->np() == 1) return; // all elements are relevant
+    
+    START_TIMER("Mark relevant elements");
+    const BIHTree &bih = mesh->get_bih_tree();
+    relevant_elements_.assign(mesh->n_elements(), false);
+    std::vector<unsigned int> candidates;
+    
+    // local elements and 3D elements intersecting local lower dimensional elements;
+    // intersections of other lower dimensional elements with these 3D elements
+    // are necessary for 2D-2D and 1D-2D intersections of local elements
+    for (unsigned int i_loc = 0; i_loc < el_ds->lsize(); i_loc++) {
+        unsigned int ele_idx = mesh->get_el_4_loc()[i_loc];
+        relevant_elements_[ele_idx] = true;
+        if (mesh->element_accessor(ele_idx)->dim() == 3) continue;
+        candidates.clear();
+        bih.find_bounding_box(bih.ele_bounding_box(ele_idx), candidates);
+        for (unsigned int bulk_ele_idx : candidates)
+            if (mesh->element_accessor(bulk_ele_idx)->dim() == 3) relevant_elements_[bulk_ele_idx] = true;
+    }
+    
+    // lower dimensional elements intersecting relevant 3D elements
+    for (auto elm : mesh->elements_range()) {
+        if (elm->dim() != 3 || ! relevant_elements_[elm.idx()]) continue;
+        candidates.clear();
+        bih.find_bounding_box(bih.ele_bounding_box(elm.idx()), candidates);
+        for (unsigned int comp_ele_idx : candidates)
+            if (mesh->element_accessor(comp_ele_idx)->dim() < 3) relevant_elements_[comp_ele_idx] = true;
+    }
+}
+
 void MixedMeshIntersections::compute_intersections(IntersectionType d)
 {
     element_intersections_.resize(mesh->n_elements());
     
+    mark_relevant_elements();
+    unsigned int n_threads = mesh->get_intersection_n_threads();
+    algorithm13_.set_n_threads(n_threads);
+    algorithm23_.set_n_threads(n_threads);
+    algorithm13_.set_relevant_elements(&relevant_elements_);
+    algorithm23_.set_relevant_elements(&relevant_elements_);
+    
     // check whether the mesh is in plane only
     bool mesh_in_2d_only = false;
     auto bb = mesh->get_bih_tree().tree_box();
@@ -396,6 +445,205 @@ void MixedMeshIntersections::compute_intersections(IntersectionType d)
 
 
 
+const std::string MixedMeshIntersections::cache_magic = "FLOW123D_INTERSECTIONS";
+
+const unsigned int MixedMeshIntersections::cache_format_version = 1;
+
+
+namespace {
+
+/// Write unsigned integer into binary stream.
+inline void write_uint(std::ostream &stream, unsigned long long val) {
+    stream.write(reinterpret_cast<const char *>(&val), sizeof(unsigned long long));
+}
+
+/// Read unsigned integer from binary stream.
+inline unsigned long long read_uint(std::istream &stream) {
+    unsigned long long val = 0;
+    stream.read(reinterpret_cast<char *>(&val), sizeof(unsigned long long));
+    return val;
+}
+
+/// Write intersections of the storage: element indices, number of points and local coordinates of points.
+template<uint dim_A, uint dim_B>
+void write_storage(std::ostream &stream, const std::vector<IntersectionLocal<dim_A, dim_B>> &storage)
+{
+    write_uint(stream, storage.size());
+    for(const IntersectionLocal<dim_A, dim_B> &isec : storage) {
+        write_uint(stream, isec.component_ele_idx());
+        write_uint(stream, isec.bulk_ele_idx());
+        write_uint(stream, isec.size());
+        for(const IntersectionPoint<dim_A, dim_B> &ip : isec.points()) {
+            stream.write(reinterpret_cast<const char *>(ip.comp_coords().memptr()), dim_A*sizeof(double));
+            stream.write(reinterpret_cast<const char *>(ip.bulk_coords().memptr()), dim_B*sizeof(double));
+        }
+    }
+}
+
+/// Read intersections written by @p write_storage, return false for invalid data.
+template<uint dim_A, uint dim_B>
+bool read_storage(std::istream &stream, std::vector<IntersectionLocal<dim_A, dim_B>> &storage, unsigned int n_elements)
+{
+    unsigned long long n_isec = read_uint(stream);
+    if (! stream.good()) return false;
+    arma::vec::fixed<dim_A> comp_coords;
+    arma::vec::fixed<dim_B> bulk_coords;
+    for(unsigned long long i = 0; i < n_isec; i++) {
+        unsigned long long comp_ele_idx = read_uint(stream);
+        unsigned long long bulk_ele_idx = read_uint(stream);
+        unsigned long long n_points = read_uint(stream);
+        if (! stream.good() || comp_ele_idx >= n_elements || bulk_ele_idx >= n_elements) return false;
+        storage.push_back(IntersectionLocal<dim_A, dim_B>(comp_ele_idx, bulk_ele_idx));
+        for(unsigned long long j = 0; j < n_points && stream.good(); j++) {
+            stream.read(reinterpret_cast<char *>(comp_coords.memptr()), dim_A*sizeof(double));
+            stream.read(reinterpret_cast<char *>(bulk_coords.memptr()), dim_B*sizeof(double));
+            storage.back().points().push_back(IntersectionPoint<dim_A, dim_B>(comp_coords, bulk_coords));
+        }
+    }
+    return stream.good();
+}
+
+/// Index of @p isec in @p storage, -1 if @p isec is intersection of other dimensions.
+template<uint dim_A, uint dim_B>
+long long storage_index(const std::vector<IntersectionLocal<dim_A, dim_B>> &storage, const IntersectionLocalBase *isec)
+{
+    auto *isec_local = dynamic_cast<const IntersectionLocal<dim_A, dim_B> *>(isec);
+    if (isec_local == nullptr) return -1;
+    ASSERT_LT(isec_local - storage.data(), (long long)storage.size());
+    return isec_local - storage.data();
+}
+
+} // namespace
+
+
+std::size_t MixedMeshIntersections::cache_key(IntersectionType d)
+{
+    std::size_t seed = 0;
+    boost::hash_combine(seed, cache_format_version);
+    boost::hash_combine(seed, (int)mesh->get_intersection_search());
+    boost::hash_combine(seed, (int)d);
+    for (auto nod : mesh->node_range()) {
+        arma::vec3 point = *nod;
+        for(uint i = 0; i < 3; i++) boost::hash_combine(seed, point[i]);
+    }
+    for (auto elm : mesh->elements_range()) {
+        boost::hash_combine(seed, elm->dim());
+        for(uint i = 0; i < elm->n_nodes(); i++) boost::hash_combine(seed, elm.node(i).idx());
+    }
+    // computed intersections depend on local elements in parallel run, see mark_relevant_elements
+    Distribution *el_ds = mesh->get_el_ds();
+    if (el_ds != nullptr && el_ds->np() > 1) {
+        boost::hash_combine(seed, el_ds->np());
+        boost::hash_combine(seed, el_ds->myp());
+        for (unsigned int i_loc = 0; i_loc < el_ds->lsize(); i_loc++)
+            boost::hash_combine(seed, mesh->get_el_4_loc()[i_loc]);
+    }
+    return seed;
+}
+
+
+void MixedMeshIntersections::write_cache(const std::string &file_name, IntersectionType d)
+{
+    START_TIMER("Write intersection cache");
+    std::ofstream stream(file_name.c_str(), std::ios_base::out | std::ios_base::binary);
+    if (! stream.is_open())
+        THROW( FilePath::ExcFileOpen() << FilePath::EI_Path(file_name) );
+
+    stream.write(cache_magic.data(), cache_magic.size());
+    write_uint(stream, cache_format_version);
+    write_uint(stream, cache_key(d));
+    write_uint(stream, mesh->n_nodes());
+    write_uint(stream, mesh->n_elements());
+
+    write_storage(stream, intersection_storage13_);
+    write_storage(stream, intersection_storage23_);
+    write_storage(stream, intersection_storage22_);
+    write_storage(stream, intersection_storage12_);
+
+    // intersections of elements: other element, storage (0 - 13, 1 - 23, 2 - 22, 3 - 12) and index in the storage
+    write_uint(stream, element_intersections_.size());
+    for(const std::vector<ILpair> &ele_isecs : element_intersections_) {
+        write_uint(stream, ele_isecs.size());
+        for(const ILpair &il : ele_isecs) {
+            long long idx[4] = { storage_index(intersection_storage13_, il.second),
+                                 storage_index(intersection_storage23_, il.second),
+                                 storage_index(intersection_storage22_, il.second),
+                                 storage_index(intersection_storage12_, il.second) };
+            unsigned int i_storage = 0;
+            while (i_storage < 4 && idx[i_storage] < 0) i_storage++;
+            ASSERT_LT(i_storage, 4).error("Intersection is not in any storage.");
+            write_uint(stream, il.first);
+            write_uint(stream, i_storage);
+            write_uint(stream, idx[i_storage]);
+        }
+    }
+    stream.close();
+    MessageOut() << "Intersections written to cache '" << file_name << "'.\n";
+}
+
+
+bool MixedMeshIntersections::read_cache(const std::string &file_name, IntersectionType d)
+{
+    std::ifstream stream(file_name.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (! stream.is_open()) return false;
+    START_TIMER("Read intersection cache");
+
+    auto mismatch = [&file_name]() {
+        MessageOut() << "Intersection cache '" << file_name << "' does not match the mesh, intersections are computed.\n";
+        return false;
+    };
+
+    unsigned int n_elements = mesh->n_elements();
+    std::string file_magic(cache_magic.size(), ' ');
+    stream.read(&file_magic[0], cache_magic.size());
+    if (file_magic != cache_magic || read_uint(stream) != cache_format_version
+            || read_uint(stream) != cache_key(d)
+            || read_uint(stream) != mesh->n_nodes() || read_uint(stream) != n_elements)
+        return mismatch();
+
+    std::vector<IntersectionLocal<1,3>> storage13;
+    std::vector<IntersectionLocal<2,3>> storage23;
+    std::vector<IntersectionLocal<2,2>> storage22;
+    std::vector<IntersectionLocal<1,2>> storage12;
+    if (! read_storage(stream, storage13, n_elements) || ! read_storage(stream, storage23, n_elements)
+            || ! read_storage(stream, storage22, n_elements) || ! read_storage(stream, storage12, n_elements))
+        return mismatch();
+
+    // pointers to elements of the storages stay valid when the storages are moved
+    if (read_uint(stream) != n_elements) return mismatch();
+    std::vector<std::vector<ILpair>> element_intersections(n_elements);
+    for(std::vector<ILpair> &ele_isecs : element_intersections) {
+        unsigned long long n_isec = read_uint(stream);
+        for(unsigned long long i = 0; i < n_isec && stream.good(); i++) {
+            unsigned long long other_ele_idx = read_uint(stream);
+            unsigned long long i_storage = read_uint(stream);
+            unsigned long long idx = read_uint(stream);
+            IntersectionLocalBase *isec = nullptr;
+            switch (i_storage) {
+                case 0: if (idx < storage13.size()) isec = &storage13[idx]; break;
+                case 1: if (idx < storage23.size()) isec = &storage23[idx]; break;
+                case 2: if (idx < storage22.size()) isec = &storage22[idx]; break;
+                case 3: if (idx < storage12.size()) isec = &storage12[idx]; break;
+            }
+            if (isec == nullptr || other_ele_idx >= n_elements) return mismatch();
+            ele_isecs.push_back(std::make_pair(other_ele_idx, isec));
+        }
+        if (! stream.good()) return mismatch();
+    }
+
+    intersection_storage13_ = std::move(storage13);
+    intersection_storage23_ = std::move(storage23);
+    intersection_storage22_ = std::move(storage22);
+    intersection_storage12_ = std::move(storage12);
+    element_intersections_ = std::move(element_intersections);
+    MessageOut().fmt("Intersections read from cache '{}': 13({}), 23({}), 22({}), 12({})\n", file_name,
+                     intersection_storage13_.size(), intersection_storage23_.size(),
+                     intersection_storage22_.size(), intersection_storage12_.size());
+    return true;
+}
+
+
+
  
 void MixedMeshIntersections::print_mesh_to_file_13(string name)
 {
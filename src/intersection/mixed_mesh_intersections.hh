@@ -59,6 +59,13 @@ enum IntersectionType
  * @p intersection_storageXY_ ..
  *
  * When we are on an element, we use @p element_intersections_ to get to all its intersections.
+ *
+ * 1D-3D and 2D-3D intersections are computed in threads (see Mesh::get_intersection_n_threads).
+ * In parallel run, only intersections of relevant elements are computed and stored, these are the local elements
+ * and their neighbourhood necessary for 2D-2D and 1D-2D intersections (see @p mark_relevant_elements).
+ *
+ * Computed intersections can be stored in a binary cache file (@p write_cache) and read by later runs
+ * with the same mesh (@p read_cache), see the key 'intersection_cache' of Mesh.
  * 
  */
 class MixedMeshIntersections
@@ -89,6 +96,16 @@ public:
     /// move them to storage, create the map and throw away the rest.
     void compute_intersections(IntersectionType d = IntersectionType::all);
     
+    /**
+     * Read storages and @p element_intersections_ from the cache file @p file_name written by @p write_cache.
+     * Returns false if the file does not exist or it was written for a different mesh, search algorithm
+     * or intersection type @p d; the object is not changed in such case.
+     */
+    bool read_cache(const std::string &file_name, IntersectionType d = IntersectionType::all);
+    
+    /// Write storages and @p element_intersections_ computed with intersection type @p d into the cache file @p file_name.
+    void write_cache(const std::string &file_name, IntersectionType d = IntersectionType::all);
+    
     // TODO: move following functions into common intersection test code.
     // Functions for tests.
     unsigned int number_of_components(unsigned int dim);
@@ -111,6 +128,26 @@ private:
     InspectElementsAlgorithm22 algorithm22_;
     InspectElementsAlgorithm12 algorithm12_;
     
+    /// Flags of relevant elements, empty in sequential run (all elements are relevant).
+    std::vector<char> relevant_elements_;
+    
+    /**
+     * Fill @p relevant_elements_: local elements, 3D elements whose bounding box intersects a local lower dimensional
+     * element and lower dimensional elements whose bounding box intersects a relevant 3D element.
+     */
+    void mark_relevant_elements();
+    
+    /// Identification of the cache file.
+    static const std::string cache_magic;
+    /// Version of the cache file format.
+    static const unsigned int cache_format_version;
+    
+    /**
+     * Hash identifying the input of intersection algorithms: nodes and elements of the mesh,
+     * intersection search algorithm, intersection type @p d and local elements in parallel run.
+     */
+    std::size_t cache_key(IntersectionType d);
+    
     template<uint dim_A, uint dim_B>
     void store_intersection(std::vector<IntersectionLocal<dim_A, dim_B>> &storage, IntersectionAux<dim_A, dim_B> &isec_aux);
 
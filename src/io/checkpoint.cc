@@ -0,0 +1,251 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    checkpoint.cc
+ * @brief   Binary checkpoints of the simulation state and restart from them.
+ */
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "io/checkpoint.hh"
+#include "io/output_time_set.hh"
+#include "input/input_type.hh"
+#include "la/vector_mpi.hh"
+#include "system/sys_profiler.hh"
+#include "system/system.hh"
+#include "system/logger.hh"
+#include "tools/time_governor.hh"
+
+
+namespace IT = Input::Type;
+
+
+/*******************************************************************
+ * implementation of CheckpointData
+ */
+
+const unsigned int CheckpointData::format_version = 1;
+
+const std::string CheckpointData::magic = "FLOW123D_CHECKPOINT";
+
+
+void CheckpointData::save(const std::string &name, const VectorMPI &vec)
+{
+    std::vector<double> local_data(vec.size());
+    for (unsigned int i=0; i<local_data.size(); ++i) local_data[i] = vec.get(i);
+    this->save(name, local_data);
+}
+
+
+void CheckpointData::load(const std::string &name, VectorMPI &vec) const
+{
+    const std::string &block = this->block(name, vec.size()*sizeof(double));
+    const double *local_data = reinterpret_cast<const double *>(block.data());
+    for (unsigned int i=0; i<vec.size(); ++i) vec.set(i, local_data[i]);
+}
+
+
+void CheckpointData::save(const std::string &name, Vec vec)
+{
+    PetscInt local_size;
+    const PetscScalar *array;
+    chkerr( VecGetLocalSize(vec, &local_size) );
+    chkerr( VecGetArrayRead(vec, &array) );
+    blocks_[name].assign( reinterpret_cast<const char *>(array), local_size*sizeof(PetscScalar) );
+    chkerr( VecRestoreArrayRead(vec, &array) );
+}
+
+
+void CheckpointData::load(const std::string &name, Vec vec) const
+{
+    PetscInt local_size;
+    PetscScalar *array;
+    chkerr( VecGetLocalSize(vec, &local_size) );
+    const std::string &block = this->block(name, local_size*sizeof(PetscScalar));
+    chkerr( VecGetArray(vec, &array) );
+    std::memcpy(array, block.data(), block.size());
+    chkerr( VecRestoreArray(vec, &array) );
+}
+
+
+void CheckpointData::write_file(const FilePath &file_path) const
+{
+    int rank, n_proc;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &n_proc);
+
+    std::ofstream stream(string(file_path).c_str(), std::ios_base::out | std::ios_base::binary);
+    if (! stream.is_open())
+        THROW( FilePath::ExcFileOpen() << FilePath::EI_Path(string(file_path)) );
+
+    auto write_uint = [&stream](unsigned long long val) {
+        stream.write(reinterpret_cast<const char *>(&val), sizeof(unsigned long long));
+    };
+
+    stream.write(magic.data(), magic.size());
+    write_uint(format_version);
+    write_uint(n_proc);
+    write_uint(rank);
+    write_uint(blocks_.size());
+    for (auto &block : blocks_) {
+        write_uint(block.first.size());
+        stream.write(block.first.data(), block.first.size());
+        write_uint(block.second.size());
+        stream.write(block.second.data(), block.second.size());
+    }
+    stream.close();
+}
+
+
+void CheckpointData::read_file(const FilePath &file_path)
+{
+    int rank, n_proc;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &n_proc);
+
+    blocks_.clear();
+    file_name_ = string(file_path);
+
+    std::ifstream stream(file_name_.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (! stream.is_open())
+        THROW( FilePath::ExcFileOpen() << FilePath::EI_Path(file_name_) );
+
+    auto read_uint = [&stream]() {
+        unsigned long long val = 0;
+        stream.read(reinterpret_cast<char *>(&val), sizeof(unsigned long long));
+        return val;
+    };
+
+    std::string file_magic(magic.size(), ' ');
+    stream.read(&file_magic[0], magic.size());
+    if (file_magic != magic || read_uint() != format_version)
+        THROW( ExcInvalidFile() << EI_File(file_name_) );
+    int file_n_proc = read_uint();
+    if (file_n_proc != n_proc)
+        THROW( ExcWrongNProc() << EI_File(file_name_) << EI_NProc(file_n_proc) );
+    int file_rank = read_uint();
+    if (file_rank != rank)
+        THROW( ExcWrongRank() << EI_File(file_name_) << EI_Rank(file_rank) );
+    unsigned long long n_blocks = read_uint();
+    for (unsigned long long i=0; i<n_blocks; ++i) {
+        std::string name(read_uint(), ' ');
+        stream.read(&name[0], name.size());
+        std::string &data = blocks_[name];
+        data.resize(read_uint());
+        stream.read(&data[0], data.size());
+        if (! stream.good())
+            THROW( ExcInvalidFile() << EI_File(file_name_) );
+    }
+}
+
+
+
+/*******************************************************************
+ * implementation of Checkpoint
+ */
+
+const IT::Record & Checkpoint::get_input_type() {
+    return IT::Record("Checkpoint", "Binary checkpoints of the simulation state allowing restart of the simulation.")
+        .declare_key("file", IT::FileName::output(), IT::Default("\"checkpoint\""),
+                "Base name of the checkpoint files. Checkpoint of i-th frame is written by every process "
+                "into the file '<file>-<i>.<rank>.chkp'.")
+        .declare_key("times", OutputTimeSet::get_input_type(), IT::Default("[]"),
+                "Times of checkpoints. The checkpoint is written as soon as all equations reach the checkpoint time.")
+        .declare_key("restart_file", IT::FileName::input(), IT::Default::optional(),
+                "Resume the simulation from given checkpoint. Give the base name of checkpoint files "
+                "without the suffix '.<rank>.chkp', e.g. 'output/checkpoint-000002'. "
+                "The restart has to be performed with the same input and number of processes.")
+        .close();
+}
+
+
+Checkpoint::Checkpoint(const Input::Record &in_rec, const TimeGovernor &tg)
+: in_rec_(in_rec),
+  mark_type_(TimeGovernor::marks().new_mark_type()),
+  last_checkpoint_time_(-TimeGovernor::inf_time),
+  frame_(0),
+  is_restart_(false)
+{
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
+
+    FilePath file_path = in_rec_.val<FilePath>("file");
+    if (rank_ == 0) file_path.create_output_dir();
+    file_base_ = file_path.cut_extension();
+
+    OutputTimeSet checkpoint_times;
+    checkpoint_times.read_from_input(in_rec_.val<Input::Array>("times"), tg, mark_type_);
+
+    FilePath restart_path;
+    if ( in_rec_.opt_val("restart_file", restart_path) ) {
+        restart_base_ = string(restart_path);
+        is_restart_ = true;
+    }
+}
+
+
+FilePath Checkpoint::rank_file_path(const std::string &base_name, FilePath::FileType file_type) const
+{
+    std::stringstream ss;
+    ss << base_name << "." << rank_ << ".chkp";
+    return FilePath(ss.str(), file_type);
+}
+
+
+bool Checkpoint::is_checkpoint_time(double solved_time) const
+{
+    auto &marks = TimeGovernor::marks();
+    for (auto it = marks.begin(mark_type_); it != marks.end(mark_type_); ++it) {
+        if (it->time() <= last_checkpoint_time_) continue;
+        return (it->time() <= solved_time);
+    }
+    return false;
+}
+
+
+void Checkpoint::write(CheckpointData &data, double solved_time)
+{
+    START_TIMER("Checkpoint::write");
+    std::stringstream ss;
+    ss << file_base_ << "-" << std::setw(6) << std::setfill('0') << frame_;
+    FilePath file_path = this->rank_file_path(ss.str(), FilePath::output_file);
+
+    last_checkpoint_time_ = solved_time;
+    frame_++;
+    // store state of the checkpoint itself, so the restarted simulation continues in numbering of frames
+    data.save("checkpoint/frame", frame_);
+    data.save("checkpoint/last_time", last_checkpoint_time_);
+
+    if (rank_ == 0)
+        MessageOut() << "Writing checkpoint " << (frame_-1) << " at time " << solved_time << ": " << ss.str() << "\n";
+    data.write_file(file_path);
+}
+
+
+void Checkpoint::read_restart(CheckpointData &data)
+{
+    ASSERT(is_restart_).error("Restart file was not set.");
+    START_TIMER("Checkpoint::read_restart");
+
+    FilePath file_path = this->rank_file_path(restart_base_, FilePath::input_file);
+    if (rank_ == 0)
+        MessageOut() << "Restart simulation from checkpoint: " << restart_base_ << "\n";
+    try {
+        data.read_file(file_path);
+    } INPUT_CATCH(FilePath::ExcFileOpen, FilePath::EI_Address_String, in_rec_)
+
+    data.load("checkpoint/frame", frame_);
+    data.load("checkpoint/last_time", last_checkpoint_time_);
+}
+
@@ -0,0 +1,246 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    checkpoint.hh
+ * @brief   Binary checkpoints of the simulation state and restart from them.
+ */
+
+#ifndef CHECKPOINT_HH_
+#define CHECKPOINT_HH_
+
+#include <map>                          // for map
+#include <string>                       // for string
+#include <vector>                       // for vector
+#include <cstring>                      // for memcpy
+#include <type_traits>                  // for is_trivially_copyable
+#include "petscvec.h"                   // for Vec
+#include "input/accessors.hh"           // for Record, Array
+#include "system/exceptions.hh"         // for DECLARE_EXCEPTION
+#include "system/file_path.hh"          // for FilePath
+#include "tools/time_marks.hh"          // for TimeMark
+
+class VectorMPI;
+class TimeGovernor;
+namespace Input { namespace Type { class Record; } }
+
+
+/**
+ * Simulation state of a single process stored as a set of named binary blocks.
+ *
+ * Every object that takes part in the checkpoint stores its state into blocks with names
+ * prefixed by the name of its owner (e.g. "flow/time/recent_steps"), so the objects can be
+ * restored in arbitrary order. The whole set is written to (and read from) a single binary
+ * file per process:
+ *
+ *  - magic string "FLOW123D_CHECKPOINT", format version, number of processes, rank, number of blocks
+ *  - for every block: length of name, name, size of data in bytes, data
+ *
+ * Data are written in the native byte order, checkpoint files are meant only for restart
+ * on the same platform with the same number of processes.
+ */
+class CheckpointData {
+public:
+    TYPEDEF_ERR_INFO( EI_BlockName, std::string);
+    TYPEDEF_ERR_INFO( EI_ExpectedSize, std::size_t);
+    TYPEDEF_ERR_INFO( EI_StoredSize, std::size_t);
+    TYPEDEF_ERR_INFO( EI_File, std::string);
+    TYPEDEF_ERR_INFO( EI_NProc, int);
+    TYPEDEF_ERR_INFO( EI_Rank, int);
+    DECLARE_EXCEPTION(ExcMissingBlock,
+            << "Missing block " << EI_BlockName::qval << " in the checkpoint file " << EI_File::qval << ".\n");
+    DECLARE_EXCEPTION(ExcBlockSize,
+            << "Block " << EI_BlockName::qval << " in the checkpoint file " << EI_File::qval
+            << " has size " << EI_StoredSize::val << " bytes, expected " << EI_ExpectedSize::val << " bytes.\n"
+            << "The checkpoint was probably written for a different problem setting.\n");
+    DECLARE_EXCEPTION(ExcInvalidFile,
+            << "Invalid format of the checkpoint file " << EI_File::qval << ".\n");
+    DECLARE_EXCEPTION(ExcWrongNProc,
+            << "Checkpoint file " << EI_File::qval << " was written by " << EI_NProc::val
+            << " processes, restart has to use the same number of processes.\n");
+    DECLARE_EXCEPTION(ExcWrongRank,
+            << "Checkpoint file " << EI_File::qval << " was written by the process of rank " << EI_Rank::val
+            << ", it can not be read by another process.\n");
+
+    /// Constructor.
+    CheckpointData() {}
+
+    /// Store trivially copyable value under given name.
+    template <class T>
+    void save(const std::string &name, const T &value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be stored directly.");
+        blocks_[name].assign( reinterpret_cast<const char *>(&value), sizeof(T) );
+    }
+
+    /// Store vector of trivially copyable values under given name.
+    template <class T>
+    void save(const std::string &name, const std::vector<T> &vec) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be stored directly.");
+        blocks_[name].assign( reinterpret_cast<const char *>(vec.data()), vec.size()*sizeof(T) );
+    }
+
+    /// Store local part (including ghost values) of the parallel vector under given name.
+    void save(const std::string &name, const VectorMPI &vec);
+
+    /// Store local part of the PETSc vector under given name.
+    void save(const std::string &name, Vec vec);
+
+    /// Restore trivially copyable value of given name.
+    template <class T>
+    void load(const std::string &name, T &value) const {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be loaded directly.");
+        const std::string &block = this->block(name, sizeof(T));
+        std::memcpy(&value, block.data(), sizeof(T));
+    }
+
+    /// Restore vector of trivially copyable values, the vector is resized to the stored size.
+    template <class T>
+    void load(const std::string &name, std::vector<T> &vec) const {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be loaded directly.");
+        const std::string &block = this->block(name);
+        if (block.size() % sizeof(T) != 0)
+            THROW( ExcBlockSize() << EI_BlockName(name) << EI_File(file_name_)
+                    << EI_StoredSize(block.size()) << EI_ExpectedSize(sizeof(T)*(block.size()/sizeof(T))) );
+        vec.resize(block.size() / sizeof(T));
+        std::memcpy(vec.data(), block.data(), block.size());
+    }
+
+    /// Restore local part of the parallel vector. Local size of the vector must match the stored size.
+    void load(const std::string &name, VectorMPI &vec) const;
+
+    /// Restore local part of the PETSc vector. Local size of the vector must match the stored size.
+    void load(const std::string &name, Vec vec) const;
+
+    /// Return true if block of given name is stored.
+    inline bool contains(const std::string &name) const {
+        return blocks_.find(name) != blocks_.end();
+    }
+
+    /// Number of stored blocks.
+    inline unsigned int size() const {
+        return blocks_.size();
+    }
+
+    /// Write all blocks to the binary file.
+    void write_file(const FilePath &file_path) const;
+
+    /// Read all blocks from the binary file. Previously stored blocks are removed.
+    void read_file(const FilePath &file_path);
+
+private:
+    /**
+     * Return stored block of given name. If @p size is given, check size of the block.
+     *
+     * Implemented in header, so the objects storing only plain data (e.g. TimeGovernor) do not depend on io library.
+     */
+    inline const std::string &block(const std::string &name, std::size_t size = std::string::npos) const {
+        auto it = blocks_.find(name);
+        if (it == blocks_.end())
+            THROW( ExcMissingBlock() << EI_BlockName(name) << EI_File(file_name_) );
+        if (size != std::string::npos && it->second.size() != size)
+            THROW( ExcBlockSize() << EI_BlockName(name) << EI_File(file_name_)
+                    << EI_StoredSize(it->second.size()) << EI_ExpectedSize(size) );
+        return it->second;
+    }
+
+    /// Binary data of blocks.
+    std::map<std::string, std::string> blocks_;
+
+    /// File name of last read file, used in error messages.
+    std::string file_name_;
+
+    /// Current format version.
+    static const unsigned int format_version;
+
+    /// Magic string at the beginning of checkpoint file.
+    static const std::string magic;
+};
+
+
+
+/**
+ * Controls when the checkpoints are written and where they are stored.
+ *
+ * Checkpoint times are given on input in the same way as output times and are added to the TimeMarks
+ * as marks of an own mark type. Checkpoint is written (by @p write) at the first time when all
+ * equations of the coupling have solved time greater or equal to the checkpoint time. The state of every
+ * equation holds its own time governor, so the written state is consistent even if the equations
+ * have different time steps.
+ *
+ * Checkpoint of the frame <i> is written on every process to the file '<file>-<i>.<rank>.chkp'.
+ * Restart file is given on input by its common part '<file>-<i>', rank suffix is added automatically.
+ */
+class Checkpoint {
+public:
+    /// Input record of the checkpoint.
+    static const Input::Type::Record & get_input_type();
+
+    /**
+     * Constructor.
+     *
+     * @param in_rec  Input record of type @p get_input_type.
+     * @param tg      Time governor used for reading of checkpoint times.
+     */
+    Checkpoint(const Input::Record &in_rec, const TimeGovernor &tg);
+
+    /// Return true if the checkpoint should be written for given solved time.
+    bool is_checkpoint_time(double solved_time) const;
+
+    /// Return true if the simulation should be resumed from a checkpoint file.
+    inline bool is_restart() const {
+        return is_restart_;
+    }
+
+    /**
+     * Write @p data to checkpoint file of the next frame. Mark all checkpoint times less or equal to @p solved_time as done.
+     *
+     * State of the checkpoint object itself is added to @p data.
+     */
+    void write(CheckpointData &data, double solved_time);
+
+    /**
+     * Read data of the restart checkpoint and restore state of the checkpoint object,
+     * so the checkpoints written before the restart are not repeated.
+     */
+    void read_restart(CheckpointData &data);
+
+private:
+    /// Return path of checkpoint file of given base name and actual process.
+    FilePath rank_file_path(const std::string &base_name, FilePath::FileType file_type) const;
+
+    /// Input record.
+    Input::Record in_rec_;
+
+    /// Mark type of checkpoint times.
+    TimeMark::Type mark_type_;
+
+    /// Time of the last written (or restored) checkpoint.
+    double last_checkpoint_time_;
+
+    /// Counter of written checkpoints.
+    unsigned int frame_;
+
+    /// Base name of checkpoint files.
+    std::string file_base_;
+
+    /// Base name of restart file (without rank suffix).
+    std::string restart_base_;
+
+    /// True if simulation is resumed from a checkpoint.
+    bool is_restart_;
+
+    /// MPI rank.
+    int rank_;
+};
+
+
+#endif /* CHECKPOINT_HH_ */
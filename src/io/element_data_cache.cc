@@ -18,6 +18,7 @@
 
 #include <limits>
 #include <ostream>
+#include <type_traits>
 #include "io/element_data_cache.hh"
 #include "io/msh_basereader.hh"
 #include "la/distribution.hh"
@@ -190,6 +191,22 @@ void ElementDataCache<T>::print_yaml_subarray(ostream &out_stream, unsigned int
 }
 
 
+template <typename T>
+void ElementDataCache<T>::print_binary_subarray(ostream &out_stream, unsigned int begin, unsigned int end)
+{
+	if (end <= begin) return;
+	std::vector<T> &vec = *( this->data_.get() );
+	if (std::is_same<T, double>::value) {
+		out_stream.write(reinterpret_cast<const char*>(&(vec[n_comp_*begin])), n_comp_*(end-begin)*sizeof(T));
+		return;
+	}
+    for(unsigned int i = n_comp_*begin; i < n_comp_*end; ++i ) {
+    	double val = vec[i];
+    	out_stream.write(reinterpret_cast<const char*>(&val), sizeof(double));
+    }
+}
+
+
 template <typename T>
 void ElementDataCache<T>::get_min_max_range(double &min, double &max)
 {
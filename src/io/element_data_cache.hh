@@ -121,6 +121,8 @@ public:
 
     void print_yaml_subarray(ostream &out_stream, unsigned int precision, unsigned int begin, unsigned int end) override;
 
+    void print_binary_subarray(ostream &out_stream, unsigned int begin, unsigned int end) override;
+
     /**
      * Store data element of given data value under given index.
      */
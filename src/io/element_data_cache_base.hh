@@ -99,6 +99,12 @@ public:
      */
     virtual void print_yaml_subarray(ostream &out_stream, unsigned int precision, unsigned int begin, unsigned int end) = 0;
 
+    /**
+     * Print stored values of indices in the range [begin, end) as raw float64 values (native byte order).
+     * Used for binary output of observe values.
+     */
+    virtual void print_binary_subarray(ostream &out_stream, unsigned int begin, unsigned int end) = 0;
+
     /**
      * Find minimal and maximal range of stored data
      */
@@ -327,6 +333,12 @@ public:
     void print_yaml_subarray(ostream &, unsigned int, unsigned int , unsigned int) override
     {}
 
+    void print_binary_subarray(ostream &out_stream, unsigned int begin, unsigned int end) override
+    {
+        double zero = 0.0;
+        for(unsigned int i=n_comp_*begin; i<n_comp_*end; i++) out_stream.write(reinterpret_cast<const char*>(&zero), sizeof(double));
+    }
+
     void get_min_max_range(double &, double &) override
     {}
 
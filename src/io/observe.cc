@@ -11,6 +11,10 @@
 #include <algorithm>
 #include <unordered_set>
 #include <queue>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <boost/filesystem.hpp>
 
 #include "system/global_defs.h"
 #include "input/accessors.hh"
@@ -25,6 +29,7 @@
 #include "io/element_data_cache.hh"
 #include "fem/mapping_p1.hh"
 #include "tools/time_governor.hh"
+#include "io/checkpoint.hh"
 
 
 namespace IT = Input::Type;
@@ -336,11 +341,56 @@ ObservePointData ObservePoint::point_projection(unsigned int i_elm, ElementAcces
 
 const unsigned int Observe::max_observe_value_time = 1000;
 
+const std::string Observe::binary_magic = "FLOW123D_OBSERVE";
+
+const unsigned int Observe::binary_format_version = 1;
+
+
+namespace {
+
+/// Print string as JSON string literal.
+std::string json_string(const std::string &str) {
+    std::stringstream ss;
+    ss << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') ss << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20) ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+        else ss << c;
+    }
+    ss << '"';
+    return ss.str();
+}
+
+/// Print vector as JSON array.
+std::string json_array(const arma::vec3 &vec) {
+    std::stringstream ss;
+    ss.precision(std::numeric_limits<double>::max_digits10);
+    ss << "[" << vec(0) << ", " << vec(1) << ", " << vec(2) << "]";
+    return ss.str();
+}
+
+} // namespace
+
+
+const IT::Selection & Observe::get_input_type_format() {
+    return IT::Selection("ObserveFormat", "Format of the observe output file.")
+        .add_value(Observe::FORMAT_YAML, "yaml",
+            "YAML file '<equation>_observe.yaml'.")
+        .add_value(Observe::FORMAT_BINARY, "binary",
+            "Binary file '<equation>_observe.bin' with JSON header and appended time frames of float64 values, "
+            "see 'src/python/observe_reader.py'.")
+        .close();
+}
+
 
 Observe::Observe(string observe_name, Mesh &mesh, Input::Array in_array,
-                 unsigned int precision, const std::shared_ptr<TimeUnitConversion>& time_unit_conv)
+                 unsigned int precision, const std::shared_ptr<TimeUnitConversion>& time_unit_conv,
+                 OutputFormat format)
 : observe_name_(observe_name),
+  in_array_(in_array),
+  restart_file_size_(-1),
   precision_(precision),
+  format_(format),
   time_unit_conversion_(time_unit_conv),
   point_ds_(nullptr),
   observe_time_idx_(0)
@@ -374,16 +424,7 @@ Observe::Observe(string observe_name, Mesh &mesh, Input::Array in_array,
 
     if (points_.size() == 0) return;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
-    if (rank_==0) {
-        FilePath observe_file_path(observe_name_ + "_observe.yaml", FilePath::output_file);
-        try {
-            observe_file_path.open_stream(observe_file_);
-            //observe_file_.setf(std::ios::scientific);
-            observe_file_.precision(this->precision_);
-
-        } INPUT_CATCH(FilePath::ExcFileOpen, FilePath::EI_Address_String, in_array)
-        output_header();
-    }
+    // output file is opened at the first output time frame, so it can be appended on restart
 
     // Create vector of observe data on patch
     for (ObservePointAccessor op_acc : this->local_range()) {
@@ -407,6 +448,11 @@ Observe::OutputDataPtr Observe::prepare_compute_data(std::string field_name, dou
         ASSERT(fabs(field_time / time_unit_seconds - observe_values_time_[observe_time_idx_]) < 2*numeric_limits<double>::epsilon())
               (field_time)(observe_values_time_[observe_time_idx_]);
 
+    this->register_field(field_name, n_shape);
+    std::vector<bool> &evaluated = evaluated_frames_[field_name];
+    evaluated.resize(max_observe_value_time, false);
+    evaluated[observe_time_idx_] = true;
+
     OutputDataFieldMap::iterator it=observe_field_values_.find(field_name);
     if (it == observe_field_values_.end()) {
         observe_field_values_[field_name]
@@ -417,6 +463,79 @@ Observe::OutputDataPtr Observe::prepare_compute_data(std::string field_name, dou
 }
 
 
+void Observe::register_field(std::string field_name, unsigned int n_shape)
+{
+    observed_fields_.insert( std::make_pair(field_name, n_shape) );
+}
+
+
+void Observe::open_file() {
+    std::string suffix = (format_ == FORMAT_BINARY) ? "_observe.bin" : "_observe.yaml";
+    FilePath observe_file_path(observe_name_ + suffix, FilePath::output_file);
+    try {
+        if (restart_file_size_ < 0) {
+            observe_file_path.open_stream(observe_file_);
+        } else {
+            // continue the file of the checkpoint, values written after the checkpoint are dropped
+            try {
+                boost::filesystem::resize_file( string(observe_file_path), restart_file_size_ );
+            } catch (boost::filesystem::filesystem_error &) {
+                THROW(FilePath::ExcFileOpen() << FilePath::EI_Path( string(observe_file_path) ));
+            }
+            observe_file_.open( string(observe_file_path).c_str(), ios_base::out | ios_base::app );
+            if (! observe_file_.is_open())
+                THROW(FilePath::ExcFileOpen() << FilePath::EI_Path( string(observe_file_path) ));
+        }
+        //observe_file_.setf(std::ios::scientific);
+        observe_file_.precision(this->precision_);
+
+    } INPUT_CATCH(FilePath::ExcFileOpen, FilePath::EI_Address_String, in_array_)
+    // header of binary file is written at first flush, when observed fields are known
+    if (format_ == FORMAT_YAML && restart_file_size_ < 0) output_header();
+}
+
+
+void Observe::flush_buffer() {
+    if (points_.size() > 0 && rank_ == 0 && ! observe_file_.is_open()) open_file();
+    flush_values();
+}
+
+
+void Observe::save_state(CheckpointData &data, const std::string &prefix) {
+    // size of the file is meaningful only on the process writing the file
+    int64_t file_size = observe_file_.is_open() ? int64_t(observe_file_.tellp()) : -1;
+    data.save(prefix + "/file_size", file_size);
+
+    std::string names;
+    std::vector<unsigned int> n_comps;
+    for (auto &field : binary_fields_) {
+        names += field.first + '\n';
+        n_comps.push_back(field.second);
+    }
+    data.save(prefix + "/binary_field_names", std::vector<char>(names.begin(), names.end()));
+    data.save(prefix + "/binary_field_n_comps", n_comps);
+}
+
+
+void Observe::load_state(const CheckpointData &data, const std::string &prefix) {
+    ASSERT_PERMANENT(! observe_file_.is_open()).error("Observe state has to be restored before the first output time frame.");
+    data.load(prefix + "/file_size", restart_file_size_);
+
+    std::vector<char> names;
+    std::vector<unsigned int> n_comps;
+    data.load(prefix + "/binary_field_names", names);
+    data.load(prefix + "/binary_field_n_comps", n_comps);
+    std::stringstream names_stream( std::string(names.begin(), names.end()) );
+    binary_fields_.clear();
+    std::string name;
+    for (unsigned int i=0; std::getline(names_stream, name); ++i) {
+        ASSERT_PERMANENT_LT(i, n_comps.size());
+        binary_fields_.push_back( std::make_pair(name, n_comps[i]) );
+        observed_fields_.insert( binary_fields_.back() );
+    }
+}
+
+
 void Observe::output_header() {
     unsigned int indent = 2;
     observe_file_ << "# Observation file: " << observe_name_ << endl;
@@ -429,6 +548,97 @@ void Observe::output_header() {
 
 }
 
+void Observe::output_binary_header() {
+    binary_fields_.assign(observed_fields_.begin(), observed_fields_.end());
+
+    uint16_t byte_order_test = 1;
+    bool little_endian = (*reinterpret_cast<const char *>(&byte_order_test) == 1);
+
+    std::stringstream header;
+    header.precision(std::numeric_limits<double>::max_digits10);
+    header << "{\"format_version\": " << binary_format_version
+           << ", \"byte_order\": " << (little_endian ? "\"little\"" : "\"big\"")
+           << ", \"time_unit\": " << json_string(time_unit_conversion_->get_unit_string())
+           << ", \"time_unit_in_seconds\": " << time_unit_conversion_->get_coef()
+           << ", \"points\": [";
+    for (unsigned int i=0; i<points_.size(); ++i) {
+        const ObservePoint &point = points_[i];
+        header << (i ? ", " : "")
+               << "{\"name\": " << json_string(point.name_)
+               << ", \"init_point\": " << json_array(point.input_point_)
+               << ", \"snap_dim\": " << point.snap_dim_
+               << ", \"snap_region\": " << json_string(point.snap_region_name_)
+               << ", \"observe_point\": " << json_array(point.observe_data_.global_coords_) << "}";
+    }
+    header << "], \"fields\": [";
+    for (unsigned int i_field=0; i_field<binary_fields_.size(); ++i_field) {
+        header << (i_field ? ", " : "")
+               << "{\"name\": " << json_string(binary_fields_[i_field].first)
+               << ", \"n_comp\": " << binary_fields_[i_field].second << "}";
+    }
+    header << "]}";
+
+    // pad the header, so data are aligned to 8 bytes
+    std::string header_str = header.str();
+    header_str.append( (8 - (binary_magic.size() + sizeof(uint64_t) + header_str.size()) % 8) % 8, ' ' );
+    uint64_t header_size = header_str.size();
+    observe_file_.write(binary_magic.data(), binary_magic.size());
+    observe_file_.write(reinterpret_cast<const char *>(&header_size), sizeof(uint64_t));
+    observe_file_.write(header_str.data(), header_str.size());
+}
+
+
+void Observe::output_binary_header_extension() {
+    std::vector< std::pair<std::string, unsigned int> > new_fields;
+    for (auto &field : observed_fields_)
+        if (std::find(binary_fields_.begin(), binary_fields_.end(), field) == binary_fields_.end())
+            new_fields.push_back(field);
+    if (new_fields.size() == 0) return;
+
+    std::stringstream extension;
+    extension << "{\"fields\": [";
+    for (unsigned int i_field=0; i_field<new_fields.size(); ++i_field) {
+        extension << (i_field ? ", " : "")
+                  << "{\"name\": " << json_string(new_fields[i_field].first)
+                  << ", \"n_comp\": " << new_fields[i_field].second << "}";
+    }
+    extension << "]}";
+    std::string extension_str = extension.str();
+    extension_str.append( (8 - extension_str.size() % 8) % 8, ' ' );
+
+    // NaN in place of the time marks the extension
+    double mark = numeric_limits<double>::quiet_NaN();
+    uint64_t extension_size = extension_str.size();
+    observe_file_.write(reinterpret_cast<const char *>(&mark), sizeof(double));
+    observe_file_.write(reinterpret_cast<const char *>(&extension_size), sizeof(uint64_t));
+    observe_file_.write(extension_str.data(), extension_str.size());
+    binary_fields_.insert(binary_fields_.end(), new_fields.begin(), new_fields.end());
+}
+
+
+void Observe::output_binary_frames() {
+    if (binary_fields_.size() == 0) output_binary_header();
+    else output_binary_header_extension();
+
+    std::vector<double> nan_values;
+    for (unsigned int i_time=0; i_time<observe_time_idx_; ++i_time) {
+        observe_file_.write(reinterpret_cast<const char *>(&observe_values_time_[i_time]), sizeof(double));
+        for (auto &field : binary_fields_) {
+            auto data_it = observe_field_values_.find(field.first);
+            auto frames_it = evaluated_frames_.find(field.first);
+            if (data_it != observe_field_values_.end() && frames_it != evaluated_frames_.end() && frames_it->second[i_time]) {
+                data_it->second->print_binary_subarray(observe_file_, i_time*points_.size(), (i_time+1)*points_.size());
+            } else {
+                // field not evaluated in the time frame
+                nan_values.assign(points_.size() * field.second, numeric_limits<double>::quiet_NaN());
+                observe_file_.write(reinterpret_cast<const char *>(nan_values.data()), nan_values.size()*sizeof(double));
+            }
+        }
+    }
+    observe_file_.flush();
+}
+
+
 void Observe::flush_values() {
     if (points_.size() == 0 || observe_field_values_.size() == 0) return;
 
@@ -441,7 +651,9 @@ void Observe::flush_values() {
 		if (rank_==0) field_data.second = serial_data;
 	}
 
-	if (rank_ == 0) {
+	if (rank_ == 0 && format_ == FORMAT_BINARY) {
+		output_binary_frames();
+	} else if (rank_ == 0) {
 		unsigned int indent = 2;
 		DebugOut() << "Observe::output_time_frame WRITE\n";
 		for (unsigned int i_time=0; i_time<observe_time_idx_; ++i_time) {
@@ -458,9 +670,12 @@ void Observe::flush_values() {
     observe_values_time_.reserve(max_observe_value_time);
     observe_values_time_.push_back(numeric_limits<double>::signaling_NaN());
     observe_time_idx_ = 0;
+    evaluated_frames_.clear();
 }
 
 void Observe::output_time_frame(bool flush) {
+    if (points_.size() > 0 && rank_ == 0 && ! observe_file_.is_open()) open_file();
+
     if ( ! no_fields_warning ) {
         no_fields_warning=true;
         // check that observe fields are set
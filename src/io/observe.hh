@@ -15,6 +15,7 @@
 #include <new>                               // for operator new[]
 #include <string>                            // for string, operator<<
 #include <vector>                            // for vector
+#include <cstdint>                           // for int64_t
 #include <armadillo>
 #include "input/accessors.hh"                // for Array (ptr only), Record
 #include "input/input_exception.hh"          // for DECLARE_INPUT_EXCEPTION
@@ -25,10 +26,11 @@
 #include "tools/general_iterator.hh"
 #include "la/distribution.hh"
 
+class CheckpointData;
 class ElementDataCacheBase;
 class Mesh;
 class TimeUnitConversion;
-namespace Input { namespace Type { class Record; } }
+namespace Input { namespace Type { class Record; class Selection; } }
 template <typename T> class ElementDataCache;
 
 
@@ -223,23 +225,50 @@ class ObservePointAccessor;
 
 /**
  * This class takes care about the observe points in the output stream, storing observe values of the fields and
- * their output in the YAML format.
+ * their output in the YAML format or in the binary format.
+ *
+ * Binary file '<name>_observe.bin' consists of:
+ *  - magic string 'FLOW123D_OBSERVE' (16 bytes) and size of the header in bytes (uint64)
+ *  - JSON header: format version, byte order, time unit, observe points and observed fields
+ *    (name and number of components), padded by spaces to multiple of 8 bytes
+ *  - time frames of fixed size: time (float64) followed by values of every field in order given by header
+ *    (float64, n_points * n_comp values in order point, component), values of fields not evaluated
+ *    in the time frame are NaN
+ *  - header extension in place of a time frame, if a field is observed first after the header was written:
+ *    NaN (float64), size of the extension (uint64) and JSON {"fields": [new fields]} padded to multiple of 8 bytes;
+ *    following frames contain also the new fields
+ *
+ * The header is written at the first flush with all fields registered by @p register_field or evaluated
+ * so far, frames are appended at every flush. See 'src/python/observe_reader.py' for the reader.
+ *
+ * The output file (of both formats) is opened at the first output time frame. After a restart from a checkpoint
+ * it is truncated to its size at the checkpoint and appended, see @p save_state.
  */
 class Observe {
 public:
-
     typedef std::shared_ptr<ElementDataCacheBase> OutputDataPtr;
     typedef std::map< string,  OutputDataPtr > OutputDataFieldMap;
 
+    /// Format of the observe output file.
+    typedef enum {
+        FORMAT_YAML = 0,
+        FORMAT_BINARY = 1
+    } OutputFormat;
+
+    /// Input type of the observe output format.
+    static const Input::Type::Selection & get_input_type_format();
+
     /**
      * Construct the observation object.
      *
      * observe_name - base name of the output file, the equation name.
      * mesh - the mesh used for search for the observe points
      * in_array - the array of observe points
+     * format - format of the output file
      */
     Observe(string observe_name, Mesh &mesh, Input::Array in_array,
-            unsigned int precision, const std::shared_ptr<TimeUnitConversion>& time_unit_conv);
+            unsigned int precision, const std::shared_ptr<TimeUnitConversion>& time_unit_conv,
+            OutputFormat format = FORMAT_YAML);
 
     /// Destructor, must close the file.
     ~Observe();
@@ -254,16 +283,40 @@ public:
             { return observed_element_indices_;}
 
     /**
-     * Output file header.
+     * Output file header (YAML format).
      */
     void output_header();
 
+    /**
+     * Register the observed field @p field_name with @p n_shape components before its first evaluation,
+     * so it gets its column in the header of the binary file even if its output starts later.
+     */
+    void register_field(std::string field_name, unsigned int n_shape);
+
     /**
      * Sets next output time frame of observe. If the table is full, writes field values to the output
-     * file. Using the YAML format. Argument flush starts writing to output file explicitly.
+     * file. Argument flush starts writing to output file explicitly.
      */
     void output_time_frame(bool flush);
 
+    /**
+     * Write buffered values of all time frames to the output file. Used before a checkpoint,
+     * collective operation.
+     */
+    void flush_buffer();
+
+    /**
+     * Store size of the output file and fields of the binary header to the checkpoint.
+     * Values have to be flushed by @p flush_buffer before.
+     */
+    void save_state(CheckpointData &data, const std::string &prefix);
+
+    /**
+     * Restore state stored by @p save_state. Must be called before the first output time frame,
+     * the file is then truncated to the stored size and appended without new header.
+     */
+    void load_state(const CheckpointData &data, const std::string &prefix);
+
     /**
      * Return \p points_ vector
      */
@@ -310,6 +363,7 @@ public:
 
 
 
+
 protected:
     /// Effectively writes the data into the observe stream.
     void flush_values();
@@ -317,6 +371,24 @@ protected:
     /// Maximal size of observe values times vector
     static const unsigned int max_observe_value_time;
 
+    /// Magic string at the begin of the binary observe file.
+    static const std::string binary_magic;
+
+    /// Version of the binary observe file format.
+    static const unsigned int binary_format_version;
+
+    /// Write header of the binary file with all fields of @p observed_fields_.
+    void output_binary_header();
+
+    /// Write header extension of the binary file with fields observed after the header was written.
+    void output_binary_header_extension();
+
+    /// Write stored time frames to the binary file.
+    void output_binary_frames();
+
+    /// Open the output file and write the header of the YAML format, called on the first output time frame.
+    void open_file();
+
     // MPI rank.
     int rank_;
 
@@ -338,8 +410,22 @@ protected:
     /// Output file stream.
     std::ofstream observe_file_;
 
+    /// Observe points on input, used in error messages.
+    Input::Array in_array_;
+
+    /// Size of the output file at the restart checkpoint, negative if the file is not restarted.
+    int64_t restart_file_size_;
+
     /// Precision of float output
     unsigned int precision_;
+    /// Format of the output file.
+    OutputFormat format_;
+    /// Names and numbers of components of all registered or evaluated fields.
+    std::map<std::string, unsigned int> observed_fields_;
+    /// Flags of time frames of the actual table in which the field was evaluated.
+    std::map<std::string, std::vector<bool>> evaluated_frames_;
+    /// Names and numbers of components of fields in the binary file (header and extensions), empty until the header is written.
+    std::vector<std::pair<std::string, unsigned int>> binary_fields_;
     /// Time unit conversion object.
     std::shared_ptr<TimeUnitConversion> time_unit_conversion_;
     
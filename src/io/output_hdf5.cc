@@ -0,0 +1,483 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    output_hdf5.cc
+ * @brief   The functions for outputs to HDF5 files with XDMF descriptor.
+ */
+
+#include "output_hdf5.hh"
+
+#ifdef FLOW123D_HAVE_HDF5
+
+#include "element_data_cache_base.hh"
+#include "element_data_cache.hh"
+#include "output_mesh.hh"
+
+#include <iomanip>
+#include <sstream>
+#include "input/factory.hh"
+#include "input/accessors_forward.hh"
+#include "system/file_path.hh"
+#include "system/sys_profiler.hh"
+#include "tools/time_governor.hh"
+
+FLOW123D_FORCE_LINK_IN_CHILD(hdf5)
+
+
+using namespace Input::Type;
+
+const Record & OutputHDF5::get_input_type() {
+    return Record("hdf5", "Parameters of HDF5 output format with XDMF descriptor.")
+		// It is derived from abstract class
+		.derive_from(OutputTime::get_input_format_type())
+		// The parallel or serial variant
+		.declare_key("parallel", Bool(), Default("true"),
+			"Every process writes its part of data to the common HDF5 file by collective MPI-IO writes. "
+			"Requires HDF5 library with parallel support, otherwise data are gathered and written by the first process.")
+		.close();
+}
+
+
+const int OutputHDF5::registrar = Input::register_class< OutputHDF5 >("hdf5") +
+		OutputHDF5::get_input_type().size();
+
+
+const std::vector<std::string> OutputHDF5::group_names = { "node_data", "corner_data", "element_data", "native_data" };
+
+
+/// Return HDF5 native memory type corresponding to type of data cache.
+static hid_t hdf5_mem_type(ElementDataCacheBase::VTKValueType vtk_type) {
+    switch (vtk_type) {
+    case ElementDataCacheBase::VTK_FLOAT64:
+        return H5T_NATIVE_DOUBLE;
+    case ElementDataCacheBase::VTK_UINT32:
+        return H5T_NATIVE_UINT;
+    case ElementDataCacheBase::VTK_INT32:
+        return H5T_NATIVE_INT;
+    default:
+        ASSERT_PERMANENT(false)(vtk_type).error("Unsupported type of HDF5 data.");
+        return H5T_NATIVE_DOUBLE;
+    }
+}
+
+
+/// Return HDF5 file type corresponding to type of data cache.
+static hid_t hdf5_file_type(ElementDataCacheBase::VTKValueType vtk_type) {
+    switch (vtk_type) {
+    case ElementDataCacheBase::VTK_FLOAT64:
+        return H5T_IEEE_F64LE;
+    case ElementDataCacheBase::VTK_UINT32:
+        return H5T_STD_U32LE;
+    case ElementDataCacheBase::VTK_INT32:
+        return H5T_STD_I32LE;
+    default:
+        ASSERT_PERMANENT(false)(vtk_type).error("Unsupported type of HDF5 data.");
+        return H5T_IEEE_F64LE;
+    }
+}
+
+
+/// Return XDMF attributes 'NumberType' and 'Precision' corresponding to type of data cache.
+static std::string xdmf_number_type(ElementDataCacheBase::VTKValueType vtk_type) {
+    switch (vtk_type) {
+    case ElementDataCacheBase::VTK_UINT32:
+        return "NumberType=\"UInt\" Precision=\"4\"";
+    case ElementDataCacheBase::VTK_INT32:
+        return "NumberType=\"Int\" Precision=\"4\"";
+    default:
+        return "NumberType=\"Float\" Precision=\"8\"";
+    }
+}
+
+
+/// Return XDMF 'AttributeType' corresponding to number of components.
+static std::string xdmf_attribute_type(unsigned int n_comp) {
+    switch (n_comp) {
+    case ElementDataCacheBase::N_SCALAR:
+        return "Scalar";
+    case ElementDataCacheBase::N_VECTOR:
+        return "Vector";
+    case ElementDataCacheBase::N_TENSOR:
+        return "Tensor";
+    default:
+        return "Matrix";
+    }
+}
+
+
+/// Return name of group of given time frame.
+static std::string step_group_name(int step) {
+    ostringstream ss;
+    ss << std::setw(6) << std::setfill('0') << step;
+    return ss.str();
+}
+
+
+
+OutputHDF5::OutputHDF5()
+: file_id_(-1),
+  xfer_plist_(-1),
+  n_global_nodes_(0),
+  n_global_elements_(0),
+  n_global_topology_(0),
+  mesh_written_(false)
+{
+    this->enable_refinement_ = true;
+}
+
+
+
+OutputHDF5::~OutputHDF5()
+{
+	// Perform output of last time step
+	this->write_time_frame();
+
+    this->write_tail();
+
+    if (xfer_plist_ >= 0) H5Pclose(xfer_plist_);
+    if (file_id_ >= 0) H5Fclose(file_id_);
+}
+
+
+
+void OutputHDF5::init_from_input(const std::string &equation_name,
+                                 const Input::Record &in_rec,
+                                 const std::shared_ptr<TimeUnitConversion>& time_unit_conv)
+{
+	OutputTime::init_from_input(equation_name, in_rec, time_unit_conv);
+
+    auto format_rec = (Input::Record)(input_record_.val<Input::AbstractRecord>("format"));
+#ifdef H5_HAVE_PARALLEL
+    this->parallel_ = format_rec.val<bool>("parallel");
+#else
+    if (format_rec.val<bool>("parallel") && this->n_proc_ > 1 && this->rank_ == 0)
+        WarningOut() << "HDF5 library is not built with parallel support, data of HDF5 output are gathered to the first process.";
+    this->parallel_ = false;
+#endif // H5_HAVE_PARALLEL
+    this->fix_main_file_extension(".xdmf");
+
+    // HDF5 data file is placed next to the XDMF descriptor
+    h5_file_name_ = this->_base_filename.stem() + ".h5";
+    h5_file_path_ = FilePath({this->_base_filename.parent_path(), h5_file_name_}, FilePath::output_file);
+
+    if(this->rank_ == 0) {
+        try {
+            this->_base_filename.open_stream( this->_base_file );
+            this->set_stream_precision(this->_base_file);
+        } INPUT_CATCH(FilePath::ExcFileOpen, FilePath::EI_Address_String, input_record_)
+
+        LogOut() << "Writing flow output file: " << this->_base_filename << " ... ";
+    }
+
+    // open HDF5 file, in parallel output collectively by all processes
+    if (this->parallel_ || this->rank_ == 0) {
+        hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+        xfer_plist_ = H5Pcreate(H5P_DATASET_XFER);
+#ifdef H5_HAVE_PARALLEL
+        if (this->parallel_) {
+            H5Pset_fapl_mpio(fapl, MPI_COMM_WORLD, MPI_INFO_NULL);
+            H5Pset_dxpl_mpio(xfer_plist_, H5FD_MPIO_COLLECTIVE);
+        }
+#endif // H5_HAVE_PARALLEL
+        file_id_ = H5Fcreate(string(h5_file_path_).c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+        H5Pclose(fapl);
+        try {
+            if (file_id_ < 0) THROW(FilePath::ExcFileOpen() << FilePath::EI_Path(h5_file_path_));
+        } INPUT_CATCH(FilePath::ExcFileOpen, FilePath::EI_Address_String, input_record_)
+
+        hid_t steps_group = create_group(file_id_, "Steps");
+        H5Gclose(steps_group);
+    }
+
+    this->write_head();
+}
+
+
+
+OutputHDF5::DatasetPart OutputHDF5::make_dataset_part(hsize_t n_local)
+{
+    DatasetPart part;
+    part.n_local = n_local;
+    if (this->parallel_) {
+        unsigned long long local_size = n_local, offset = 0, global_size = 0;
+        MPI_Exscan(&local_size, &offset, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+        MPI_Allreduce(&local_size, &global_size, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+        if (this->rank_ == 0) offset = 0; // MPI_Exscan leaves result undefined on the first process
+        part.offset = offset;
+        part.n_global = global_size;
+    } else {
+        part.offset = 0;
+        part.n_global = n_local;
+    }
+    return part;
+}
+
+
+
+hid_t OutputHDF5::create_group(hid_t parent, const std::string &name)
+{
+    hid_t group = H5Gcreate2(parent, name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    ASSERT_PERMANENT_GE(group, 0)(name).error("Can not create HDF5 group.");
+    return group;
+}
+
+
+
+void OutputHDF5::write_double_attribute(hid_t object, const std::string &name, double value)
+{
+    hid_t space = H5Screate(H5S_SCALAR);
+    hid_t attr = H5Acreate2(object, name.c_str(), H5T_IEEE_F64LE, space, H5P_DEFAULT, H5P_DEFAULT);
+    H5Awrite(attr, H5T_NATIVE_DOUBLE, &value);
+    H5Aclose(attr);
+    H5Sclose(space);
+}
+
+
+
+void OutputHDF5::write_dataset(hid_t group, const std::string &name, hid_t mem_type, hid_t file_type,
+        const DatasetPart &part, hsize_t n_cols, const void *data)
+{
+    hsize_t global_dims[2] = { part.n_global, n_cols };
+    hsize_t local_dims[2] = { part.n_local, n_cols };
+    hsize_t start[2] = { part.offset, 0 };
+
+    hid_t file_space = H5Screate_simple(2, global_dims, NULL);
+    hid_t dataset = H5Dcreate2(group, name.c_str(), file_type, file_space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    ASSERT_PERMANENT_GE(dataset, 0)(name).error("Can not create HDF5 dataset.");
+
+    hid_t mem_space = H5Screate_simple(2, local_dims, NULL);
+    if (part.n_local > 0) {
+        H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, local_dims, NULL);
+    } else {
+        // process without data must take part in collective write too
+        H5Sselect_none(file_space);
+        H5Sselect_none(mem_space);
+    }
+    herr_t status = H5Dwrite(dataset, mem_type, mem_space, file_space, xfer_plist_, data);
+    ASSERT_PERMANENT_GE(status, 0)(name).error("Write to HDF5 dataset failed.");
+
+    H5Sclose(mem_space);
+    H5Dclose(dataset);
+    H5Sclose(file_space);
+}
+
+
+
+void OutputHDF5::write_data_cache(hid_t group, OutputDataPtr output_data)
+{
+    // serialize data to contiguous buffer, values are stored in raw-first order
+    ostringstream buffer;
+    output_data->print_binary_all(buffer, false);
+    std::string data = buffer.str();
+
+    DatasetPart part = make_dataset_part(output_data->n_values());
+    this->write_dataset(group, output_data->field_input_name(),
+            hdf5_mem_type(output_data->vtk_type()), hdf5_file_type(output_data->vtk_type()),
+            part, output_data->n_comp(), data.data());
+}
+
+
+
+void OutputHDF5::write_field_data(hid_t step_group, const std::string &group_name, OutputDataFieldVec &output_data_vec)
+{
+    if (output_data_vec.empty()) return;
+
+    hid_t group = create_group(step_group, group_name);
+    for(OutputDataPtr data : output_data_vec)
+        if ( ! data->is_dummy() )
+            this->write_data_cache(group, data);
+    H5Gclose(group);
+}
+
+
+
+void OutputHDF5::write_mesh()
+{
+    auto &nodes = *( this->nodes_->get_data().get() );
+    auto &connectivity = *( this->connectivity_->get_data().get() );
+    auto &offsets = *( this->offsets_->get_data().get() );
+    unsigned int n_elements = offsets.size()-1;
+
+    DatasetPart node_part = make_dataset_part(this->nodes_->n_values());
+    DatasetPart conn_part = make_dataset_part(connectivity.size());
+    DatasetPart elem_part = make_dataset_part(n_elements);
+
+    // shift local connectivity and offsets to global numbering
+    std::vector<unsigned int> global_conn(connectivity.size());
+    for (unsigned int i=0; i<connectivity.size(); ++i)
+        global_conn[i] = connectivity[i] + node_part.offset;
+    std::vector<unsigned int> global_offsets(n_elements);
+    for (unsigned int i=0; i<n_elements; ++i)
+        global_offsets[i] = offsets[i+1] + conn_part.offset;
+
+    // XDMF mixed topology: element type, (number of nodes for polyline), node indices
+    std::vector<unsigned int> topology;
+    topology.reserve(connectivity.size() + 2*n_elements);
+    for (unsigned int i=0; i<n_elements; ++i) {
+        unsigned int n_nodes = offsets[i+1]-offsets[i];
+        switch (n_nodes) {
+        case 2:
+            topology.push_back(XDMF_POLYLINE);
+            topology.push_back(n_nodes);
+            break;
+        case 3:
+            topology.push_back(XDMF_TRIANGLE);
+            break;
+        case 4:
+            topology.push_back(XDMF_TETRA);
+            break;
+        }
+        for (unsigned int j=offsets[i]; j<offsets[i+1]; ++j)
+            topology.push_back(global_conn[j]);
+    }
+    DatasetPart topo_part = make_dataset_part(topology.size());
+
+    hid_t mesh_group = create_group(file_id_, "Mesh");
+    this->write_dataset(mesh_group, "nodes", H5T_NATIVE_DOUBLE, H5T_IEEE_F64LE, node_part, this->nodes_->n_comp(), nodes.data());
+    this->write_dataset(mesh_group, "connectivity", H5T_NATIVE_UINT, H5T_STD_U32LE, conn_part, 1, global_conn.data());
+    this->write_dataset(mesh_group, "offsets", H5T_NATIVE_UINT, H5T_STD_U32LE, elem_part, 1, global_offsets.data());
+    this->write_dataset(mesh_group, "topology", H5T_NATIVE_UINT, H5T_STD_U32LE, topo_part, 1, topology.data());
+    H5Gclose(mesh_group);
+
+    n_global_nodes_ = node_part.n_global;
+    n_global_elements_ = elem_part.n_global;
+    n_global_topology_ = topo_part.n_global;
+    mesh_written_ = true;
+}
+
+
+
+int OutputHDF5::write_data(void)
+{
+    ASSERT_PTR(this->nodes_).error();
+
+    /* Output of serial format is implemented only in the first process */
+    if ( (this->rank_ != 0) && (!parallel_) ) {
+        return 0;
+    }
+
+    START_TIMER("OutputHDF5::write_data");
+    LogOut() << __func__ << ": Writing output (frame: " << this->current_step
+             << ", rank: " << this->rank_
+             << ") file: " << h5_file_path_ << " ... ";
+
+    if (!mesh_written_) this->write_mesh();
+
+    double corrected_time = (isfinite(this->registered_time_)?this->registered_time_:0);
+    corrected_time /= this->time_unit_converter->get_coef();
+
+    hid_t steps_group = H5Gopen2(file_id_, "Steps", H5P_DEFAULT);
+    hid_t step_group = create_group(steps_group, step_group_name(this->current_step));
+    write_double_attribute(step_group, "time", corrected_time);
+    for (unsigned int i_space=0; i_space<N_DISCRETE_SPACES; ++i_space)
+        this->write_field_data(step_group, group_names[i_space], this->output_data_vec_[i_space]);
+    H5Gclose(step_group);
+    H5Gclose(steps_group);
+    H5Fflush(file_id_, H5F_SCOPE_GLOBAL);
+
+    if (this->rank_ == 0) this->write_xdmf_frame(corrected_time);
+
+    LogOut() << "O.K.";
+
+    return 1;
+}
+
+
+
+void OutputHDF5::write_xdmf_attributes(OutputDataFieldVec &output_data_vec, const std::string &group_name,
+        const std::string &center, unsigned long long n_values)
+{
+    ofstream &file = this->_base_file;
+
+    for(OutputDataPtr data : output_data_vec) {
+        if (data->is_dummy()) continue;
+        file << "<Attribute Name=\"" << data->field_input_name() << "\" AttributeType=\""
+             << xdmf_attribute_type(data->n_comp()) << "\" Center=\"" << center << "\">" << endl;
+        file << "<DataItem Dimensions=\"" << n_values << " " << data->n_comp() << "\" "
+             << xdmf_number_type(data->vtk_type()) << " Format=\"HDF\">"
+             << h5_file_name_ << ":/Steps/" << step_group_name(this->current_step) << "/" << group_name
+             << "/" << data->field_input_name() << "</DataItem>" << endl;
+        file << "</Attribute>" << endl;
+    }
+}
+
+
+
+void OutputHDF5::write_xdmf_frame(double time)
+{
+    ofstream &file = this->_base_file;
+
+    file << "<Grid Name=\"frame_" << step_group_name(this->current_step) << "\" GridType=\"Uniform\">" << endl;
+    file << "<Time Value=\"" << time << "\"/>" << endl;
+
+    /* Topology and geometry refer to the mesh written at the first frame */
+    file << "<Topology TopologyType=\"Mixed\" NumberOfElements=\"" << n_global_elements_ << "\">" << endl;
+    file << "<DataItem Dimensions=\"" << n_global_topology_ << "\" NumberType=\"UInt\" Precision=\"4\" Format=\"HDF\">"
+         << h5_file_name_ << ":/Mesh/topology</DataItem>" << endl;
+    file << "</Topology>" << endl;
+    file << "<Geometry GeometryType=\"XYZ\">" << endl;
+    file << "<DataItem Dimensions=\"" << n_global_nodes_ << " 3\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">"
+         << h5_file_name_ << ":/Mesh/nodes</DataItem>" << endl;
+    file << "</Geometry>" << endl;
+
+    /* Node and corner data are both related to nodes of output mesh, native data are skipped */
+    this->write_xdmf_attributes(output_data_vec_[NODE_DATA], group_names[NODE_DATA], "Node", n_global_nodes_);
+    this->write_xdmf_attributes(output_data_vec_[CORNER_DATA], group_names[CORNER_DATA], "Node", n_global_nodes_);
+    this->write_xdmf_attributes(output_data_vec_[ELEM_DATA], group_names[ELEM_DATA], "Cell", n_global_elements_);
+
+    file << "</Grid>" << endl;
+    file.flush();
+}
+
+
+
+int OutputHDF5::write_head(void)
+{
+    /* Output to XDMF file is implemented only in the first process */
+    if(this->rank_ != 0) {
+        return 0;
+    }
+
+    LogOut() << __func__ << ": Writing output file (head) " << this->_base_filename << " ... ";
+
+    this->_base_file << "<?xml version=\"1.0\"?>" << endl;
+    this->_base_file << "<Xdmf Version=\"3.0\">" << endl;
+    this->_base_file << "<Domain>" << endl;
+    this->_base_file << "<Grid Name=\"" << this->equation_name_ << "\" GridType=\"Collection\" CollectionType=\"Temporal\">" << endl;
+
+    LogOut() << "O.K.";
+
+    return 1;
+}
+
+
+
+int OutputHDF5::write_tail(void)
+{
+    /* Output to XDMF file is implemented only in the first process */
+    if(this->rank_ != 0) {
+        return 0;
+    }
+
+    LogOut() << __func__ << ": Writing output file (tail) " << this->_base_filename << " ... ";
+
+    this->_base_file << "</Grid>" << endl;
+    this->_base_file << "</Domain>" << endl;
+    this->_base_file << "</Xdmf>" << endl;
+
+    LogOut() << "O.K.";
+
+    return 1;
+}
+
+#endif // FLOW123D_HAVE_HDF5
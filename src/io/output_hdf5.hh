@@ -0,0 +1,200 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    output_hdf5.hh
+ * @brief   Header: The functions for HDF5/XDMF outputs.
+ */
+
+#ifndef OUTPUT_HDF5_HH_
+#define OUTPUT_HDF5_HH_
+
+#include <memory>          // for shared_ptr
+#include <ostream>         // for ofstream, ostringstream
+#include <string>          // for string
+#include <vector>          // for vector
+#include "output_time.hh"  // for OutputTime, OutputTime::OutputDataFieldVec
+
+#include "config.h"
+
+#ifdef FLOW123D_HAVE_HDF5
+
+#include <hdf5.h>
+
+class TimeUnitConversion;
+namespace Input {
+	class Record;
+	namespace Type {
+		class Record;
+	}
+}
+
+using namespace std;
+
+
+/**
+ * \brief This class is used for output data to HDF5 file format with XDMF descriptor.
+ *
+ * All time frames are stored in a single HDF5 file. The mesh is written only once at the
+ * first time frame, the data of each frame are stored in group '/Steps/<frame>'. In parallel
+ * every process writes its own part of mesh and data into the common datasets using collective
+ * MPI-IO writes (requires HDF5 library compiled with parallel support). Otherwise data are gathered
+ * on the first process and written serially.
+ *
+ * Structure of the HDF5 file:
+ *  - /Mesh/nodes          [n_nodes x 3] coordinates of nodes
+ *  - /Mesh/connectivity   [n_conn] global indices of nodes of elements
+ *  - /Mesh/offsets        [n_elements] end offsets of elements in connectivity
+ *  - /Mesh/topology       [n_topo] XDMF mixed topology array
+ *  - /Steps/<frame>/{node_data,corner_data,element_data,native_data}/<field> [n_values x n_comp]
+ *
+ * The XDMF descriptor (.xdmf file) references these datasets, so the output can be opened by Paraview.
+ * Native data are written to HDF5 file but they are not listed in XDMF descriptor.
+ */
+class OutputHDF5 : public OutputTime {
+
+public:
+	typedef OutputTime FactoryBaseType;
+
+    /**
+     * \brief The constructor of this class.
+     */
+    OutputHDF5();
+
+    /**
+     * \brief The destructor of this class. It writes the last time frame, tail of XDMF file
+     * and closes the HDF5 file.
+     */
+    ~OutputHDF5();
+
+    /**
+     * \brief The definition of input record for HDF5 file format
+     */
+    static const Input::Type::Record & get_input_type();
+
+    /**
+     * \brief This function writes data of current time frame to HDF5 file and updates the XDMF descriptor.
+     */
+    int write_data(void) override;
+
+    /// Override @p OutputTime::init_from_input.
+    void init_from_input(const std::string &equation_name,
+                         const Input::Record &in_rec,
+                         const std::shared_ptr<TimeUnitConversion>& time_unit_conv) override;
+
+protected:
+
+    // XDMF mixed topology element types
+    typedef enum {
+        XDMF_POLYLINE = 2,
+        XDMF_TRIANGLE = 4,
+        XDMF_TETRA = 6
+    } XDMFElemType;
+
+    /// Registrar of class to factory
+    static const int registrar;
+
+    /**
+     * Position of local part of distributed dataset.
+     *
+     * In serial output (or on one process) holds offset = 0 and global size = local size.
+     */
+    struct DatasetPart {
+        hsize_t n_local;    ///< number of local rows
+        hsize_t offset;     ///< offset of local rows in global dataset
+        hsize_t n_global;   ///< total number of rows
+    };
+
+    /**
+     * Compute position of local part of size \p n_local in distributed dataset.
+     *
+     * Collective operation in parallel output.
+     */
+    DatasetPart make_dataset_part(hsize_t n_local);
+
+    /**
+     * Write distributed 2D dataset of \p n_cols columns to given group.
+     *
+     * Every process writes rows given by \p part. Collective operation in parallel output.
+     */
+    void write_dataset(hid_t group, const std::string &name, hid_t mem_type, hid_t file_type,
+            const DatasetPart &part, hsize_t n_cols, const void *data);
+
+    /**
+     * Write content of data cache to given group. Data are serialized through @p ElementDataCacheBase::print_binary_all.
+     */
+    void write_data_cache(hid_t group, OutputDataPtr output_data);
+
+    /**
+     * Write all non-dummy data caches of given discrete space to new group \p group_name.
+     */
+    void write_field_data(hid_t step_group, const std::string &group_name, OutputDataFieldVec &output_data_vec);
+
+    /// Create group of given name, close it by H5Gclose.
+    hid_t create_group(hid_t parent, const std::string &name);
+
+    /// Write scalar attribute of type double to the HDF5 object.
+    void write_double_attribute(hid_t object, const std::string &name, double value);
+
+    /**
+     * Write mesh (nodes, connectivity, offsets and XDMF topology) to the '/Mesh' group.
+     *
+     * Called only once at the first time frame.
+     */
+    void write_mesh();
+
+    /// Handle of HDF5 file.
+    hid_t file_id_;
+
+    /// Data transfer property list (collective in parallel output).
+    hid_t xfer_plist_;
+
+    /**
+     * \brief This function writes head of XDMF descriptor (.xdmf) file
+     */
+    int write_head(void);
+
+    /**
+     * \brief This function writes tail of XDMF descriptor (.xdmf) file
+     */
+    int write_tail(void);
+
+    /**
+     * Add grid of the current time frame to the XDMF descriptor.
+     */
+    void write_xdmf_frame(double time);
+
+    /**
+     * Write XDMF attribute elements of given data caches to the descriptor file.
+     */
+    void write_xdmf_attributes(OutputDataFieldVec &output_data_vec, const std::string &group_name,
+            const std::string &center, unsigned long long n_values);
+
+    /// Name of data cache group in the HDF5 file
+    static const std::vector<std::string> group_names;
+
+    /// Path of HDF5 data file
+    FilePath h5_file_path_;
+
+    /// File name of HDF5 data (relative to XDMF descriptor)
+    std::string h5_file_name_;
+
+    /// Global number of nodes, elements and size of XDMF topology array
+    unsigned long long n_global_nodes_, n_global_elements_, n_global_topology_;
+
+    /// Flag is set after mesh is written to the HDF5 file.
+    bool mesh_written_;
+};
+
+#endif // FLOW123D_HAVE_HDF5
+
+#endif /* OUTPUT_HDF5_HH_ */
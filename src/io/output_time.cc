@@ -27,10 +27,14 @@
 #include "io/output_time_set.hh"
 #include "io/observe.hh"
 #include "tools/time_governor.hh"
+#include "config.h"
 
 
 FLOW123D_FORCE_LINK_IN_PARENT(vtk)
 FLOW123D_FORCE_LINK_IN_PARENT(gmsh)
+#ifdef FLOW123D_HAVE_HDF5
+FLOW123D_FORCE_LINK_IN_PARENT(hdf5)
+#endif // FLOW123D_HAVE_HDF5
 
 
 namespace IT = Input::Type;
@@ -58,6 +62,8 @@ const IT::Record & OutputTime::get_input_type() {
                 "Default is 17 decimal digits which are necessary to reproduce double values exactly after write-read cycle.")
         .declare_key("observe_points", IT::Array(ObservePoint::get_input_type()), IT::Default("[]"),
                 "Array of observe points.")
+        .declare_key("observe_format", Observe::get_input_type_format(), IT::Default("\"yaml\""),
+                "Format of the file with values in observe points.")
 		.close();
 }
 
@@ -237,15 +243,34 @@ std::shared_ptr<Observe> OutputTime::observe(Mesh *mesh)
     if (! observe_) {
         auto observe_points = input_record_.val<Input::Array>("observe_points");
         unsigned int precision = input_record_.val<unsigned int>("precision");
+        auto format = input_record_.val<Observe::OutputFormat>("observe_format");
         observe_ = std::make_shared<Observe>(this->equation_name_,
                                              *mesh,
                                              observe_points, precision,
-                                             this->time_unit_converter);
+                                             this->time_unit_converter, format);
     }
     return observe_;
 }
 
 
+void OutputTime::flush_observe()
+{
+    if (observe_) observe_->flush_buffer();
+}
+
+
+void OutputTime::save_state(CheckpointData &data, const std::string &prefix)
+{
+    if (observe_) observe_->save_state(data, prefix + "/observe");
+}
+
+
+void OutputTime::load_state(const CheckpointData &data, const std::string &prefix)
+{
+    if (observe_) observe_->load_state(data, prefix + "/observe");
+}
+
+
 void OutputTime::clear_data(void)
 {
     // fill all the existing output data with dummy cash
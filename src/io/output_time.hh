@@ -25,6 +25,7 @@
 #include "input/accessors.hh"   // for Iterator, Array (ptr only), Record
 #include "system/file_path.hh"  // for FilePath
 
+class CheckpointData;
 class ElementDataCacheBase;
 class Mesh;
 class Observe;
@@ -172,6 +173,18 @@ public:
      */
     std::shared_ptr<Observe> observe(Mesh *mesh);
 
+    /**
+     * Write buffered values of the observe object (if exists) to its output file.
+     * Used before a checkpoint, collective operation.
+     */
+    void flush_observe();
+
+    /// Store state of the observe output (if exists) to the checkpoint.
+    void save_state(CheckpointData &data, const std::string &prefix);
+
+    /// Restore state stored by @p save_state, the observe file is appended after the restart.
+    void load_state(const CheckpointData &data, const std::string &prefix);
+
     /**
      * \brief Clear data for output computed by method @p compute_field_data.
      */
@@ -0,0 +1,242 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    csr_assembly.cc
+ * @brief   Assembly of local matrices directly into CSR arrays of PETSc AIJ matrix.
+ */
+
+#include <algorithm>
+#include "la/csr_assembly.hh"
+#include "la/distribution.hh"
+#include "system/system.hh"
+#include "system/sys_profiler.hh"
+
+
+CsrAssembly::CsrAssembly(const Distribution *rows_ds)
+: rows_ds_(rows_ds),
+  mat_(NULL),
+  row_cols_(rows_ds->lsize()),
+  row_unique_sizes_(rows_ds->lsize(), 0),
+  nonlocal_pattern_(rows_ds->np()),
+  call_index_starts_(1, 0),
+  call_position_starts_(1, 0),
+  i_call_(0),
+  diag_block_(NULL),
+  offdiag_block_(NULL),
+  diag_values_(NULL),
+  offdiag_values_(NULL)
+{}
+
+
+void CsrAssembly::add_pattern(int nrow, const int *rows, int ncol, const int *cols)
+{
+    for (int i=0; i<nrow; i++) {
+        if (rows[i] < 0) continue;
+        if (rows_ds_->is_local(rows[i])) {
+            unsigned int loc_row = rows[i] - rows_ds_->begin();
+            std::vector<PetscInt> &row_cols = row_cols_[loc_row];
+            for (int j=0; j<ncol; j++)
+                if (cols[j] >= 0) row_cols.push_back(cols[j]);
+            // remove duplicities when the row doubles its size, keeps memory proportional to the pattern
+            if (row_cols.size() >= 2*std::max(row_unique_sizes_[loc_row], 16u)) {
+                std::sort(row_cols.begin(), row_cols.end());
+                row_cols.erase( std::unique(row_cols.begin(), row_cols.end()), row_cols.end() );
+                row_unique_sizes_[loc_row] = row_cols.size();
+            }
+        } else {
+            std::vector<int> &pattern = nonlocal_pattern_[rows_ds_->get_proc(rows[i])];
+            for (int j=0; j<ncol; j++)
+                if (cols[j] >= 0) {
+                    pattern.push_back(rows[i]);
+                    pattern.push_back(cols[j]);
+                }
+        }
+    }
+}
+
+
+void CsrAssembly::preallocate(Mat mat)
+{
+    START_TIMER("CsrAssembly::preallocate");
+    mat_ = mat;
+    unsigned int np = rows_ds_->np();
+
+    // send pairs (row, col) to owners of rows
+    std::vector<int> send_counts(np), send_displs(np), recv_counts(np), recv_displs(np);
+    std::vector<int> send_buf;
+    for (unsigned int proc=0; proc<np; proc++) {
+        send_displs[proc] = send_buf.size();
+        send_counts[proc] = nonlocal_pattern_[proc].size();
+        send_buf.insert(send_buf.end(), nonlocal_pattern_[proc].begin(), nonlocal_pattern_[proc].end());
+        std::vector<int>().swap(nonlocal_pattern_[proc]);
+    }
+    MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, rows_ds_->get_comm());
+    int recv_size = 0;
+    for (unsigned int proc=0; proc<np; proc++) {
+        recv_displs[proc] = recv_size;
+        recv_size += recv_counts[proc];
+    }
+    send_buf.push_back(0); // avoid NULL pointers of empty buffers
+    std::vector<int> recv_buf(recv_size+1);
+    MPI_Alltoallv(send_buf.data(), send_counts.data(), send_displs.data(), MPI_INT,
+                  recv_buf.data(), recv_counts.data(), recv_displs.data(), MPI_INT, rows_ds_->get_comm());
+    for (int k=0; k<recv_size; k+=2)
+        row_cols_[ recv_buf[k] - rows_ds_->begin() ].push_back(recv_buf[k+1]);
+
+    // CSR structure with sorted columns
+    unsigned int lsize = rows_ds_->lsize();
+    csr_rows_.assign(lsize+1, 0);
+    csr_cols_.clear();
+    for (unsigned int loc_row=0; loc_row<lsize; loc_row++) {
+        std::vector<PetscInt> &row_cols = row_cols_[loc_row];
+        std::sort(row_cols.begin(), row_cols.end());
+        row_cols.erase( std::unique(row_cols.begin(), row_cols.end()), row_cols.end() );
+        csr_cols_.insert(csr_cols_.end(), row_cols.begin(), row_cols.end());
+        csr_rows_[loc_row+1] = csr_cols_.size();
+        std::vector<PetscInt>().swap(row_cols);
+    }
+    std::vector< std::vector<PetscInt> >().swap(row_cols_);
+    std::vector<unsigned int>().swap(row_unique_sizes_);
+
+    // Entries of the diagonal and off-diagonal block are stored by PETSc in the same order as in the CSR
+    // (off-diagonal columns are compressed by sorted map of global indices, so their order is kept).
+    csr_positions_.resize(csr_cols_.size());
+    PetscInt n_diag = 0, n_offdiag = 0;
+    for (unsigned int k=0; k<csr_cols_.size(); k++)
+        csr_positions_[k] = rows_ds_->is_local(csr_cols_[k]) ? n_diag++ : -3 - n_offdiag++;
+
+    csr_cols_.push_back(0); // avoid NULL pointer of empty pattern
+    chkerr(MatSeqAIJSetPreallocationCSR(mat_, csr_rows_.data(), csr_cols_.data(), NULL));
+    chkerr(MatMPIAIJSetPreallocationCSR(mat_, csr_rows_.data(), csr_cols_.data(), NULL));
+    csr_cols_.pop_back();
+    // positions of entries are valid only for unchanged pattern
+    chkerr(MatSetOption(mat_, MAT_KEEP_NONZERO_PATTERN, PETSC_TRUE));
+
+    PetscBool is_mpi;
+    chkerr(PetscObjectTypeCompare((PetscObject)mat_, MATMPIAIJ, &is_mpi));
+    if (is_mpi) {
+        const PetscInt *col_map;
+        chkerr(MatMPIAIJGetSeqAIJ(mat_, &diag_block_, &offdiag_block_, &col_map));
+    } else {
+        diag_block_ = mat_;
+        offdiag_block_ = NULL;
+    }
+
+    // new pattern, recorded calls are not valid
+    call_index_starts_.assign(1, 0);
+    call_position_starts_.assign(1, 0);
+    call_indices_.clear();
+    call_positions_.clear();
+    i_call_ = 0;
+}
+
+
+void CsrAssembly::start_assembly()
+{
+    i_call_ = 0;
+}
+
+
+void CsrAssembly::add_values(int nrow, const int *rows, int ncol, const int *cols, const double *vals)
+{
+    ASSERT_PTR(mat_).error("Matrix is not preallocated.\n");
+    if (nrow == 0 || ncol == 0) return;
+    if (diag_values_ == NULL) {
+        chkerr(MatSeqAIJGetArray(diag_block_, &diag_values_));
+        if (offdiag_block_ != NULL) chkerr(MatSeqAIJGetArray(offdiag_block_, &offdiag_values_));
+    }
+
+    // compare the call with the recorded one
+    bool match = false;
+    if (i_call_+1 < call_index_starts_.size()) {
+        const int *rec = call_indices_.data() + call_index_starts_[i_call_];
+        match = (rec[0] == nrow) && (rec[1] == ncol)
+                && std::equal(rows, rows+nrow, rec+2) && std::equal(cols, cols+ncol, rec+2+nrow);
+    }
+    if (! match) {
+        // drop the rest of the recorded sequence
+        call_index_starts_.resize(i_call_+1);
+        call_position_starts_.resize(i_call_+1);
+        call_indices_.resize(call_index_starts_.back());
+        call_positions_.resize(call_position_starts_.back());
+        record_call(nrow, rows, ncol, cols);
+    }
+    const PetscInt *positions = call_positions_.data() + call_position_starts_[i_call_];
+    i_call_++;
+
+    for (int i=0; i<nrow; i++) {
+        const PetscInt *row_positions = positions + i*ncol;
+        const double *row_vals = vals + i*ncol;
+        if (row_positions[0] == fallback_row) {
+            chkerr(MatSetValues(mat_, 1, rows+i, ncol, cols, row_vals, ADD_VALUES));
+            continue;
+        }
+        for (int j=0; j<ncol; j++) {
+            PetscInt pos = row_positions[j];
+            if (pos >= 0) diag_values_[pos] += row_vals[j];
+            else if (pos <= -3) offdiag_values_[-3-pos] += row_vals[j];
+        }
+    }
+}
+
+
+void CsrAssembly::restore_arrays()
+{
+    if (diag_values_ != NULL) {
+        chkerr(MatSeqAIJRestoreArray(diag_block_, &diag_values_));
+        if (offdiag_block_ != NULL) chkerr(MatSeqAIJRestoreArray(offdiag_block_, &offdiag_values_));
+        diag_values_ = NULL;
+        offdiag_values_ = NULL;
+    }
+}
+
+
+void CsrAssembly::record_call(int nrow, const int *rows, int ncol, const int *cols)
+{
+    call_indices_.push_back(nrow);
+    call_indices_.push_back(ncol);
+    call_indices_.insert(call_indices_.end(), rows, rows+nrow);
+    call_indices_.insert(call_indices_.end(), cols, cols+ncol);
+    call_index_starts_.push_back(call_indices_.size());
+
+    for (int i=0; i<nrow; i++) {
+        if (rows[i] < 0) {
+            call_positions_.insert(call_positions_.end(), ncol, skip_entry);
+        } else if (! rows_ds_->is_local(rows[i])) {
+            call_positions_.insert(call_positions_.end(), ncol, fallback_row);
+        } else {
+            PetscInt loc_row = rows[i] - rows_ds_->begin();
+            unsigned int row_start = call_positions_.size();
+            bool in_pattern = true;
+            for (int j=0; j<ncol; j++) {
+                PetscInt pos = (cols[j] < 0) ? skip_entry : entry_position(loc_row, cols[j]);
+                if (pos == fallback_row) in_pattern = false;
+                call_positions_.push_back(pos);
+            }
+            // entry out of pattern, let PETSc report the error
+            if (! in_pattern)
+                std::fill(call_positions_.begin()+row_start, call_positions_.end(), fallback_row);
+        }
+    }
+    call_position_starts_.push_back(call_positions_.size());
+}
+
+
+PetscInt CsrAssembly::entry_position(PetscInt loc_row, PetscInt col) const
+{
+    auto row_begin = csr_cols_.begin() + csr_rows_[loc_row];
+    auto row_end = csr_cols_.begin() + csr_rows_[loc_row+1];
+    auto it = std::lower_bound(row_begin, row_end, col);
+    if (it == row_end || *it != col) return fallback_row;
+    return csr_positions_[it - csr_cols_.begin()];
+}
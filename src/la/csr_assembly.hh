@@ -0,0 +1,122 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    csr_assembly.hh
+ * @brief   Assembly of local matrices directly into CSR arrays of PETSc AIJ matrix.
+ */
+
+#ifndef LA_CSR_ASSEMBLY_HH_
+#define LA_CSR_ASSEMBLY_HH_
+
+#include <vector>
+#include "petscmat.h"
+
+class Distribution;
+
+
+/**
+ * @brief Assembly of local matrices directly into the value arrays of PETSc AIJ matrix.
+ *
+ * The exact sparsity pattern is collected in the allocation pass of LinSys (blocks of rows
+ * and columns given to @p add_pattern), entries of rows owned by other processors are sent
+ * to their owners. The matrix is preallocated by its CSR structure, so the layout of the value
+ * arrays of the diagonal and off-diagonal block of the matrix is known without asking PETSc.
+ *
+ * Assemblies repeat the same sequence of calls of @p add_values (the order of cells and
+ * local matrices does not change). The first assembly records for every call the positions
+ * of its entries in the value arrays, found by binary search in the pattern. Following assemblies
+ * only compare indices of the call with the recorded ones and add values by plain indexed adds.
+ * If the call differs, the rest of the sequence is recorded again. Rows of other processors
+ * are passed to MatSetValues and communicated in the matrix assembly as usual.
+ *
+ * Only ADD_VALUES mode and AIJ matrices (sequential or MPI) are supported.
+ */
+class CsrAssembly {
+public:
+    /// Constructor, @p rows_ds is distribution of rows and columns of the square matrix.
+    CsrAssembly(const Distribution *rows_ds);
+
+    /// Add entries of the block given by @p rows and @p cols to the pattern. Negative indices are skipped.
+    void add_pattern(int nrow, const int *rows, int ncol, const int *cols);
+
+    /**
+     * Complete the pattern by entries of local rows given by other processors and preallocate
+     * matrix @p mat by its CSR structure. The matrix must have set type AIJ and sizes.
+     */
+    void preallocate(Mat mat);
+
+    /// Start new sequence of calls of @p add_values.
+    void start_assembly();
+
+    /// Add block of values @p vals (row major) given by @p rows and @p cols. Negative indices are skipped.
+    void add_values(int nrow, const int *rows, int ncol, const int *cols, const double *vals);
+
+    /**
+     * Return value arrays to the matrix, must be called before any PETSc operation with the matrix
+     * (assembly, zeroing, destruction).
+     */
+    void restore_arrays();
+
+private:
+    /**
+     * Position codes of entries: non-negative code is index into value array of the diagonal block,
+     * code c <= -3 is index (-3-c) into value array of the off-diagonal block, other codes mark entries
+     * that are skipped (negative index) and rows passed to MatSetValues.
+     */
+    static constexpr PetscInt skip_entry = -1;
+    static constexpr PetscInt fallback_row = -2;
+
+    /// Record call of @p add_values at the end of recorded sequence.
+    void record_call(int nrow, const int *rows, int ncol, const int *cols);
+
+    /// Find position code of the entry (@p row, @p col) of local row.
+    PetscInt entry_position(PetscInt loc_row, PetscInt col) const;
+
+    /// Distribution of rows.
+    const Distribution *rows_ds_;
+
+    /// Matrix being assembled.
+    Mat mat_;
+
+    /// Columns of local rows collected in the allocation pass.
+    std::vector< std::vector<PetscInt> > row_cols_;
+
+    /// Sizes of rows in @p row_cols_ after their last compression.
+    std::vector<unsigned int> row_unique_sizes_;
+
+    /// Pairs (row, col) of rows owned by other processors, for every processor.
+    std::vector< std::vector<int> > nonlocal_pattern_;
+
+    /// CSR pattern of local rows: starts of rows, global column indices and position codes of entries.
+    std::vector<PetscInt> csr_rows_, csr_cols_, csr_positions_;
+
+    /// Recorded calls: starts of indices and position codes of every call.
+    std::vector<unsigned int> call_index_starts_, call_position_starts_;
+
+    /// Recorded calls: nrow, ncol, rows and cols of every call.
+    std::vector<int> call_indices_;
+
+    /// Recorded calls: position codes of all entries of every call.
+    std::vector<PetscInt> call_positions_;
+
+    /// Index of the next call in the actual sequence.
+    unsigned int i_call_;
+
+    /// Diagonal and off-diagonal block of the matrix (off-diagonal is NULL for sequential matrix).
+    Mat diag_block_, offdiag_block_;
+
+    /// Value arrays of the blocks, NULL if not taken from the matrix.
+    PetscScalar *diag_values_, *offdiag_values_;
+};
+
+#endif /* LA_CSR_ASSEMBLY_HH_ */
@@ -239,6 +239,21 @@ public:
     bool is_rhs_changed()
     { return rhs_changed_;}
 
+    /**
+     * Request rebuild of the preconditioner in the next solve, e.g. after a substantial change
+     * of the matrix. Used by solvers that reuse the preconditioner, default implementation does nothing.
+     */
+    virtual void force_pc_rebuild()
+    {}
+
+    /**
+     * Notify the solver about the start of a new time step. Solvers extrapolating the initial guess
+     * from previous solutions use only the last solve of each step, so repeated solves of a nonlinear
+     * iteration do not spoil the extrapolation. Default implementation does nothing.
+     */
+    virtual void start_time_step()
+    {}
+
 
     /**
      * Sets PETSC matrix (only for PETSC solvers)
@@ -17,6 +17,8 @@
  */
 
 // derived from base linsys
+#include <cctype>
+#include <sstream>
 #include "la/linsys_PETSC.hh"
 #include "petscvec.h"
 #include "petscksp.h"
@@ -29,6 +31,35 @@
 
 namespace it = Input::Type;
 
+
+namespace {
+
+/// Number of created solvers, used for unique options prefixes.
+unsigned int n_options_prefixes = 0;
+
+/// Return unique options prefix of a new solver.
+std::string new_options_prefix()
+{
+    return "flow123d_ls" + std::to_string(n_options_prefixes++) + "_";
+}
+
+/// Add @p prefix to all option names (e.g. '-ksp_type' -> '-<prefix>ksp_type') in PETSc options string.
+std::string prefix_options(const std::string &options, const std::string &prefix)
+{
+    std::istringstream in(options);
+    std::string token, prefixed;
+    while (in >> token) {
+        if (token.size() > 1 && token[0] == '-' && std::isalpha(token[1]))
+            token = "-" + prefix + token.substr(1);
+        if (! prefixed.empty()) prefixed += " ";
+        prefixed += token;
+    }
+    return prefixed;
+}
+
+} // namespace
+
+
 const it::Record & LinSys_PETSC::get_input_type() {
 	return it::Record("Petsc", "PETSc solver settings.\n It provides interface to various PETSc solvers. The convergence criteria is:\n"
 	        "```\n"
@@ -52,6 +83,27 @@ const it::Record & LinSys_PETSC::get_input_type() {
         .declare_key("max_it", it::Integer(0), it::Default::read_time("Default value is set by the nonlinear solver or the equation. "
                         "If not, we use the value 1000."),
                     "Maximum number of outer iterations of the linear solver.")
+        .declare_key("pc_reuse_steps", it::Integer(1), it::Default::read_time("Default value is set by the equation. "
+                        "If not, we use the value 1, i.e. the preconditioner is rebuilt whenever the matrix changes."),
+                    "Maximal number of solutions with changed matrix using the same preconditioner.")
+        .declare_key("pc_reuse_iter_growth", it::Double(1.0), it::Default::read_time("Default value is set by the equation. "
+                        "If not, we use the value 1.5."),
+                    "Reused preconditioner is rebuilt if the number of iterations exceeds the number of iterations "
+                    "of its first solution multiplied by this factor.")
+        .declare_key("csr_assembly", it::Bool(), it::Default::read_time("Default value is set by the equation. "
+                        "If not, we use the value false."),
+                    "Assemble the matrix directly into CSR arrays of the AIJ matrix. The exact sparsity pattern is computed "
+                    "once and positions of local matrices in the arrays are reused in following assemblies.")
+        .declare_key("krylov_recycling", it::Integer(0), it::Default::read_time("Default value is set by the equation. "
+                        "If not, we use the value 0, i.e. no recycling."),
+                    "Dimension of the Krylov subspace recycled between solutions of systems with slowly changing matrix. "
+                    "GCRO-DR method of HPDDM is used, or deflated GMRES if PETSc is built without HPDDM. "
+                    "The Krylov method given by 'options' is overridden for this solver only.")
+        .declare_key("initial_guess_history", it::Integer(1, 4), it::Default::read_time("Default value is set by the equation. "
+                        "If not, we use the value 1, i.e. the last solution."),
+                    "Number of previous solutions used for polynomial extrapolation of the initial guess. "
+                    "Extrapolation assumes equidistant time steps, solutions of nonlinear iterations within a time step "
+                    "are not used.")
 		.declare_key("options", it::String(), it::Default("\"\""),  "This options is passed to PETSC to create a particular KSP (Krylov space method).\n"
                                                                     "If the string is left empty (by default), the internal default options is used.")
 		.close();
@@ -65,7 +117,23 @@ LinSys_PETSC::LinSys_PETSC( const Distribution * rows_ds, const std::string &par
         : LinSys( rows_ds ),
           params_(params),
           init_guess_nonzero(false),
-          matrix_(0)
+          matrix_(0),
+          block_size_(1),
+          use_baij_(false),
+          near_null_space_(NULL),
+          ksp_matrix_(NULL),
+          pc_reuse_max_steps_(1),
+          pc_reuse_iter_growth_(1.5),
+          pc_age_(0),
+          pc_ref_iterations_(0),
+          pc_rebuild_requested_(false),
+          use_csr_assembly_(false),
+          recycle_dim_(0),
+          n_guess_history_(1),
+          history_by_steps_(false),
+          step_solved_(false),
+          step_solution_(NULL),
+          options_prefix_(new_options_prefix())
 {
     // create PETSC vectors:
     PetscErrorCode ierr;
@@ -76,14 +144,23 @@ LinSys_PETSC::LinSys_PETSC( const Distribution * rows_ds, const std::string &par
     VecDuplicate(rhs_, &residual_);
 
     matrix_ = NULL;
+    system = NULL;
     solution_precision_ = std::numeric_limits<double>::infinity();
     matrix_changed_ = true;
     rhs_changed_ = true;
 }
 
 LinSys_PETSC::LinSys_PETSC( LinSys_PETSC &other )
-	: LinSys(other), params_(other.params_), v_rhs_(NULL), solution_precision_(other.solution_precision_)
+	: LinSys(other), params_(other.params_), v_rhs_(NULL), solution_precision_(other.solution_precision_),
+	  block_size_(other.block_size_), use_baij_(other.use_baij_), near_null_space_(other.near_null_space_),
+	  ksp_matrix_(NULL), pc_reuse_max_steps_(other.pc_reuse_max_steps_), pc_reuse_iter_growth_(other.pc_reuse_iter_growth_),
+	  pc_age_(0), pc_ref_iterations_(0), pc_rebuild_requested_(false), use_csr_assembly_(other.use_csr_assembly_),
+	  recycle_dim_(other.recycle_dim_), n_guess_history_(other.n_guess_history_),
+	  history_by_steps_(other.history_by_steps_), step_solved_(false), step_solution_(NULL),
+	  options_prefix_(new_options_prefix())
 {
+	system = NULL;
+	if (near_null_space_ != NULL) PetscObjectReference((PetscObject)near_null_space_);
 	MatCopy(other.matrix_, matrix_, DIFFERENT_NONZERO_PATTERN);
 	VecCopy(other.rhs_, rhs_);
 	VecCopy(other.on_vec_, on_vec_);
@@ -112,13 +189,21 @@ void LinSys_PETSC::start_allocation( )
 {
     PetscErrorCode ierr;
 
-    ierr = VecCreateMPI( comm_, rows_ds_->lsize(), PETSC_DECIDE, &(on_vec_) ); CHKERRV( ierr ); 
-    ierr = VecDuplicate( on_vec_, &(off_vec_) ); CHKERRV( ierr ); 
+    if (csr_assembly_) csr_assembly_->restore_arrays();
+    if (use_csr_assembly_ && !use_baij_) {
+        // exact pattern is collected instead of counts of entries
+        csr_assembly_ = std::make_shared<CsrAssembly>(rows_ds_);
+    } else {
+        csr_assembly_.reset();
+        ierr = VecCreateMPI( comm_, rows_ds_->lsize(), PETSC_DECIDE, &(on_vec_) ); CHKERRV( ierr ); 
+        ierr = VecDuplicate( on_vec_, &(off_vec_) ); CHKERRV( ierr ); 
+    }
     status_ = ALLOCATE;
 }
 
 void LinSys_PETSC::start_add_assembly()
 {
+    bool new_assembly = (status_ == ALLOCATE || status_ == DONE);
     switch ( status_ ) {
         case ALLOCATE:
             this->preallocate_matrix( );
@@ -132,6 +217,7 @@ void LinSys_PETSC::start_add_assembly()
         default:
         	ASSERT_PERMANENT(false).error("Can not set values. Matrix is not preallocated.\n");
     }
+    if (csr_assembly_ && new_assembly) csr_assembly_->start_assembly();
     status_ = ADD;
 }
 
@@ -158,11 +244,15 @@ void LinSys_PETSC::mat_set_values( int nrow, int *rows, int ncol, int *cols, dou
     // here vals would need to be converted from double to PetscScalar if it was ever something else than double :-)
     switch (status_) {
         case INSERT:
-        case ADD:
             chkerr(MatSetValues(matrix_,nrow,rows,ncol,cols,vals,(InsertMode)status_));
             break;
+        case ADD:
+            if (csr_assembly_) csr_assembly_->add_values(nrow,rows,ncol,cols,vals);
+            else chkerr(MatSetValues(matrix_,nrow,rows,ncol,cols,vals,(InsertMode)status_));
+            break;
         case ALLOCATE:
-            this->preallocate_values(nrow,rows,ncol,cols); 
+            if (csr_assembly_) csr_assembly_->add_pattern(nrow,rows,ncol,cols);
+            else this->preallocate_values(nrow,rows,ncol,cols); 
             break;
         default: DebugOut() << "LS SetValues with non allowed insert mode.\n";
     }
@@ -209,6 +299,19 @@ void LinSys_PETSC::preallocate_matrix()
 {
 	ASSERT_EQ(status_, ALLOCATE).error("Linear system has to be in ALLOCATE status.");
 
+    if (csr_assembly_) {
+        // matrix with exact CSR pattern
+        if (matrix_ != NULL) chkerr(MatDestroy(&matrix_));
+        chkerr(MatCreate(PETSC_COMM_WORLD, &matrix_));
+        chkerr(MatSetSizes(matrix_, rows_ds_->lsize(), rows_ds_->lsize(), PETSC_DETERMINE, PETSC_DETERMINE));
+        if (block_size_ > 1) chkerr(MatSetBlockSize(matrix_, block_size_));
+        chkerr(MatSetType(matrix_, MATAIJ));
+        csr_assembly_->preallocate(matrix_);
+        if (symmetric_) MatSetOption(matrix_, MAT_SYMMETRIC, PETSC_TRUE);
+        MatSetOption(matrix_, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_TRUE);
+        return;
+    }
+
     PetscErrorCode ierr;
     PetscInt *on_nz, *off_nz;
     PetscScalar *on_array, *off_array;
@@ -241,8 +344,33 @@ void LinSys_PETSC::preallocate_matrix()
     {
     	chkerr(MatDestroy(&matrix_));
     }
-    ierr = MatCreateAIJ(PETSC_COMM_WORLD, rows_ds_->lsize(), rows_ds_->lsize(), PETSC_DETERMINE, PETSC_DETERMINE,
-                           0, on_nz, 0, off_nz, &matrix_); CHKERRV( ierr );
+    if (block_size_ == 1) {
+        ierr = MatCreateAIJ(PETSC_COMM_WORLD, rows_ds_->lsize(), rows_ds_->lsize(), PETSC_DETERMINE, PETSC_DETERMINE,
+                               0, on_nz, 0, off_nz, &matrix_); CHKERRV( ierr );
+    } else {
+        // block size has to be set before preallocation
+        chkerr(MatCreate(PETSC_COMM_WORLD, &matrix_));
+        chkerr(MatSetSizes(matrix_, rows_ds_->lsize(), rows_ds_->lsize(), PETSC_DETERMINE, PETSC_DETERMINE));
+        chkerr(MatSetBlockSize(matrix_, block_size_));
+        if (use_baij_) {
+            // number of nonzero blocks in block row is given by its densest row
+            unsigned int n_block_rows = rows_ds_->lsize() / block_size_;
+            std::vector<PetscInt> on_nz_block(n_block_rows, 0), off_nz_block(n_block_rows, 0);
+            PetscInt bs = block_size_;
+            for ( unsigned int i=0; i<rows_ds_->lsize(); i++ ) {
+                on_nz_block[i/bs]  = std::max( on_nz_block[i/bs],  (on_nz[i]+bs-1)/bs );
+                off_nz_block[i/bs] = std::max( off_nz_block[i/bs], (off_nz[i]+bs-1)/bs );
+            }
+            chkerr(MatSetType(matrix_, MATBAIJ));
+            chkerr(MatSeqBAIJSetPreallocation(matrix_, block_size_, 0, makePetscPointer_(on_nz_block)));
+            chkerr(MatMPIBAIJSetPreallocation(matrix_, block_size_, 0, makePetscPointer_(on_nz_block),
+                                              0, makePetscPointer_(off_nz_block)));
+        } else {
+            chkerr(MatSetType(matrix_, MATAIJ));
+            chkerr(MatSeqAIJSetPreallocation(matrix_, 0, on_nz));
+            chkerr(MatMPIAIJSetPreallocation(matrix_, 0, on_nz, 0, off_nz));
+        }
+    }
 
     if (symmetric_) MatSetOption(matrix_, MAT_SYMMETRIC, PETSC_TRUE);
     MatSetOption(matrix_, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_TRUE);
@@ -250,7 +378,9 @@ void LinSys_PETSC::preallocate_matrix()
     // This option is used in order to assembly larger local matrices with own non-zero structure.
     // Zero entries are ignored so we must prevent adding exact zeroes.
     // Add LocalSystem::almost_zero for entries that should not be eliminated.
-    MatSetOption(matrix_, MAT_IGNORE_ZERO_ENTRIES, PETSC_TRUE);
+    // BAIJ format stores whole blocks, so the option has no sense there.
+    if (! use_baij_ || block_size_ == 1)
+        MatSetOption(matrix_, MAT_IGNORE_ZERO_ENTRIES, PETSC_TRUE);
 
 
 
@@ -272,6 +402,7 @@ void LinSys_PETSC::finish_assembly( MatAssemblyType assembly_type )
     	WarningOut() << "Finalizing linear system without setting values.\n";
         this->preallocate_matrix();
     }
+    if (csr_assembly_) csr_assembly_->restore_arrays();
     ierr = MatAssemblyBegin(matrix_, assembly_type); CHKERRV( ierr ); 
     ierr = VecAssemblyBegin(rhs_); CHKERRV( ierr ); 
     ierr = MatAssemblyEnd(matrix_, assembly_type); CHKERRV( ierr ); 
@@ -339,6 +470,86 @@ void LinSys_PETSC::set_initial_guess_nonzero(bool set_nonzero)
 }
 
 
+void LinSys_PETSC::set_block_size(unsigned int block_size, bool use_baij)
+{
+	ASSERT_GT(block_size, 0);
+	ASSERT_EQ(rows_ds_->lsize() % block_size, 0)(rows_ds_->lsize())(block_size).error("Local size is not divisible by the block size.");
+	ASSERT(matrix_ == NULL).error("Block size has to be set before preallocation of the matrix.");
+	block_size_ = block_size;
+	use_baij_ = use_baij;
+}
+
+
+void LinSys_PETSC::set_pc_reuse(unsigned int max_steps, double iter_growth)
+{
+	if (! in_rec_.is_empty()) {
+		pc_reuse_max_steps_ = in_rec_.val<unsigned int>("pc_reuse_steps", max_steps);
+		pc_reuse_iter_growth_ = in_rec_.val<double>("pc_reuse_iter_growth", iter_growth);
+	} else {
+		pc_reuse_max_steps_ = max_steps;
+		pc_reuse_iter_growth_ = iter_growth;
+	}
+}
+
+
+void LinSys_PETSC::set_csr_assembly(bool use_csr_assembly)
+{
+	if (! in_rec_.is_empty())
+		use_csr_assembly_ = in_rec_.val<bool>("csr_assembly", use_csr_assembly);
+	else
+		use_csr_assembly_ = use_csr_assembly;
+}
+
+
+void LinSys_PETSC::set_krylov_acceleration(unsigned int recycle_dim, unsigned int n_history)
+{
+	if (! in_rec_.is_empty()) {
+		recycle_dim_ = in_rec_.val<unsigned int>("krylov_recycling", recycle_dim);
+		n_guess_history_ = in_rec_.val<unsigned int>("initial_guess_history", n_history);
+	} else {
+		recycle_dim_ = recycle_dim;
+		n_guess_history_ = n_history;
+	}
+	unsigned int n_stored = (n_guess_history_ > 1) ? n_guess_history_ : 0;
+	while (solution_history_.size() > n_stored) {
+		chkerr(VecDestroy(&solution_history_.back()));
+		solution_history_.pop_back();
+	}
+}
+
+
+void LinSys_PETSC::start_time_step()
+{
+	if (history_by_steps_ && step_solved_ && n_guess_history_ > 1)
+		push_solution_history(step_solution_);
+	history_by_steps_ = true;
+	step_solved_ = false;
+}
+
+
+void LinSys_PETSC::push_solution_history(Vec solution)
+{
+	Vec newest;
+	if (solution_history_.size() >= n_guess_history_) {
+		// reuse vector of the oldest solution
+		newest = solution_history_.back();
+		solution_history_.pop_back();
+	} else {
+		chkerr(VecDuplicate(solution, &newest));
+	}
+	chkerr(VecCopy(solution, newest));
+	solution_history_.insert(solution_history_.begin(), newest);
+}
+
+
+void LinSys_PETSC::set_near_null_space(MatNullSpace near_null_space)
+{
+	chkerr(PetscObjectReference((PetscObject)near_null_space));
+	if (near_null_space_ != NULL) chkerr(MatNullSpaceDestroy(&near_null_space_));
+	near_null_space_ = near_null_space;
+}
+
+
 LinSys::SolveInfo LinSys_PETSC::solve()
 {
 
@@ -373,45 +584,119 @@ LinSys::SolveInfo LinSys_PETSC::solve()
     }
 
     if (params_ == "") params_ = petsc_dflt_opt;
-    LogOut().fmt("inserting petsc options: {}\n",params_.c_str());
+    std::string options = params_;
+    if (recycle_dim_ > 0) {
+        // Krylov method with recycling overrides the method given by user, options are prefixed
+        // by the prefix of this solver, so the other solvers are not affected
+#ifdef PETSC_HAVE_HPDDM
+        options += " -ksp_type hpddm -ksp_hpddm_type gcrodr -ksp_hpddm_recycle " + std::to_string(recycle_dim_);
+#else
+        options += " -ksp_type dgmres -ksp_dgmres_force -ksp_dgmres_eigen " + std::to_string(recycle_dim_);
+#endif
+        options = prefix_options(options, options_prefix_);
+    }
+    LogOut().fmt("inserting petsc options: {}\n",options.c_str());
     
     // now takes an optional PetscOptions object as the first argument
     // value NULL will preserve previous behaviour previous behavior.
-    PetscOptionsInsertString(NULL, params_.c_str()); // overwrites previous options values
+    PetscOptionsInsertString(NULL, options.c_str()); // overwrites previous options values
     
-    MatSetOption( matrix_, MAT_USE_INODES, PETSC_FALSE );
+    // inodes are kept for block matrices of vector problems
+    if (block_size_ == 1) MatSetOption( matrix_, MAT_USE_INODES, PETSC_FALSE );
+    if (near_null_space_ != NULL) chkerr(MatSetNearNullSpace(matrix_, near_null_space_));
     
-    chkerr(KSPCreate( comm_, &system ));
+    // KSP is kept between solves, it is recreated only if the matrix was reallocated
+    bool rebuild_pc = true;
+    if (system == NULL || ksp_matrix_ != matrix_) {
+        if (system != NULL) chkerr(KSPDestroy(&system));
+        chkerr(KSPCreate( comm_, &system ));
+        ksp_matrix_ = matrix_;
+        pc_age_ = 0;
+    } else if (matrix_changed_) {
+        rebuild_pc = pc_rebuild_requested_ || (pc_age_+1 >= pc_reuse_max_steps_);
+    } else {
+        // matrix not marked as changed, without reuse policy PETSc decides about the setup itself
+        rebuild_pc = (pc_reuse_max_steps_ <= 1);
+    }
+    if (matrix_changed_) pc_age_ = rebuild_pc ? 0 : pc_age_+1;
     chkerr(KSPSetOperators(system, matrix_, matrix_));
+    chkerr(KSPSetReusePreconditioner(system, rebuild_pc ? PETSC_FALSE : PETSC_TRUE));
 
 
     // TODO take care of tolerances - shall we support both input file and command line petsc setting
     chkerr(KSPSetTolerances(system, r_tol_, a_tol_, d_tol_,PETSC_DEFAULT));
     chkerr(KSPSetTolerances(system, r_tol_, a_tol_, d_tol_,  max_it_));
-    KSPSetFromOptions(system);
-    // We set the KSP flag set_initial_guess_nonzero
-    // unless KSP type is preonly.
-    // In such case PETSc fails (version 3.4.1)
-    if (init_guess_nonzero)
-    {
-    	KSPType type;
-    	KSPGetType(system, &type);
-    	if (strcmp(type, KSPPREONLY) != 0)
-    		KSPSetInitialGuessNonzero(system, PETSC_TRUE);
+    if (rebuild_pc) {
+        chkerr(KSPSetOptionsPrefix(system, (recycle_dim_ > 0) ? options_prefix_.c_str() : NULL));
+        KSPSetFromOptions(system);
+        // We set the KSP flag set_initial_guess_nonzero
+        // unless KSP type is preonly.
+        // In such case PETSc fails (version 3.4.1)
+        if (init_guess_nonzero)
+        {
+            KSPType type;
+            KSPGetType(system, &type);
+            if (strcmp(type, KSPPREONLY) != 0)
+                KSPSetInitialGuessNonzero(system, PETSC_TRUE);
+        }
+    }
+
+    // polynomial extrapolation of the initial guess from previous solutions, assumes equidistant steps:
+    // x_0 = sum_i c_i x_{n-i}, c_i = (-1)^i binom(m, i+1)
+    // nonlinear iterations within a time step start from the solution of the previous iteration
+    if (n_guess_history_ > 1 && solution_history_.size() > 1 && !(history_by_steps_ && step_solved_)) {
+        unsigned int m = solution_history_.size();
+        std::vector<PetscScalar> coefs(m);
+        double binom = m;
+        for (unsigned int i=0; i<m; i++) {
+            coefs[i] = (i%2 == 0) ? binom : -binom;
+            binom = binom * (m-i-1) / (i+2);
+        }
+        chkerr(VecSet(solution_, 0.0));
+        chkerr(VecMAXPY(solution_, m, coefs.data(), solution_history_.data()));
+        KSPType type;
+        KSPGetType(system, &type);
+        if (strcmp(type, KSPPREONLY) != 0)
+            KSPSetInitialGuessNonzero(system, PETSC_TRUE);
     }
 
     {
 		START_TIMER("PETSC linear solver");
+		if (rebuild_pc) {
+		    START_TIMER("PETSC preconditioner setup");
+		    chkerr(KSPSetUp(system));
+		}
 		START_TIMER("PETSC linear iteration");
 		chkerr(KSPSolve(system, rhs_, solution_ ));
 		KSPGetConvergedReason(system,&reason);
 		KSPGetIterationNumber(system,&nits);
 		ADD_CALLS(nits);
     }
+
+    // decide about rebuild of the preconditioner in the next solve
+    if (rebuild_pc) {
+        pc_ref_iterations_ = nits;
+        pc_rebuild_requested_ = false;
+    } else if (reason < 0 || nits > pc_reuse_iter_growth_ * std::max(pc_ref_iterations_, 1)) {
+        pc_rebuild_requested_ = true;
+    }
+    matrix_changed_ = false;
+
+    // store the solution for extrapolation, with time steps only the last solution of the step is stored
+    if (n_guess_history_ > 1) {
+        if (history_by_steps_) {
+            if (step_solution_ == NULL) chkerr(VecDuplicate(solution_, &step_solution_));
+            chkerr(VecCopy(solution_, step_solution_));
+        } else {
+            push_solution_history(solution_);
+        }
+    }
+    step_solved_ = true;
     // substitute by PETSc call for residual
     VecNorm(rhs_, NORM_2, &residual_norm_);
     
-    LogOut().fmt("convergence reason {}, number of iterations is {}\n", reason, nits);
+    LogOut().fmt("convergence reason {}, number of iterations is {}, preconditioner {}\n", reason, nits,
+            rebuild_pc ? "rebuilt" : "reused");
 
     // get residual norm
     KSPGetResidualNorm(system, &solution_precision_);
@@ -419,8 +704,6 @@ LinSys::SolveInfo LinSys_PETSC::solve()
     // TODO: I do not understand this 
     //Profiler::instance()->set_timer_subframes("SOLVING MH SYSTEM", nits);
 
-    chkerr(KSPDestroy(&system));
-
     return LinSys::SolveInfo(static_cast<int>(reason), static_cast<int>(nits));
 
 }
@@ -463,7 +746,12 @@ void LinSys_PETSC::view(string text )
 
 LinSys_PETSC::~LinSys_PETSC( )
 {
+    if (csr_assembly_) csr_assembly_->restore_arrays();
     if (matrix_ != NULL) { chkerr(MatDestroy(&matrix_)); }
+    if (near_null_space_ != NULL) { chkerr(MatNullSpaceDestroy(&near_null_space_)); }
+    if (system != NULL) { chkerr(KSPDestroy(&system)); }
+    for (Vec &vec : solution_history_) chkerr(VecDestroy(&vec));
+    if (step_solution_ != NULL) chkerr(VecDestroy(&step_solution_));
     chkerr(VecDestroy(&rhs_));
 
     if (residual_ != NULL) chkerr(VecDestroy(&residual_));
@@ -481,6 +769,10 @@ void LinSys_PETSC::set_from_input(const Input::Record in_rec)
     // otherwise keep settings provided in constructor of LinSys_PETSC.
     std::string user_params = in_rec.val<string>("options");
 	if (user_params != "") params_ = user_params;
+
+	set_pc_reuse(pc_reuse_max_steps_, pc_reuse_iter_growth_);
+	set_csr_assembly(use_csr_assembly_);
+	set_krylov_acceleration(recycle_dim_, n_guess_history_);
 }
 
 
@@ -20,9 +20,11 @@
 #define LA_LINSYS_PETSC_HH_
 
 #include <functional>    // for unary_function
+#include <memory>        // for shared_ptr
 #include <string>        // for string
 #include <vector>        // for vector
 #include "la/linsys.hh"  // for LinSys
+#include "la/csr_assembly.hh"  // for CsrAssembly
 #include "petscksp.h"    // for KSP, KSPConvergedReason, _p_KSP
 #include "petscmat.h"    // for Mat, MatCopy, MatZeroEntries, MatAssemblyType
 #include "petscmath.h"   // for PetscScalar
@@ -78,6 +80,7 @@ public:
 
     PetscErrorCode set_matrix(Mat &matrix, MatStructure str) override
     {
+        if (csr_assembly_) csr_assembly_->restore_arrays();
         matrix_changed_ = true;
     	return MatCopy(matrix, matrix_, str);
     }
@@ -90,6 +93,7 @@ public:
 
     PetscErrorCode mat_zero_entries() override
     {
+        if (csr_assembly_) csr_assembly_->restore_arrays();
         matrix_changed_ = true;
         constraints_.clear();
     	return MatZeroEntries(matrix_);
@@ -123,6 +127,63 @@ public:
 
     void set_initial_guess_nonzero(bool set_nonzero = true);
 
+    /**
+     * Set block structure of the matrix, must be called before preallocate_matrix.
+     *
+     * Rows are grouped into blocks of @p block_size consecutive rows (e.g. components of a vector
+     * unknown at one node), local size of the system has to be divisible by the block size.
+     * If @p use_baij is true, the matrix is created in BAIJ format, otherwise the AIJ format
+     * with the block size set is used. Note that GAMG preconditioner supports only AIJ matrices.
+     */
+    void set_block_size(unsigned int block_size, bool use_baij = false);
+
+    /**
+     * Set near null space of the operator (e.g. rigid body modes), used by algebraic multigrid
+     * preconditioners (GAMG, BoomerAMG with nodal interpolation). The object is referenced, caller may destroy its copy.
+     */
+    void set_near_null_space(MatNullSpace near_null_space);
+
+    /**
+     * Set policy of preconditioner reuse for the systems with changing matrix (e.g. time dependent problems).
+     *
+     * The preconditioner is kept for at most @p max_steps solves with changed matrix, value 1 means that
+     * the preconditioner is rebuilt whenever the matrix changes. The preconditioner is rebuilt also
+     * if the number of iterations exceeds @p iter_growth times the number of iterations of the first solve
+     * with the actual preconditioner, or if the solver does not converge.
+     *
+     * Values given by the input record (keys 'pc_reuse_steps', 'pc_reuse_iter_growth') take precedence.
+     */
+    void set_pc_reuse(unsigned int max_steps, double iter_growth);
+
+    void force_pc_rebuild() override
+    { pc_rebuild_requested_ = true; }
+
+    /**
+     * Assemble the matrix directly into the CSR arrays of AIJ matrix (see CsrAssembly) instead of MatSetValues.
+     * The exact pattern is collected in the allocation pass, so the setting takes effect in the next start_allocation.
+     * Not used for BAIJ matrices. Value given by the input record (key 'csr_assembly') takes precedence.
+     */
+    void set_csr_assembly(bool use_csr_assembly);
+
+    /**
+     * Set acceleration of repeated solves with slowly changing matrix (e.g. time dependent problems).
+     *
+     * @param recycle_dim  Dimension of Krylov subspace recycled between solves (GCRO-DR of HPDDM,
+     *                     deflated GMRES if PETSc is built without HPDDM), zero turns the recycling off.
+     * @param n_history    Number of previous solutions used for polynomial extrapolation of the initial guess,
+     *                     value 1 means that the last solution is used (if the initial guess is nonzero).
+     *
+     * Values given by the input record (keys 'krylov_recycling', 'initial_guess_history') take precedence.
+     */
+    void set_krylov_acceleration(unsigned int recycle_dim, unsigned int n_history);
+
+    /**
+     * After the first call, only the last solution of each time step is stored for the extrapolation
+     * of the initial guess and the extrapolation is applied only in the first solve of the step.
+     * Without calls every solve is considered to be a time step.
+     */
+    void start_time_step() override;
+
     LinSys::SolveInfo solve() override;
 
     /**
@@ -184,9 +245,34 @@ protected:
 
     double  solution_precision_; // precision of KSP system solver
 
-    KSP                system;
+    unsigned int block_size_;    //!< Number of consecutive rows forming one block of the matrix.
+    bool    use_baij_;           //!< Create matrix in BAIJ format if block_size_ > 1.
+    MatNullSpace near_null_space_; //!< Near null space attached to the matrix before solution, or NULL.
+
+    KSP                system;   //!< Solver kept between solves, so its preconditioner can be reused.
     KSPConvergedReason reason;
 
+    Mat     ksp_matrix_;         //!< Matrix set to the KSP, solver is recreated if the matrix is reallocated.
+    unsigned int pc_reuse_max_steps_;  //!< Maximal number of solves with changed matrix using the same preconditioner.
+    double  pc_reuse_iter_growth_;     //!< Allowed growth of iterations with reused preconditioner.
+    unsigned int pc_age_;        //!< Number of solves with changed matrix since the last rebuild of the preconditioner.
+    int     pc_ref_iterations_;  //!< Number of iterations of the first solve with the actual preconditioner.
+    bool    pc_rebuild_requested_; //!< Rebuild the preconditioner in the next solve.
+
+    bool    use_csr_assembly_;   //!< Assemble directly into CSR arrays of the matrix.
+    std::shared_ptr<CsrAssembly> csr_assembly_; //!< Direct assembly of the actual matrix, NULL if not used.
+
+    unsigned int recycle_dim_;   //!< Dimension of recycled Krylov subspace, zero if not used.
+    unsigned int n_guess_history_; //!< Number of previous solutions used for extrapolation of the initial guess.
+    std::vector<Vec> solution_history_; //!< Previous solutions, the newest first.
+    bool    history_by_steps_;   //!< Solution history is updated in start_time_step instead of every solve.
+    bool    step_solved_;        //!< The system has been solved in the actual time step.
+    Vec     step_solution_;      //!< The last solution of the actual time step, NULL if not used.
+    std::string options_prefix_; //!< Options prefix of the KSP, keeps options of Krylov recycling private to the solver.
+
+    /// Store copy of @p solution as the newest item of the solution history.
+    void push_solution_history(Vec solution);
+
 
 };
 
@@ -85,6 +85,10 @@ public:
      */
     void set_from_input(const Input::Record in_rec) override;
 
+    /// Time steps are relevant for the solver of the complement system.
+    void start_time_step() override
+    { Compl->start_time_step(); }
+
     /**
      * Returns pointer to LinSys object representing the schur complement.
      */
@@ -88,6 +88,12 @@ public:
         vec_view_ = &fe_values_.vector_view(0);
         vec_view_side_ = &fe_values_side_.vector_view(0);
         if (dim>1) vec_view_sub_ = &fe_values_sub_.vector_view(0);
+
+        n_points_ = this->quad_->size();
+        strain_ops_.resize(n_points_ * n_strain_rows * n_dofs_ * batch_size);
+        strain_weights_.resize(n_points_ * 2 * batch_size);
+        batch_matrices_.resize(n_dofs_ * n_dofs_ * batch_size);
+        batch_dof_indices_.resize(batch_size, vector<LongIdx>(n_dofs_));
     }
 
 
@@ -96,30 +102,29 @@ public:
     {
         if (cell.dim() != dim) return;
 
-        ElementAccessor<3> elm_acc = cell.elm();
-
-        fe_values_.reinit(elm_acc);
-        cell.get_dof_indices(dof_indices_);
-
-        // assemble the local stiffness matrix
-        for (unsigned int i=0; i<n_dofs_; i++)
-            for (unsigned int j=0; j<n_dofs_; j++)
-                local_matrix_[i*n_dofs_+j] = 0;
+        this->fill_strain_operators(cell, element_patch_idx, 0);
+        this->assemble_batch(1);
+    }
 
-        unsigned int k=0;
-        for (auto p : this->bulk_points(element_patch_idx) )
-        {
-            for (unsigned int i=0; i<n_dofs_; i++)
-            {
-                for (unsigned int j=0; j<n_dofs_; j++)
-                    local_matrix_[i*n_dofs_+j] += eq_fields_->cross_section(p)*(
-                                                2*eq_fields_->lame_mu(p)*arma::dot(vec_view_->sym_grad(j,k), vec_view_->sym_grad(i,k))
-                                                + eq_fields_->lame_lambda(p)*vec_view_->divergence(j,k)*vec_view_->divergence(i,k)
-                                               )*fe_values_.JxW(k);
+    /**
+     * Assembles the cell integrals of the patch in batches of cells.
+     *
+     * Strain operators of all cells of the batch are computed first, then the local matrices
+     * of the whole batch are formed by a single kernel vectorized across cells.
+     */
+    inline void assemble_cell_integrals(const RevertableList<typename AssemblyBase<dim>::BulkIntegralData> &bulk_integral_data) override
+    {
+        unsigned int i_batch = 0;
+        for (unsigned int i=0; i<bulk_integral_data.permanent_size(); ++i) {
+            if (bulk_integral_data[i].cell.dim() != dim) continue;
+            this->fill_strain_operators(bulk_integral_data[i].cell,
+                    this->element_cache_map_->position_in_cache(bulk_integral_data[i].cell.elm_idx()), i_batch);
+            if (++i_batch == batch_size) {
+                this->assemble_batch(batch_size);
+                i_batch = 0;
             }
-            k++;
         }
-        eq_data_->ls->mat_set_values(n_dofs_, dof_indices_.data(), n_dofs_, dof_indices_.data(), &(local_matrix_[0]));
+        if (i_batch > 0) this->assemble_batch(i_batch);
     }
 
     /// Assembles boundary integral.
@@ -238,6 +243,60 @@ public:
                 eq_data_->ls->mat_set_values(n_dofs_ngh_[n], side_dof_indices_[n].data(), n_dofs_ngh_[m], side_dof_indices_[m].data(), &(local_matrix_ngh_[n][m][0]));
     }
 
+    /**
+     * Set strain operator of shape function with gradient @p g, rows of the operator are stored
+     * in @p op with stride @p row_stride.
+     *
+     * Rows are components of symmetric gradient in Voigt notation (shear components scaled
+     * by sqrt(2), so the product of rows gives the double dot product of tensors) and divergence.
+     */
+    static inline void set_strain_operator(const arma::mat33 &g, double *op, unsigned int row_stride)
+    {
+        static const double sqrt2 = std::sqrt(2.0);
+        op[0*row_stride] = g(0,0);
+        op[1*row_stride] = g(1,1);
+        op[2*row_stride] = g(2,2);
+        op[3*row_stride] = 0.5*sqrt2*(g(0,1)+g(1,0));
+        op[4*row_stride] = 0.5*sqrt2*(g(0,2)+g(2,0));
+        op[5*row_stride] = 0.5*sqrt2*(g(1,2)+g(2,1));
+        op[6*row_stride] = g(0,0)+g(1,1)+g(2,2);
+    }
+
+    /**
+     * Form upper triangles of local matrices K = B^T D B of first @p n_cells cells of the batch.
+     *
+     * @p strain_ops are indexed [point][row][dof][cell], @p strain_weights [point][2][cell]
+     * and @p batch_matrices [dof][dof][cell], cell index runs up to @p batch_size.
+     * Innermost loops run over cells of the batch with unit stride, so they are vectorized by compiler.
+     */
+    static inline void batch_local_matrices(unsigned int n_points, unsigned int n_dofs, unsigned int n_cells,
+            const double *strain_ops, const double *strain_weights, double *batch_matrices)
+    {
+        std::fill(batch_matrices, batch_matrices + n_dofs*n_dofs*batch_size, 0.0);
+        for (unsigned int k=0; k<n_points; k++)
+            for (unsigned int r=0; r<n_strain_rows; r++)
+            {
+                const double * __restrict__ w = &strain_weights[(k*2 + (r<6 ? 0 : 1))*batch_size];
+                const double *op = &strain_ops[(k*n_strain_rows + r)*n_dofs*batch_size];
+                for (unsigned int i=0; i<n_dofs; i++)
+                {
+                    const double * __restrict__ op_i = op + i*batch_size;
+                    for (unsigned int j=i; j<n_dofs; j++)
+                    {
+                        const double * __restrict__ op_j = op + j*batch_size;
+                        double * __restrict__ mat_ij = &batch_matrices[(i*n_dofs+j)*batch_size];
+                        for (unsigned int c=0; c<n_cells; c++)
+                            mat_ij[c] += w[c] * op_i[c] * op_j[c];
+                    }
+                }
+            }
+    }
+
+    /// Maximal number of cells in batch of assemble_cell_integrals.
+    static constexpr unsigned int batch_size = 32;
+
+    /// Number of rows of strain operator (6 components of symmetric gradient and divergence).
+    static constexpr unsigned int n_strain_rows = 7;
 
 
 private:
@@ -247,6 +306,38 @@ private:
       return mt;
     }
 
+    /// Compute strain operator (B-matrix) and weights of given cell and store them at position @p i_batch of the batch.
+    inline void fill_strain_operators(DHCellAccessor cell, unsigned int element_patch_idx, unsigned int i_batch)
+    {
+        fe_values_.reinit(cell.elm());
+        cell.get_dof_indices(batch_dof_indices_[i_batch]);
+
+        unsigned int k=0;
+        for (auto p : this->bulk_points(element_patch_idx) )
+        {
+            double cs_jxw = eq_fields_->cross_section(p) * fe_values_.JxW(k);
+            strain_weights_[(k*2)*batch_size + i_batch] = 2*eq_fields_->lame_mu(p) * cs_jxw;
+            strain_weights_[(k*2+1)*batch_size + i_batch] = eq_fields_->lame_lambda(p) * cs_jxw;
+
+            double *op = &strain_ops_[k*n_strain_rows*n_dofs_*batch_size + i_batch];
+            for (unsigned int i=0; i<n_dofs_; i++)
+                set_strain_operator(vec_view_->grad(i,k), op + i*batch_size, n_dofs_*batch_size);
+            k++;
+        }
+    }
+
+    /// Form local matrices of first @p n_cells cells of the batch and set them to the linear system.
+    inline void assemble_batch(unsigned int n_cells)
+    {
+        batch_local_matrices(n_points_, n_dofs_, n_cells, strain_ops_.data(), strain_weights_.data(), batch_matrices_.data());
+        for (unsigned int c=0; c<n_cells; c++)
+        {
+            for (unsigned int i=0; i<n_dofs_; i++)
+                for (unsigned int j=i; j<n_dofs_; j++)
+                    local_matrix_[i*n_dofs_+j] = local_matrix_[j*n_dofs_+i] = batch_matrices_[(i*n_dofs_+j)*batch_size + c];
+            eq_data_->ls->mat_set_values(n_dofs_, batch_dof_indices_[c].data(), n_dofs_, batch_dof_indices_[c].data(), &(local_matrix_[0]));
+        }
+    }
 
 
     shared_ptr<FiniteElement<dim>> fe_;         ///< Finite element for the solution of the advection-diffusion equation.
@@ -274,6 +365,12 @@ private:
     const FEValuesViews::Vector<3> * vec_view_side_;          ///< Vector view in boundary / neighbour calculation.
     const FEValuesViews::Vector<3> * vec_view_sub_;           ///< Vector view of low dim element in neighbour calculation.
 
+    unsigned int n_points_;                                   ///< Number of quadrature points of cell integral.
+    vector<double> strain_ops_;                               ///< Strain operators of batch, indexed [point][row][dof][cell].
+    vector<double> strain_weights_;                           ///< Weights 2*mu*cs*JxW and lambda*cs*JxW of batch, indexed [point][2][cell].
+    vector<double> batch_matrices_;                           ///< Local matrices of batch, indexed [dof][dof][cell].
+    vector<vector<LongIdx> > batch_dof_indices_;              ///< DOF indices of cells of batch.
+
     template < template<IntDim...> class DimAssembly>
     friend class GenericAssembly;
 
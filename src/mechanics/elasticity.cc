@@ -37,6 +37,7 @@
 #include "fields/generic_field.hh"
 #include "fields/field_model.hh"
 #include "input/factory.hh"
+#include "io/checkpoint.hh"
 
 
 
@@ -58,6 +59,11 @@ const Record & Elasticity::get_input_type() {
                     "Parameters of output stream.")
            .declare_key("solver", LinSys_PETSC::get_input_type(), Default::obligatory(),
 				"Linear solver for elasticity.")
+           .declare_key("preconditioner", Elasticity::get_preconditioner_selection(), Default("\"hypre\""),
+                "Built-in PETSc options of the linear solver, used if the key 'options' of the solver is empty.")
+           .declare_key("block_matrix", Bool(), IT::Default("false"),
+                "Assemble the matrix in BAIJ format with 3x3 blocks of displacement components at nodes. "
+                "Otherwise the AIJ format with block size 3 is used. GAMG preconditioner requires the AIJ format.")
 		   .declare_key("input_fields", Array(
 		        Elasticity::EqFields()
 		            .make_field_descriptor_type(equation_name)),
@@ -68,6 +74,9 @@ const Record & Elasticity::get_input_type() {
                 IT::Default("{ \"fields\": [ \"displacement\" ] }"),
                 "Setting of the field output.")
            .declare_key("contact", Bool(), IT::Default("false"), "Indicates the use of contact conditions on fractures.")
+           .declare_key("dof_renumbering", DOFHandlerMultiDim::get_renumbering_selection(), IT::Default("\"none\""),
+                "Renumbering of the degrees of freedom owned by the processor. Without contact only 'none' and 'sfc' "
+                "are allowed, they keep the three displacement dofs of a node consecutive (block size 3, rigid body modes).")
 		   .close();
 }
 
@@ -128,6 +137,19 @@ const Selection & Elasticity::EqFields::get_bc_type_selection() {
 }
 
 
+const Selection & Elasticity::get_preconditioner_selection() {
+    return Selection("Elasticity_Preconditioner", "Built-in settings of the linear solver for mechanics.")
+            .add_value(pc_hypre, "hypre",
+                  "CG method with BoomerAMG preconditioner with default settings.")
+            .add_value(pc_hypre_nodal, "hypre_nodal",
+                  "CG method with BoomerAMG preconditioner using nodal coarsening "
+                  "and interpolation of rigid body modes.")
+            .add_value(pc_gamg, "gamg",
+                  "CG method with smoothed aggregation AMG (PETSc GAMG) using rigid body modes as near null space.")
+            .close();
+}
+
+
 Elasticity::EqFields::EqFields()
 {
     *this+=bc_type
@@ -279,7 +301,7 @@ Elasticity::EqFields::EqFields()
 
 }
 
-void Elasticity::EqData::create_dh(Mesh * mesh, unsigned int fe_order)
+void Elasticity::EqData::create_dh(Mesh * mesh, unsigned int fe_order, DOFHandlerMultiDim::Renumbering renumbering)
 {
 	ASSERT_EQ(fe_order, 1)(fe_order).error("Unsupported polynomial order for finite elements in Elasticity");
     MixedPtr<FE_P> fe_p(1);
@@ -287,7 +309,7 @@ void Elasticity::EqData::create_dh(Mesh * mesh, unsigned int fe_order)
 
     std::shared_ptr<DiscreteSpace> ds = std::make_shared<EqualOrderDiscreteSpace>(mesh, fe);
 	dh_ = std::make_shared<DOFHandlerMultiDim>(*mesh);
-
+	dh_->set_renumbering(renumbering);
 	dh_->distribute_dofs(ds);
 
 
@@ -340,7 +362,14 @@ Elasticity::Elasticity(Mesh & init_mesh, const Input::Record in_rec, TimeGoverno
     eq_data_->balance_ = this->balance();
     
     // create finite element structures and distribute DOFs
-    eq_data_->create_dh(mesh_, 1);
+    // block size 3 and rigid body modes of the linear system without contact need consecutive dofs of nodes,
+    // the numbering of a node is kept only by the order of entities along the space filling curve
+    auto renumbering = in_rec.val<DOFHandlerMultiDim::Renumbering>("dof_renumbering");
+    if (!in_rec.val<bool>("contact") && renumbering != DOFHandlerMultiDim::Renumbering::none
+            && renumbering != DOFHandlerMultiDim::Renumbering::sfc)
+        THROW( Input::ExcInputMessage() << EI_Message("Elasticity without contact supports only 'dof_renumbering' none or sfc.")
+                << in_rec.ei_address() );
+    eq_data_->create_dh(mesh_, 1, renumbering);
     DebugOut().fmt("Mechanics: solution size {}\n", eq_data_->dh_->n_global_dofs());
     
 }
@@ -406,7 +435,19 @@ void Elasticity::initialize()
 
     // equation default PETSc solver options
     std::string petsc_default_opts;
-    petsc_default_opts = "-ksp_type cg -pc_type hypre -pc_hypre_type boomeramg";
+    switch (input_rec.val<PreconditionerPreset>("preconditioner")) {
+    case pc_hypre:
+        petsc_default_opts = "-ksp_type cg -pc_type hypre -pc_hypre_type boomeramg";
+        break;
+    case pc_hypre_nodal:
+        petsc_default_opts = "-ksp_type cg -pc_type hypre -pc_hypre_type boomeramg -pc_hypre_boomeramg_nodal_coarsen 6 "
+                "-pc_hypre_boomeramg_vec_interp_variant 3 -pc_hypre_boomeramg_strong_threshold 0.5";
+        break;
+    case pc_gamg:
+        petsc_default_opts = "-ksp_type cg -pc_type gamg -pc_gamg_type agg -pc_gamg_agg_nsmooths 1 -pc_gamg_threshold 0.01 "
+                "-mg_levels_ksp_type chebyshev -mg_levels_pc_type jacobi";
+        break;
+    }
     
     // allocate matrix and vector structures
     LinSys *ls;
@@ -435,8 +476,14 @@ void Elasticity::initialize()
 
         constraint_assembly_ = new GenericAssembly< ConstraintAssemblyElasticity >(eq_fields_.get(), eq_data_.get());
     } else {
-        ls = new LinSys_PETSC(eq_data_->dh_->distr().get(), petsc_default_opts);
-        ((LinSys_PETSC*)ls)->set_initial_guess_nonzero();
+        LinSys_PETSC *ls_petsc = new LinSys_PETSC(eq_data_->dh_->distr().get(), petsc_default_opts);
+        ls_petsc->set_initial_guess_nonzero();
+        // dofs of the three displacement components at a node are numbered consecutively
+        ls_petsc->set_block_size(3, input_rec.val<bool>("block_matrix"));
+        // the same sequence of local matrices in every assembly
+        ls_petsc->set_csr_assembly(true);
+        set_rigid_body_modes(ls_petsc);
+        ls = ls_petsc;
     }
     ls->set_from_input( input_rec.val<Input::Record>("solver") );
     ls->set_solution(eq_fields_->output_field_ptr->vec().petsc_vec());
@@ -498,6 +545,23 @@ void Elasticity::update_output_fields()
 
 
 
+void Elasticity::save_state(CheckpointData &data, const std::string &prefix)
+{
+    EquationBase::save_state(data, prefix);
+    data.save(prefix + "/displacement", eq_fields_->output_field_ptr->vec());
+}
+
+
+void Elasticity::load_state(const CheckpointData &data, const std::string &prefix)
+{
+    EquationBase::load_state(data, prefix);
+    data.load(prefix + "/displacement", eq_fields_->output_field_ptr->vec());
+    update_output_fields();
+}
+
+
+
+
 void Elasticity::zero_time_step()
 {
 	START_TIMER(name_);
@@ -526,7 +590,7 @@ void Elasticity::zero_time_step()
     LinSys::SolveInfo si = eq_data_->ls->solve();
     MessageOut().fmt("[mech solver] lin. it: {}, reason: {}, residual: {}\n",
         		si.n_iterations, si.converged_reason, eq_data_->ls->compute_residual());
-    output_data();
+    if (zero_step_output_) output_data();
 }
 
 
@@ -543,6 +607,37 @@ void Elasticity::preallocate()
 }
 
 
+void Elasticity::set_rigid_body_modes(LinSys_PETSC *ls)
+{
+    unsigned int lsize = eq_data_->dh_->lsize();
+    Vec coords;
+    PetscScalar *coords_array;
+    chkerr(VecCreateMPI(PETSC_COMM_WORLD, lsize, PETSC_DETERMINE, &coords));
+    chkerr(VecSetBlockSize(coords, 3));
+    chkerr(VecGetArray(coords, &coords_array));
+    for (auto cell : eq_data_->dh_->own_range())
+    {
+        LocDofVec loc_dofs = cell.get_loc_dof_indices();
+        std::vector<unsigned int> loc_node_dof_count(cell.elm()->n_nodes(), 0);
+        for (unsigned int idof=0; idof<cell.n_dofs(); ++idof)
+        {
+            // k-th dof at the node belongs to k-th component of displacement
+            unsigned int nid = cell.cell_dof(idof).n_face_idx;
+            unsigned int component = loc_node_dof_count[nid]++;
+            if (loc_dofs[idof] < (LongIdx)lsize)
+                coords_array[loc_dofs[idof]] = (*cell.elm().node(nid))[component];
+        }
+    }
+    chkerr(VecRestoreArray(coords, &coords_array));
+
+    MatNullSpace rigid_body_modes;
+    chkerr(MatNullSpaceCreateRigidBody(coords, &rigid_body_modes));
+    ls->set_near_null_space(rigid_body_modes);
+    chkerr(MatNullSpaceDestroy(&rigid_body_modes));
+    chkerr(VecDestroy(&coords));
+}
+
+
 
 
 void Elasticity::update_solution()
@@ -34,6 +34,7 @@
 class Distribution;
 class OutputTime;
 class DOFHandlerMultiDim;
+class LinSys_PETSC;
 template<unsigned int dim> class FiniteElement;
 class Elasticity;
 template<unsigned int dim> class StiffnessAssemblyElasticity;
@@ -121,7 +122,7 @@ public:
 		}
 
 		/// Create DOF handler objects
-        void create_dh(Mesh * mesh, unsigned int fe_order);
+        void create_dh(Mesh * mesh, unsigned int fe_order, DOFHandlerMultiDim::Renumbering renumbering);
 
         /// Objects for distribution of dofs.
         std::shared_ptr<DOFHandlerMultiDim> dh_;
@@ -191,6 +192,16 @@ public:
     
 	// Recompute fields for output (stress, divergence etc.)
 	void update_output_fields();
+
+    /// Store time governor, balance and displacement to the checkpoint.
+    void save_state(CheckpointData &data, const std::string &prefix) override;
+
+    /// Restore state stored by @p save_state and recompute the output fields.
+    void load_state(const CheckpointData &data, const std::string &prefix) override;
+
+    /// Add the output stream of the mechanics.
+    void get_output_streams(std::vector<std::shared_ptr<OutputTime>> &streams) override
+    { streams.push_back(output_stream_); }
     
     void set_potential_load(const Field<3, FieldValue<3>::Scalar> &potential,
                             const Field<3, FieldValue<3>::Scalar> &ref_potential)
@@ -212,6 +223,16 @@ public:
     
     typedef Elasticity FactoryBaseType;
 
+    /// Built-in sets of PETSc options for the linear solver.
+    enum PreconditionerPreset {
+        pc_hypre,          ///< BoomerAMG with default settings
+        pc_hypre_nodal,    ///< BoomerAMG with nodal coarsening and rigid body interpolation
+        pc_gamg            ///< smoothed aggregation AMG with rigid body near null space
+    };
+
+    /// Selection of built-in preconditioner settings.
+    static const Input::Type::Selection & get_preconditioner_selection();
+
 
 
 
@@ -224,6 +245,12 @@ private:
 
 	void assemble_constraint_matrix();
 
+	/**
+	 * Create rigid body modes of the displacement space from coordinates of nodal dofs
+	 * and set them as near null space of the linear system.
+	 */
+	void set_rigid_body_modes(LinSys_PETSC *ls);
+
 
 	/// @name Physical parameters
 	// @{
@@ -63,9 +63,7 @@ void BIHTree::construct() {
     // make root node
     nodes_.push_back(BIHNode());
     nodes_.back().set_leaf(0, in_leaves_.size(), 0, 0);
-    uint height = make_node(main_box_, 0);
-
-    node_stack_.reserve(2*height);
+    make_node(main_box_, 0);
 }
 
 
@@ -236,13 +234,16 @@ void BIHTree::find_bounding_box(const BoundingBox &box, std::vector<unsigned int
 
 	ASSERT_EQ(result_list.size() , 0);
 
+    // stack of the calling thread, the tree can be searched by several threads at once
+    static thread_local std::vector<unsigned int> node_stack;
+
     unsigned int counter = 0;
-    node_stack_.clear();
-    node_stack_.push_back(0);
-	while (! node_stack_.empty()) {
-		const BIHNode &node = nodes_[node_stack_.back()];
+    node_stack.clear();
+    node_stack.push_back(0);
+	while (! node_stack.empty()) {
+		const BIHNode &node = nodes_[node_stack.back()];
 		//DebugOut().fmt("node: {}\n", node_stack.top() );
-		node_stack_.pop_back();
+		node_stack.pop_back();
 
 
 		if (node.is_leaf()) {
@@ -260,17 +261,17 @@ void BIHTree::find_bounding_box(const BoundingBox &box, std::vector<unsigned int
 			//START_TIMER("recursion");
 			if ( ! box.projection_gt( node.axis(), nodes_[node.child(0)].bound() ) ) {
 				// box intersects left group
-				node_stack_.push_back( node.child(0) );
+				node_stack.push_back( node.child(0) );
 			}
 			if ( ! box.projection_lt( node.axis(), nodes_[node.child(1)].bound() ) ) {
 				// box intersects right group
-				node_stack_.push_back( node.child(1) );
+				node_stack.push_back( node.child(1) );
 			}
 			//END_TIMER("recursion");
 		}
 	}
-	//node_stack_.pop_back();
-	//cout << "stack size: " << node_stack_.size();
+	//node_stack.pop_back();
+	//cout << "stack size: " << node_stack.size();
 
 //    DebugOut().fmt("leaves: {}\n", counter);
 
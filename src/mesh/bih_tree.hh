@@ -79,6 +79,8 @@ public:
 	 * @param boundingBox Bounding box which is tested if has intersection
 	 * @param result_list vector of ids of suspect elements
 	 * @param full_list put to result_list all suspect elements found in leaf node or add only those that has intersection with boundingBox
+	 *
+	 * Can be called by several threads at once.
 	 */
     void find_bounding_box(const BoundingBox &boundingBox, std::vector<unsigned int> &result_list, bool full_list = false) const;
 
@@ -132,8 +134,6 @@ protected:
     std::vector<BoundingBox> elements_;
     /// Main bounding box. (from mesh)
     BoundingBox main_box_;
-    /// Stack for search algorithms.
-    mutable std::vector<unsigned int>  node_stack_;
 
     /// vector of tree nodes
     std::vector<BIHNode> nodes_;
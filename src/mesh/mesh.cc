@@ -20,6 +20,8 @@
 #include <unistd.h>
 #include <set>
 #include <unordered_map>
+#include <thread>
+#include <algorithm>
 
 #include "system/system.hh"
 #include "system/exceptions.hh"
@@ -225,6 +227,18 @@ const IT::Record & Mesh::get_input_type() {
 	    .declare_key("print_regions", IT::Bool(), IT::Default("true"), "If true, print table of all used regions.")
         .declare_key("intersection_search", Mesh::get_input_intersection_variant(), 
                      IT::Default("\"BIHsearch\""), "Search algorithm for element intersections.")
+        .declare_key("intersection_n_threads", IT::Integer(0), IT::Default("1"),
+                     "Number of threads used for computation of 1D-3D and 2D-3D element intersections. "
+                     "Connected components of lower dimensional elements (blocks of elements for 'BIHonly' search) "
+                     "are distributed to the threads, the result does not depend on the number of threads. "
+                     "Value 0 means the number of hardware threads.")
+        .declare_key("intersection_cache", IT::FileName::input(), IT::Default::optional(),
+                     "Binary file caching computed mixed mesh intersections. If the file matches the mesh "
+                     "(nodes, elements, partitioning) and 'intersection_search', intersections are read from it, "
+                     "otherwise they are computed and the file is (re)written. A relative path is resolved against "
+                     "the directory of the main input file (not the output directory), so the cache is shared "
+                     "by runs with different output directories. In parallel run every process uses "
+                     "its own file with the suffix '.<rank>'.")
         .declare_key("global_snap_radius", IT::Double(0.0), IT::Default("1E-3"),
                      "Maximal snapping distance from the mesh in various search operations. In particular, it is used "
                      "to find the closest mesh element of an observe point; and in FieldFormula to find closest surface "
@@ -278,6 +292,14 @@ Mesh::IntersectionSearch Mesh::get_intersection_search()
 }
 
 
+unsigned int Mesh::get_intersection_n_threads()
+{
+    unsigned int n_threads = in_record_.val<unsigned int>("intersection_n_threads");
+    if (n_threads == 0) n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    return n_threads;
+}
+
+
 void Mesh::init()
 {
     // set in_record_, if input accessor is empty
@@ -856,7 +878,26 @@ MixedMeshIntersections & Mesh::mixed_intersections() {
 	 */
     if (! intersections) {
         intersections = std::make_shared<MixedMeshIntersections>(this);
-        intersections->compute_intersections();
+
+        FilePath cache_path;
+        if ( in_record_.opt_val("intersection_cache", cache_path) ) {
+            int rank, n_proc;
+            MPI_Comm_rank(comm_, &rank);
+            MPI_Comm_size(comm_, &n_proc);
+            std::string cache_file = string(cache_path);
+            if (n_proc > 1) cache_file += "." + std::to_string(rank);
+
+            if (! intersections->read_cache(cache_file)) {
+                intersections->compute_intersections();
+                try {
+                    intersections->write_cache(cache_file);
+                } catch (FilePath::ExcFileOpen &) {
+                    WarningOut() << "Can not write intersection cache '" << cache_file << "', intersections are not cached.\n";
+                }
+            }
+        } else {
+            intersections->compute_intersections();
+        }
     }
     return *intersections;
 }
@@ -554,6 +554,9 @@ public:
     /// Getter for input type selection for intersection search algorithm.
     IntersectionSearch get_intersection_search();
 
+    /// Number of threads used for computation of intersections (input key 'intersection_n_threads', 0 is resolved).
+    unsigned int get_intersection_n_threads();
+
     /// Maximal distance of observe point from Mesh relative to its size
     double global_snap_radius() const;
 
@@ -45,11 +45,20 @@ class PythonFieldBase:
             # evaluation of
             z = self.X[2]
             return np.exp(-z)
+
+    Fields of one user class are evaluated in batches, `evaluate_batch` is called once per patch of elements
+    with all requested fields and their point ranges. By default every field method is called once with
+    the input fields of all its points (a view of the cache for a single range, a contiguous copy otherwise).
+    Override `evaluate_batch` to evaluate more fields together, using `select_batch` and `set_batch_result`.
     """
     
     # Singleton like instances of the user field evaluation classes.
     _instances = dict()
 
+    # Names of fields which values depend only on the points and the used fields (not on the time).
+    # Values of these fields are evaluated once and reused by Flow123d, redefine in the user class.
+    time_independent_fields = set()
+
     @staticmethod
     def _create(module: types.ModuleType, class_name: str) -> 'PythonFieldBase':
         """ 
@@ -71,11 +80,17 @@ class PythonFieldBase:
         # Slice of the quadrature points to evaluate, set by _cache_update.
         self._region_chunk_begin = 0
         self._region_chunk_end = 0
+        # Point ranges of the batch evaluation, None if a single slice is evaluated.
+        self._batch_ranges = None
+        # Input arrays gathered for the point ranges of the batch, key is (field name, ranges).
+        self._batch_inputs = dict()
         # Currently evaluated time.
         self.t = 0.0
-        # Dictionary of the input fields. Access through dot syntax:
+        # Dictionary of the input fields of the evaluated field. Access through dot syntax:
         # self.<input_field>
         self._used_fields_dict = dict()
+        # Dictionaries of the input fields of every result field, set by `_cache_reinit`.
+        self._result_used_fields = dict()
         # Dictionary of the output fields. No direct access. Reuslts of the user methods are stored
         # in `_cache_update`.
         self._result_fields_dict = dict()
@@ -86,7 +101,16 @@ class PythonFieldBase:
         Example: use 'self.field_name' id equal to 'self.used_fields_dict["field_name"]'
         """
         cache_data = self._used_fields_dict.get(attr, None)
-        return cache_data[..., self._region_chunk_begin:self._region_chunk_end]
+        if cache_data is None:
+            raise AttributeError(f"Unknown attribute or input field '{attr}'.")
+        if self._batch_ranges is None:
+            return cache_data[..., self._region_chunk_begin:self._region_chunk_end]
+        key = (attr, self._batch_ranges)
+        gathered = self._batch_inputs.get(key, None)
+        if gathered is None:
+            gathered = self.gather(cache_data, self._batch_ranges)
+            self._batch_inputs[key] = gathered
+        return gathered
         
     @staticmethod
     def repl(x):
@@ -102,29 +126,52 @@ class PythonFieldBase:
         (n_points) which is broadcasted to common the shape (3,3,n_points).
         """
         return x[..., None]
+
+    @staticmethod
+    def gather(x, ranges):
+        """
+        Return values of the array `x` on given point ranges (list of (begin, end) along the last axis).
+        Single range gives a view of `x`, more ranges are concatenated to a contiguous array.
+        """
+        if len(ranges) == 1:
+            begin, end = ranges[0]
+            return x[..., begin:end]
+        return np.concatenate([x[..., begin:end] for begin, end in ranges], axis=-1)
         
 
     def _cache_reinit(self, time: float, data: List[FieldCacheProxy], result: FieldCacheProxy) -> None:
         """
         Create arrays as wrappers to given C++ field value caches passed as FieldCacheProxy.
-        One reinit is called for every result field.
+        One reinit is called for every result field, its input fields are stored for evaluation of the field.
         """
         self._used_fields_dict.clear()
+        self._batch_inputs.clear()
         for in_field in data:
             in_array = np.array(in_field, copy=False)
             in_array.flags.writeable = False
             self._used_fields_dict[in_field.field_name()] = in_array
+        self._result_used_fields[result.field_name()] = dict(self._used_fields_dict)
         self._result_fields_dict[result.field_name()] = np.array(result, copy=False)
         
         self.t = time
 
 
+    def _select_inputs(self, field_name: str):
+        """
+        Make input fields of the result field `field_name` accessible through the dot syntax.
+        """
+        self._used_fields_dict.clear()
+        self._used_fields_dict.update(self._result_used_fields[field_name])
+
+
     def _cache_update(self, field_name: str, reg_chunk_begin: int, reg_chunk_end: int):
         """
         Method called from cache_update in C++ code.
         Needs to define the method with same name as name of evaluated field in descendant
         that executes evaluation.
         """
+        self._select_inputs(field_name)
+        self._batch_ranges = None
         self._region_chunk_begin = reg_chunk_begin
         self._region_chunk_end = reg_chunk_end
         res_array = getattr(self, field_name)()
@@ -138,6 +185,66 @@ class PythonFieldBase:
         self._result_fields_dict[field_name][..., self._region_chunk_begin:self._region_chunk_end] = res_array
 
 
+    def _cache_update_batch(self, time: float, requests: List[Tuple[str, int, int]]):
+        """
+        Method called from C++ code once per patch with all postponed requests
+        (field name, region chunk begin, region chunk end) of the patch.
+        Requests are grouped by fields and passed to `evaluate_batch` in one call.
+        """
+        self.t = time
+        field_ranges = dict()
+        for field_name, reg_chunk_begin, reg_chunk_end in requests:
+            field_ranges.setdefault(field_name, []).append((reg_chunk_begin, reg_chunk_end))
+        try:
+            self.evaluate_batch({name: tuple(ranges) for name, ranges in field_ranges.items()})
+        finally:
+            self._batch_ranges = None
+            self._batch_inputs.clear()
+
+
+    def evaluate_batch(self, field_ranges: Dict[str, Tuple[Tuple[int, int], ...]]) -> None:
+        """
+        Evaluate all fields requested on the patch, `field_ranges` maps the field name to its point ranges.
+        Default implementation calls the method of every field once for all its points.
+        """
+        for field_name, ranges in field_ranges.items():
+            self.select_batch(field_name, ranges)
+            self.set_batch_result(field_name, ranges, getattr(self, field_name)())
+
+
+    def select_batch(self, field_name: str, ranges: Tuple[Tuple[int, int], ...]) -> None:
+        """
+        Make input fields of `field_name` on all points of `ranges` accessible through the dot syntax,
+        e.g. self.X has shape (3, n_points) where n_points is the total size of the ranges.
+        """
+        self._select_inputs(field_name)
+        self._batch_ranges = tuple(ranges)
+        self._region_chunk_begin = 0
+        self._region_chunk_end = sum(end - begin for begin, end in ranges)
+
+
+    def set_batch_result(self, field_name: str, ranges: Tuple[Tuple[int, int], ...], res_array: np.ndarray) -> None:
+        """
+        Store values of `field_name` on all points of `ranges` (last axis of `res_array`) to the result cache.
+        """
+        result = self._result_fields_dict[field_name]
+        n_points = sum(end - begin for begin, end in ranges)
+        expect_shape = result.shape[:-1] + (n_points,)
+        if res_array.shape != expect_shape:
+            raise ValueError(f"Invalid shape of '{field_name}' method result. Must be {expect_shape}.")
+        pos = 0
+        for begin, end in ranges:
+            result[..., begin:end] = res_array[..., pos:pos + end - begin]
+            pos += end - begin
+
+
+    def _is_time_independent(self, field_name: str) -> bool:
+        """
+        Return True if the field is declared in `time_independent_fields`.
+        """
+        return field_name in self.time_independent_fields
+
+
     def _print_fields(self):
         """ Auxiliary method for development """
         print("Dictionary contains fields: ")
@@ -0,0 +1,140 @@
+#!/bin/python3
+# -*- coding: utf-8 -*-
+"""
+Reader of the binary observe output of Flow123d ('<equation>_observe.bin', key 'observe_format: binary').
+
+File layout:
+    - magic string 'FLOW123D_OBSERVE' (16 bytes), size of the JSON header in bytes (uint64)
+    - JSON header with keys: format_version, byte_order, time_unit, time_unit_in_seconds,
+      points (list of point descriptions), fields (list of {name, n_comp})
+    - time frames: time (float64) followed by values of all fields in order given by header,
+      every field has n_points * n_comp float64 values, NaN if the field was not evaluated at the time
+    - header extension in place of a time frame: NaN (float64), size of the extension (uint64),
+      JSON {"fields": [...]} with fields observed first after the header was written;
+      following frames contain also these fields
+
+Usage:
+    from observe_reader import read_observe
+    header, times, data = read_observe('output/flow_observe.bin')
+    data['pressure_p0']     # array of shape (n_times, n_points, n_comp)
+
+    python3 observe_reader.py output/flow_observe.bin
+"""
+
+import json
+import sys
+
+import numpy as np
+
+MAGIC = b'FLOW123D_OBSERVE'
+
+
+def read_header(path):
+    """Return the JSON header (dict) and the offset of the first time frame."""
+    with open(path, 'rb') as f:
+        magic = f.read(len(MAGIC))
+        if magic != MAGIC:
+            raise ValueError("Not a binary observe file: {}".format(path))
+        # size is written in native byte order of the writer, the wrong order gives a huge number
+        raw_size = f.read(8)
+        header_size = min(int(np.frombuffer(raw_size, dtype='<u8')[0]), int(np.frombuffer(raw_size, dtype='>u8')[0]))
+        header = json.loads(f.read(header_size).decode('utf-8'))
+    return header, len(MAGIC) + 8 + header_size
+
+
+def byte_order(header):
+    return '<' if header['byte_order'] == 'little' else '>'
+
+
+def frame_dtype(header, fields=None):
+    """Structured dtype of one time frame, fields (default: fields of the header) are columns of the record."""
+    order = byte_order(header)
+    n_points = len(header['points'])
+    columns = [('time', order + 'f8')]
+    for field in (header['fields'] if fields is None else fields):
+        columns.append((field['name'], order + 'f8', (n_points, field['n_comp'])))
+    return np.dtype(columns)
+
+
+def read_segments(raw, header, offset):
+    """
+    Split time frames in the byte array raw (starting at offset) by header extensions.
+    Returns list of tuples (fields, frames), frames is structured array of the frames with given fields.
+    """
+    order = byte_order(header)
+    fields = list(header['fields'])
+    segments = []
+    while True:
+        dtype = frame_dtype(header, fields)
+        n_times = (raw.size - offset) // dtype.itemsize
+        frames = raw[offset:offset + n_times * dtype.itemsize].view(dtype)
+        extension = np.flatnonzero(np.isnan(frames['time']))
+        if extension.size:
+            n_times = int(extension[0])
+            frames = frames[:n_times]
+        segments.append((fields, frames))
+        offset += n_times * dtype.itemsize
+        # header extension starts by NaN time
+        if offset + 16 > raw.size or not np.isnan(raw[offset:offset + 8].view(order + 'f8')[0]):
+            break
+        size = int(raw[offset + 8:offset + 16].view(order + 'u8')[0])
+        if offset + 16 + size > raw.size:
+            break
+        fields = fields + json.loads(bytes(raw[offset + 16:offset + 16 + size]).decode('utf-8'))['fields']
+        offset += 16 + size
+    return segments
+
+
+def read_observe(path, mmap=False):
+    """
+    Read the binary observe file.
+
+    Returns tuple (header, times, data), where times is array of output times (in time unit of the header)
+    and data is dictionary: field name -> array of shape (n_times, n_points, n_comp).
+    Fields added by header extensions are appended to header['fields'], their values before
+    the extension are NaN. Incomplete last frame (file being written) is ignored.
+    With mmap=True the arrays are memory mapped (if the file has no header extension).
+    """
+    header, offset = read_header(path)
+    if mmap:
+        raw = np.memmap(path, dtype=np.uint8, mode='r')
+    else:
+        with open(path, 'rb') as f:
+            raw = np.frombuffer(f.read(), dtype=np.uint8)
+    segments = read_segments(raw, header, offset)
+    header['fields'] = segments[-1][0]
+    if len(segments) == 1:
+        frames = segments[0][1]
+        data = {field['name']: frames[field['name']] for field in header['fields']}
+        return header, frames['time'], data
+
+    n_points = len(header['points'])
+    times = np.concatenate([frames['time'] for fields, frames in segments])
+    data = {}
+    for field in header['fields']:
+        parts = []
+        for fields, frames in segments:
+            if field['name'] in frames.dtype.names:
+                parts.append(frames[field['name']])
+            else:
+                parts.append(np.full((len(frames), n_points, field['n_comp']), np.nan))
+        data[field['name']] = np.concatenate(parts)
+    return header, times, data
+
+
+def main(argv):
+    if len(argv) != 2:
+        print("Usage: {} <file>_observe.bin".format(argv[0]))
+        return 1
+    header, times, data = read_observe(argv[1])
+    print("time_unit: {}".format(header['time_unit']))
+    print("points: {}".format(", ".join(p['name'] for p in header['points'])))
+    print("times: {} frames, {} .. {}".format(len(times), times[0] if len(times) else '-', times[-1] if len(times) else '-'))
+    for name, values in data.items():
+        print("{}: shape {}, min {}, max {}".format(name, values.shape,
+              values.min() if values.size else '-', values.max() if values.size else '-'))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
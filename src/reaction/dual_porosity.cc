@@ -30,6 +30,7 @@
 #include "mesh/region.hh"
 #include "mesh/accessors.hh"
 #include "fields/field_fe.hh"
+#include "io/checkpoint.hh"
 
 #include "reaction/sorption.hh"
 #include "reaction/first_order_reaction.hh"
@@ -253,7 +254,7 @@ void DualPorosity::zero_time_step()
   }
   init_condition_assembly_->assemble(eq_data_->dof_handler_);
 
-  output_data();
+  if (zero_step_output_) output_data();
   
   if(reaction_mobile)
     reaction_mobile->zero_time_step();
@@ -294,3 +295,31 @@ void DualPorosity::output_data(void )
         if (reaction_immobile) reaction_immobile->output_data();
     }
 }
+
+
+void DualPorosity::save_state(CheckpointData &data, const std::string &prefix)
+{
+    ReactionTerm::save_state(data, prefix);
+    for (unsigned int sbi = 0; sbi < eq_data_->substances_.size(); sbi++)
+        data.save(prefix + "/conc_immobile/" + eq_data_->substances_[sbi].name(), eq_fields_->conc_immobile_fe[sbi]->vec());
+    if (reaction_mobile) reaction_mobile->save_state(data, prefix + "/reaction_mobile");
+    if (reaction_immobile) reaction_immobile->save_state(data, prefix + "/reaction_immobile");
+}
+
+
+void DualPorosity::load_state(const CheckpointData &data, const std::string &prefix)
+{
+    ReactionTerm::load_state(data, prefix);
+    for (unsigned int sbi = 0; sbi < eq_data_->substances_.size(); sbi++)
+        data.load(prefix + "/conc_immobile/" + eq_data_->substances_[sbi].name(), eq_fields_->conc_immobile_fe[sbi]->vec());
+    if (reaction_mobile) reaction_mobile->load_state(data, prefix + "/reaction_mobile");
+    if (reaction_immobile) reaction_immobile->load_state(data, prefix + "/reaction_immobile");
+}
+
+
+void DualPorosity::set_zero_step_output(bool output)
+{
+    ReactionTerm::set_zero_step_output(output);
+    if (reaction_mobile) reaction_mobile->set_zero_step_output(output);
+    if (reaction_immobile) reaction_immobile->set_zero_step_output(output);
+}
@@ -127,6 +127,15 @@ public:
   
   /// Main output routine.
   void output_data(void) override;
+
+  /// Store immobile concentrations and state of following reactions to the checkpoint.
+  void save_state(CheckpointData &data, const std::string &prefix) override;
+
+  /// Restore state stored by @p save_state.
+  void load_state(const CheckpointData &data, const std::string &prefix) override;
+
+  /// Pass the setting to the reactions in both zones.
+  void set_zero_step_output(bool output) override;
   
 protected:
   /**
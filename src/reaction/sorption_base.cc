@@ -34,6 +34,7 @@
 
 #include "fields/field_set.hh"
 #include "fields/field_fe.hh"
+#include "io/checkpoint.hh"
 
 using namespace Input::Type;
 
@@ -389,7 +390,7 @@ void SorptionBase::zero_time_step()
   if(reaction_liquid) reaction_liquid->zero_time_step();
   if(reaction_solid) reaction_solid->zero_time_step();
 
-  output_data();
+  if (zero_step_output_) output_data();
 }
 
 
@@ -608,3 +609,31 @@ void SorptionBase::output_data(void )
     // Register fresh output data
     eq_fields_->output_fields.output(time().step());
 }
+
+
+void SorptionBase::save_state(CheckpointData &data, const std::string &prefix)
+{
+    ReactionTerm::save_state(data, prefix);
+    for (unsigned int sbi = 0; sbi < eq_data_->substances_.size(); sbi++)
+        data.save(prefix + "/conc_solid/" + eq_data_->substances_[sbi].name(), eq_fields_->conc_solid_fe[sbi]->vec());
+    if (reaction_liquid) reaction_liquid->save_state(data, prefix + "/reaction_liquid");
+    if (reaction_solid) reaction_solid->save_state(data, prefix + "/reaction_solid");
+}
+
+
+void SorptionBase::load_state(const CheckpointData &data, const std::string &prefix)
+{
+    ReactionTerm::load_state(data, prefix);
+    for (unsigned int sbi = 0; sbi < eq_data_->substances_.size(); sbi++)
+        data.load(prefix + "/conc_solid/" + eq_data_->substances_[sbi].name(), eq_fields_->conc_solid_fe[sbi]->vec());
+    if (reaction_liquid) reaction_liquid->load_state(data, prefix + "/reaction_liquid");
+    if (reaction_solid) reaction_solid->load_state(data, prefix + "/reaction_solid");
+}
+
+
+void SorptionBase::set_zero_step_output(bool output)
+{
+    ReactionTerm::set_zero_step_output(output);
+    if (reaction_liquid) reaction_liquid->set_zero_step_output(output);
+    if (reaction_solid) reaction_solid->set_zero_step_output(output);
+}
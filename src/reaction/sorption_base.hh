@@ -188,6 +188,15 @@ public:
   void update_solution(void) override;
   
   void output_data(void) override;
+
+  /// Store sorbed concentrations and state of following reactions to the checkpoint.
+  void save_state(CheckpointData &data, const std::string &prefix) override;
+
+  /// Restore state stored by @p save_state.
+  void load_state(const CheckpointData &data, const std::string &prefix) override;
+
+  /// Pass the setting to the following reactions.
+  void set_zero_step_output(bool output) override;
   
     
 protected:
@@ -31,6 +31,8 @@
 //#define ARMA_NO_DEBUG
 #include <armadillo>
 #include <array>
+#include <new>
+#include <type_traits>
 #include "system/asserts.hh"
 #include "system/logger.hh"
 
@@ -592,10 +594,18 @@ using ArmaVec = typename arma::Col<Type>::template fixed<nr>;
  * Array of Armor::Mat with given shape. Provides contiguous storage for the data and access to the array elements.
  * The shape of the matrices is specified at run time, so the class Array is independent of additional template parameters.
  * However, to access the array elements, one must use the templated method get().
+ *
+ * Storage is aligned to @p alignment bytes, component c of all matrices forms a contiguous block
+ * starting at data_ + c*reserved. Arrays of size given by CacheMapElementNumber (field value caches)
+ * can be therefore passed directly as variables to BParser.
  */
 template<class Type>
 class Array {
+    static_assert(std::is_trivial<Type>::value, "Armor::Array supports only trivial types.");
 public:
+    /// Alignment of the data storage in bytes (cache line, sufficient for AVX-512 loads).
+    static constexpr std::size_t alignment = 64;
+
     class ArrayMatSet {
         Type * ptr_;
         uint n_rows_, n_cols_;
@@ -657,7 +667,7 @@ public:
      * @param nc    Number of columns in each matrix.
      */
     Array(uint nr, uint nc = 1, uint size = 0)
-    : data_(new Type[nr * nc * size]),
+    : data_(alloc_data(nr * nc * size)),
       n_rows_(nr),
       n_cols_(nc),
       size_(size),
@@ -674,7 +684,7 @@ public:
     }
 
     ~Array() {
-        delete [] data_;
+        free_data(data_);
         data_ = nullptr;
     }
 
@@ -696,11 +706,11 @@ public:
      * @param size  New size of array.
      */
     void reinit(uint size) {
-        delete [] data_;
+        free_data(data_);
         data_ = nullptr;
         reserved_ = size;
         size_ = 0;
-        data_ = new Type[n_rows_ * n_cols_ * reserved_];
+        data_ = alloc_data(n_rows_ * n_cols_ * reserved_);
     }
 
 
@@ -874,6 +884,17 @@ public:
 
 private:
     inline uint space_() { return n_rows_ * n_cols_ * reserved_; }
+
+    /// Allocate aligned storage of @p n_items items.
+    static inline Type * alloc_data(uint n_items) {
+        return static_cast<Type *>( ::operator new[](n_items * sizeof(Type), std::align_val_t(alignment)) );
+    }
+
+    /// Free storage allocated by alloc_data.
+    static inline void free_data(Type *data) {
+        if (data != nullptr) ::operator delete[](data, std::align_val_t(alignment));
+    }
+
     uint n_rows_;
     uint n_cols_;
     uint size_;
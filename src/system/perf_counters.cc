@@ -0,0 +1,193 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    perf_counters.cc
+ * @brief   Hardware performance counters of the calling thread (Linux perf_event interface).
+ */
+
+#include "system/perf_counters.hh"
+
+#include <cstring>
+#include <initializer_list>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+
+const char *PerfCounters::event_names[PerfCounters::n_events] = {
+        "hw-cycles", "hw-instructions", "hw-cache-misses", "hw-flops"
+};
+
+
+namespace {
+
+/// Return true if the code runs on Intel processor, raw FLOP events are defined only for them.
+bool is_intel_cpu() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (! __get_cpuid(0, &eax, &ebx, &ecx, &edx)) return false;
+    char vendor[13];
+    std::memcpy(vendor, &ebx, 4);
+    std::memcpy(vendor+4, &edx, 4);
+    std::memcpy(vendor+8, &ecx, 4);
+    vendor[12] = 0;
+    return std::strcmp(vendor, "GenuineIntel") == 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+
+PerfCounters::PerfCounters()
+{
+    main_group_.size = 0;
+    flops_group_.size = 0;
+    for (unsigned int i=0; i<n_events; ++i) available_[i] = false;
+
+#ifdef __linux__
+    open_counter(main_group_, cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 1);
+    open_counter(main_group_, instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 1);
+    open_counter(main_group_, cache_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, 1);
+
+    if (is_intel_cpu()) {
+        // FP_ARITH_INST_RETIRED (event 0xC7), umasks: scalar, 128b, 256b and 512b packed double
+        open_counter(flops_group_, flops, PERF_TYPE_RAW, 0x01c7, 1);
+        open_counter(flops_group_, flops, PERF_TYPE_RAW, 0x04c7, 2);
+        open_counter(flops_group_, flops, PERF_TYPE_RAW, 0x10c7, 4);
+        open_counter(flops_group_, flops, PERF_TYPE_RAW, 0x40c7, 8);
+    }
+
+    for (Group *group : {&main_group_, &flops_group_})
+        if (group->size > 0) {
+            ioctl(group->fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(group->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+}
+
+
+PerfCounters::~PerfCounters()
+{
+    close_group(main_group_);
+    close_group(flops_group_);
+}
+
+
+bool PerfCounters::any_available() const
+{
+    for (unsigned int i=0; i<n_events; ++i)
+        if (available_[i]) return true;
+    return false;
+}
+
+
+void PerfCounters::read(Reading &reading) const
+{
+    for (unsigned int i=0; i<n_events; ++i)
+        reading.count[i] = reading.time_enabled[i] = reading.time_running[i] = 0;
+    read_group(main_group_, reading);
+    read_group(flops_group_, reading);
+}
+
+
+uint64_t PerfCounters::delta(const Reading &start, const Reading &end, Event event)
+{
+    // counters are monotone, other readings come from different opening of counters
+    if (end.count[event] < start.count[event] || end.time_running[event] <= start.time_running[event]) return 0;
+
+    uint64_t count = end.count[event] - start.count[event];
+    uint64_t time_enabled = end.time_enabled[event] - start.time_enabled[event];
+    uint64_t time_running = end.time_running[event] - start.time_running[event];
+    if (time_running >= time_enabled) return count;
+    return static_cast<uint64_t>( double(count) * time_enabled / time_running );
+}
+
+
+#ifdef __linux__
+
+void PerfCounters::open_counter(Group &group, Event event, unsigned int type, unsigned long long config, unsigned int weight)
+{
+    if (group.size == max_group_size) return;
+
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (group.size == 0);  // group is enabled at once through its leader
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    int group_fd = (group.size == 0) ? -1 : group.fd[0];
+    // pid = 0, cpu = -1: calling thread on any CPU
+    int fd = syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+    if (fd < 0) return; // not supported by hardware or not permitted, event stays unavailable
+
+    group.fd[group.size] = fd;
+    group.event[group.size] = event;
+    group.weight[group.size] = weight;
+    group.size++;
+    available_[event] = true;
+}
+
+
+void PerfCounters::read_group(const Group &group, Reading &reading) const
+{
+    if (group.size == 0) return;
+
+    // layout given by read_format: nr, time_enabled, time_running, value[nr]
+    uint64_t data[3 + max_group_size];
+    ssize_t expected = (3 + group.size) * sizeof(uint64_t);
+    if (::read(group.fd[0], data, sizeof(data)) != expected) return;
+
+    for (unsigned int i=0; i<group.size; ++i) {
+        Event event = group.event[i];
+        reading.count[event] += data[3+i] * group.weight[i];
+        reading.time_enabled[event] = data[1];
+        reading.time_running[event] = data[2];
+    }
+}
+
+
+void PerfCounters::close_group(Group &group)
+{
+    // members first, leader last
+    for (unsigned int i=group.size; i>0; --i) close(group.fd[i-1]);
+    group.size = 0;
+}
+
+#else // __linux__
+
+void PerfCounters::open_counter(Group &, Event, unsigned int, unsigned long long, unsigned int)
+{}
+
+void PerfCounters::read_group(const Group &, Reading &) const
+{}
+
+void PerfCounters::close_group(Group &group)
+{
+    group.size = 0;
+}
+
+#endif // __linux__
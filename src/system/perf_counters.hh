@@ -0,0 +1,129 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    perf_counters.hh
+ * @brief   Hardware performance counters of the calling thread (Linux perf_event interface).
+ */
+
+#ifndef PERF_COUNTERS_HH_
+#define PERF_COUNTERS_HH_
+
+#include <cstdint>
+
+
+/**
+ * @brief Hardware performance counters of a single thread.
+ *
+ * Counters are opened through the Linux 'perf_event_open' system call for the thread that constructs
+ * the object and count only events of this thread (in user space). Events are organized into two groups,
+ * that are scheduled on PMU independently:
+ *  - cycles, instructions and last level cache misses (generic events of the kernel)
+ *  - floating point operations: weighted sum of the raw events FP_ARITH_INST_RETIRED
+ *    (scalar, 128b, 256b and 512b packed double), available only on Intel processors.
+ *
+ * If the kernel does not allow the counters (e.g. perf_event_paranoid > 2, virtual machines, non-Linux systems)
+ * the event is marked as not available and its value is always zero. Values are scaled if the kernel multiplexes
+ * the counters.
+ *
+ * The object is not copyable, the counters are closed in destructor.
+ */
+class PerfCounters {
+public:
+    /// Measured events.
+    enum Event {
+        cycles = 0,
+        instructions,
+        cache_misses,
+        flops,
+        n_events
+    };
+
+    /// Names of events used in the profiler report.
+    static const char *event_names[n_events];
+
+    /**
+     * Raw values of counters of all events together with the enabled and running times of their groups.
+     *
+     * Counters are multiplexed if there are more events than hardware counters, so the raw counts
+     * are not comparable between readings. Use @p delta to get estimate of the number of events between two readings.
+     */
+    struct Reading {
+        uint64_t count[n_events];         ///< weighted sum of raw counts of the event
+        uint64_t time_enabled[n_events];  ///< time the group of the event was enabled
+        uint64_t time_running[n_events];  ///< time the group of the event was scheduled on PMU
+    };
+
+    /**
+     * Return estimate of the number of @p event occurrences between readings @p start and @p end.
+     * Difference of raw counts is scaled by the ratio of enabled and running time in the interval.
+     */
+    static uint64_t delta(const Reading &start, const Reading &end, Event event);
+
+    /// Open counters of the calling thread.
+    PerfCounters();
+
+    /// Close counters.
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /// Return true if the event is counted.
+    inline bool available(Event event) const {
+        return available_[event];
+    }
+
+    /// Return true if at least one event is counted.
+    bool any_available() const;
+
+    /**
+     * Read actual raw values of all events into @p reading.
+     * Values of not available events are set to zero.
+     *
+     * Must be called from the thread that constructs the object.
+     */
+    void read(Reading &reading) const;
+
+private:
+    /// Maximal number of events in one group.
+    static const unsigned int max_group_size = 4;
+
+    /// Group of counters read by a single system call.
+    struct Group {
+        int fd[max_group_size];              ///< file descriptors, the first is the group leader
+        Event event[max_group_size];         ///< event measured by the counter
+        unsigned int weight[max_group_size]; ///< weight of the counter in the sum of the event
+        unsigned int size;                   ///< number of opened counters
+    };
+
+    /// Open counter of given type and config, add it to @p group as contribution to @p event with @p weight.
+    void open_counter(Group &group, Event event, unsigned int type, unsigned long long config, unsigned int weight);
+
+    /// Add weighted raw values of counters of the @p group and times of the group to @p reading.
+    void read_group(const Group &group, Reading &reading) const;
+
+    /// Close all counters of the group.
+    void close_group(Group &group);
+
+    /// Counters of cycles, instructions and cache misses.
+    Group main_group_;
+
+    /// Counters of floating point operations.
+    Group flops_group_;
+
+    /// Availability of events.
+    bool available_[n_events];
+};
+
+
+#endif /* PERF_COUNTERS_HH_ */
@@ -19,8 +19,10 @@
 
 // Fat header
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
+#include <limits>
 #include <sys/param.h>
 #include <unordered_map>
 
@@ -110,6 +112,7 @@ Timer::Timer(const CodePoint &cp, int parent)
   full_hash_(cp.hash_),
   hash_idx_(cp.hash_idx_),
   parent_timer(parent),
+  anchor_timer_(0),
   total_allocated_(0),
   total_deallocated_(0),
   max_allocated_(0),
@@ -125,6 +128,10 @@ Timer::Timer(const CodePoint &cp, int parent)
 #endif // FLOW123D_HAVE_PETSC
 {
     for(unsigned int i=0; i< max_n_childs ;i++)   child_timers[i]=timer_no_child;
+    for(unsigned int i=0; i< PerfCounters::n_events ;i++) {
+        hw_start_.count[i] = hw_start_.time_enabled[i] = hw_start_.time_running[i] = 0;
+        hw_counts_[i] = 0;
+    }
 }
 
 
@@ -202,7 +209,7 @@ void Timer::resume() {
 #endif // FLOW123D_HAVE_PETSC
 }
 
-void Timer::start() {
+void Timer::start(const PerfCounters *hw) {
 #ifdef FLOW123D_HAVE_PETSC
     if (Profiler::get_petsc_memory_monitoring()) {
         // Tell PETSc to monitor the maximum memory usage so
@@ -214,6 +221,7 @@ void Timer::start() {
     
     if (start_count == 0) {
         start_time = TimePoint();
+        if (hw != nullptr) hw->read(hw_start_);
     }
     call_count++;
     start_count++;
@@ -221,7 +229,7 @@ void Timer::start() {
 
 
 
-bool Timer::stop(bool forced) {
+bool Timer::stop(bool forced, const PerfCounters *hw) {
 #ifdef FLOW123D_HAVE_PETSC
     if (Profiler::get_petsc_memory_monitoring()) {
         // get current memory usage
@@ -239,6 +247,12 @@ bool Timer::stop(bool forced) {
 
     if (start_count == 1) {
         cumul_time += (TimePoint() - start_time);
+        if (hw != nullptr) {
+            PerfCounters::Reading hw_end;
+            hw->read(hw_end);
+            for (unsigned int i=0; i<PerfCounters::n_events; i++)
+                hw_counts_[i] += PerfCounters::delta(hw_start_, hw_end, PerfCounters::Event(i));
+        }
         start_count--;
         return true;
     } else {
@@ -273,10 +287,68 @@ string Timer::code_point_str() const {
 }
 
 
+/***********************************************************************************************
+ * Implementation of ThreadTimers
+ */
+
+ThreadTimers::ThreadTimers()
+: actual_node(0),
+  hw_counters_(nullptr),
+  trace_count_(0)
+{}
+
+
+ThreadTimers::ThreadTimers(const CodePoint &root_cp)
+: actual_node(0),
+  hw_counters_(nullptr),
+  trace_count_(0)
+{
+    timers_.push_back( Timer(root_cp, 0) );
+    timers_[0].start();
+}
+
+
+ThreadTimers::~ThreadTimers() {
+    close_hw_counters();
+}
+
+
+void ThreadTimers::open_hw_counters() {
+    if (hw_counters_ != nullptr) return;
+    hw_counters_ = new ( malloc(sizeof(PerfCounters)) ) PerfCounters();
+    // timers running now count from the opening of the counters
+    PerfCounters::Reading hw_values;
+    hw_counters_->read(hw_values);
+    for (Timer &timer : timers_)
+        if (timer.running()) timer.hw_start_ = hw_values;
+}
+
+
+void ThreadTimers::close_hw_counters() {
+    if (hw_counters_ == nullptr) return;
+    hw_counters_->~PerfCounters();
+    free(hw_counters_);
+    hw_counters_ = nullptr;
+}
+
+
+void ThreadTimers::open_trace(unsigned int capacity) {
+    trace_.clear();
+    trace_.resize(capacity);
+    trace_.shrink_to_fit();
+    trace_count_ = 0;
+}
+
+
+
 /***********************************************************************************************
  * Implementation of Profiler
  */
 
+thread_local Profiler::ThreadCache Profiler::thread_cache_ = {0, nullptr};
+std::atomic<unsigned int> Profiler::generation_(0);
+const unsigned int Profiler::default_trace_capacity = 1 << 18;
+
 
 Profiler * Profiler::instance(bool clear) {
     static Profiler * _instance = NULL;
@@ -302,7 +374,13 @@ Profiler * Profiler::instance(bool clear) {
 const long Profiler::malloc_map_reserve = 100 * 1000;
 
 Profiler::Profiler()
-: actual_node(0),
+: main_timers_(),
+  timers_(main_timers_.timers_),
+  actual_node(main_timers_.actual_node),
+  main_actual_node_(0),
+  hw_counters_enabled_(false),
+  trace_capacity_(0),
+  trace_start_(),
   task_size_(1),
   start_time( time(NULL) ),
   //json_filepath(""),
@@ -312,6 +390,8 @@ Profiler::Profiler()
 {
     static CONSTEXPR_ CodePoint main_cp = CODE_POINT("Whole Program");
     set_memory_monitoring(true, true);
+    thread_cache_.generation_ = ++generation_;
+    thread_cache_.timers_ = &main_timers_;
 #ifdef FLOW123D_DEBUG_PROFILER
     MemoryAlloc::malloc_map().reserve(Profiler::malloc_map_reserve);
     timers_.push_back( Timer(main_cp, 0) );
@@ -320,6 +400,50 @@ Profiler::Profiler()
 }
 
 
+Profiler::~Profiler() {
+    for (ThreadTimers *tt : thread_timers_) {
+        tt->~ThreadTimers();
+        free(tt);
+    }
+}
+
+
+void Profiler::set_hw_counters(bool enable) {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    if (enable) {
+        main_timers_.open_hw_counters();
+        if (! main_timers_.hw_counters_->any_available()) {
+            WarningOut() << "Hardware performance counters are not available, profiler measures only times." << std::endl;
+            enable = false;
+        }
+    }
+    if (! enable) main_timers_.close_hw_counters();
+    hw_counters_enabled_ = enable;
+}
+
+
+void Profiler::set_trace(bool enable, unsigned int capacity) {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    trace_capacity_ = enable ? capacity : 0;
+    main_timers_.open_trace(trace_capacity_);
+    for (ThreadTimers *tt : thread_timers_) tt->open_trace(trace_capacity_);
+}
+
+
+ThreadTimers &Profiler::register_thread() {
+    static CONSTEXPR_ CodePoint thread_cp = CODE_POINT("Thread");
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    // allocate by malloc, the allocation must not be reported to the (not yet registered) thread
+    ThreadTimers *tt = new ( malloc(sizeof(ThreadTimers)) ) ThreadTimers(thread_cp);
+    if (hw_counters_enabled_) tt->open_hw_counters();
+    if (trace_capacity_ > 0) tt->open_trace(trace_capacity_);
+    thread_timers_.push_back(tt);
+    thread_cache_.generation_ = generation_.load();
+    thread_cache_.timers_ = tt;
+    return *tt;
+}
+
+
 void Profiler::calibrate() {
 
     uint SIZE = 64 * 1024;
@@ -382,39 +506,51 @@ void Profiler::set_program_info(string program_name, string program_version, str
 
 
 
-int  Profiler::start_timer(const CodePoint &cp) {
-    unsigned int parent_node = actual_node;
+int Profiler::start_timer(const CodePoint &cp) {
+    ThreadTimers &tt = thread_timers();
+    int timer_idx = start_timer(tt, cp);
+    if (&tt == &main_timers_) main_actual_node_.store(actual_node, std::memory_order_relaxed);
+    return timer_idx;
+}
+
+
+
+int Profiler::start_timer(ThreadTimers &tt, const CodePoint &cp) {
+    auto &timers = tt.timers_;
+    unsigned int parent_node = tt.actual_node;
     //DebugOut().fmt("Start timer: {}\n", cp.tag_);
-    int child_idx = find_child(cp);
+    int child_idx = find_child(tt, parent_node, cp);
     if (child_idx < 0) {
         //DebugOut().fmt("Adding timer: {}\n", cp.tag_);
         // tag not present - create new timer
-        child_idx=timers_.size();
-        timers_.push_back( Timer(cp, actual_node) );
-        timers_[actual_node].add_child(child_idx , timers_.back() );
+        child_idx=timers.size();
+        timers.push_back( Timer(cp, parent_node) );
+        if (&tt != &main_timers_ && parent_node == 0)
+            timers.back().anchor_timer_ = main_actual_node_.load(std::memory_order_relaxed);
+        timers[parent_node].add_child(child_idx , timers.back() );
     }
-    actual_node=child_idx;
+    tt.actual_node=child_idx;
     
     // pause current timer
-    timers_[parent_node].pause();
+    timers[parent_node].pause();
     
-    timers_[actual_node].start();
+    timers[tt.actual_node].start(tt.hw_counters_);
     
-    return actual_node;
+    return tt.actual_node;
 }
 
 
 
-int Profiler::find_child(const CodePoint &cp) {
-    Timer &timer =timers_[actual_node];
+int Profiler::find_child(ThreadTimers &tt, unsigned int node, const CodePoint &cp) {
+    Timer &timer = tt.timers_[node];
     unsigned int idx = cp.hash_idx_;
     unsigned int child_idx;
     do {
         if (timer.child_timers[idx] == timer_no_child) break; // tag is not there
 
         child_idx=timer.child_timers[idx];
-        ASSERT_PERMANENT_LT(child_idx, timers_.size()).error();
-        if (timers_[child_idx].full_hash_ == cp.hash_) return child_idx;
+        ASSERT_PERMANENT_LT(child_idx, tt.timers_.size()).error();
+        if (tt.timers_[child_idx].full_hash_ == cp.hash_) return child_idx;
         idx = ( (unsigned int)(idx)==(Timer::max_n_childs - 1) ? 0 : idx+1 );
     } while ( (unsigned int)(idx) != cp.hash_idx_ ); // passed through whole array
     return -1;
@@ -423,35 +559,55 @@ int Profiler::find_child(const CodePoint &cp) {
 
 
 void Profiler::stop_timer(const CodePoint &cp) {
+    ThreadTimers &tt = thread_timers();
+    stop_timer(tt, cp);
+    if (&tt == &main_timers_) main_actual_node_.store(actual_node, std::memory_order_relaxed);
+}
+
+
+
+void Profiler::close_timer(ThreadTimers &tt, unsigned int node, bool forced) {
+    Timer &timer = tt.timers_[node];
+    if (timer.stop(forced, tt.hw_counters_) && tt.trace_.size() > 0) {
+        TimePoint now;
+        tt.record_event(node, timer.start_time - trace_start_, now - trace_start_);
+    }
+}
+
+
+
+void Profiler::stop_timer(ThreadTimers &tt, const CodePoint &cp) {
+    auto &timers = tt.timers_;
+    unsigned int &act_node = tt.actual_node;
 #ifdef FLOW123D_DEBUG_ASSERTS
     // check that all childrens are closed
-    Timer &timer=timers_[actual_node];
+    Timer &timer=timers[act_node];
     for(unsigned int i=0; i < Timer::max_n_childs; i++)
         if (timer.child_timers[i] != timer_no_child)
-        	ASSERT_PERMANENT(! timers_[timer.child_timers[i]].running())(timers_[timer.child_timers[i]].tag())(timer.tag())
+        	ASSERT_PERMANENT(! timers[timer.child_timers[i]].running())(timers[timer.child_timers[i]].tag())(timer.tag())
 				.error("Child timer running while closing timer.");
 #endif
-    unsigned int child_timer = actual_node;
-    if ( cp.hash_ != timers_[actual_node].full_hash_) {
+    unsigned int child_timer = act_node;
+    if ( cp.hash_ != timers[act_node].full_hash_) {
         // timer to close is not actual - we search for it above actual
-        for(unsigned int node=actual_node; node != 0; node=timers_[node].parent_timer) {
-            if ( cp.hash_ == timers_[node].full_hash_) {
+        for(unsigned int node=act_node; node != 0; node=timers[node].parent_timer) {
+            if ( cp.hash_ == timers[node].full_hash_) {
                 // found above - close all nodes between
-                for(; (unsigned int)(actual_node) != node; actual_node=timers_[actual_node].parent_timer) {
+                for(; (unsigned int)(act_node) != node; act_node=timers[act_node].parent_timer) {
                 	WarningOut() << "Timer to close '" << cp.tag_ << "' do not match actual timer '"
-                			<< timers_[actual_node].tag() << "'. Force closing actual." << std::endl;
-                    timers_[actual_node].stop(true);
+                			<< timers[act_node].tag() << "'. Force closing actual." << std::endl;
+                    close_timer(tt, act_node, true);
                 }
                 // close 'node' itself
-                timers_[actual_node].stop(false);
-                actual_node = timers_[actual_node].parent_timer;
+                close_timer(tt, act_node, false);
+                act_node = timers[act_node].parent_timer;
                 
-                // actual_node == child_timer indicates this is root
-                if (actual_node == child_timer)
+                // act_node == child_timer indicates this is root
+                if (act_node == child_timer)
                     return;
                 
                 // resume current timer
-                timers_[actual_node].resume();
+                timers[act_node].resume();
                 return;
             }
         }
@@ -459,15 +615,15 @@ void Profiler::stop_timer(const CodePoint &cp) {
         return;
     }
     // node to close match the actual
-    timers_[actual_node].stop(false);
-    actual_node = timers_[actual_node].parent_timer;
+    close_timer(tt, act_node, false);
+    act_node = timers[act_node].parent_timer;
     
-    // actual_node == child_timer indicates this is root
-    if (actual_node == child_timer)
+    // act_node == child_timer indicates this is root
+    if (act_node == child_timer)
         return;
     
     // resume current timer
-    timers_[actual_node].resume();
+    timers[act_node].resume();
 }
 
 
@@ -476,9 +632,10 @@ void Profiler::stop_timer(int timer_index) {
     // stop_timer with CodePoint type
     // timer which is still running MUST be the same as actual_node index
     // if timer is not running index will differ
-    if (timers_[timer_index].running()) {
-    	ASSERT_PERMANENT_EQ(timer_index, (int)actual_node).error();
-        stop_timer(*timers_[timer_index].code_point_);
+    ThreadTimers &tt = thread_timers();
+    if (tt.timers_[timer_index].running()) {
+    	ASSERT_PERMANENT_EQ(timer_index, (int)tt.actual_node).error();
+        stop_timer(*tt.timers_[timer_index].code_point_);
     }
     
 }
@@ -486,32 +643,89 @@ void Profiler::stop_timer(int timer_index) {
 
 
 void Profiler::add_calls(unsigned int n_calls) {
-    timers_[actual_node].call_count += n_calls-1;
+    ThreadTimers &tt = thread_timers();
+    tt.timers_[tt.actual_node].call_count += n_calls-1;
 }
 
 
 
 void Profiler::notify_malloc(const size_t size, const long p) {
-    MemoryAlloc::malloc_map()[p] = static_cast<int>(size);
-    timers_[actual_node].total_allocated_ += size;
-    timers_[actual_node].current_allocated_ += size;
-    timers_[actual_node].alloc_called++;
+    // allocations of threads without timers are not monitored
+    if (thread_cache_.generation_ != generation_.load(std::memory_order_relaxed)) return;
+    Timer &timer = thread_cache_.timers_->timers_[thread_cache_.timers_->actual_node];
+    {
+        std::lock_guard<std::mutex> lock(malloc_mutex_);
+        MemoryAlloc::malloc_map()[p] = static_cast<int>(size);
+    }
+    timer.total_allocated_ += size;
+    timer.current_allocated_ += size;
+    timer.alloc_called++;
         
-    if (timers_[actual_node].current_allocated_ > timers_[actual_node].max_allocated_)
-        timers_[actual_node].max_allocated_ = timers_[actual_node].current_allocated_;
+    if (timer.current_allocated_ > timer.max_allocated_)
+        timer.max_allocated_ = timer.current_allocated_;
 }
 
 
 
 void Profiler::notify_free(const long p) {
+    if (thread_cache_.generation_ != generation_.load(std::memory_order_relaxed)) return;
+    Timer &timer = thread_cache_.timers_->timers_[thread_cache_.timers_->actual_node];
     int size = sizeof(p);
-    if (MemoryAlloc::malloc_map()[(long)p] > 0) {
-        size = MemoryAlloc::malloc_map()[(long)p];
-        MemoryAlloc::malloc_map().erase((long)p);
+    {
+        std::lock_guard<std::mutex> lock(malloc_mutex_);
+        auto it = MemoryAlloc::malloc_map().find((long)p);
+        if (it != MemoryAlloc::malloc_map().end()) {
+            if (it->second > 0) size = it->second;
+            MemoryAlloc::malloc_map().erase(it);
+        }
+    }
+    timer.total_deallocated_ += size;
+    timer.current_allocated_ -= size;
+    timer.dealloc_called++;
+}
+
+
+
+void Profiler::merge_thread_timers() {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+
+    // contribution of the main thread
+    thread_stats_.assign(timers_.size(), ThreadStat());
+    for (unsigned int i=0; i<timers_.size(); ++i) {
+        thread_stats_[i].add(timers_[i].cumulative_time(), timers_[i].call_count);
+        thread_stats_[i].add_hw(timers_[i].hw_counts_);
+    }
+
+    for (ThreadTimers *tt : thread_timers_) {
+        // map from timers of the thread to timers of the main tree
+        vector<unsigned int, internal::SimpleAllocator<unsigned int>> main_idx(tt->timers_.size(), 0);
+        // timers are stored in order of creation, so the parent is always processed before its children
+        for (unsigned int i=1; i<tt->timers_.size(); ++i) {
+            Timer &timer = tt->timers_[i];
+            unsigned int parent = (timer.parent_timer == 0) ? timer.anchor_timer_ : main_idx[timer.parent_timer];
+            int idx = find_child(main_timers_, parent, *timer.code_point_);
+            if (idx < 0) {
+                idx = timers_.size();
+                timers_.push_back( Timer(*timer.code_point_, parent) );
+                timers_[parent].add_child(idx, timers_.back());
+                thread_stats_.push_back( ThreadStat() );
+            }
+            main_idx[i] = idx;
+            thread_stats_[idx].add(timer.cumulative_time(), timer.call_count);
+            thread_stats_[idx].add_hw(timer.hw_counts_);
+        }
     }
-    timers_[actual_node].total_deallocated_ += size;
-    timers_[actual_node].current_allocated_ -= size;
-    timers_[actual_node].dealloc_called++;
+
+    for (unsigned int i=0; i<timers_.size(); ++i)
+        thread_stats_[i].cumul_time = (timers_[i].call_count > 0) ? timers_[i].cumulative_time() : thread_stats_[i].max_time;
+}
+
+
+
+Profiler::ThreadStat Profiler::thread_stat(const Timer &timer) const {
+    unsigned int idx = &timer - timers_.data();
+    ASSERT_PERMANENT_LT(idx, thread_stats_.size()).error("Thread statistics are not merged.");
+    return thread_stats_[idx];
 }
 
 
@@ -641,6 +855,7 @@ void Profiler::output(MPI_Comm comm, ostream &os) {
     MPI_Barrier(comm);
     stop_timer(0);
     propagate_timers();
+    merge_thread_timers();
     
     // stop monitoring memory
     bool temp_memory_monitoring = global_monitor_memory;
@@ -649,6 +864,13 @@ void Profiler::output(MPI_Comm comm, ostream &os) {
     chkerr( MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank) );
     MPI_Comm_size(comm, &mpi_size);
 
+    // hardware events reported by all processes
+    int hw_reported[PerfCounters::n_events];
+    for (unsigned int i=0; i<PerfCounters::n_events; i++) {
+        int available = hw_counters_enabled_ && main_timers_.hw_counters_->available( PerfCounters::Event(i) );
+        hw_reported[i] = MPI_Functions::min(&available, comm);
+    }
+
     // output header
     nlohmann::json jsonRoot, jsonChildren;
 
@@ -656,8 +878,9 @@ void Profiler::output(MPI_Comm comm, ostream &os) {
     // define lambda function which reduces timer from multiple processors
     // MPI implementation uses MPI call to reduce values
     auto reduce = [=] (Timer &timer, nlohmann::json &node) -> double {
-        int call_count = timer.call_count;
-        double cumul_time = timer.cumulative_time ();
+        ThreadStat stat = thread_stat(timer);
+        int call_count = stat.call_count;
+        double cumul_time = stat.cumul_time;
         
         long memory_allocated = (long)timer.total_allocated_;
         long memory_deallocated = (long)timer.total_deallocated_;
@@ -670,6 +893,19 @@ void Profiler::output(MPI_Comm comm, ostream &os) {
         save_mpi_metric<double>(node, comm, &cumul_time, "cumul-time");
         save_mpi_metric<int>(node, comm, &call_count, "call-count");
         
+        // statistics over threads, the average is averaged also over processes
+        double thread_avg = stat.sum_time / std::max(stat.n_threads, 1);
+        node["cumul-time-thread-min"] = MPI_Functions::min(&stat.min_time, comm);
+        node["cumul-time-thread-max"] = MPI_Functions::max(&stat.max_time, comm);
+        node["cumul-time-thread-avg"] = MPI_Functions::sum(&thread_avg, comm) / mpi_size;
+        node["thread-count"] = MPI_Functions::max(&stat.n_threads, comm);
+
+        for (unsigned int i=0; i<PerfCounters::n_events; i++)
+            if (hw_reported[i]) {
+                long hw_count = (long)stat.hw_counts[i];
+                save_mpi_metric<long>(node, comm, &hw_count, PerfCounters::event_names[i]);
+            }
+        
         save_mpi_metric<long>(node, comm, &memory_allocated, "memory-alloc");
         save_mpi_metric<long>(node, comm, &memory_deallocated, "memory-dealloc");
         save_mpi_metric<long>(node, comm, &memory_peak, "memory-peak");
@@ -731,12 +967,172 @@ string Profiler::output(MPI_Comm comm, string profiler_path /* = "" */) {
     }
 }
 
+
+double Profiler::trace_clock_offset(MPI_Comm comm) {
+    // number of ping-pong messages, the fastest one is used for the estimate
+    const int n_rounds = 10;
+    int mpi_rank, mpi_size;
+    MPI_Comm_rank(comm, &mpi_rank);
+    MPI_Comm_size(comm, &mpi_size);
+    auto trace_time = [this]() -> double {
+        TimePoint now;
+        return now - trace_start_;
+    };
+
+    double offset = 0.0;
+    if (mpi_rank == 0) {
+        for (int proc = 1; proc < mpi_size; proc++) {
+            double min_round_trip = std::numeric_limits<double>::max(), proc_offset = 0.0;
+            for (int i = 0; i < n_rounds; i++) {
+                double t_send = trace_time(), t_remote;
+                MPI_Send(&t_send, 1, MPI_DOUBLE, proc, 0, comm);
+                MPI_Recv(&t_remote, 1, MPI_DOUBLE, proc, 0, comm, MPI_STATUS_IGNORE);
+                double t_recv = trace_time();
+                if (t_recv - t_send < min_round_trip) {
+                    // remote time corresponds to the middle of the round trip
+                    min_round_trip = t_recv - t_send;
+                    proc_offset = t_remote - 0.5 * (t_send + t_recv);
+                }
+            }
+            MPI_Send(&proc_offset, 1, MPI_DOUBLE, proc, 1, comm);
+        }
+    } else {
+        for (int i = 0; i < n_rounds; i++) {
+            double t;
+            MPI_Recv(&t, 1, MPI_DOUBLE, 0, 0, comm, MPI_STATUS_IGNORE);
+            t = trace_time();
+            MPI_Send(&t, 1, MPI_DOUBLE, 0, 0, comm);
+        }
+        MPI_Recv(&offset, 1, MPI_DOUBLE, 0, 1, comm, MPI_STATUS_IGNORE);
+    }
+    return offset;
+}
+
+
+void Profiler::output_trace(MPI_Comm comm, ostream &os) {
+    int mpi_rank, mpi_size;
+    MPI_Comm_rank(comm, &mpi_rank);
+    MPI_Comm_size(comm, &mpi_size);
+
+    // stop monitoring memory
+    bool temp_memory_monitoring = global_monitor_memory;
+    set_memory_monitoring(false, petsc_monitor_memory);
+
+    double offset = trace_clock_offset(comm);
+    string events = trace_events_json(mpi_rank, offset);
+
+    // events of other processes are received by the first one process by process and written directly,
+    // messages are limited to trace_chunk_size, so int counts of MPI can not overflow
+    const uint64_t trace_chunk_size = 1 << 28;
+    uint64_t length = events.size();
+    std::vector<uint64_t> lengths(mpi_size);
+    MPI_Gather(&length, 1, MPI_UINT64_T, lengths.data(), 1, MPI_UINT64_T, 0, comm);
+
+    if (mpi_rank == 0) {
+        os << "{\"traceEvents\":[\n";
+        bool first = true;
+        string chunk;
+        for (int proc = 0; proc < mpi_size; proc++) {
+            if (lengths[proc] == 0) continue;
+            if (!first) os << ",\n";
+            first = false;
+            if (proc == 0) {
+                os.write(events.data(), events.size());
+                continue;
+            }
+            for (uint64_t pos = 0; pos < lengths[proc]; pos += trace_chunk_size) {
+                int chunk_length = static_cast<int>( std::min(trace_chunk_size, lengths[proc] - pos) );
+                chunk.resize(chunk_length);
+                MPI_Recv(&chunk[0], chunk_length, MPI_CHAR, proc, 2, comm, MPI_STATUS_IGNORE);
+                os.write(chunk.data(), chunk_length);
+            }
+        }
+        os << "\n],\n\"displayTimeUnit\":\"ms\"}" << endl;
+    } else {
+        for (uint64_t pos = 0; pos < length; pos += trace_chunk_size) {
+            int chunk_length = static_cast<int>( std::min(trace_chunk_size, length - pos) );
+            MPI_Send(events.data() + pos, chunk_length, MPI_CHAR, 0, 2, comm);
+        }
+    }
+
+    // restore memory monitoring
+    set_memory_monitoring(temp_memory_monitoring, petsc_monitor_memory);
+}
+
+
+string Profiler::output_trace(MPI_Comm comm, string trace_path /* = "" */) {
+    int mpi_rank;
+    chkerr(MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank));
+
+    // all processes must call output, but only rank 0 would use the output stream
+    if (mpi_rank == 0) {
+        if (trace_path == "") trace_path = "profiler_trace.json";
+        string out_path = FilePath(trace_path, FilePath::output_file);
+        output_trace(comm, *_profiler_output_stream(out_path));
+        return out_path;
+    } else {
+        ostringstream os;
+        output_trace(comm, os);
+        return "";
+    }
+}
+
 #endif /* FLOW123D_HAVE_MPI */
 
+
+string Profiler::trace_events_json(int rank, double offset) {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    std::stringstream ss;
+    bool first = true;
+    auto add_event = [&ss, &first](const nlohmann::json &event) {
+        if (!first) ss << ",\n";
+        ss << event.dump();
+        first = false;
+    };
+
+    nlohmann::json process_name;
+    process_name["name"] = "process_name";
+    process_name["ph"] = "M";
+    process_name["pid"] = rank;
+    process_name["args"]["name"] = "rank " + std::to_string(rank);
+    add_event(process_name);
+
+    // thread 0 is the main thread, other threads are numbered in order of registration
+    for (unsigned int tid = 0; tid <= thread_timers_.size(); tid++) {
+        ThreadTimers &tt = (tid == 0) ? main_timers_ : *thread_timers_[tid-1];
+        if (tt.trace_count_ == 0) continue;
+
+        nlohmann::json thread_name;
+        thread_name["name"] = "thread_name";
+        thread_name["ph"] = "M";
+        thread_name["pid"] = rank;
+        thread_name["tid"] = tid;
+        thread_name["args"]["name"] = (tid == 0) ? string("main") : "thread " + std::to_string(tid);
+        add_event(thread_name);
+
+        // only last events are kept in the ring buffer
+        std::size_t n_events = std::min(tt.trace_count_, tt.trace_.size());
+        for (std::size_t i = tt.trace_count_ - n_events; i < tt.trace_count_; i++) {
+            const ThreadTimers::TraceEvent &trace_event = tt.trace_[i % tt.trace_.size()];
+            // complete event, times in microseconds
+            nlohmann::json event;
+            event["name"] = tt.timers_[trace_event.timer].tag();
+            event["ph"] = "X";
+            event["pid"] = rank;
+            event["tid"] = tid;
+            event["ts"] = (trace_event.start - offset) * 1.0e6;
+            event["dur"] = (trace_event.end - trace_event.start) * 1.0e6;
+            add_event(event);
+        }
+    }
+    return ss.str();
+}
+
 void Profiler::output(ostream &os) {
     // last update
     stop_timer(0);
     propagate_timers();
+    merge_thread_timers();
 
     // output header
     nlohmann::json jsonRoot, jsonChildren;
@@ -752,8 +1148,9 @@ void Profiler::output(ostream &os) {
     // define lambda function which reduces timer from multiple processors
     // non-MPI implementation is just dummy repetition of initial value
     auto reduce = [=] (Timer &timer, nlohmann::json &node) -> double {
-        int call_count = timer.call_count;
-        double cumul_time = timer.cumulative_time ();
+        ThreadStat stat = thread_stat(timer);
+        int call_count = stat.call_count;
+        double cumul_time = stat.cumul_time;
         
         long memory_allocated = (long)timer.total_allocated_;
         long memory_deallocated = (long)timer.total_deallocated_;
@@ -765,6 +1162,17 @@ void Profiler::output(ostream &os) {
         save_nonmpi_metric<double>(node, &cumul_time, "cumul-time");
         save_nonmpi_metric<int>(node, &call_count, "call-count");
         
+        node["cumul-time-thread-min"] = stat.min_time;
+        node["cumul-time-thread-max"] = stat.max_time;
+        node["cumul-time-thread-avg"] = stat.sum_time / std::max(stat.n_threads, 1);
+        node["thread-count"] = stat.n_threads;
+
+        for (unsigned int i=0; i<PerfCounters::n_events; i++)
+            if (hw_counters_enabled_ && main_timers_.hw_counters_->available( PerfCounters::Event(i) )) {
+                long hw_count = (long)stat.hw_counts[i];
+                save_nonmpi_metric<long>(node, &hw_count, PerfCounters::event_names[i]);
+            }
+        
         save_nonmpi_metric<long>(node, &memory_allocated, "memory-alloc");
         save_nonmpi_metric<long>(node, &memory_deallocated, "memory-dealloc");
         save_nonmpi_metric<long>(node, &memory_peak, "memory-peak");
@@ -51,6 +51,8 @@
 #include "global_defs.h"
 
 #include <mpi.h>
+#include <atomic>
+#include <mutex>
 #include <ostream>
 #include <unordered_map>
 
@@ -62,6 +64,7 @@ namespace boost { template <class T> struct hash; }
 #include <nlohmann/json.hpp>
 
 #include "time_point.hh"
+#include "perf_counters.hh"
 #include "petscsys.h"
 #include "simple_allocator.hh"
 
@@ -283,7 +286,8 @@ public:
  * @brief Class for profiling tree nodes.
  *
  * One Timer represents one particular time frame in the execution tree.
- * It collects information about total time, number of calls, allocated and deallocated memory.
+ * It collects information about total time, number of calls, allocated and deallocated memory
+ * and optionally values of hardware performance counters (see PerfCounters).
  *
  * It should be accessed only through Profiler, which is its friend class.
  *
@@ -306,16 +310,18 @@ public:
 
     /**
      * Start the timer. If it is already started, just increase number of starts (recursions) and calls.
+     * If @p hw is given, read the hardware counters at the start of the frame.
      */
-    void start();
+    void start(const PerfCounters *hw = nullptr);
 
     /**
      * If number of starts (recursions) drop back to zero, we stop the timer and add the period to the cumulative time.
      * This method do not take care of its childs (it has no access to the other timers).
      * When the parameter 2p forced is 'true', we stop the timer immediately regardless the number of recursions.
+     * If @p hw is given, increments of the hardware counters are added to the timer.
      * Returns true if the timer is not closed (recursions didn't drop to zero yet).
      */
-    bool stop(bool forced = false);
+    bool stop(bool forced = false, const PerfCounters *hw = nullptr);
 
 
     /// Getter for the 'tag'.
@@ -391,6 +397,11 @@ protected:
      * Index of the parent timer node  in the tree. Negative value means 'not set'.
      */
     int parent_timer;
+    /**
+     * Only for top level timers of other than main thread: index of the main thread timer
+     * that was running when this timer was created. The thread tree is merged under this timer on output.
+     */
+    unsigned int anchor_timer_;
     /**
      * Indices of the child timers in the Profiler::timers_ vector. Negative values means 'not set'.
      */
@@ -428,6 +439,15 @@ protected:
      * Number of times delete/delete[] operator was used in this scope
      */
     int dealloc_called;
+
+    /**
+     * Raw values of hardware counters at the start of the frame.
+     */
+    PerfCounters::Reading hw_start_;
+    /**
+     * Cumulative increments of hardware counters in the frame (including children).
+     */
+    uint64_t hw_counts_[PerfCounters::n_events];
     
     #ifdef FLOW123D_HAVE_PETSC
     /**
@@ -498,6 +518,69 @@ struct translator_between<std::basic_string< Ch, Traits, Alloc >, int> {
 } // namespace property_tree
 } // namespace boost
 */
+/**
+ * @brief Timer tree of a single thread.
+ *
+ * Every thread starting a timer has its own tree, so no locking is necessary in START_TIMER.
+ * Trees of other than main thread are merged into the main tree on output.
+ */
+class ThreadTimers {
+public:
+    /// Constructor of an empty tree, used for the main thread (root timer is created by Profiler).
+    ThreadTimers();
+
+    /// Constructor of the tree of a worker thread with started root timer given by @p root_cp.
+    ThreadTimers(const CodePoint &root_cp);
+
+    /// Destructor, closes hardware counters.
+    ~ThreadTimers();
+
+    /// The tree owns hardware counters (@p hw_counters_), copies are not allowed.
+    ThreadTimers(const ThreadTimers &) = delete;
+    ThreadTimers &operator=(const ThreadTimers &) = delete;
+
+    /**
+     * Open hardware counters of the calling thread (it has to be the owner of the tree).
+     * Counters are allocated by malloc, so they are not reported by memory monitoring.
+     */
+    void open_hw_counters();
+
+    /// Close hardware counters.
+    void close_hw_counters();
+
+    /// Event of the timeline: closed frame of the timer.
+    struct TraceEvent {
+        unsigned int timer;   ///< index of the timer in @p timers_
+        double start;         ///< start of the frame in seconds from start of the profiler
+        double end;           ///< end of the frame in seconds from start of the profiler
+    };
+
+    /// Allocate ring buffer of trace events of given @p capacity, previously recorded events are discarded.
+    void open_trace(unsigned int capacity);
+
+    /// Record closed timer frame, if the buffer is full the oldest event is overwritten.
+    inline void record_event(unsigned int timer, double start, double end) {
+        trace_[trace_count_ % trace_.size()] = {timer, start, end};
+        trace_count_++;
+    }
+
+    /// Vector of all timers of the thread.
+    vector<Timer, internal::SimpleAllocator<Timer>> timers_;
+
+    /// Index of the actual timer node of the thread.
+    unsigned int actual_node;
+
+    /// Hardware counters of the thread, NULL if they are not measured.
+    PerfCounters *hw_counters_;
+
+    /// Ring buffer of trace events, empty if the timeline is not recorded.
+    vector<TraceEvent, internal::SimpleAllocator<TraceEvent>> trace_;
+
+    /// Total number of recorded events (including overwritten).
+    std::size_t trace_count_;
+};
+
+
 /**
  *
  * @brief Main class for profiling by measuring time intervals.
@@ -518,7 +601,17 @@ struct translator_between<std::basic_string< Ch, Traits, Alloc >, int> {
  * for the currently active timer.
  *
  *
- * Currently the Profiler system is not thread safe. No idea how to do this.
+ * Every thread has its own timer tree (see ThreadTimers), the thread is registered by its first START_TIMER.
+ * Top level timers of other threads are merged under the main thread timer that was running at their creation.
+ * On output all threads have to be out of the measured regions, merged timers report maximal time over threads
+ * as cumulative time and minimal, maximal and average time over threads in the keys 'cumul-time-thread-*'.
+ *
+ * Optionally (see set_hw_counters) every timer reads hardware performance counters at its start and stop,
+ * sums over threads are reported in keys 'hw-cycles-*', 'hw-instructions-*', 'hw-cache-misses-*' and 'hw-flops-*'.
+ * Events not available on some process are not reported.
+ *
+ * Optionally (see set_trace) every closed timer frame is recorded as an event of the timeline into the ring buffer
+ * of its thread. The timeline of all processes is written by output_trace in Chrome trace event format.
  *
  */
 class Profiler {
@@ -617,6 +710,22 @@ public:
      */
     string output(MPI_Comm comm, string profiler_path = "");
 
+    /**
+     * @brief Output recorded timeline of all processes in Chrome trace event format into the given stream.
+     *
+     * COLECTIVE - all processes in the communicator have to call this method.
+     * Clocks of processes are aligned to the clock of the first process, offsets are estimated
+     * from the fastest of several ping-pong messages. Every process is a 'pid' of the trace, every thread a 'tid'.
+     * The output can be opened in chrome://tracing or Perfetto UI.
+     */
+    void output_trace(MPI_Comm comm, std::ostream &os);
+
+    /**
+     * Same as previous, but output to the file @p trace_path, default name is "profiler_trace.json".
+     * Returns path to the file on the first process, empty string on others.
+     */
+    string output_trace(MPI_Comm comm, string trace_path = "");
+
 #endif /* FLOW123D_HAVE_MPI */
     /**
      * @brief Output current timing information into the given stream.
@@ -659,6 +768,9 @@ public:
     static void operator delete (void* p);
     /// Sized deallocator, doesthe same as operator delete (void* p)
     static void operator delete (void* p, std::size_t);
+
+    /// Destructor, releases timer trees of other threads.
+    ~Profiler();
     
     /**
      * Public setter to turn on/off memory monitoring
@@ -683,6 +795,23 @@ public:
     	return petsc_monitor_memory;
     }
 
+    /**
+     * Turn on/off measurement of hardware performance counters in timers. Counters of the calling (main) thread
+     * are opened immediately, other threads open their counters when they start their first timer.
+     * If the counters are not available (not Linux, kernel restrictions), a warning is printed and only times are measured.
+     */
+    void set_hw_counters(bool enable);
+
+    /**
+     * Turn on/off recording of the timeline of timer frames. Every thread keeps last @p capacity events,
+     * older events are overwritten. Events recorded so far are discarded.
+     * Should be called when no other thread runs a timer.
+     */
+    void set_trace(bool enable, unsigned int capacity = default_trace_capacity);
+
+    /// Default number of trace events kept by one thread.
+    static const unsigned int default_trace_capacity;
+
     /**
      * Run calibration frame "UNIT PAYLOAD".
      * That should be about 100x timer resolution.
@@ -736,10 +865,73 @@ protected:
     void accept_from_child (Timer &parent, Timer &child);
     
     /**
-     * Try to find timer with tag (in fact only its 32-bit hash) from given code point @p cp.
-     * Returns -1 if it is not found otherwise it returns its index.
+     * Try to find child of the timer @p node in the tree @p tt with tag (in fact only its 32-bit hash)
+     * from given code point @p cp. Returns -1 if it is not found otherwise it returns its index.
      */
-    int find_child(const CodePoint &cp);
+    int find_child(ThreadTimers &tt, unsigned int node, const CodePoint &cp);
+
+    /// Statistics of a timer over all threads.
+    struct ThreadStat {
+        ThreadStat() : n_threads(0), call_count(0), cumul_time(0.0), min_time(0.0), max_time(0.0), sum_time(0.0) {
+            for (unsigned int i=0; i<PerfCounters::n_events; ++i) hw_counts[i] = 0;
+        }
+
+        /// Add contribution of one thread.
+        inline void add(double time, int calls) {
+            if (calls == 0) return;
+            min_time = (n_threads == 0) ? time : std::min(min_time, time);
+            max_time = std::max(max_time, time);
+            sum_time += time;
+            call_count += calls;
+            n_threads++;
+        }
+
+        /// Add hardware counters of one thread.
+        inline void add_hw(const uint64_t *counts) {
+            for (unsigned int i=0; i<PerfCounters::n_events; ++i) hw_counts[i] += counts[i];
+        }
+
+        int n_threads;
+        int call_count;
+        double cumul_time;  ///< Time of the main thread if it runs the timer, maximum over threads otherwise.
+        double min_time, max_time, sum_time;
+        uint64_t hw_counts[PerfCounters::n_events];  ///< Hardware counters summed over threads.
+    };
+
+    /// Return timer tree of the calling thread, register the thread if it is called first time.
+    inline ThreadTimers &thread_timers() {
+        if (thread_cache_.generation_ != generation_.load(std::memory_order_relaxed)) return register_thread();
+        return *thread_cache_.timers_;
+    }
+
+    /// Create timer tree of the calling thread.
+    ThreadTimers &register_thread();
+
+    /// Stop the timer @p node of the tree @p tt, record trace event if the frame is closed.
+    void close_timer(ThreadTimers &tt, unsigned int node, bool forced);
+
+#ifdef FLOW123D_HAVE_MPI
+    /// Estimate offset of the trace clock of the actual process to the clock of the first process in @p comm.
+    double trace_clock_offset(MPI_Comm comm);
+#endif /* FLOW123D_HAVE_MPI */
+
+    /// Return trace events of all threads as comma separated JSON objects with times shifted by @p offset.
+    string trace_events_json(int rank, double offset);
+
+    /// Implementation of @p start_timer in given tree.
+    int start_timer(ThreadTimers &tt, const CodePoint &cp);
+
+    /// Implementation of @p stop_timer in given tree.
+    void stop_timer(ThreadTimers &tt, const CodePoint &cp);
+
+    /**
+     * Merge timer trees of other threads into the main tree and fill @p thread_stats_.
+     * Must be called when other threads are out of the measured regions.
+     */
+    void merge_thread_timers();
+
+    /// Return statistics over threads of the main tree timer, valid after @p merge_thread_timers.
+    ThreadStat thread_stat(const Timer &timer) const;
 
 
     /**
@@ -755,11 +947,48 @@ protected:
      */
     //std::shared_ptr<std::ostream> get_output_stream(string path);
 
-    /// Vector of all timers. Whole tree is stored in this array.
-    vector<Timer, internal::SimpleAllocator<Timer>> timers_;
+    /// Cache of the timer tree of the calling thread, valid if generation match the actual Profiler.
+    struct ThreadCache {
+        unsigned int generation_;
+        ThreadTimers *timers_;
+    };
+    static thread_local ThreadCache thread_cache_;
 
-    /// Index of the actual timer node. Negative value means 'unset'.
-    unsigned int actual_node;
+    /// Incremented for every new Profiler instance, invalidates thread caches. Read by all threads in START_TIMER.
+    static std::atomic<unsigned int> generation_;
+
+    /// Timer tree of the main thread (thread that created the Profiler).
+    ThreadTimers main_timers_;
+
+    /// Vector of all timers of the main thread. Whole tree is stored in this array.
+    vector<Timer, internal::SimpleAllocator<Timer>> &timers_;
+
+    /// Index of the actual timer node of the main thread.
+    unsigned int &actual_node;
+
+    /// Copy of @p actual_node readable from other threads.
+    std::atomic<unsigned int> main_actual_node_;
+
+    /// Timer trees of other threads.
+    vector<ThreadTimers *, internal::SimpleAllocator<ThreadTimers *>> thread_timers_;
+
+    /// Guards registration of threads.
+    std::mutex thread_mutex_;
+
+    /// Guards MemoryAlloc::malloc_map.
+    std::mutex malloc_mutex_;
+
+    /// Statistics over threads of the main tree timers, filled by @p merge_thread_timers.
+    vector<ThreadStat, internal::SimpleAllocator<ThreadStat>> thread_stats_;
+
+    /// True if hardware counters are measured, see set_hw_counters.
+    bool hw_counters_enabled_;
+
+    /// Capacity of trace buffers of threads, zero if the timeline is not recorded.
+    unsigned int trace_capacity_;
+
+    /// Origin of times of trace events.
+    TimePoint trace_start_;
 
     /// MPI communicator used for final reduce of the timer node tree.
     //MPI_Comm communicator_;
@@ -887,6 +1116,14 @@ public:
     {}
     void output(MPI_Comm, ostream &)
     {}
+    void set_hw_counters(bool)
+    {}
+    void set_trace(bool, unsigned int = 0)
+    {}
+    void output_trace(MPI_Comm, ostream &)
+    {}
+    string output_trace(MPI_Comm, string = "")
+    {return "";}
     string output(MPI_Comm, string)
     {return "";}
     void output(std::ostream &)
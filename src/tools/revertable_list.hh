@@ -146,6 +146,19 @@ public:
     	data_.resize(0);
     }
 
+    /**
+     * Replace content of the list by items of range [first, last), all items are permanent.
+     *
+     * Reserved size is enlarged if it is necessary.
+     */
+    template<class Iterator>
+    inline void assign(Iterator first, Iterator last)
+    {
+        data_.assign(first, last);
+        temporary_size_ = data_.size();
+        permanent_size_ = data_.size();
+    }
+
     inline typename std::vector<Type>::iterator begin()
     {
     	return data_.begin();
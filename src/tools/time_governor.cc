@@ -23,6 +23,7 @@
 #include "time_marks.hh"
 #include "unit_si.hh"
 #include "unit_converter.hh"
+#include "io/checkpoint.hh"
 
 /*******************************************************************
  * implementation of TimeGovernor static values and methods
@@ -787,6 +788,73 @@ void TimeGovernor::view(const char *name) const
 
 
 
+void TimeGovernor::save_state(CheckpointData &data, const std::string &prefix) const
+{
+    // recent steps from the oldest one, so they can be pushed to the front in the same order
+    std::vector<unsigned int> step_index;
+    std::vector<double> step_length, step_end;
+    for (auto it = recent_steps_.rbegin(); it != recent_steps_.rend(); ++it) {
+        step_index.push_back(it->index_);
+        step_length.push_back(it->length_);
+        step_end.push_back(it->end_);
+    }
+    data.save(prefix + "/step_index", step_index);
+    data.save(prefix + "/step_length", step_length);
+    data.save(prefix + "/step_end", step_end);
+
+    std::vector<double> real_state = { end_of_fixed_dt_interval_, fixed_time_step_,
+            upper_constraint_, lower_constraint_, max_time_step_, min_time_step_,
+            last_upper_constraint_, last_lower_constraint_, last_printed_timestep_ };
+    data.save(prefix + "/real_state", real_state);
+    std::vector<unsigned int> int_state = { is_time_step_fixed_, time_step_changed_, dt_limits_pos_ };
+    data.save(prefix + "/int_state", int_state);
+}
+
+
+
+void TimeGovernor::load_state(const CheckpointData &data, const std::string &prefix)
+{
+    std::vector<unsigned int> step_index;
+    std::vector<double> step_length, step_end;
+    data.load(prefix + "/step_index", step_index);
+    data.load(prefix + "/step_length", step_length);
+    data.load(prefix + "/step_end", step_end);
+    ASSERT_EQ(step_index.size(), step_length.size());
+    ASSERT_EQ(step_index.size(), step_end.size());
+
+    TimeStep init_step = recent_steps_.back();
+    recent_steps_.clear();
+    for (unsigned int i=0; i<step_index.size(); ++i) {
+        TimeStep ts(init_step);
+        ts.index_ = step_index[i];
+        ts.length_ = step_length[i];
+        ts.end_ = step_end[i];
+        recent_steps_.push_front(ts);
+    }
+
+    std::vector<double> real_state;
+    data.load(prefix + "/real_state", real_state);
+    ASSERT_EQ(real_state.size(), 9);
+    end_of_fixed_dt_interval_ = real_state[0];
+    fixed_time_step_ = real_state[1];
+    upper_constraint_ = real_state[2];
+    lower_constraint_ = real_state[3];
+    max_time_step_ = real_state[4];
+    min_time_step_ = real_state[5];
+    last_upper_constraint_ = real_state[6];
+    last_lower_constraint_ = real_state[7];
+    last_printed_timestep_ = real_state[8];
+
+    std::vector<unsigned int> int_state;
+    data.load(prefix + "/int_state", int_state);
+    ASSERT_EQ(int_state.size(), 3);
+    is_time_step_fixed_ = int_state[0];
+    time_step_changed_ = int_state[1];
+    dt_limits_pos_ = int_state[2];
+}
+
+
+
 double TimeGovernor::read_time(Input::Iterator<Input::Tuple> time_it, double default_time) const {
 	return time_unit_conversion_->read_time(time_it, default_time);
 }
@@ -38,6 +38,7 @@
 #include "system/exceptions.hh"
 #include "tools/time_marks.hh"
 
+class CheckpointData;
 namespace Input {
     class Record;
     class Tuple;
@@ -227,6 +228,7 @@ public:
                 && (end_ == other.end_);
         }
 private:
+    friend class TimeGovernor;
 
     /* Returns true if t1-t0 > delta. Where delta is choosen
      * related to the current time step and magnitude of t1, t0.
@@ -607,6 +609,18 @@ public:
      */
     void view(const char *name="") const;
 
+    /**
+     * Store state of the time governor (recent time steps, constraints and fixed time step)
+     * into the checkpoint. Names of blocks are prefixed by @p prefix.
+     */
+    void save_state(CheckpointData &data, const std::string &prefix) const;
+
+    /**
+     * Restore state of the time governor stored by @p save_state.
+     * Time marks and DT limits table are not stored, they are given by the input.
+     */
+    void load_state(const CheckpointData &data, const std::string &prefix);
+
     /**
      * Read and return time value multiplied by coefficient of given unit or global coefficient of equation
      * stored in time_unit_conversion_. If time Tuple is not defined (e. g. Tuple is optional key) return
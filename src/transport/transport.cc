@@ -41,6 +41,7 @@
 #include "tools/time_governor.hh"
 #include "tools/mixed.hh"
 #include "coupling/balance.hh"
+#include "io/checkpoint.hh"
 #include "input/accessors.hh"
 #include "input/input_type.hh"
 
@@ -319,7 +320,7 @@ void ConvectionTransport::zero_time_step()
 	END_TIMER("sources_reinit_set_bc");
 
     // write initial condition
-	output_data();
+	if (zero_step_output_) output_data();
 }
 
 
@@ -542,3 +543,29 @@ void ConvectionTransport::set_balance_object(std::shared_ptr<Balance> balance)
 	eq_data_->subst_idx = balance_->add_quantities(eq_data_->substances_.names());
     eq_data_->balance_ = this->balance();
 }
+
+
+
+void ConvectionTransport::save_state(CheckpointData &data, const std::string &prefix)
+{
+    EquationBase::save_state(data, prefix);
+    for (unsigned int sbi=0; sbi<n_substances(); sbi++)
+        data.save(prefix + "/conc/" + substances()[sbi].name(), eq_fields_->conc_mobile_fe[sbi]->vec());
+    data.save(prefix + "/mass_diag", eq_data_->mass_diag);
+    data.save(prefix + "/vpmass_diag", vpmass_diag);
+}
+
+
+
+void ConvectionTransport::load_state(const CheckpointData &data, const std::string &prefix)
+{
+    EquationBase::load_state(data, prefix);
+    for (unsigned int sbi=0; sbi<n_substances(); sbi++) {
+        VectorMPI &conc_vec = eq_fields_->conc_mobile_fe[sbi]->vec();
+        data.load(prefix + "/conc/" + substances()[sbi].name(), conc_vec);
+        conc_vec.local_to_ghost_begin();
+        conc_vec.local_to_ghost_end();
+    }
+    data.load(prefix + "/mass_diag", eq_data_->mass_diag);
+    data.load(prefix + "/vpmass_diag", vpmass_diag);
+}
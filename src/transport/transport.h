@@ -254,6 +254,16 @@ public:
      */
     virtual void output_data() override;
 
+    /// Store time governor, balance, concentrations and mass matrix diagonals to the checkpoint.
+    void save_state(CheckpointData &data, const std::string &prefix) override;
+
+    /// Restore state stored by @p save_state.
+    void load_state(const CheckpointData &data, const std::string &prefix) override;
+
+    /// Add the output stream of the transport.
+    void get_output_streams(std::vector<std::shared_ptr<OutputTime>> &streams) override
+    { streams.push_back(output_stream_); }
+
     void set_output_stream(std::shared_ptr<OutputTime> stream) override
     { output_stream_ = stream; }
 
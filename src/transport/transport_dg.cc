@@ -29,6 +29,7 @@
 #include "fields/field_fe.hh"
 #include "la/linsys_PETSC.hh"
 #include "coupling/balance.hh"
+#include "io/checkpoint.hh"
 #include "coupling/generic_assembly.hh"
 #include "transport/advection_diffusion_model.hh"
 #include "transport/concentration_model.hh"
@@ -90,6 +91,8 @@ const Record & TransportDG<Model>::get_input_type() {
                 "Variant of the interior penalty discontinuous Galerkin method.")
         .declare_key("dg_order", Integer(0,3), Default("1"),
                 "Polynomial order for the finite element in DG method (order 0 is suitable if there is no diffusion/dispersion).")
+        .declare_key("dof_renumbering", DOFHandlerMultiDim::get_renumbering_selection(), Default("\"none\""),
+                "Renumbering of the degrees of freedom owned by the processor, 'cell_block' improves locality of the DG matrix.")
         .declare_key("init_projection", Bool(), Default("true"),
                 "If true, use DG projection of the initial condition field."
                 "Otherwise, evaluate initial condition field directly (well suited for reading native data).")
@@ -181,6 +184,7 @@ TransportDG<Model>::TransportDG(Mesh & init_mesh, const Input::Record in_rec)
 	MixedPtr<FE_P_disc> fe(eq_data_->dg_order);
 	shared_ptr<DiscreteSpace> ds = make_shared<EqualOrderDiscreteSpace>(Model::mesh_, fe);
 	eq_data_->dh_ = make_shared<DOFHandlerMultiDim>(*Model::mesh_);
+	eq_data_->dh_->set_renumbering( in_rec.val<DOFHandlerMultiDim::Renumbering>("dof_renumbering") );
 	eq_data_->dh_->distribute_dofs(ds);
     //DebugOut().fmt("TDG: solution size {}\n", eq_data_->dh_->n_global_dofs());
 
@@ -366,7 +370,7 @@ void TransportDG<Model>::zero_time_step()
         ret_sources_prev[sbi] = 0;
     }
 
-    output_data();
+    if (Model::zero_step_output_) output_data();
 }
 
 
@@ -428,13 +432,14 @@ void TransportDG<Model>::update_solution()
         	eq_data_->ls_dt[i]->finish_assembly();
             VecAssemblyBegin(eq_data_->ret_vec[i]);
             VecAssemblyEnd(eq_data_->ret_vec[i]);
-            // construct mass_vec for initial time
-            if (mass_matrix[i] == NULL)
+            // construct mass_vec for initial time, unless it is restored from a checkpoint
+            if (mass_vec[i] == NULL)
             {
                 VecDuplicate(eq_data_->ls[i]->get_solution(), &mass_vec[i]);
                 MatMult(*(eq_data_->ls_dt[i]->get_matrix()), eq_data_->ls[i]->get_solution(), mass_vec[i]);
-                MatConvert(*( eq_data_->ls_dt[i]->get_matrix() ), MATSAME, MAT_INITIAL_MATRIX, &mass_matrix[i]);
             }
+            if (mass_matrix[i] == NULL)
+                MatConvert(*( eq_data_->ls_dt[i]->get_matrix() ), MATSAME, MAT_INITIAL_MATRIX, &mass_matrix[i]);
             else
                 MatCopy(*( eq_data_->ls_dt[i]->get_matrix() ), mass_matrix[i], DIFFERENT_NONZERO_PATTERN);
         }
@@ -670,6 +675,38 @@ void TransportDG<Model>::update_after_reactions(bool solution_changed)
 
 
 
+template<class Model>
+void TransportDG<Model>::save_state(CheckpointData &data, const std::string &prefix)
+{
+    Model::save_state(data, prefix);
+    for (unsigned int sbi=0; sbi<eq_data_->n_substances(); ++sbi) {
+        data.save(prefix + "/solution/" + std::to_string(sbi), eq_data_->output_vec[sbi]);
+        // mass of the previous time step, not allocated before the first step
+        if (mass_vec[sbi] != NULL)
+            data.save(prefix + "/mass_vec/" + std::to_string(sbi), mass_vec[sbi]);
+    }
+    data.save(prefix + "/ret_sources_prev", ret_sources_prev);
+}
+
+
+template<class Model>
+void TransportDG<Model>::load_state(const CheckpointData &data, const std::string &prefix)
+{
+    Model::load_state(data, prefix);
+    for (unsigned int sbi=0; sbi<eq_data_->n_substances(); ++sbi) {
+        data.load(prefix + "/solution/" + std::to_string(sbi), eq_data_->output_vec[sbi]);
+        std::string mass_name = prefix + "/mass_vec/" + std::to_string(sbi);
+        if (data.contains(mass_name)) {
+            if (mass_vec[sbi] == NULL) chkerr(VecDuplicate(eq_data_->ls[sbi]->get_solution(), &mass_vec[sbi]));
+            data.load(mass_name, mass_vec[sbi]);
+        }
+    }
+    data.load(prefix + "/ret_sources_prev", ret_sources_prev);
+    compute_p0_interpolation();
+}
+
+
+
 
 template class TransportDG<ConcentrationTransportModel>;
 template class TransportDG<HeatTransferModel>;
@@ -255,6 +255,16 @@ public:
 	 */
 	void output_data();
 
+	/// Store time governor, balance and solution vectors to the checkpoint.
+	void save_state(CheckpointData &data, const std::string &prefix) override;
+
+	/// Restore state stored by @p save_state.
+	void load_state(const CheckpointData &data, const std::string &prefix) override;
+
+	/// Add the output stream of the model.
+	void get_output_streams(std::vector<std::shared_ptr<OutputTime>> &streams) override
+	{ streams.push_back(Model::output_stream_); }
+
 	/**
 	 * @brief Destructor.
 	 */
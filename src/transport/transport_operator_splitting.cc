@@ -29,6 +29,7 @@
 #include "tools/time_governor.hh"
 #include "coupling/equation.hh"
 #include "coupling/balance.hh"
+#include "io/checkpoint.hh"
 #include "transport/transport.h"
 #include "mesh/mesh.h"
 
@@ -252,6 +253,30 @@ void TransportOperatorSplitting::output_data(){
 }
 
 
+void TransportOperatorSplitting::save_state(CheckpointData &data, const std::string &prefix)
+{
+    EquationBase::save_state(data, prefix);
+    convection->save_state(data, prefix + "/convection");
+    if(reaction) reaction->save_state(data, prefix + "/reaction");
+}
+
+
+void TransportOperatorSplitting::load_state(const CheckpointData &data, const std::string &prefix)
+{
+    EquationBase::load_state(data, prefix);
+    convection->load_state(data, prefix + "/convection");
+    if(reaction) reaction->load_state(data, prefix + "/reaction");
+}
+
+
+void TransportOperatorSplitting::set_zero_step_output(bool output)
+{
+    EquationBase::set_zero_step_output(output);
+    convection->set_zero_step_output(output);
+    if(reaction) reaction->set_zero_step_output(output);
+}
+
+
 void TransportOperatorSplitting::zero_time_step()
 {
     //DebugOut() << "tos ZERO TIME STEP.\n";
@@ -260,7 +285,7 @@ void TransportOperatorSplitting::zero_time_step()
     if(reaction)
     {
       reaction->zero_time_step();
-      reaction->output_data(); // do not perform write_time_frame
+      if (zero_step_output_) reaction->output_data(); // do not perform write_time_frame
     }
 
 }
@@ -228,6 +228,19 @@ public:
     void compute_internal_step();
     void output_data() override;
 
+    /// Store state of the convection and the reaction to the checkpoint.
+    void save_state(CheckpointData &data, const std::string &prefix) override;
+
+    /// Restore state stored by @p save_state.
+    void load_state(const CheckpointData &data, const std::string &prefix) override;
+
+    /// Pass the setting to the convection and the reaction.
+    void set_zero_step_output(bool output) override;
+
+    /// Add the output stream of the convection, it is shared with the reaction.
+    void get_output_streams(std::vector<std::shared_ptr<OutputTime>> &streams) override
+    { convection->get_output_streams(streams); }
+
    
 
 private:
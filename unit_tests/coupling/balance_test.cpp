@@ -0,0 +1,262 @@
+/*
+ * balance_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#define TEST_USE_PETSC
+#define FEAL_OVERRIDE_ASSERTS
+#include <flow_gtest_mpi.hh>
+#include <mesh_constructor.hh>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <petscvec.h>
+#include "yaml-cpp/yaml.h"
+
+#include "system/file_path.hh"
+#include "system/sys_profiler.hh"
+#include "input/accessors.hh"
+#include "input/reader_to_storage.hh"
+#include "io/checkpoint.hh"
+#include "coupling/balance.hh"
+#include "fem/dofhandler.hh"
+#include "fem/dh_cell_accessor.hh"
+#include "mesh/mesh.h"
+#include "mesh/accessors.hh"
+#include "tools/time_governor.hh"
+#include "tools/unit_si.hh"
+
+
+const std::string balance_input = R"YAML(
+cumulative: true
+add_output_times: false
+times: [ 0, 1, 2 ]
+)YAML";
+
+
+/**
+ * Balance of a single quantity on the bulk regions "3D back" and "3D front" of simplest_cube.msh.
+ *
+ * Every element of these regions has one dof with solution value 2 and contributes:
+ *  - mass 1*2+0.5 = 2.5 (3D back), 3*2 = 6 (3D front),
+ *  - source -1*2+3 = 1 (3D back), -2*2+1 = -3 (3D front),
+ *  - on every boundary side outgoing flux 0.5*2-2 = -1 (3D back), 1*2+0.5 = 2.5 (3D front),
+ *    i.e. incoming fluxes 1 and -2.5.
+ */
+class BalanceTest : public testing::Test {
+protected:
+    void SetUp() override {
+        Profiler::instance();
+        FilePath::set_io_dirs(".", UNIT_TESTS_SRC_DIR, "", ".");
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
+        mesh_ = mesh_full_constructor("{ mesh_file=\"mesh/simplest_cube.msh\", optimize_mesh=false }");
+        dh_ = std::make_shared<DOFHandlerMultiDim>(*mesh_);
+
+        Input::ReaderToStorage reader( balance_input, Balance::get_input_type(), Input::FileFormat::format_YAML );
+        in_rec_ = reader.get_root_interface<Input::Record>();
+
+        back_ = mesh_->region_db().find_label("3D back").bulk_idx();
+        front_ = mesh_->region_db().find_label("3D front").bulk_idx();
+
+        // local dofs of the balanced elements
+        n_loc_dofs_ = 0;
+        for (auto cell : dh_->own_range())
+            if (is_balanced(cell.elm())) n_loc_dofs_++;
+        solution_data_.assign(n_loc_dofs_, 2.0);
+        chkerr(VecCreateSeqWithArray(PETSC_COMM_SELF, 1, n_loc_dofs_, solution_data_.data(), &solution_));
+
+        // hand-computed global values
+        n_back_ = n_front_ = 0;
+        for (auto elm : mesh_->elements_range()) {
+            if (! is_balanced(elm)) continue;
+            bool is_back = (elm.region_idx().bulk_idx() == back_);
+            if (is_back) n_back_++;
+            else n_front_++;
+            for (unsigned int si=0; si<elm->n_sides(); si++)
+                if (elm.side(si)->is_boundary()) {
+                    std::string label = elm.side(si)->cond().region().label();
+                    if (is_back) flux_in_[label] += 1.0;
+                    else flux_out_[label] += -2.5;
+                }
+        }
+        total_flux_ = 0;
+        for (auto &f : flux_in_) total_flux_ += f.second;
+        for (auto &f : flux_out_) total_flux_ += f.second;
+        total_mass_ = 2.5*n_back_ + 6.0*n_front_;
+        total_source_ = 1.0*n_back_ - 3.0*n_front_;
+    }
+
+    void TearDown() override {
+        chkerr(VecDestroy(&solution_));
+        dh_.reset();
+        delete mesh_;
+        Profiler::uninitialize();
+    }
+
+    bool is_balanced(const ElementAccessor<3> &elm) const {
+        if (elm.region_idx().is_boundary()) return false;
+        unsigned int reg_idx = elm.region_idx().bulk_idx();
+        return (reg_idx == back_ || reg_idx == front_);
+    }
+
+    /// Create balance, the output files are given by @p prefix.
+    std::shared_ptr<Balance> create_balance(const std::string &prefix, TimeGovernor &tg) {
+        auto balance = std::make_shared<Balance>(prefix, mesh_);
+        balance->init_from_input(in_rec_, tg);
+        balance->units(UnitSI().kg());
+        quantity_ = balance->add_quantity("A");
+        balance->allocate(n_loc_dofs_, 1);
+        return balance;
+    }
+
+    /// Assemble mass, flux and source entries of all local balanced elements.
+    void assemble(Balance &balance) {
+        balance.start_mass_assembly(quantity_);
+        balance.start_flux_assembly(quantity_);
+        balance.start_source_assembly(quantity_);
+        unsigned int i_dof = 0;
+        for (auto cell : dh_->own_range()) {
+            if (! is_balanced(cell.elm())) continue;
+            bool is_back = (cell.elm().region_idx().bulk_idx() == back_);
+            LocDofVec dofs = { (IntIdx)i_dof++ };
+            balance.add_mass_values(quantity_, cell, dofs, { is_back ? 1.0 : 3.0 }, is_back ? 0.5 : 0.0);
+            balance.add_source_values(quantity_, cell.elm().region_idx().bulk_idx(), dofs,
+                    { is_back ? -1.0 : -2.0 }, { is_back ? 3.0 : 1.0 });
+            for (DHCellSide side : cell.side_range())
+                if (side.side().is_boundary())
+                    balance.add_flux_values(quantity_, side, dofs, { is_back ? 0.5 : 1.0 }, is_back ? -2.0 : 0.5);
+        }
+        balance.finish_mass_assembly(quantity_);
+        balance.finish_flux_assembly(quantity_);
+        balance.finish_source_assembly(quantity_);
+    }
+
+    /// Balance step at the actual time of the time governor.
+    void balance_step(Balance &balance) {
+        balance.calculate_cumulative(quantity_, solution_);
+        balance.calculate_instant(quantity_, solution_);
+        balance.output();
+    }
+
+    /// Return data of the YAML balance output of given time and region, only on process 0.
+    std::vector<double> yaml_data(const std::string &prefix, double time, const std::string &region) {
+        YAML::Node root = YAML::LoadFile( std::string( FilePath(prefix + "_balance.yaml", FilePath::output_file) ) );
+        for (auto item : root["data"])
+            if (item["time"].as<double>() == time && item["region"].as<std::string>() == region)
+                return item["data"].as< std::vector<double> >();
+        ADD_FAILURE() << "Missing balance of region " << region << " at time " << time;
+        return std::vector<double>(12, 0.0);
+    }
+
+    int rank_;
+    Mesh *mesh_;
+    std::shared_ptr<DOFHandlerMultiDim> dh_;
+    Input::Record in_rec_;
+    unsigned int back_, front_;
+    unsigned int quantity_;
+    unsigned int n_loc_dofs_;
+    std::vector<double> solution_data_;
+    Vec solution_;
+
+    unsigned int n_back_, n_front_;
+    std::map<std::string, double> flux_in_, flux_out_;
+    double total_flux_, total_mass_, total_source_;
+};
+
+
+TEST_F(BalanceTest, mass_instant_cumulative) {
+    TimeGovernor tg(0.0, 1.0);
+    std::shared_ptr<Balance> balance = create_balance("balance_a", tg);
+    assemble(*balance);
+
+    std::vector<double> mass;
+    balance->calculate_mass(quantity_, solution_, mass);
+    if (rank_ == 0) {
+        EXPECT_DOUBLE_EQ(2.5*n_back_, mass[back_]);
+        EXPECT_DOUBLE_EQ(6.0*n_front_, mass[front_]);
+    }
+
+    balance_step(*balance);
+    tg.next_time();
+    balance_step(*balance);
+
+    if (rank_ == 0) {
+        std::vector<double> data = yaml_data("balance_a", 1, "3D back");
+        EXPECT_DOUBLE_EQ(2.5*n_back_, data[3]);
+        EXPECT_DOUBLE_EQ(1.0*n_back_, data[5]);
+        EXPECT_DOUBLE_EQ(0.0, data[6]);
+        data = yaml_data("balance_a", 1, "3D front");
+        EXPECT_DOUBLE_EQ(6.0*n_front_, data[3]);
+        EXPECT_DOUBLE_EQ(0.0, data[5]);
+        EXPECT_DOUBLE_EQ(-3.0*n_front_, data[6]);
+        for (auto &f : flux_in_)
+            EXPECT_DOUBLE_EQ(f.second, yaml_data("balance_a", 1, f.first)[1]);
+        for (auto &f : flux_out_)
+            EXPECT_DOUBLE_EQ(f.second, yaml_data("balance_a", 1, f.first)[2]);
+
+        // flux, mass, source, cumulative flux and source over one unit time step
+        data = yaml_data("balance_a", 1, "ALL");
+        EXPECT_DOUBLE_EQ(total_flux_, data[0]);
+        EXPECT_DOUBLE_EQ(total_mass_, data[3]);
+        EXPECT_DOUBLE_EQ(total_source_, data[4]);
+        EXPECT_DOUBLE_EQ(total_flux_, data[9]);
+        EXPECT_DOUBLE_EQ(total_source_, data[10]);
+    }
+}
+
+
+TEST_F(BalanceTest, save_load_state) {
+    TimeGovernor tg(0.0, 1.0);
+    std::shared_ptr<Balance> balance = create_balance("balance_b", tg);
+    assemble(*balance);
+    balance_step(*balance);
+    tg.next_time();
+    balance_step(*balance);
+    balance->add_cumulative_source(quantity_, 0.25);
+
+    CheckpointData data;
+    balance->save_state(data, "balance");
+    std::vector<double> initial_mass, integrated_sources, integrated_fluxes, increment_sources;
+    data.load("balance/initial_mass", initial_mass);
+    data.load("balance/integrated_sources", integrated_sources);
+    data.load("balance/integrated_fluxes", integrated_fluxes);
+    data.load("balance/increment_sources", increment_sources);
+    if (rank_ == 0) {
+        EXPECT_DOUBLE_EQ(total_mass_, initial_mass[quantity_]);
+        EXPECT_DOUBLE_EQ(total_source_, integrated_sources[quantity_]);
+        EXPECT_DOUBLE_EQ(total_flux_, integrated_fluxes[quantity_]);
+        EXPECT_DOUBLE_EQ(0.25, increment_sources[quantity_]);
+    }
+
+    // restored balance continues as the original one
+    std::shared_ptr<Balance> restored = create_balance("balance_c", tg);
+    assemble(*restored);
+    restored->load_state(data, "balance");
+
+    tg.next_time();
+    balance_step(*balance);
+    balance_step(*restored);
+
+    CheckpointData data_cont, data_rest;
+    balance->save_state(data_cont, "balance");
+    restored->save_state(data_rest, "balance");
+    for (const std::string &name : {"initial_mass", "integrated_sources", "integrated_fluxes"}) {
+        std::vector<double> cont, rest;
+        data_cont.load("balance/" + name, cont);
+        data_rest.load("balance/" + name, rest);
+        EXPECT_EQ(cont, rest) << name;
+    }
+    if (rank_ == 0) {
+        std::vector<double> cont;
+        data_cont.load("balance/integrated_sources", cont);
+        EXPECT_DOUBLE_EQ(2*total_source_ + 0.25, cont[quantity_]);
+        data_cont.load("balance/integrated_fluxes", cont);
+        EXPECT_DOUBLE_EQ(2*total_flux_, cont[quantity_]);
+        std::vector<double> yaml_all = yaml_data("balance_c", 2, "ALL");
+        EXPECT_DOUBLE_EQ(2*total_flux_, yaml_all[9]);
+        EXPECT_DOUBLE_EQ(2*total_source_ + 0.25, yaml_all[10]);
+    }
+}
@@ -305,6 +305,62 @@ TEST(DOFHandler, test_rt)
 
 
 
+// Renumbered dof handler must give the same dofs on cells up to a permutation
+// of dofs owned by each processor.
+TEST(DOFHandler, test_renumbering)
+{
+    FilePath::set_io_dirs(".",UNIT_TESTS_SRC_DIR,"",".");
+    Profiler::instance();
+    Mesh * mesh = mesh_full_constructor("{ mesh_file=\"fem/small_mesh_junction.msh\", optimize_mesh=false }");
+
+    MixedPtr<FE_P> fe_p(1);
+    MixedPtr<FE_RT0> fe_rt;
+    for (auto fe : { MixedPtr<FiniteElement>(fe_p), MixedPtr<FiniteElement>(fe_rt) })
+    {
+        std::shared_ptr<DiscreteSpace> ds = std::make_shared<EqualOrderDiscreteSpace>(mesh, fe);
+        DOFHandlerMultiDim dh_ref(*mesh);
+        dh_ref.distribute_dofs(ds);
+
+        for (auto renumbering : { DOFHandlerMultiDim::Renumbering::rcm,
+                                  DOFHandlerMultiDim::Renumbering::sfc,
+                                  DOFHandlerMultiDim::Renumbering::cell_block })
+        {
+            DOFHandlerMultiDim dh(*mesh);
+            dh.set_renumbering(renumbering);
+            dh.distribute_dofs(ds);
+
+            EXPECT_EQ( dh_ref.n_global_dofs(), dh.n_global_dofs() );
+            EXPECT_EQ( dh_ref.lsize(), dh.lsize() );
+
+            std::map<LongIdx, LongIdx> ref_to_new, new_to_ref;
+            std::vector<LongIdx> ref_indices(dh.max_elem_dofs()), indices(dh.max_elem_dofs());
+            for ( DHCellAccessor cell : dh.local_range() )
+            {
+                unsigned int n_dofs = cell.get_dof_indices(indices);
+                dh_ref.cell_accessor_from_element(cell.elm_idx()).get_dof_indices(ref_indices);
+                for (unsigned int i=0; i<n_dofs; i++)
+                {
+                    // owned dofs stay on the processor
+                    bool ref_owned = (ref_indices[i] >= (LongIdx)dh_ref.distr()->begin() && ref_indices[i] < (LongIdx)dh_ref.distr()->end());
+                    bool owned = (indices[i] >= (LongIdx)dh.distr()->begin() && indices[i] < (LongIdx)dh.distr()->end());
+                    EXPECT_EQ( ref_owned, owned );
+
+                    auto it = ref_to_new.insert( std::make_pair(ref_indices[i], indices[i]) ).first;
+                    EXPECT_EQ( it->second, indices[i] );
+                    auto it_new = new_to_ref.insert( std::make_pair(indices[i], ref_indices[i]) ).first;
+                    EXPECT_EQ( it_new->second, ref_indices[i] );
+                }
+            }
+        }
+    }
+
+    delete mesh;
+
+    Profiler::uninitialize();
+}
+
+
+
 TEST(DHAccessors, dh_cell_accessors) {
     FilePath::set_io_dirs(".",UNIT_TESTS_SRC_DIR,"",".");
     Profiler::instance();
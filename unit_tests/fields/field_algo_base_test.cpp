@@ -979,3 +979,154 @@ TEST(Field, field_values) {
 
 
 
+
+
+/**
+ * Fixture for tests of the incremental update of region fields in Field::set_time.
+ *
+ * History is set directly by FieldConstant algorithms, the value on a region is identified
+ * by the algorithm returned by Field::region_algorithm.
+ */
+class FieldSetTime : public testing::Test {
+protected:
+    typedef Field<3, FieldValue<3>::Scalar > ScalarField;
+
+    void SetUp() override {
+        Profiler::instance();
+        FilePath::set_io_dirs(".",UNIT_TESTS_SRC_DIR,"",".");
+        mesh_ = mesh_full_constructor("{ mesh_file=\"mesh/simplest_cube.msh\", optimize_mesh=false }");
+
+        field_.name("field").units( UnitSI::dimensionless() );
+        field_.set_mesh(*mesh_);
+    }
+
+    void TearDown() override {
+        delete mesh_;
+        Profiler::uninitialize();
+    }
+
+    /// Set constant @p value on the given region sets from @p time.
+    void set_value(double value, double time, std::vector<std::string> region_set_names) {
+        auto algo = std::make_shared< FieldConstant<3, FieldValue<3>::Scalar> >();
+        algo->set_value(value);
+        values_[algo.get()] = value;
+        field_.set(algo, time, region_set_names);
+    }
+
+    /// Value of @p field on the region with given label.
+    double value(const ScalarField &field, const std::string &label) {
+        auto it = values_.find( field.region_algorithm( mesh_->region_db().find_label(label).idx() ) );
+        return (it == values_.end()) ? -1.0 : it->second;
+    }
+
+    /// Check values of @p field on the bulk regions in the order: 1D diagonal, 2D XY diagonal, 3D back, 3D front.
+    void expect_values(const ScalarField &field, std::vector<double> ref) {
+        EXPECT_EQ( ref[0], value(field, "1D diagonal") );
+        EXPECT_EQ( ref[1], value(field, "2D XY diagonal") );
+        EXPECT_EQ( ref[2], value(field, "3D back") );
+        EXPECT_EQ( ref[3], value(field, "3D front") );
+    }
+
+    Mesh *mesh_;
+    ScalarField field_;
+    std::map<const void *, double> values_;
+};
+
+
+// regions with different last history times, only the group at the actual time is updated
+TEST_F(FieldSetTime, partial_update) {
+    TimeGovernor tg(0.0, 0.5);
+    set_value(1.0, 0.0, {"ALL"});
+    EXPECT_TRUE( field_.set_time(tg.step(), LimitSide::right) );
+    expect_values(field_, {1.0, 1.0, 1.0, 1.0});
+
+    tg.next_time();
+    EXPECT_FALSE( field_.set_time(tg.step(), LimitSide::right) );
+    expect_values(field_, {1.0, 1.0, 1.0, 1.0});
+
+    // new history point, first set_time updates all regions, left limit keeps old values
+    set_value(2.0, 1.0, {"3D back"});
+    tg.next_time();
+    EXPECT_FALSE( field_.set_time(tg.step(), LimitSide::left) );
+    EXPECT_TRUE( field_.is_jump_time() );
+    expect_values(field_, {1.0, 1.0, 1.0, 1.0});
+
+    // same time and history, only the group of "3D back" is updated
+    EXPECT_TRUE( field_.set_time(tg.step(), LimitSide::right) );
+    EXPECT_TRUE( field_.is_jump_time() );
+    expect_values(field_, {1.0, 1.0, 2.0, 1.0});
+
+    // later time with no history point, jump regions are updated, values are kept
+    tg.next_time();
+    EXPECT_FALSE( field_.set_time(tg.step(), LimitSide::right) );
+    EXPECT_FALSE( field_.is_jump_time() );
+    expect_values(field_, {1.0, 1.0, 2.0, 1.0});
+}
+
+
+// jump times on subsets of regions, other regions keep their values on both limit sides
+TEST_F(FieldSetTime, jump_on_subset) {
+    TimeGovernor tg(0.0, 0.5);
+    set_value(1.0, 0.0, {"ALL"});
+    EXPECT_TRUE( field_.set_time(tg.step(), LimitSide::right) );
+    expect_values(field_, {1.0, 1.0, 1.0, 1.0});
+    unsigned int n_changes = field_.n_changes();
+
+    set_value(3.0, 0.5, {"1D diagonal", "3D front"});
+    tg.next_time();
+    EXPECT_FALSE( field_.set_time(tg.step(), LimitSide::left) );
+    EXPECT_TRUE( field_.is_jump_time() );
+    expect_values(field_, {1.0, 1.0, 1.0, 1.0});
+
+    EXPECT_TRUE( field_.set_time(tg.step(), LimitSide::right) );
+    EXPECT_TRUE( field_.is_jump_time() );
+    expect_values(field_, {3.0, 1.0, 1.0, 3.0});
+
+    // the same limit side, nothing is updated
+    EXPECT_TRUE( field_.set_time(tg.step(), LimitSide::right) );
+    expect_values(field_, {3.0, 1.0, 1.0, 3.0});
+
+    // jump of other subset, regions of the previous jump are not in the actual group
+    set_value(2.0, 1.0, {"3D back"});
+    tg.next_time();
+    EXPECT_FALSE( field_.set_time(tg.step(), LimitSide::left) );
+    EXPECT_TRUE( field_.is_jump_time() );
+    expect_values(field_, {3.0, 1.0, 1.0, 3.0});
+
+    EXPECT_TRUE( field_.set_time(tg.step(), LimitSide::right) );
+    expect_values(field_, {3.0, 1.0, 2.0, 3.0});
+
+    tg.next_time();
+    EXPECT_FALSE( field_.set_time(tg.step(), LimitSide::left) );
+    EXPECT_FALSE( field_.is_jump_time() );
+    expect_values(field_, {3.0, 1.0, 2.0, 3.0});
+    EXPECT_EQ( n_changes + 2, field_.n_changes() );
+}
+
+
+// history point added after the first set_time invalidates region groups of the field and of its copies
+TEST_F(FieldSetTime, history_changed) {
+    TimeGovernor tg(0.0, 0.5);
+    set_value(1.0, 0.0, {"ALL"});
+    EXPECT_TRUE( field_.set_time(tg.step(), LimitSide::right) );
+    ScalarField copy(field_);
+    EXPECT_TRUE( copy.set_time(tg.step(), LimitSide::right) );
+
+    tg.next_time();
+    EXPECT_FALSE( field_.set_time(tg.step(), LimitSide::right) );
+    EXPECT_FALSE( copy.set_time(tg.step(), LimitSide::right) );
+
+    // the new history time is greater than times in the region groups
+    set_value(4.0, 1.0, {"2D XY diagonal"});
+    tg.next_time();
+    EXPECT_TRUE( field_.set_time(tg.step(), LimitSide::right) );
+    expect_values(field_, {1.0, 4.0, 1.0, 1.0});
+    EXPECT_TRUE( copy.set_time(tg.step(), LimitSide::right) );
+    expect_values(copy, {1.0, 4.0, 1.0, 1.0});
+
+    tg.next_time();
+    EXPECT_FALSE( field_.set_time(tg.step(), LimitSide::right) );
+    EXPECT_FALSE( copy.set_time(tg.step(), LimitSide::right) );
+    expect_values(field_, {1.0, 4.0, 1.0, 1.0});
+    expect_values(copy, {1.0, 4.0, 1.0, 1.0});
+}
@@ -495,3 +495,31 @@ TEST_F(FieldEvalFETest, set_fe_data_vector) {
     SingleValRef<arma::vec3> ref_vector(expected);
     EXPECT_TRUE( eval_bulk_field(eq_data_->vector_field, ref_vector) );
 }
+
+
+TEST_F(FieldEvalFETest, observe_stencil) {
+    typedef FieldFE<3, FieldValue<3>::VectorFixed > VectorFieldFE;
+    this->create_mesh("fields/one_element_2d.msh");
+    this->set_dof_values( {0.5, 1.5, 2.5} );
+
+    MixedPtr<FE_RT0> fe;
+    std::shared_ptr<DiscreteSpace> ds = std::make_shared<EqualOrderDiscreteSpace>(mesh_, fe);
+    dh_->distribute_dofs(ds);
+
+    std::shared_ptr<VectorFieldFE> fe_field = std::make_shared<VectorFieldFE>();
+    fe_field->set_fe_data(dh_, v);
+
+    std::vector<IntIdx> dofs;
+    std::vector<double> shapes;
+    arma::vec local_coords = {1./3, 1./3}; // barycenter, the point of QGauss(2, 0)
+    EXPECT_TRUE( fe_field->observe_stencil(0, local_coords, dofs, shapes) );
+    ASSERT_EQ(3u, dofs.size());
+    ASSERT_EQ(9u, shapes.size());
+
+    // value given by stencil is equal to value evaluated by the field
+    arma::vec3 value = arma::zeros<arma::vec>(3);
+    for (unsigned int k=0; k<dofs.size(); ++k)
+        for (unsigned int c=0; c<3; ++c) value(c) += fe_field->vec().get(dofs[k]) * shapes[3*k+c];
+    arma::vec3 expected = { 1./7, 2./7, 0.0 };
+    for (unsigned int c=0; c<3; ++c) EXPECT_NEAR(expected(c), value(c), 1e-12);
+}
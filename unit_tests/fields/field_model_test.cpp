@@ -21,6 +21,7 @@
 #include "fields/field_model.hh"
 #include "fields/multi_field.hh"
 #include "fields/field_constant.hh"
+#include "fields/field_set.hh"
 #include "mesh/accessors.hh"
 #include "mesh/mesh.h"
 #include "quadrature/quadrature.hh"
@@ -112,6 +113,26 @@ Vector fn_other(Vector a, Scalar c, Vector b) {
 }
 
 
+// Functor class without data members with resolution 'scalar * vector'
+struct FnProduct {
+    inline Vector operator() (Scalar a, Vector v) {
+        return a * v;
+    }
+};
+
+
+// Functor class with data member with resolution 'coef * scalar * vector'
+struct FnScaledProduct {
+    FnScaledProduct(double coef) : coef_(coef) {}
+
+    inline Vector operator() (Scalar a, Vector v) {
+        return coef_ * a * v;
+    }
+
+    double coef_;
+};
+
+
 // Test of FieldModel - simple test without MultiFields (static method Model::create)
 TEST_F(FieldModelTest, create) {
     Field<3, FieldValue<3>::Scalar > f_scal;
@@ -169,6 +190,70 @@ TEST_F(FieldModelTest, create) {
 
 
 
+// Test of FieldSet::cache_update reusing stored values of unchanged fields
+TEST_F(FieldModelTest, stored_values) {
+    class EqFields : public FieldSet {
+    public:
+        EqFields() {
+            *this += f_scal.name("f_scal").units( UnitSI::dimensionless() );
+            *this += f_vec.name("f_vec").units( UnitSI::dimensionless() );
+            *this += f_product.name("f_product").units( UnitSI::dimensionless() );
+        }
+
+        Field<3, FieldValue<3>::Scalar > f_scal;
+        Field<3, FieldValue<3>::VectorFixed > f_vec;
+        Field<3, FieldValue<3>::VectorFixed > f_product;
+    };
+
+    TimeGovernor tg(0.0, 1.0);
+    this->init_field_caches();
+    EqFields data;
+    data.set_mesh( *mesh );
+    data.set_default_fieldset();
+    auto scal_ptr = std::make_shared< FieldConstant<3, FieldValue<3>::Scalar> >();
+    scal_ptr->set_value(2.0);
+    auto vec_ptr = std::make_shared< FieldConstant<3, FieldValue<3>::VectorFixed> >();
+    vec_ptr->set_value( arma::vec3("1.0 2.0 3.0") );
+    data.f_scal.set(scal_ptr, 0.0);
+    data.f_vec.set(vec_ptr, 0.0);
+    data.f_product.set(Model<3, FieldValue<3>::VectorFixed>::create(FnProduct(), data.f_scal, data.f_vec), 0.0);
+    data.set_time(tg.step(), LimitSide::right);
+    data.set_dependency(data);
+    EXPECT_TRUE( data.f_product.is_cache_reusable(1) );
+
+    // only models of functors without state are reusable
+    EXPECT_FALSE( Model<3, FieldValue<3>::VectorFixed>::create(FnScaledProduct(2.0), data.f_scal, data.f_vec)->is_cache_reusable() );
+    EXPECT_FALSE( Model<3, FieldValue<3>::VectorFixed>::create(fn_product, data.f_scal, data.f_vec)->is_cache_reusable() );
+
+    this->start_elements_update();
+    this->fill_cache_data();
+    ElementCacheMap::PatchFieldValues stored_values;
+    this->set_patch_field_values(&stored_values);
+
+    // first update evaluates and stores all fields
+    data.cache_update(*this);
+    EXPECT_EQ(stored_values.size(), 3);
+    for (unsigned int i=0; i<n_items; ++i)
+        EXPECT_ARMA_EQ(data.f_product.value_cache()->template mat<3, 1>(i), arma::vec3("2.0 4.0 6.0"));
+
+    // fields did not change, values are copied from storage (change of value without set_time is not visible)
+    scal_ptr->set_value(3.0);
+    data.f_product.value_cache()->set(0) = arma::vec3("0.0 0.0 0.0");
+    data.cache_update(*this);
+    for (unsigned int i=0; i<n_items; ++i)
+        EXPECT_ARMA_EQ(data.f_product.value_cache()->template mat<3, 1>(i), arma::vec3("2.0 4.0 6.0"));
+
+    // change of dependency invalidates stored values of the model
+    data.f_scal.set_time_result_changed();
+    data.cache_update(*this);
+    for (unsigned int i=0; i<n_items; ++i) {
+        EXPECT_DOUBLE_EQ(data.f_scal.value_cache()->scalar(i), 3.0);
+        EXPECT_ARMA_EQ(data.f_product.value_cache()->template mat<3, 1>(i), arma::vec3("3.0 6.0 9.0"));
+    }
+    this->set_patch_field_values(nullptr);
+}
+
+
 // Functor with resolution 'scalar * multi'
 Scalar multi_product(Scalar a, Scalar v) {
     return a * v;
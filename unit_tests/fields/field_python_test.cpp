@@ -106,6 +106,69 @@ TEST_F(FieldEvalPythonTest, evaluate) {
 }
 
 
+TEST_F(FieldEvalPythonTest, batch_dependency) {
+    // vector_field depends on the Python field, it is evaluated after the batch of Python fields
+    string eq_data_input = R"YAML(
+    data:
+      - region: BULK
+        time: 0.0
+        scalar_field: !FieldPython
+          source_file: ./fields/field_python_test.py
+          class: FieldPythonTest4
+          used_fields: ['X']
+        vector_field: !FieldFormula
+          value: "[scalar_field, 2*scalar_field, 0.5]"
+        scalar_ref: !FieldFormula
+          value: X[0]
+        vector_ref: !FieldFormula
+          value: "[X[0], 2*X[0], 0.5]"
+    )YAML";
+
+    this->create_mesh("mesh/cube_2x1.msh");
+    this->read_input(eq_data_input);
+
+    eq_data_->reallocate_cache();
+
+    FieldRef<ScalarField> ref_scalar(eq_data_->scalar_ref);
+    FieldRef<VectorField> ref_vector(eq_data_->vector_ref);
+    EXPECT_TRUE( eq_data_->scalar_field.is_cache_reusable(1) );
+    EXPECT_TRUE( eval_bulk_field(eq_data_->scalar_field, ref_scalar) );
+    EXPECT_TRUE( eval_bulk_field(eq_data_->vector_field, ref_vector) );
+}
+
+
+TEST_F(FieldEvalPythonTest, evaluate_batch) {
+    // user class evaluates both fields in one call, fields have different used fields
+    string eq_data_input = R"YAML(
+    data:
+      - region: BULK
+        time: 0.0
+        scalar_field: !FieldPython
+          source_file: ./fields/field_python_test.py
+          class: FieldPythonTest5
+          used_fields: ['X']
+        vector_field: !FieldPython
+          source_file: ./fields/field_python_test.py
+          class: FieldPythonTest5
+          used_fields: ['scalar_ref']
+        scalar_ref: !FieldFormula
+          value: X[0]
+        vector_ref: !FieldFormula
+          value: "[X[0], 2*X[0], 0.5]"
+    )YAML";
+
+    this->create_mesh("mesh/cube_2x1.msh");
+    this->read_input(eq_data_input);
+
+    eq_data_->reallocate_cache();
+
+    FieldRef<ScalarField> ref_scalar(eq_data_->scalar_ref);
+    FieldRef<VectorField> ref_vector(eq_data_->vector_ref);
+    EXPECT_TRUE( eval_bulk_field(eq_data_->scalar_field, ref_scalar) );
+    EXPECT_TRUE( eval_bulk_field(eq_data_->vector_field, ref_vector) );
+}
+
+
 TEST_F(FieldEvalPythonTest, exc_nonexist_file) {
     string eq_data_input = R"YAML(
     data:
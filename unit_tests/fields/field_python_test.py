@@ -59,4 +59,24 @@ class FieldPythonTest3(flowpy.PythonFieldBase):
     def python_field(self):
         """ Evaluates expression: x """
         return self.X[0]
-        
\ No newline at end of file
+        
+
+class FieldPythonTest4(flowpy.PythonFieldBase):
+    time_independent_fields = {"scalar_field"}
+
+    def scalar_field(self):
+        """ Evaluates expression: x, values are reused in time """
+        return self.X[0]
+
+
+class FieldPythonTest5(flowpy.PythonFieldBase):
+    def evaluate_batch(self, field_ranges):
+        """ Evaluates all fields of the patch in one call, fields have different used fields """
+        for field_name, ranges in field_ranges.items():
+            self.select_batch(field_name, ranges)
+            if field_name == "scalar_field":
+                self.set_batch_result(field_name, ranges, self.X[0])
+            else:
+                ones = np.ones(self.scalar_ref.shape[-1])
+                values = self.repl( np.array([1.0, 2.0, 0.0]) ) * self.scalar_ref + self.repl( np.array([0.0, 0.0, 0.5]) ) * ones
+                self.set_batch_result(field_name, ranges, values)
@@ -387,6 +387,18 @@ public:
             }
         }
 
+        /// Addresses of evaluation plans of regions, plans taken from the cache keep their addresses.
+        std::map<unsigned int, const void *> plan_data() {
+            std::map<unsigned int, const void *> data;
+            for (auto &r : this->region_eval_plans_) data[r.first] = r.second.data();
+            return data;
+        }
+
+        /// Check number of sorted fields on all regions
+        void check_size(unsigned int n_fields) {
+            for (auto r : this->region_field_update_order_) EXPECT_EQ(r.second.size(), n_fields);
+        }
+
         // fields
         Field<3, FieldValue<3>::Scalar >      a_field;
         Field<3, FieldValue<3>::VectorFixed > b_field;
@@ -460,6 +472,27 @@ TEST_F(TestDependency, dependency_tree) {
 }
 
 
+TEST_F(TestDependency, cached_plans) {
+	this->read_input(dependency_input);
+    std::map<unsigned int, const void *> plan_data = data_->plan_data();
+
+    // plans are not rebuilt for the same used field set
+    data_->set_dependency( *(data_.get()) );
+    EXPECT_EQ(plan_data, data_->plan_data());
+
+    // e_field depends on a_field, b_field, c_field, d_field
+    FieldSet e_set;
+    e_set += data_->e_field;
+    data_->set_dependency(e_set);
+    data_->check_size(5);
+
+    // plans of the whole field set are taken from the cache
+    data_->set_dependency( *(data_.get()) );
+    EXPECT_EQ(plan_data, data_->plan_data());
+    data_->check_size(7);
+}
+
+
     /*
      * set_time
      */
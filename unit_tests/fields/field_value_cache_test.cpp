@@ -214,3 +214,65 @@ TEST_F(FieldValueCacheTest, element_cache_map) {
     elm_to_patch_.clear();
     this->clear_element_eval_points_map();
 }
+
+
+TEST_F(FieldValueCacheTest, patch_layout) {
+    // Create patch of 3 elements on 2 different regions and store its layout
+    this->start_elements_update();
+    DHCellAccessor dh_cell1(dh_.get(), 1);
+    DHCellAccessor dh_cell3(dh_.get(), 3);
+    DHCellAccessor dh_cell6(dh_.get(), 6);
+    this->add_bulk_points(dh_cell1);
+    this->add_bulk_points(dh_cell3);
+    this->add_bulk_points(dh_cell6);
+    this->eval_point_data_.make_permanent();
+    this->create_patch();
+
+    unsigned int n_map_items = this->n_elements() * eval_points->max_size();
+    std::vector<int> ref_map(element_eval_points_map_, element_eval_points_map_ + n_map_items);
+    std::vector<unsigned int> ref_elm_idx(elm_idx_.begin(), elm_idx_.begin() + this->n_elements());
+    std::vector<unsigned int> ref_positions = { this->position_in_cache(1), this->position_in_cache(3), this->position_in_cache(6) };
+    unsigned int ref_n_points = this->eval_point_data_.permanent_size();
+
+    ElementCacheMap::PatchLayout layout;
+    this->save_patch_layout(layout);
+    this->finish_elements_update();
+    elm_to_patch_.clear();
+    this->clear_element_eval_points_map();
+
+    // Other patch between save and restore
+    this->start_elements_update();
+    DHCellAccessor dh_cell2(dh_.get(), 2);
+    this->add_bulk_points(dh_cell2);
+    this->eval_point_data_.make_permanent();
+    this->create_patch();
+    EXPECT_EQ(this->n_elements(), 1);
+    this->finish_elements_update();
+    elm_to_patch_.clear();
+    this->clear_element_eval_points_map();
+
+    // Restored patch is identical to the created one
+    this->start_elements_update();
+    this->restore_patch_layout(layout);
+    EXPECT_EQ(this->n_elements(), 3);
+    EXPECT_EQ(this->n_regions(), 2);
+    EXPECT_EQ(this->eval_point_data_.permanent_size(), ref_n_points);
+    EXPECT_EQ(this->region_chunk_begin(0), 0);
+    EXPECT_EQ(this->region_chunk_end(0), 8);
+    EXPECT_EQ(this->position_in_cache(1), ref_positions[0]);
+    EXPECT_EQ(this->position_in_cache(3), ref_positions[1]);
+    EXPECT_EQ(this->position_in_cache(6), ref_positions[2]);
+    EXPECT_EQ(this->position_in_cache(2), ElementCacheMap::undef_elem_idx);
+    for (unsigned int i=0; i<ref_elm_idx.size(); ++i)
+        EXPECT_EQ(elm_idx_[i], ref_elm_idx[i]);
+    for (unsigned int i=0; i<n_map_items; ++i)
+        EXPECT_EQ(element_eval_points_map_[i], ref_map[i]);
+    this->finish_elements_update();
+    this->release_patch_layout(layout);
+    this->clear_element_eval_points_map();
+
+    // Maps of elements are returned to layout, so the patch can be restored again
+    EXPECT_EQ(layout.element_to_map_.size(), 3);
+    for (unsigned int i=0; i<n_map_items; ++i)
+        EXPECT_EQ(element_eval_points_map_[i], int(ElementCacheMap::unused_point));
+}
@@ -0,0 +1,135 @@
+/*
+ * darcy_checkpoint_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#define TEST_USE_PETSC
+#define FEAL_OVERRIDE_ASSERTS
+#include <flow_gtest_mpi.hh>
+#include <mesh_constructor.hh>
+
+#include <fstream>
+#include <sstream>
+#include "io/checkpoint.hh"
+#include "io/output_time.hh"
+#include "system/file_path.hh"
+#include "system/sys_profiler.hh"
+#include "input/reader_to_storage.hh"
+#include "flow/darcy_flow_lmh.hh"
+#include "mesh/mesh.h"
+
+
+const std::string darcy_input = R"YAML(
+time:
+  end_time: 0.6
+  init_dt: 0.1
+  min_dt: 0.1
+  max_dt: 0.1
+nonlinear_solver:
+  linear_solver: !Petsc
+    r_tol: 1.0e-12
+    a_tol: 1.0e-14
+input_fields:
+  - region: BULK
+    conductivity: 1
+    storativity: 1
+    init_pressure: 0
+  - region: .BOUNDARY
+    bc_type: dirichlet
+    bc_pressure: !FieldFormula
+      value: X[0]*(1+t)
+output:
+  fields: [pressure_p0]
+  observe_fields: [pressure_p0, velocity_p0]
+output_stream:
+  file: checkpoint_flow.pvd
+  format: !vtk
+  observe_points:
+    - { name: center, point: [0.1, 0.2, 0.3] }
+    - { name: corner, point: [-0.9, 0.8, -0.7] }
+)YAML";
+
+
+/// Return content of the observe file of the Darcy flow, empty on other processes than 0.
+std::string darcy_observe_file(int rank) {
+    if (rank != 0) return "";
+    std::ifstream file( std::string( FilePath("flow_observe.yaml", FilePath::output_file) ) );
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+
+// Unsteady Darcy flow restarted from the checkpoint file reproduces the solution of the continuous run
+// bit for bit and appends the observe file written before the checkpoint.
+TEST(DarcyCheckpoint, restart_bit_for_bit) {
+    Profiler::instance();
+    FilePath::set_io_dirs(".", UNIT_TESTS_SRC_DIR, "", ".");
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    FilePath file_path("test_darcy_restart." + std::to_string(rank) + ".chkp", FilePath::output_file);
+    const unsigned int n_steps = 6, n_restart_steps = 2;
+
+    Mesh *mesh = mesh_full_constructor("{ mesh_file=\"mesh/simplest_cube.msh\", optimize_mesh=false }");
+    Input::ReaderToStorage reader( darcy_input, DarcyLMH::get_input_type(), Input::FileFormat::format_YAML );
+    Input::Record in_rec = reader.get_root_interface<Input::Record>();
+
+    auto save_checkpoint = [&file_path](DarcyLMH &flow) {
+        std::vector<std::shared_ptr<OutputTime>> streams;
+        flow.get_output_streams(streams);
+        CheckpointData data;
+        for (unsigned int i=0; i<streams.size(); ++i) {
+            streams[i]->flush_observe();
+            streams[i]->save_state(data, "output_" + std::to_string(i));
+        }
+        flow.save_state(data, "flow");
+        data.write_file(file_path);
+    };
+
+    // continuous run, writes the checkpoint
+    std::vector<double> solution;
+    std::string observe_content;
+    {
+        DarcyLMH flow(*mesh, in_rec);
+        flow.initialize();
+        flow.zero_time_step();
+        for (unsigned int step=0; step<n_steps; ++step) {
+            if (step == n_restart_steps) save_checkpoint(flow);
+            flow.update_solution();
+        }
+        auto &full_solution = flow.eq_data().full_solution;
+        for (unsigned int i=0; i<full_solution.size(); ++i) solution.push_back(full_solution.get(i));
+    }
+    observe_content = darcy_observe_file(rank);
+    if (rank == 0) EXPECT_NE(std::string::npos, observe_content.find("- time:"));
+
+    // restarted run, the zero time step only allocates the structures
+    {
+        DarcyLMH flow(*mesh, in_rec);
+        flow.initialize();
+        flow.set_zero_step_output(false);
+        flow.zero_time_step();
+
+        CheckpointData data;
+        data.read_file(file_path);
+        std::vector<std::shared_ptr<OutputTime>> streams;
+        flow.get_output_streams(streams);
+        for (unsigned int i=0; i<streams.size(); ++i)
+            streams[i]->load_state(data, "output_" + std::to_string(i));
+        flow.load_state(data, "flow");
+        EXPECT_EQ(n_restart_steps, flow.time().step().index());
+
+        for (unsigned int step=n_restart_steps; step<n_steps; ++step)
+            flow.update_solution();
+
+        // exact comparison
+        auto &full_solution = flow.eq_data().full_solution;
+        ASSERT_EQ(solution.size(), full_solution.size());
+        for (unsigned int i=0; i<full_solution.size(); ++i) EXPECT_EQ(solution[i], full_solution.get(i));
+    }
+    EXPECT_EQ(observe_content, darcy_observe_file(rank));
+
+    delete mesh;
+    Profiler::uninitialize();
+}
@@ -191,3 +191,104 @@ TEST(intersection_prolongation_23d, all) {
     }
     Profiler::uninitialize();
 }
+
+
+/// Intersections computed in several threads are the same as in the serial computation.
+TEST(intersection_prolongation_23d, threads) {
+    Profiler::instance();
+    FilePath::set_dirs(UNIT_TESTS_SRC_DIR,"",".");
+    string dir_name = string(UNIT_TESTS_SRC_DIR) + "/intersection/prolong_meshes_23d/";
+    std::vector<string> filenames;
+    read_files_from_dir(dir_name, "msh", filenames);
+
+    for(string search : {"BIHsearch", "BIHonly"})
+        for(unsigned int s=0; s< filenames.size(); s++)
+    {
+        // pairs of elements and coordinates of IPs computed with 1 and 3 threads
+        std::vector<std::pair<unsigned int, unsigned int>> ele_pairs[2];
+        std::vector<std::vector<arma::vec3>> ips[2];
+        unsigned int n_threads[2] = {1, 3};
+        for(unsigned int k=0; k<2; k++) {
+            string in_mesh_string = "{ mesh_file=\"" + dir_name + filenames[s] + "\", optimize_mesh=false, "
+                    + "intersection_search=\"" + search + "\", intersection_n_threads=" + std::to_string(n_threads[k]) + " }";
+            Mesh *mesh = mesh_constructor(in_mesh_string);
+            auto reader = reader_constructor(in_mesh_string);
+            reader->read_raw_mesh(mesh);
+            mesh->setup_topology();
+
+            MixedMeshIntersections ie(mesh);
+            ie.compute_intersections(IntersectionType::d23);
+            for(IntersectionLocal<2,3> &il : ie.intersection_storage23_) {
+                ele_pairs[k].push_back( std::make_pair(il.component_ele_idx(), il.bulk_ele_idx()) );
+                ips[k].push_back(std::vector<arma::vec3>());
+                for(unsigned int j=0; j < il.size(); j++)
+                    ips[k].back().push_back( il[j].coords(mesh->element_accessor(il.component_ele_idx())) );
+            }
+        }
+
+        // storage is ordered by component elements in both cases
+        ASSERT_EQ(ele_pairs[0], ele_pairs[1]);
+        for(unsigned int i=0; i < ips[0].size(); i++) {
+            ASSERT_EQ(ips[0][i].size(), ips[1][i].size());
+            for(unsigned int j=0; j < ips[0][i].size(); j++)
+                EXPECT_ARMA_EQ(ips[0][i][j], ips[1][i][j]);
+        }
+    }
+    Profiler::uninitialize();
+}
+
+
+TEST(intersection_prolongation_23d, cache) {
+    Profiler::instance();
+    FilePath::set_dirs(UNIT_TESTS_SRC_DIR,"",".");
+    string dir_name = string(UNIT_TESTS_SRC_DIR) + "/intersection/prolong_meshes_23d/";
+    std::vector<string> filenames;
+    read_files_from_dir(dir_name, "msh", filenames);
+    string cache_file = "intersection_cache_23.bin";
+
+    for(unsigned int s=0; s< filenames.size(); s++)
+    {
+        string in_mesh_string = "{ mesh_file=\"" + dir_name + filenames[s] + "\", optimize_mesh=false }";
+        Mesh *mesh = mesh_constructor(in_mesh_string);
+        auto reader = reader_constructor(in_mesh_string);
+        reader->read_raw_mesh(mesh);
+        mesh->setup_topology();
+
+        MixedMeshIntersections ie(mesh);
+        ie.compute_intersections(IntersectionType::all);
+        ie.write_cache(cache_file, IntersectionType::all);
+
+        // cache of different intersection type is not accepted
+        MixedMeshIntersections ie_other(mesh);
+        EXPECT_FALSE(ie_other.read_cache(cache_file, IntersectionType::d23));
+
+        MixedMeshIntersections ie_cached(mesh);
+        ASSERT_TRUE(ie_cached.read_cache(cache_file, IntersectionType::all));
+        ASSERT_EQ(ie.intersection_storage23_.size(), ie_cached.intersection_storage23_.size());
+        for(unsigned int i=0; i < ie.intersection_storage23_.size(); i++) {
+            const IntersectionLocal<2,3> &il = ie.intersection_storage23_[i], &il_cached = ie_cached.intersection_storage23_[i];
+            EXPECT_EQ(il.component_ele_idx(), il_cached.component_ele_idx());
+            EXPECT_EQ(il.bulk_ele_idx(), il_cached.bulk_ele_idx());
+            ASSERT_EQ(il.size(), il_cached.size());
+            for(unsigned int j=0; j < il.size(); j++) {
+                EXPECT_ARMA_EQ(il[j].comp_coords(), il_cached[j].comp_coords());
+                EXPECT_ARMA_EQ(il[j].bulk_coords(), il_cached[j].bulk_coords());
+            }
+        }
+        EXPECT_EQ(ie.intersection_storage22_.size(), ie_cached.intersection_storage22_.size());
+
+        ASSERT_EQ(ie.element_intersections_.size(), ie_cached.element_intersections_.size());
+        for(unsigned int i=0; i < ie.element_intersections_.size(); i++) {
+            ASSERT_EQ(ie.element_intersections_[i].size(), ie_cached.element_intersections_[i].size());
+            for(unsigned int j=0; j < ie.element_intersections_[i].size(); j++) {
+                EXPECT_EQ(ie.element_intersections_[i][j].first, ie_cached.element_intersections_[i][j].first);
+                EXPECT_EQ(ie.element_intersections_[i][j].second->component_ele_idx(),
+                          ie_cached.element_intersections_[i][j].second->component_ele_idx());
+                EXPECT_EQ(ie.element_intersections_[i][j].second->bulk_ele_idx(),
+                          ie_cached.element_intersections_[i][j].second->bulk_ele_idx());
+            }
+        }
+    }
+    std::remove(cache_file.c_str());
+    Profiler::uninitialize();
+}
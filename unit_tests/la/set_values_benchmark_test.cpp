@@ -181,6 +181,151 @@ TEST_F(LinSys_PETSC_Test, set_local_system_mm) {
 
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Assemble chain of 2x2 'element' matrices (negative index on the first element), scaled by @p scale.
+void assemble_chain(LinSys *ls, double scale, bool extra_element = false) {
+    int rows[2], cols[2];
+    double vals[4];
+    for(int e = -1; e < ls_size-1; e++) {
+        rows[0] = cols[0] = e;
+        rows[1] = cols[1] = e+1;
+        for(int i = 0; i<4; i++) vals[i] = scale * (e + i + 2);
+        ls->mat_set_values(2, rows, 2, cols, vals);
+        if (extra_element && e == ls_size/2) ls->mat_set_values(2, rows, 2, cols, vals);
+    }
+}
+
+// Test AIJ matrix assembly directly into CSR arrays, compared to assembly by MatSetValues.
+TEST_F(LinSys_PETSC_Test, csr_assembly) {
+    LinSys_PETSC *ls_ref = new LinSys_PETSC(new Distribution(ls_size, MPI_COMM_WORLD));
+    LinSys_PETSC *ls_csr = new LinSys_PETSC(new Distribution(ls_size, MPI_COMM_WORLD));
+    ls_csr->set_csr_assembly(true);
+    for(LinSys *ls : {(LinSys *)ls_ref, (LinSys *)ls_csr}) {
+        ls->start_allocation();
+        assemble_chain(ls, 1.0);
+    }
+
+    // first assembly records positions, second one reuses them, third one differs from the recorded sequence
+    for(unsigned int i_assembly = 0; i_assembly < 3; i_assembly++) {
+        for(LinSys *ls : {(LinSys *)ls_ref, (LinSys *)ls_csr}) {
+            ls->start_add_assembly();
+            ls->mat_zero_entries();
+            START_TIMER("LinSys_PETSC_csr_assembly");
+            assemble_chain(ls, 1.0 + i_assembly, (i_assembly == 2));
+            END_TIMER("LinSys_PETSC_csr_assembly");
+            ls->finish_assembly();
+        }
+
+        Mat diff;
+        PetscReal norm;
+        MatDuplicate(*ls_ref->get_matrix(), MAT_COPY_VALUES, &diff);
+        MatAXPY(diff, -1.0, *ls_csr->get_matrix(), DIFFERENT_NONZERO_PATTERN);
+        MatNorm(diff, NORM_FROBENIUS, &norm);
+        EXPECT_NEAR(0.0, norm, 1e-12);
+        MatNorm(*ls_csr->get_matrix(), NORM_FROBENIUS, &norm);
+        EXPECT_GT(norm, 1.0);
+        MatDestroy(&diff);
+    }
+
+    delete ls_ref;
+    delete ls_csr;
+}
+
+
+// Assemble local rows of tridiagonal s.p.d. matrix, right hand side is scaled by @p rhs_scale.
+void assemble_tridiag(LinSys *ls, const Distribution *ds, double rhs_scale) {
+    for(int i = ds->begin(); i < (int)ds->end(); i++) {
+        int cols[3] = {i-1, i, i+1};
+        double vals[3] = {-1.0, 4.0, -1.0};
+        int row = i;
+        if (i == 0) ls->mat_set_values(1, &row, 2, cols+1, vals+1);
+        else if (i == ls_size-1) ls->mat_set_values(1, &row, 2, cols, vals);
+        else ls->mat_set_values(1, &row, 3, cols, vals);
+        ls->rhs_set_value(i, rhs_scale * (1.0 + i % 7));
+    }
+}
+
+// Gives access to the KSP of the solver.
+class TestLinSysPETSC : public LinSys_PETSC {
+public:
+    TestLinSysPETSC(const Distribution *ds, const std::string &params)
+    : LinSys_PETSC(ds, params) {}
+
+    KSP ksp() const
+    { return system; }
+};
+
+// Options of the Krylov method with recycling must not change the other solvers.
+TEST_F(LinSys_PETSC_Test, krylov_recycling) {
+    Distribution *ds = new Distribution(ls_size, MPI_COMM_WORLD);
+    TestLinSysPETSC *ls_rec = new TestLinSysPETSC(ds, "-pc_type jacobi");
+    TestLinSysPETSC *ls_plain = new TestLinSysPETSC(ds, "-pc_type jacobi");
+    ls_rec->set_krylov_acceleration(5, 1);
+    std::vector<double> norms;
+    for(TestLinSysPETSC *ls : {ls_rec, ls_plain}) {
+        ls->set_solution();
+        ls->set_tolerances(1e-10, 1e-12, 1e5, 1000);
+        ls->start_allocation();
+        assemble_tridiag(ls, ds, 1.0);
+        ls->start_add_assembly();
+        ls->mat_zero_entries();
+        ls->rhs_zero_entries();
+        assemble_tridiag(ls, ds, 1.0);
+        ls->finish_assembly();
+        LinSys::SolveInfo si = ls->solve();
+        EXPECT_GT(si.converged_reason, 0);
+        EXPECT_LT(ls->compute_residual(), 1e-8);
+    }
+
+    KSPType type;
+    KSPGetType(ls_rec->ksp(), &type);
+#ifdef PETSC_HAVE_HPDDM
+    EXPECT_STREQ(KSPHPDDM, type);
+#else
+    EXPECT_STREQ(KSPDGMRES, type);
+#endif
+    KSPGetType(ls_plain->ksp(), &type);
+    EXPECT_STRNE(KSPHPDDM, type);
+    EXPECT_STRNE(KSPDGMRES, type);
+
+    delete ls_rec;
+    delete ls_plain;
+}
+
+// Extrapolation of the initial guess, solution is linear in time, so quadratic extrapolation is exact
+// if it uses solutions of time steps and not of the nonlinear iterations.
+TEST_F(LinSys_PETSC_Test, initial_guess_history) {
+    for(bool by_steps : {false, true}) {
+        Distribution *ds = new Distribution(ls_size, MPI_COMM_WORLD);
+        LinSys_PETSC *ls = new LinSys_PETSC(ds, "-ksp_type gmres -pc_type jacobi");
+        ls->set_solution();
+        ls->set_tolerances(1e-10, 1e-12, 1e5, 1000);
+        ls->set_krylov_acceleration(0, 2);
+        ls->start_allocation();
+        assemble_tridiag(ls, ds, 1.0);
+
+        for(unsigned int step = 1; step <= 3; step++) {
+            if (by_steps) ls->start_time_step();
+            // two nonlinear iterations
+            for(unsigned int it = 0; it < 2; it++) {
+                ls->start_add_assembly();
+                ls->mat_zero_entries();
+                ls->rhs_zero_entries();
+                assemble_tridiag(ls, ds, step);
+                ls->finish_assembly();
+                LinSys::SolveInfo si = ls->solve();
+                EXPECT_GT(si.converged_reason, 0);
+                if (step == 3 && it == 0) {
+                    if (by_steps) EXPECT_EQ(0, si.n_iterations);
+                    else EXPECT_GT(si.n_iterations, 0);
+                }
+            }
+        }
+        delete ls;
+    }
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Test AIJ matrix direct PETSC assembly of an m x m continuous matrix, whole block at once.
 TEST_F(LinSys_PETSC_Test, PETSC_mat_set_values_mm) {
@@ -0,0 +1,98 @@
+/*
+ * assembly_elasticity_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#define TEST_USE_PETSC
+#define FEAL_OVERRIDE_ASSERTS
+#include <flow_gtest_mpi.hh>
+
+#include <vector>
+#include "armadillo"
+#include "system/sys_profiler.hh"
+#include "quadrature/quadrature_lib.hh"
+#include "fem/fe_p.hh"
+#include "fem/fe_system.hh"
+#include "fem/fe_values.hh"
+#include "mesh/mesh.h"
+#include "mesh/accessors.hh"
+#include "mechanics/assembly_elasticity.hh"
+
+
+typedef StiffnessAssemblyElasticity<3> StiffnessAsm;
+
+
+/**
+ * Compare local stiffness matrices of the batched kernel of StiffnessAssemblyElasticity with the direct
+ * formulation by symmetric gradients and divergences of shape functions.
+ *
+ * Batch contains two different tetrahedra, Lame parameters and cross section differ between quadrature
+ * points and cells.
+ */
+TEST(StiffnessAssemblyElasticity, batch_local_matrix) {
+    Profiler::instance();
+
+    Mesh mesh;
+    mesh.init_node_vector(5);
+    mesh.add_node(0, arma::vec3("0.1 0.0 0.2"));
+    mesh.add_node(1, arma::vec3("2.0 0.3 0.0"));
+    mesh.add_node(2, arma::vec3("0.4 1.5 0.1"));
+    mesh.add_node(3, arma::vec3("0.3 0.2 0.7"));
+    mesh.add_node(4, arma::vec3("1.2 1.1 -2.5"));
+    mesh.init_element_vector(2);
+    mesh.add_element(0, 3, 1, 0, {0, 1, 2, 3});
+    mesh.add_element(1, 3, 1, 0, {0, 1, 2, 4});
+
+    FESystem<3> fe(std::make_shared< FE_P<3> >(1), FEVector, 3);
+    QGauss quad(3, 2);
+    FEValues<3> fe_values;
+    fe_values.initialize(quad, fe, update_values | update_gradients | update_JxW_values | update_quadrature_points);
+    const FEValuesViews::Vector<3> &vec_view = fe_values.vector_view(0);
+
+    const unsigned int n_cells = 2;
+    const unsigned int batch_size = StiffnessAsm::batch_size;
+    const unsigned int n_strain_rows = StiffnessAsm::n_strain_rows;
+    const unsigned int n_dofs = fe.n_dofs();
+    const unsigned int n_points = quad.size();
+    std::vector<double> strain_ops(n_points * n_strain_rows * n_dofs * batch_size);
+    std::vector<double> strain_weights(n_points * 2 * batch_size);
+    std::vector<double> batch_matrices(n_dofs * n_dofs * batch_size);
+    std::vector<arma::mat> ref_matrices(n_cells, arma::mat(n_dofs, n_dofs, arma::fill::zeros));
+
+    for (unsigned int c=0; c<n_cells; c++) {
+        fe_values.reinit(mesh.element_accessor(c));
+        for (unsigned int k=0; k<n_points; k++) {
+            double mu = 1.5 + 0.3*k + c;
+            double lambda = 40.0 - 2.0*k + 5.0*c;
+            double cs = 0.7 + 0.1*c;
+            strain_weights[(k*2)*batch_size + c] = 2*mu * cs * fe_values.JxW(k);
+            strain_weights[(k*2+1)*batch_size + c] = lambda * cs * fe_values.JxW(k);
+
+            double *op = &strain_ops[k*n_strain_rows*n_dofs*batch_size + c];
+            for (unsigned int i=0; i<n_dofs; i++)
+                StiffnessAsm::set_strain_operator(vec_view.grad(i,k), op + i*batch_size, n_dofs*batch_size);
+
+            // formulation of the cell integral before batching
+            for (unsigned int i=0; i<n_dofs; i++)
+                for (unsigned int j=0; j<n_dofs; j++)
+                    ref_matrices[c](i,j) += cs*(
+                                2*mu*arma::dot(vec_view.sym_grad(j,k), vec_view.sym_grad(i,k))
+                                + lambda*vec_view.divergence(j,k)*vec_view.divergence(i,k)
+                               )*fe_values.JxW(k);
+        }
+    }
+
+    StiffnessAsm::batch_local_matrices(n_points, n_dofs, n_cells, strain_ops.data(), strain_weights.data(), batch_matrices.data());
+
+    for (unsigned int c=0; c<n_cells; c++) {
+        double tol = 1e-12 * arma::abs(ref_matrices[c]).max();
+        for (unsigned int i=0; i<n_dofs; i++)
+            for (unsigned int j=i; j<n_dofs; j++) {
+                EXPECT_NEAR( ref_matrices[c](i,j), batch_matrices[(i*n_dofs+j)*batch_size + c], tol );
+                EXPECT_NEAR( ref_matrices[c](j,i), batch_matrices[(i*n_dofs+j)*batch_size + c], tol );
+            }
+    }
+
+    Profiler::uninitialize();
+}
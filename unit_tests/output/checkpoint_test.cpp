@@ -0,0 +1,187 @@
+/*
+ * checkpoint_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#define TEST_USE_PETSC
+#define FEAL_OVERRIDE_ASSERTS
+#include <flow_gtest_mpi.hh>
+
+#include <cmath>
+#include "io/checkpoint.hh"
+#include "la/vector_mpi.hh"
+#include "tools/time_governor.hh"
+#include "system/file_path.hh"
+
+
+TEST(CheckpointData, save_load) {
+    CheckpointData data;
+    std::vector<double> vec = {1.0, 2.5, -3.0};
+    data.save("eq/int", 42);
+    data.save("eq/vec", vec);
+    EXPECT_EQ(2, data.size());
+    EXPECT_TRUE(data.contains("eq/vec"));
+    EXPECT_FALSE(data.contains("eq/other"));
+
+    int int_val;
+    std::vector<double> vec_val;
+    data.load("eq/int", int_val);
+    data.load("eq/vec", vec_val);
+    EXPECT_EQ(42, int_val);
+    EXPECT_EQ(vec, vec_val);
+
+    double double_val;
+    EXPECT_THROW( data.load("eq/int", double_val), CheckpointData::ExcBlockSize);
+    EXPECT_THROW( data.load("eq/other", int_val), CheckpointData::ExcMissingBlock);
+}
+
+
+TEST(CheckpointData, write_read_file) {
+    FilePath::set_io_dirs(".", UNIT_TESTS_SRC_DIR, "", ".");
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    FilePath file_path("test_checkpoint." + std::to_string(rank) + ".chkp", FilePath::output_file);
+
+    VectorMPI vec(4);
+    for (unsigned int i=0; i<vec.size(); ++i) vec.set(i, 0.5*i + rank);
+    {
+        CheckpointData data;
+        data.save("flow/solution", vec);
+        data.save("flow/time", 1.5);
+        data.write_file(file_path);
+    }
+
+    CheckpointData data;
+    data.read_file(file_path);
+    VectorMPI vec_read(4);
+    double time;
+    data.load("flow/solution", vec_read);
+    data.load("flow/time", time);
+    EXPECT_DOUBLE_EQ(1.5, time);
+    for (unsigned int i=0; i<vec.size(); ++i) EXPECT_DOUBLE_EQ(vec.get(i), vec_read.get(i));
+
+    VectorMPI vec_wrong(3);
+    EXPECT_THROW( data.load("flow/solution", vec_wrong), CheckpointData::ExcBlockSize);
+}
+
+
+TEST(CheckpointData, time_governor) {
+    TimeGovernor tg(0.0, 0.5);
+    for (unsigned int i=0; i<3; ++i) tg.next_time();
+
+    CheckpointData data;
+    tg.save_state(data, "tg");
+
+    TimeGovernor restored(0.0, 0.5);
+    restored.load_state(data, "tg");
+    EXPECT_EQ(tg.tlevel(), restored.tlevel());
+    EXPECT_DOUBLE_EQ(tg.t(), restored.t());
+    EXPECT_DOUBLE_EQ(tg.last_t(), restored.last_t());
+    EXPECT_DOUBLE_EQ(tg.dt(), restored.dt());
+
+    tg.next_time();
+    restored.next_time();
+    EXPECT_DOUBLE_EQ(tg.t(), restored.t());
+}
+
+
+TEST(CheckpointData, wrong_rank) {
+    FilePath::set_io_dirs(".", UNIT_TESTS_SRC_DIR, "", ".");
+    int rank, n_proc;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &n_proc);
+    if (n_proc < 2) return;
+
+    {
+        CheckpointData data;
+        data.save("flow/time", 1.5);
+        data.write_file( FilePath("test_rank." + std::to_string(rank) + ".chkp", FilePath::output_file) );
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    // file of the other process
+    CheckpointData data;
+    FilePath other_path("test_rank." + std::to_string((rank+1) % n_proc) + ".chkp", FilePath::output_file);
+    EXPECT_THROW( data.read_file(other_path), CheckpointData::ExcWrongRank);
+}
+
+
+/// Explicit steps of nonlinear ODEs, the result depends on the time governor and both vectors.
+void ode_steps(TimeGovernor &tg, VectorMPI &x, Vec y, unsigned int n_steps) {
+    for (unsigned int step=0; step<n_steps; ++step) {
+        tg.next_time();
+        PetscScalar *y_array;
+        VecGetArray(y, &y_array);
+        for (unsigned int i=0; i<x.size(); ++i) {
+            x.set(i, x.get(i) + tg.dt() * (std::sin(x.get(i)) + tg.t()));
+            y_array[i] += tg.dt() * std::exp(-x.get(i)) * y_array[i];
+        }
+        VecRestoreArray(y, &y_array);
+    }
+}
+
+
+// State of the simulation restarted from the checkpoint file is bit-for-bit equal to the state of the continuous run.
+TEST(CheckpointData, restart_bit_for_bit) {
+    FilePath::set_io_dirs(".", UNIT_TESTS_SRC_DIR, "", ".");
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    FilePath file_path("test_restart." + std::to_string(rank) + ".chkp", FilePath::output_file);
+    const unsigned int local_size = 5, n_steps = 10, n_restart_steps = 4;
+
+    auto initialize = [rank](VectorMPI &x, Vec &y) {
+        for (unsigned int i=0; i<x.size(); ++i) x.set(i, 0.1*i + rank);
+        VecCreateMPI(PETSC_COMM_WORLD, local_size, PETSC_DETERMINE, &y);
+        VecSet(y, 1.0);
+    };
+
+    // continuous run
+    TimeGovernor tg(0.0, 0.1);
+    VectorMPI x(local_size);
+    Vec y;
+    initialize(x, y);
+    ode_steps(tg, x, y, n_steps);
+
+    // run interrupted by the checkpoint
+    {
+        TimeGovernor tg_first(0.0, 0.1);
+        VectorMPI x_first(local_size);
+        Vec y_first;
+        initialize(x_first, y_first);
+        ode_steps(tg_first, x_first, y_first, n_restart_steps);
+
+        CheckpointData data;
+        tg_first.save_state(data, "eq/time");
+        data.save("eq/x", x_first);
+        data.save("eq/y", y_first);
+        data.write_file(file_path);
+        VecDestroy(&y_first);
+    }
+
+    // restarted run
+    TimeGovernor tg_restart(0.0, 0.1);
+    VectorMPI x_restart(local_size);
+    Vec y_restart;
+    initialize(x_restart, y_restart);
+    VecSet(y_restart, 0.0);
+    CheckpointData data;
+    data.read_file(file_path);
+    tg_restart.load_state(data, "eq/time");
+    data.load("eq/x", x_restart);
+    data.load("eq/y", y_restart);
+    ode_steps(tg_restart, x_restart, y_restart, n_steps - n_restart_steps);
+
+    // exact comparison
+    EXPECT_EQ(tg.tlevel(), tg_restart.tlevel());
+    EXPECT_EQ(tg.t(), tg_restart.t());
+    for (unsigned int i=0; i<local_size; ++i) EXPECT_EQ(x.get(i), x_restart.get(i));
+    const PetscScalar *y_array, *y_restart_array;
+    VecGetArrayRead(y, &y_array);
+    VecGetArrayRead(y_restart, &y_restart_array);
+    EXPECT_EQ(0, std::memcmp(y_array, y_restart_array, local_size*sizeof(PetscScalar)));
+    VecRestoreArrayRead(y, &y_array);
+    VecRestoreArrayRead(y_restart, &y_restart_array);
+    VecDestroy(&y);
+    VecDestroy(&y_restart);
+}
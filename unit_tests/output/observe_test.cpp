@@ -15,6 +15,7 @@
 #include "flow_gtest_mpi.hh"
 #include <mesh_constructor.hh>
 #include "io/observe.hh"
+#include "io/element_data_cache.hh"
 #include "mesh/mesh.h"
 #include "io/msh_gmshreader.h"
 #include "input/reader_to_storage.hh"
@@ -32,6 +33,7 @@
 #include "fem/fe_p.hh"
 #include "../arma_expect.hh"
 #include <fstream>
+#include <cmath>
 
 
 
@@ -311,3 +313,152 @@ TEST(Observe, all) {
     Profiler::uninitialize();
 }
 
+
+
+TEST(Observe, binary_format) {
+    Profiler::instance();
+    armadillo_setup();
+
+    auto output_type = Input::Type::Record("Output", "")
+        .declare_key("observe_points", Input::Type::Array(ObservePoint::get_input_type()), Input::Type::Default::obligatory(), "")
+        .declare_key("input_fields", Input::Type::Array(
+                EqData()
+                .make_field_descriptor_type("SomeEquation")
+                .close() ), Input::Type::Default::obligatory(), "")
+        .close();
+    auto in_rec = Input::ReaderToStorage(test_input, output_type, Input::FileFormat::format_JSON)
+        .get_root_interface<Input::Record>();
+
+    FilePath mesh_file( string(UNIT_TESTS_SRC_DIR) + "/mesh/simplest_cube.msh", FilePath::input_file);
+    Mesh *mesh = mesh_full_constructor("{ mesh_file=\"" + (string)mesh_file + "\", optimize_mesh=false, global_snap_radius=1.0 }");
+
+    unsigned int n_points;
+    {
+        Observe obs("test_eq_bin", *mesh, in_rec.val<Input::Array>("observe_points"), 6,
+                std::make_shared<TimeUnitConversion>(), Observe::FORMAT_BINARY);
+        n_points = obs.points().size();
+        // two frames, value of point is its global index plus time
+        for (unsigned int i_time=0; i_time<2; ++i_time) {
+            auto cache = std::dynamic_pointer_cast< ElementDataCache<double> >(
+                    obs.prepare_compute_data("scalar_field", i_time, 1) );
+            for (ObservePointAccessor op_acc : obs.local_range()) {
+                double val = op_acc.global_idx() + i_time;
+                cache->store_value(op_acc.loc_point_time_index(), &val);
+            }
+            obs.output_time_frame( i_time==1 );
+        }
+    }
+
+    if (mesh->get_el_ds()->myp()==0) {
+        std::ifstream obs_file("test_eq_bin_observe.bin", std::ios_base::binary);
+        std::string magic(16, ' ');
+        obs_file.read(&magic[0], 16);
+        EXPECT_EQ("FLOW123D_OBSERVE", magic);
+        uint64_t header_size;
+        obs_file.read(reinterpret_cast<char *>(&header_size), sizeof(uint64_t));
+        EXPECT_EQ(0u, (16 + 8 + header_size) % 8);
+        std::string header(header_size, ' ');
+        obs_file.read(&header[0], header_size);
+        EXPECT_NE(std::string::npos, header.find("{\"name\": \"scalar_field\", \"n_comp\": 1}"));
+        EXPECT_NE(std::string::npos, header.find("\"name\": \"obs_0\""));
+
+        std::vector<double> frame(1 + n_points);
+        for (unsigned int i_time=0; i_time<2; ++i_time) {
+            obs_file.read(reinterpret_cast<char *>(frame.data()), frame.size()*sizeof(double));
+            EXPECT_TRUE(obs_file.good());
+            EXPECT_DOUBLE_EQ(i_time, frame[0]);
+            for (unsigned int i=0; i<n_points; ++i) EXPECT_DOUBLE_EQ(i + i_time, frame[1+i]);
+        }
+        obs_file.peek();
+        EXPECT_TRUE(obs_file.eof());
+    }
+    Profiler::uninitialize();
+}
+
+
+TEST(Observe, binary_format_late_field) {
+    Profiler::instance();
+    armadillo_setup();
+
+    auto output_type = Input::Type::Record("Output", "")
+        .declare_key("observe_points", Input::Type::Array(ObservePoint::get_input_type()), Input::Type::Default::obligatory(), "")
+        .declare_key("input_fields", Input::Type::Array(
+                EqData()
+                .make_field_descriptor_type("SomeEquation")
+                .close() ), Input::Type::Default::obligatory(), "")
+        .close();
+    auto in_rec = Input::ReaderToStorage(test_input, output_type, Input::FileFormat::format_JSON)
+        .get_root_interface<Input::Record>();
+
+    FilePath mesh_file( string(UNIT_TESTS_SRC_DIR) + "/mesh/simplest_cube.msh", FilePath::input_file);
+    Mesh *mesh = mesh_full_constructor("{ mesh_file=\"" + (string)mesh_file + "\", optimize_mesh=false, global_snap_radius=1.0 }");
+
+    unsigned int n_points;
+    {
+        Observe obs("test_eq_late", *mesh, in_rec.val<Input::Array>("observe_points"), 6,
+                std::make_shared<TimeUnitConversion>(), Observe::FORMAT_BINARY);
+        n_points = obs.points().size();
+        // registered field without values, field evaluated in both frames, field evaluated only in the second frame
+        obs.register_field("a_registered", 1);
+        std::vector<std::string> frame_fields[2] = { {"b_field"}, {"b_field", "c_late"} };
+        for (unsigned int i_time=0; i_time<2; ++i_time) {
+            for (auto &name : frame_fields[i_time]) {
+                auto cache = std::dynamic_pointer_cast< ElementDataCache<double> >(
+                        obs.prepare_compute_data(name, i_time, 1) );
+                for (ObservePointAccessor op_acc : obs.local_range()) {
+                    double val = op_acc.global_idx() + i_time;
+                    cache->store_value(op_acc.loc_point_time_index(), &val);
+                }
+            }
+            // flush every frame, c_late is written by header extension
+            obs.output_time_frame(true);
+        }
+    }
+
+    if (mesh->get_el_ds()->myp()==0) {
+        std::ifstream obs_file("test_eq_late_observe.bin", std::ios_base::binary);
+        std::string magic(16, ' ');
+        obs_file.read(&magic[0], 16);
+        EXPECT_EQ("FLOW123D_OBSERVE", magic);
+        uint64_t header_size;
+        obs_file.read(reinterpret_cast<char *>(&header_size), sizeof(uint64_t));
+        std::string header(header_size, ' ');
+        obs_file.read(&header[0], header_size);
+        EXPECT_NE(std::string::npos, header.find("{\"name\": \"a_registered\", \"n_comp\": 1}, {\"name\": \"b_field\", \"n_comp\": 1}"));
+        EXPECT_EQ(std::string::npos, header.find("c_late"));
+
+        // first frame: time, NaN values of a_registered, values of b_field
+        std::vector<double> frame(1 + 2*n_points);
+        obs_file.read(reinterpret_cast<char *>(frame.data()), frame.size()*sizeof(double));
+        EXPECT_DOUBLE_EQ(0.0, frame[0]);
+        for (unsigned int i=0; i<n_points; ++i) {
+            EXPECT_TRUE(std::isnan(frame[1+i]));
+            EXPECT_DOUBLE_EQ(i, frame[1+n_points+i]);
+        }
+
+        // header extension
+        double mark;
+        obs_file.read(reinterpret_cast<char *>(&mark), sizeof(double));
+        EXPECT_TRUE(std::isnan(mark));
+        uint64_t extension_size;
+        obs_file.read(reinterpret_cast<char *>(&extension_size), sizeof(uint64_t));
+        EXPECT_EQ(0u, extension_size % 8);
+        std::string extension(extension_size, ' ');
+        obs_file.read(&extension[0], extension_size);
+        EXPECT_NE(std::string::npos, extension.find("{\"fields\": [{\"name\": \"c_late\", \"n_comp\": 1}]}"));
+
+        // second frame contains also c_late
+        frame.resize(1 + 3*n_points);
+        obs_file.read(reinterpret_cast<char *>(frame.data()), frame.size()*sizeof(double));
+        EXPECT_TRUE(obs_file.good());
+        EXPECT_DOUBLE_EQ(1.0, frame[0]);
+        for (unsigned int i=0; i<n_points; ++i) {
+            EXPECT_TRUE(std::isnan(frame[1+i]));
+            EXPECT_DOUBLE_EQ(i + 1, frame[1+n_points+i]);
+            EXPECT_DOUBLE_EQ(i + 1, frame[1+2*n_points+i]);
+        }
+        obs_file.peek();
+        EXPECT_TRUE(obs_file.eof());
+    }
+    Profiler::uninitialize();
+}
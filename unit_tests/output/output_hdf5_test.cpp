@@ -0,0 +1,220 @@
+/*
+ * output_hdf5_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#define TEST_USE_PETSC
+#define FEAL_OVERRIDE_ASSERTS
+#include <flow_gtest_mpi.hh>
+#include <mesh_constructor.hh>
+
+#include "config.h"
+
+#ifdef FLOW123D_HAVE_HDF5
+
+#include "io/output_time.hh"
+#include "io/output_hdf5.hh"
+#include "io/output_mesh.hh"
+#include "mesh/mesh.h"
+#include "input/reader_to_storage.hh"
+#include "system/logger_options.hh"
+#include "system/sys_profiler.hh"
+#include "fields/field.hh"
+
+FLOW123D_FORCE_LINK_IN_PARENT(field_constant)
+
+const string test_output_time_hdf5 = R"YAML(
+file: ./test_hdf5.xdmf
+format: !hdf5
+  parallel: false
+)YAML";
+
+const string test_output_time_hdf5_parallel = R"YAML(
+file: ./test_hdf5_parallel.xdmf
+format: !hdf5
+  parallel: true
+)YAML";
+
+
+class TestHDF5 : public testing::Test {
+protected:
+	TestHDF5()
+    {
+        Profiler::instance();
+    }
+
+    ~TestHDF5()
+    {
+        Profiler::uninitialize();
+    }
+};
+
+class TestOutputHDF5 : public OutputHDF5, public std::enable_shared_from_this<OutputHDF5> {
+public:
+    TestOutputHDF5()
+    : OutputHDF5()
+    {
+        LoggerOptions::get_instance().set_log_file("");
+
+        FilePath mesh_file( string(UNIT_TESTS_SRC_DIR) + "/fields/simplest_cube_3d.msh", FilePath::input_file);
+        this->_mesh = mesh_full_constructor("{ mesh_file=\"" + (string)mesh_file + "\", optimize_mesh=false }");
+
+        this->write_time = 0.0; // hack: unset condition in OutputTime::write_time_frame and output is not performed
+    }
+
+    ~TestOutputHDF5()
+    {
+        delete this->_mesh;
+        LoggerOptions::get_instance().reset();
+    }
+
+    // initialize mesh with given yaml input
+    void init_mesh(string input_yaml)
+    {
+    	auto in_rec = Input::ReaderToStorage(input_yaml, const_cast<Input::Type::Record &>(OutputTime::get_input_type()), Input::FileFormat::format_YAML)
+        				.get_root_interface<Input::Record>();
+        this->init_from_input("dummy_equation", in_rec, std::make_shared<TimeUnitConversion>());
+
+        // create output mesh identical to computational mesh
+        output_mesh_ = std::make_shared<OutputMesh>(*(this->_mesh));
+        output_mesh_->create_sub_mesh();
+        if (this->is_parallel()) output_mesh_->make_parallel_master_mesh();
+        else output_mesh_->make_serial_master_mesh();
+        this->set_output_data_caches(output_mesh_);
+    }
+
+    void set_scalar_data(string field_name, double value)
+    {
+        auto output_cache_base = this->prepare_compute_data<double>(field_name, OutputTime::ELEM_DATA, 1, 1);
+        auto output_data_cache = std::dynamic_pointer_cast<ElementDataCache<double>>(output_cache_base);
+        for (uint i=0; i<output_data_cache->n_values(); ++i)
+            output_data_cache->store_value(i, &value);
+        this->update_time(0.0);
+    }
+
+    /// Read dataset of doubles from HDF5 file, return its dimensions and data.
+    std::vector<double> read_dataset(std::string dataset_path, hsize_t dims[2])
+    {
+        H5Fflush(this->file_id_, H5F_SCOPE_GLOBAL);
+        hid_t dataset = H5Dopen2(this->file_id_, dataset_path.c_str(), H5P_DEFAULT);
+        EXPECT_GE(dataset, 0);
+        hid_t space = H5Dget_space(dataset);
+        H5Sget_simple_extent_dims(space, dims, NULL);
+        std::vector<double> data(dims[0]*dims[1]);
+        H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
+        H5Sclose(space);
+        H5Dclose(dataset);
+        return data;
+    }
+
+    /// Write current frame, in serial output the data are gathered to the first process.
+    void write_frame()
+    {
+        this->gather_output_data();
+        this->write_data();
+    }
+
+    /// Local sizes of nodes, connectivity and elements of the output mesh.
+    std::vector<unsigned int> local_mesh_sizes()
+    {
+        return { this->nodes_->n_values(), this->connectivity_->n_values(), this->offsets_->n_values()-1 };
+    }
+
+	void set_current_step(int step) {
+		this->current_step = step;
+	}
+
+	std::string base_filename() {
+		return string(this->_base_filename);
+	}
+
+	Mesh *_mesh;
+	std::shared_ptr<OutputMeshBase> output_mesh_;
+};
+
+
+TEST_F(TestHDF5, write_data) {
+	std::shared_ptr<TestOutputHDF5> output_hdf5 = std::make_shared<TestOutputHDF5>();
+
+	output_hdf5->init_mesh(test_output_time_hdf5);
+	output_hdf5->set_current_step(0);
+	output_hdf5->set_scalar_data("scalar_field", 0.5);
+	output_hdf5->write_frame();
+
+	EXPECT_EQ("./test_hdf5.xdmf", output_hdf5->base_filename());
+
+	// serial output is written only by the first process
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	if (rank != 0) return;
+
+	hsize_t dims[2];
+	std::vector<double> nodes = output_hdf5->read_dataset("/Mesh/nodes", dims);
+	EXPECT_EQ(output_hdf5->_mesh->n_nodes(), dims[0]);
+	EXPECT_EQ(3, dims[1]);
+
+	std::vector<double> values = output_hdf5->read_dataset("/Steps/000000/element_data/scalar_field", dims);
+	EXPECT_EQ(output_hdf5->_mesh->n_elements(), dims[0]);
+	EXPECT_EQ(1, dims[1]);
+	for (double val : values) EXPECT_DOUBLE_EQ(0.5, val);
+}
+
+
+#ifdef H5_HAVE_PARALLEL
+
+// every process writes its local part of mesh and data, parts are placed in the datasets in the order of ranks
+TEST_F(TestHDF5, write_parallel_data) {
+	int rank, n_proc;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &n_proc);
+	std::shared_ptr<TestOutputHDF5> output_hdf5 = std::make_shared<TestOutputHDF5>();
+
+	output_hdf5->init_mesh(test_output_time_hdf5_parallel);
+	ASSERT_TRUE(output_hdf5->is_parallel());
+	output_hdf5->set_current_step(0);
+	output_hdf5->set_scalar_data("scalar_field", rank + 1.0);
+	output_hdf5->write_frame();
+
+	// expected offsets and global sizes of nodes, connectivity and elements
+	std::vector<unsigned int> n_local = output_hdf5->local_mesh_sizes();
+	std::vector<unsigned int> all_sizes(3*n_proc);
+	MPI_Allgather(n_local.data(), 3, MPI_UNSIGNED, all_sizes.data(), 3, MPI_UNSIGNED, MPI_COMM_WORLD);
+	std::vector<unsigned int> offset(3, 0), n_global(3, 0);
+	for (int proc=0; proc<n_proc; ++proc)
+		for (unsigned int i=0; i<3; ++i) {
+			if (proc < rank) offset[i] += all_sizes[3*proc+i];
+			n_global[i] += all_sizes[3*proc+i];
+		}
+	EXPECT_EQ(output_hdf5->_mesh->n_elements(), n_global[2]);
+
+	hsize_t dims[2];
+	output_hdf5->read_dataset("/Mesh/nodes", dims);
+	EXPECT_EQ(n_global[0], dims[0]);
+	EXPECT_EQ(3, dims[1]);
+
+	// connectivity of the local part refers to the local part of nodes
+	std::vector<double> connectivity = output_hdf5->read_dataset("/Mesh/connectivity", dims);
+	EXPECT_EQ(n_global[1], dims[0]);
+	for (unsigned int i=offset[1]; i<offset[1]+n_local[1]; ++i) {
+		EXPECT_LE(offset[0], connectivity[i]);
+		EXPECT_GT(offset[0]+n_local[0], connectivity[i]);
+	}
+
+	// end offsets of elements are shifted by the offset of connectivity
+	std::vector<double> offsets = output_hdf5->read_dataset("/Mesh/offsets", dims);
+	EXPECT_EQ(n_global[2], dims[0]);
+	EXPECT_DOUBLE_EQ(n_global[1], offsets[n_global[2]-1]);
+	if (n_local[2] > 0)
+		EXPECT_DOUBLE_EQ(offset[1]+n_local[1], offsets[offset[2]+n_local[2]-1]);
+
+	std::vector<double> values = output_hdf5->read_dataset("/Steps/000000/element_data/scalar_field", dims);
+	EXPECT_EQ(n_global[2], dims[0]);
+	EXPECT_EQ(1, dims[1]);
+	for (unsigned int i=offset[2]; i<offset[2]+n_local[2]; ++i)
+		EXPECT_DOUBLE_EQ(rank + 1.0, values[i]);
+}
+
+#endif // H5_HAVE_PARALLEL
+
+#endif // FLOW123D_HAVE_HDF5
@@ -8,6 +8,8 @@
 #include <ctime>
 #include <cstdlib>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #define TEST_USE_MPI
 #define TEST_USE_PETSC
@@ -41,6 +43,9 @@ class ProfilerTest: public testing::Test {
         void test_multiple_instances();
         void test_propagate_values();
         void test_calibrate();
+        void test_threads();
+        void test_hw_counters();
+        void test_trace();
         // void test_inconsistent_tree();
 };
 
@@ -567,6 +572,159 @@ void ProfilerTest::test_calibrate() {
     Profiler::uninitialize();
 }
 
+// testing merge of timers started in other threads
+TEST_F(ProfilerTest, test_threads) {test_threads();}
+void ProfilerTest::test_threads() {
+    const int n_threads = 4;
+    Profiler::instance();
+    {
+        START_TIMER("parallel");
+            std::vector<std::thread> workers;
+            for (int i = 0; i < n_threads; i++)
+                workers.emplace_back( [i]() {
+                    START_TIMER("work");
+                        wait_sec(0.01 * (i+1));
+                    END_TIMER("work");
+                });
+            for (auto &w : workers) w.join();
+            // timers of other threads do not change actual timer of the main thread
+            EXPECT_EQ("parallel", ATN);
+        END_TIMER("parallel");
+    }
+    std::stringstream sout;
+    PI->output(MPI_COMM_WORLD, sout);
+
+    // timers of threads are merged under the main thread timer running at their start
+    int work_idx = -1;
+    for (unsigned int i = 0; i < PI->timers_.size(); i++)
+        if (string(PI->timers_[i].tag()) == "work") work_idx = i;
+    ASSERT_GE(work_idx, 0);
+    Timer &work = PI->timers_[work_idx];
+    EXPECT_EQ("parallel", string(PI->timers_[work.parent_timer].tag()));
+
+    Profiler::ThreadStat stat = PI->thread_stat(work);
+    EXPECT_EQ(n_threads, stat.n_threads);
+    EXPECT_EQ(n_threads, stat.call_count);
+    EXPECT_GE(stat.min_time, 0.01);
+    EXPECT_GE(stat.max_time, 0.04);
+    EXPECT_LE(stat.min_time, stat.sum_time / stat.n_threads);
+    EXPECT_LE(stat.sum_time / stat.n_threads, stat.max_time);
+    // main thread does not run the timer, cumulative time is the maximum over threads
+    EXPECT_DOUBLE_EQ(stat.max_time, stat.cumul_time);
+    EXPECT_NE(sout.str().find("cumul-time-thread-max"), string::npos);
+
+    Profiler::uninitialize();
+}
+
+
+// testing report of hardware counters, counters need not be available (e.g. in virtual machines)
+TEST_F(ProfilerTest, test_hw_counters) {test_hw_counters();}
+void ProfilerTest::test_hw_counters() {
+    Profiler::instance()->set_hw_counters(true);
+    {
+        START_TIMER("compute");
+            volatile double sum = 0.0;
+            for (int i = 0; i < 100000; i++) sum += 0.5 * i;
+        END_TIMER("compute");
+    }
+    std::stringstream sout;
+    PI->output(MPI_COMM_WORLD, sout);
+
+    bool available = PI->hw_counters_enabled_
+            && PI->main_timers_.hw_counters_->available(PerfCounters::instructions);
+    if (available) {
+        EXPECT_NE(sout.str().find("hw-instructions-sum"), string::npos);
+        for (unsigned int i = 0; i < PI->timers_.size(); i++)
+            if (string(PI->timers_[i].tag()) == "compute")
+                EXPECT_GT(PI->thread_stat(PI->timers_[i]).hw_counts[PerfCounters::instructions], 100000);
+    } else {
+        EXPECT_EQ(sout.str().find("hw-instructions"), string::npos);
+    }
+
+    Profiler::uninitialize();
+}
+
+
+// estimate of events between two readings of multiplexed counters
+TEST(PerfCounters, delta) {
+    PerfCounters::Reading start, end;
+    for (unsigned int i = 0; i < PerfCounters::n_events; i++) {
+        start.count[i] = 1000; start.time_enabled[i] = 100; start.time_running[i] = 50;
+        end.count[i] = 1000;   end.time_enabled[i] = 100;   end.time_running[i] = 50;
+    }
+    // group running all the time in the interval
+    end.count[PerfCounters::cycles] = 1600;
+    end.time_enabled[PerfCounters::cycles] = 200;
+    end.time_running[PerfCounters::cycles] = 150;
+    EXPECT_EQ(600u, PerfCounters::delta(start, end, PerfCounters::cycles));
+
+    // group running 10 of 200 time units of the interval, estimate is scaled by the ratio of the interval
+    // (difference of scaled total counts would give 1100*300/60 - 1000*100/50 = 3500)
+    end.count[PerfCounters::instructions] = 1100;
+    end.time_enabled[PerfCounters::instructions] = 300;
+    end.time_running[PerfCounters::instructions] = 60;
+    EXPECT_EQ(2000u, PerfCounters::delta(start, end, PerfCounters::instructions));
+
+    // group not scheduled in the interval
+    end.time_enabled[PerfCounters::cache_misses] = 300;
+    EXPECT_EQ(0u, PerfCounters::delta(start, end, PerfCounters::cache_misses));
+
+    // reading of reopened counters is smaller than the start, no wrap around
+    end.count[PerfCounters::flops] = 10;
+    end.time_running[PerfCounters::flops] = 60;
+    EXPECT_EQ(0u, PerfCounters::delta(start, end, PerfCounters::flops));
+}
+
+
+// testing timeline export in Chrome trace format
+TEST_F(ProfilerTest, test_trace) {test_trace();}
+void ProfilerTest::test_trace() {
+    const unsigned int capacity = 4;
+    Profiler::instance()->set_trace(true, capacity);
+    {
+        START_TIMER("step");
+            START_TIMER("assembly");
+            END_TIMER("assembly");
+        END_TIMER("step");
+        std::thread worker( []() {
+            START_TIMER("worker");
+            END_TIMER("worker");
+        });
+        worker.join();
+    }
+    EXPECT_EQ(2, PI->main_timers_.trace_count_);
+    EXPECT_EQ(1, PI->thread_timers_[0]->trace_count_);
+    // events are recorded at their end, the inner one first
+    ThreadTimers::TraceEvent &assembly = PI->main_timers_.trace_[0];
+    ThreadTimers::TraceEvent &step = PI->main_timers_.trace_[1];
+    EXPECT_EQ("assembly", PI->timers_[assembly.timer].tag());
+    EXPECT_LE(step.start, assembly.start);
+    EXPECT_LE(assembly.end, step.end);
+
+    // ring buffer keeps only last events
+    for (int i = 0; i < 10; i++) {
+        START_TIMER("loop");
+        END_TIMER("loop");
+    }
+    EXPECT_EQ(12, PI->main_timers_.trace_count_);
+    EXPECT_EQ(capacity, PI->main_timers_.trace_.size());
+
+    std::stringstream sout;
+    PI->output_trace(MPI_COMM_WORLD, sout);
+    int mpi_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    if (mpi_rank == 0) {
+        EXPECT_NE(sout.str().find("\"traceEvents\""), string::npos);
+        EXPECT_NE(sout.str().find("\"worker\""), string::npos);
+        EXPECT_NE(sout.str().find("\"ph\":\"X\""), string::npos);
+        // overwritten events are not written
+        EXPECT_EQ(sout.str().find("\"step\""), string::npos);
+    }
+
+    Profiler::uninitialize();
+}
+
+
 // optional test only for testing merging of inconsistent profiler trees
 // TEST_F(ProfilerTest, test_inconsistent_tree) {test_inconsistent_tree();}
 // void ProfilerTest::test_inconsistent_tree() {